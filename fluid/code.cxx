@@ -44,6 +44,9 @@ int write_number = 0;
 
 int write_sourceview = 0;
 
+/// If set, write this stamp into the source code file, see fluid -stamp
+char code_stamp[32] = "";
+
 /**
  Return true if c can be in a C identifier.
  I needed this so it is not messed up by locale settings.
@@ -55,52 +58,204 @@ int is_id(char c) {
 ////////////////////////////////////////////////////////////////
 // Generate unique but human-readable identifiers:
 
-struct id {
-  char* text;
-  void* object;
-  id *left, *right;
-  id (const char* t, void* o) : text(fl_strdup(t)), object(o) {left = right = 0;}
-  ~id();
+/**
+ A single identifier in the Fd_Id_Map.
+ */
+struct Fd_Id_Map::Entry {
+  char *text;           ///< the identifier
+  void *object;         ///< the object that this identifier was generated for
+  int next_suffix;      ///< all identifiers with this base and a smaller suffix are taken
+  Entry *name_link;     ///< next entry in the same name bucket
+  Entry *object_link;   ///< next entry in the same object bucket
 };
 
-id::~id() {
-  delete left;
-  free((void *)text);
-  delete right;
+static unsigned int hash_name(const char *s) {
+  unsigned int h = 2166136261U;
+  for (; *s; s++) { h ^= (unsigned char)*s; h *= 16777619U; }
+  return h;
 }
 
-static id* id_root;
+static unsigned int hash_object(const void *o) {
+  unsigned long long v = (unsigned long long)(fl_intptr_t)o;
+  v ^= v >> 17; v *= 0xed5ad4bbU; v ^= v >> 11;
+  return (unsigned int)v;
+}
 
-// TODO: document me
-const char* unique_id(void* o, const char* type, const char* name, const char* label) {
-  char buffer[128];
-  char* q = buffer;
-  while (*type) *q++ = *type++;
+/**
+ Create an empty identifier map.
+ */
+Fd_Id_Map::Fd_Id_Map() :
+  name_buckets_(NULL),
+  object_buckets_(NULL),
+  num_buckets_(0),
+  count_(0)
+{ }
+
+/**
+ Release all identifiers.
+ */
+Fd_Id_Map::~Fd_Id_Map() {
+  clear();
+}
+
+/**
+ Forget all identifiers that were generated so far.
+ This is called at the start of every code generation run.
+ */
+void Fd_Id_Map::clear() {
+  for (int i = 0; i < num_buckets_; i++) {
+    Entry *e = name_buckets_[i];
+    while (e) {
+      Entry *n = e->name_link;
+      free(e->text);
+      delete e;
+      e = n;
+    }
+  }
+  free(name_buckets_);
+  free(object_buckets_);
+  name_buckets_ = object_buckets_ = NULL;
+  num_buckets_ = count_ = 0;
+}
+
+/**
+ Find an identifier.
+ \param[in] text the identifier
+ \return the entry, or NULL if the identifier is not used yet
+ */
+Fd_Id_Map::Entry *Fd_Id_Map::find(const char *text) const {
+  if (!num_buckets_) return NULL;
+  Entry *e = name_buckets_[hash_name(text) & (num_buckets_-1)];
+  for (; e; e = e->name_link)
+    if (strcmp(e->text, text) == 0) return e;
+  return NULL;
+}
+
+/**
+ Double the number of buckets when the tables are getting crowded.
+ */
+void Fd_Id_Map::grow() {
+  int n = num_buckets_ ? 2*num_buckets_ : 256;
+  Entry **nb = (Entry**)calloc(n, sizeof(Entry*));
+  Entry **ob = (Entry**)calloc(n, sizeof(Entry*));
+  for (int i = 0; i < num_buckets_; i++) {
+    Entry *e = name_buckets_[i];
+    while (e) {
+      Entry *next = e->name_link;
+      unsigned int h = hash_name(e->text) & (n-1);
+      e->name_link = nb[h]; nb[h] = e;
+      h = hash_object(e->object) & (n-1);
+      e->object_link = ob[h]; ob[h] = e;
+      e = next;
+    }
+  }
+  free(name_buckets_);
+  free(object_buckets_);
+  name_buckets_ = nb;
+  object_buckets_ = ob;
+  num_buckets_ = n;
+}
+
+/**
+ Add a new identifier to the map.
+ \param[in] text the identifier, which must not be in the map yet
+ \param[in] o the object that owns the identifier
+ \return the new entry
+ */
+Fd_Id_Map::Entry *Fd_Id_Map::insert(const char *text, void *o) {
+  if (count_ >= num_buckets_) grow();
+  Entry *e = new Entry;
+  e->text = fl_strdup(text);
+  e->object = o;
+  e->next_suffix = 1;
+  unsigned int h = hash_name(text) & (num_buckets_-1);
+  e->name_link = name_buckets_[h]; name_buckets_[h] = e;
+  h = hash_object(o) & (num_buckets_-1);
+  e->object_link = object_buckets_[h]; object_buckets_[h] = e;
+  count_++;
+  return e;
+}
+
+/**
+ Create a unique but human-readable identifier for an object.
+
+ The identifier is built from the type, followed by an underscore, followed by
+ the C identifier characters of the name, or of the label if there is no name.
+ If that identifier was already given to another object, a hexadecimal number
+ is appended, starting at 1. Calling this function again for the same object
+ and the same name returns the same identifier.
+
+ The first free number is remembered with every base identifier, so that
+ many objects with the same name can be named in constant time per object.
+
+ \param[in] o the object that will be identified
+ \param[in] type a short prefix, e.g. "cb" or "menu"
+ \param[in] name the name of the object, may be NULL
+ \param[in] label the label of the object, used if there is no name
+ \return a pointer to the identifier, which is valid until clear() is called
+ */
+const char *Fd_Id_Map::unique_id(void *o, const char *type, const char *name, const char *label) {
+  char buffer[256];
+  char *q = buffer;
+  char *end = buffer + sizeof(buffer) - 10; // leave room for the suffix
+  while (*type && q < end) *q++ = *type++;
   *q++ = '_';
   const char* n = name;
   if (!n || !*n) n = label;
   if (n && *n) {
     while (*n && !is_id(*n)) n++;
-    while (is_id(*n)) *q++ = *n++;
+    while (is_id(*n) && q < end) *q++ = *n++;
   }
   *q = 0;
-  // okay, search the tree and see if the name was already used:
-  id** p = &id_root;
-  int which = 0;
-  while (*p) {
-    int i = strcmp(buffer, (*p)->text);
-    if (!i) {
-      if ((*p)->object == o) return (*p)->text;
-      // already used, we need to pick a new name:
-      sprintf(q,"%x",++which);
-      p = &id_root;
-      continue;
+
+  Entry *base = find(buffer);
+  if (!base) return insert(buffer, o)->text;
+  if (base->object == o) return base->text;
+
+  // All identifiers below the base's next_suffix are taken. If one of them
+  // belongs to this object, return the one with the lowest suffix.
+  int base_len = (int)(q - buffer);
+  int best = 0;
+  Entry *e = object_buckets_[hash_object(o) & (num_buckets_-1)];
+  for (; e; e = e->object_link) {
+    if (e->object != o || strncmp(e->text, buffer, base_len) != 0) continue;
+    const char *s = e->text + base_len;
+    if (*s == '0' || strlen(s) < 1 || strlen(s) > 7) continue;
+    int v = 0;
+    for (; *s; s++) {
+      if (*s >= '0' && *s <= '9') v = v*16 + (*s - '0');
+      else if (*s >= 'a' && *s <= 'f') v = v*16 + (*s - 'a' + 10);
+      else break;
     }
-    else if (i < 0) p = &((*p)->left);
-    else p  = &((*p)->right);
+    if (*s || v >= base->next_suffix) continue;
+    if (!best || v < best) best = v;
+  }
+  if (best) {
+    sprintf(q, "%x", best);
+    return find(buffer)->text;
+  }
+
+  // Find the next free suffix.
+  int which = base->next_suffix;
+  for (;; which++) {
+    sprintf(q, "%x", which);
+    e = find(buffer);
+    if (!e) break;
+    if (e->object == o) return e->text;
   }
-  *p = new id(buffer, o);
-  return (*p)->text;
+  base->next_suffix = which + 1;
+  return insert(buffer, o)->text;
+}
+
+/// The identifiers used during the current code generation run.
+Fd_Id_Map g_id_map;
+
+/**
+ Create a unique but human-readable identifier for an object.
+ \see Fd_Id_Map::unique_id()
+ */
+const char* unique_id(void* o, const char* type, const char* name, const char* label) {
+  return g_id_map.unique_id(o, type, name, label);
 }
 
 ////////////////////////////////////////////////////////////////
@@ -536,7 +691,7 @@ int write_code(const char *s, const char *t) {
   if (write_sourceview)
     filemode = "wb";
   write_number++;
-  delete id_root; id_root = 0;
+  g_id_map.clear();
   indentation = 0;
   current_class = 0L;
   current_widget_class = 0L;
@@ -573,6 +728,8 @@ int write_code(const char *s, const char *t) {
 // generated by Fast Light User Interface Designer (fluid) version %.4f\n\n";
   fprintf(header_file, hdr, FL_VERSION);
   fprintf(code_file, hdr, FL_VERSION);
+  if (code_stamp[0])
+    fprintf(code_file, "// fluid stamp %s\n\n", code_stamp);
 
   {char define_name[102];
   const char* a = fl_filename_name(t);
@@ -24,8 +24,33 @@
 extern int indentation;
 extern int write_number;
 extern int write_sourceview;
+extern char code_stamp[32];
 
 int is_id(char c);
+
+/**
+ A hashed table of all identifiers that were generated by unique_id().
+ */
+class Fd_Id_Map {
+  struct Entry;
+  Entry **name_buckets_;
+  Entry **object_buckets_;
+  int num_buckets_;
+  int count_;
+  Entry *find(const char *text) const;
+  Entry *insert(const char *text, void *o);
+  void grow();
+public:
+  Fd_Id_Map();
+  ~Fd_Id_Map();
+  void clear();
+  const char *unique_id(void *o, const char *type, const char *name, const char *label);
+  /** Return the number of identifiers in the map. */
+  int size() const { return count_; }
+};
+
+extern Fd_Id_Map g_id_map;
+
 const char* unique_id(void* o, const char*, const char*, const char*);
 const char *indent();
 const char *indent(int set);
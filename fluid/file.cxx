@@ -51,6 +51,13 @@
 static FILE *fout;
 static FILE *fin;
 
+static char *mem_out;           // memory buffer if writing to memory, or NULL
+static int mem_out_size;        // number of bytes written to mem_out
+static int mem_out_alloc;       // allocated size of mem_out
+
+static const char *mem_in;      // memory buffer if reading from memory, or NULL
+static const char *mem_in_end;  // end of the memory buffer
+
 static int needspace;
 static int lineno;
 static const char *fname;
@@ -90,17 +97,73 @@ static int close_write() {
   return 1;
 }
 
+/**
+ Make sure that the memory output buffer can hold \p n more bytes.
+ */
+static void mem_out_reserve(int n) {
+  if (mem_out_size + n + 1 > mem_out_alloc) {
+    mem_out_alloc = 2 * mem_out_alloc + n + 1024;
+    mem_out = (char*)realloc(mem_out, mem_out_alloc);
+  }
+}
+
+/**
+ Write a single character to the .fl file or memory buffer.
+ */
+static void write_c(int c) {
+  if (mem_out) {
+    mem_out_reserve(1);
+    mem_out[mem_out_size++] = (char)c;
+  } else {
+    putc(c, fout);
+  }
+}
+
+/**
+ Write an unquoted string to the .fl file or memory buffer.
+ */
+static void write_s(const char *s) {
+  if (mem_out) {
+    int n = (int)strlen(s);
+    mem_out_reserve(n);
+    memcpy(mem_out + mem_out_size, s, n);
+    mem_out_size += n;
+  } else {
+    fputs(s, fout);
+  }
+}
+
+/**
+ Write a formatted string to the .fl file or memory buffer.
+ */
+static void write_vfmt(const char *format, va_list args) {
+  if (mem_out) {
+    va_list args2;
+    va_copy(args2, args);
+    int n = vsnprintf(mem_out + mem_out_size, mem_out_alloc - mem_out_size, format, args2);
+    va_end(args2);
+    if (n < 0) return;
+    if (mem_out_size + n >= mem_out_alloc) {
+      mem_out_reserve(n);
+      vsnprintf(mem_out + mem_out_size, mem_out_alloc - mem_out_size, format, args);
+    }
+    mem_out_size += n;
+  } else {
+    vfprintf(fout, format, args);
+  }
+}
+
 /**
  Write a string to the .fl file, quoting characters if necessary.
  */
 void write_word(const char *w) {
-  if (needspace) putc(' ', fout);
+  if (needspace) write_c(' ');
   needspace = 1;
-  if (!w || !*w) {fprintf(fout,"{}"); return;}
+  if (!w || !*w) {write_s("{}"); return;}
   const char *p;
   // see if it is a single word:
   for (p = w; is_id(*p); p++) ;
-  if (!*p) {fprintf(fout,"%s",w); return;}
+  if (!*p) {write_s(w); return;}
   // see if there are matching braces:
   int n = 0;
   for (p = w; *p; p++) {
@@ -109,7 +172,7 @@ void write_word(const char *w) {
   }
   int mismatched = (n != 0);
   // write out brace-quoted string:
-  putc('{', fout);
+  write_c('{');
   for (; *w; w++) {
     switch (*w) {
     case '{':
@@ -117,12 +180,12 @@ void write_word(const char *w) {
       if (!mismatched) break;
     case '\\':
     case '#':
-      putc('\\',fout);
+      write_c('\\');
       break;
     }
-    putc(*w,fout);
+    write_c(*w);
   }
-  putc('}', fout);
+  write_c('}');
 }
 
 /**
@@ -133,8 +196,8 @@ void write_word(const char *w) {
 void write_string(const char *format, ...) {
   va_list args;
   va_start(args, format);
-  if (needspace && *format != '\n') fputc(' ',fout);
-  vfprintf(fout, format, args);
+  if (needspace && *format != '\n') write_c(' ');
+  write_vfmt(format, args);
   va_end(args);
   needspace = !isspace(format[strlen(format)-1] & 255);
 }
@@ -143,8 +206,8 @@ void write_string(const char *format, ...) {
  Start a new line in the .fl file and indent it for a given nesting level.
  */
 void write_indent(int n) {
-  fputc('\n',fout);
-  while (n--) {fputc(' ',fout); fputc(' ',fout);}
+  write_c('\n');
+  while (n--) {write_c(' '); write_c(' ');}
   needspace = 0;
 }
 
@@ -152,8 +215,8 @@ void write_indent(int n) {
  Write a '{' to the .fl file at the given indenting level.
  */
 void write_open(int) {
-  if (needspace) fputc(' ',fout);
-  fputc('{',fout);
+  if (needspace) write_c(' ');
+  write_c('{');
   needspace = 0;
 }
 
@@ -162,7 +225,7 @@ void write_open(int) {
  */
 void write_close(int n) {
   if (needspace) write_indent(n);
-  fputc('}',fout);
+  write_c('}');
   needspace = 1;
 }
 
@@ -190,6 +253,10 @@ static int open_read(const char *s) {
  \return 0 if the operation failed, 1 if it succeeded
  */
 static int close_read() {
+  if (mem_in) {
+    mem_in = mem_in_end = 0;
+    return 1;
+  }
   if (fin != stdin) {
     int x = fclose(fin);
     fin = 0;
@@ -207,7 +274,7 @@ static int close_read() {
 void read_error(const char *format, ...) {
   va_list args;
   va_start(args, format);
-  if (!fin) {
+  if (!fin && !mem_in) {
     char buffer[1024];
     vsnprintf(buffer, sizeof(buffer), format, args);
     fl_message("%s", buffer);
@@ -219,6 +286,35 @@ void read_error(const char *format, ...) {
   va_end(args);
 }
 
+/**
+ Read the next character from the .fl file or memory buffer.
+ \return the character, or EOF at the end of the input
+ */
+static int read_c() {
+  if (mem_in) {
+    if (mem_in >= mem_in_end) return EOF;
+    return (unsigned char)*mem_in++;
+  }
+  return getc(fin);
+}
+
+/**
+ Push back the last character returned by read_c().
+ */
+static void unread_c(int c) {
+  if (c < 0) return;
+  if (mem_in) mem_in--;
+  else ungetc(c, fin);
+}
+
+/**
+ Return non-zero if the .fl file or memory buffer is at its end.
+ */
+static int read_eof() {
+  if (mem_in) return mem_in >= mem_in_end;
+  return feof(fin);
+}
+
 /**
  Convert a single ASCII char, assumed to be a hex digit, into its decimal value.
  */
@@ -236,7 +332,7 @@ static int hexdigit(int x) {
  */
 static int read_quoted() {      // read whatever character is after a \ .
   int c,d,x;
-  switch(c = fgetc(fin)) {
+  switch(c = read_c()) {
   case '\n': lineno++; return -1;
   case 'a' : return('\a');
   case 'b' : return('\b');
@@ -247,9 +343,9 @@ static int read_quoted() {      // read whatever character is after a \ .
   case 'v' : return('\v');
   case 'x' :    /* read hex */
     for (c=x=0; x<3; x++) {
-      int ch = fgetc(fin);
+      int ch = read_c();
       d = hexdigit(ch);
-      if (d > 15) {ungetc(ch,fin); break;}
+      if (d > 15) {unread_c(ch); break;}
       c = (c<<4)+d;
     }
     break;
@@ -257,9 +353,9 @@ static int read_quoted() {      // read whatever character is after a \ .
     if (c<'0' || c>'7') break;
     c -= '0';
     for (x=0; x<2; x++) {
-      int ch = fgetc(fin);
+      int ch = read_c();
       d = hexdigit(ch);
-      if (d>7) {ungetc(ch,fin); break;}
+      if (d>7) {unread_c(ch); break;}
       c = (c<<3)+d;
     }
     break;
@@ -303,11 +399,11 @@ const char *read_word(int wantbrace) {
 
   // skip all the whitespace before it:
   for (;;) {
-    x = getc(fin);
-    if (x < 0 && feof(fin)) {   // eof
+    x = read_c();
+    if (x < 0 && read_eof()) {   // eof
       return 0;
     } else if (x == '#') {      // comment
-      do x = getc(fin); while (x >= 0 && x != '\n');
+      do x = read_c(); while (x >= 0 && x != '\n');
       lineno++;
       continue;
     } else if (x == '\n') {
@@ -325,10 +421,10 @@ const char *read_word(int wantbrace) {
     int length = 0;
     int nesting = 0;
     for (;;) {
-      x = getc(fin);
+      x = read_c();
       if (x<0) {read_error("Missing '}'"); break;}
       else if (x == '#') { // embedded comment
-        do x = getc(fin); while (x >= 0 && x != '\n');
+        do x = read_c(); while (x >= 0 && x != '\n');
         lineno++;
         continue;
       } else if (x == '\n') lineno++;
@@ -356,9 +452,9 @@ const char *read_word(int wantbrace) {
       else if (x<0 || isspace(x & 255) || x=='{' || x=='}' || x=='#') break;
       buffer[length++] = x;
       expand_buffer(length);
-      x = getc(fin);
+      x = read_c();
     }
-    ungetc(x, fin);
+    unread_c(x);
     buffer[length] = 0;
     return buffer;
 
@@ -368,13 +464,11 @@ const char *read_word(int wantbrace) {
 ////////////////////////////////////////////////////////////////
 
 /**
- Write an .fl design description file.
- \param[in] filename create this file, and if it exists, overwrite it
+ Write the project settings and the design tree to the current output.
  \param[in] selected_only write only the selected nodes in the widget_tree. This
     is used to implement copy and paste.
  */
-int write_file(const char *filename, int selected_only) {
-  if (!open_write(filename)) return 0;
+static void write_design(int selected_only) {
   write_string("# data file for the Fltk User Interface Designer (fluid)\n"
                "version %.4f",FL_VERSION);
   if(!P.include_H_from_C)
@@ -437,9 +531,47 @@ int write_file(const char *filename, int selected_only) {
       p = p->next;
     }
   }
+}
+
+/**
+ Write an .fl design description file.
+ \param[in] filename create this file, and if it exists, overwrite it
+ \param[in] selected_only write only the selected nodes in the widget_tree. This
+    is used to implement copy and paste.
+ */
+int write_file(const char *filename, int selected_only) {
+  if (!open_write(filename)) return 0;
+  write_design(selected_only);
   return close_write();
 }
 
+/**
+ Write an .fl design description into a memory buffer.
+
+ The buffer is allocated with malloc() and must be released by the caller
+ with free(). The buffer is zero terminated, but may contain more than
+ one line.
+
+ \param[out] data return a pointer to the newly allocated buffer
+ \param[out] size return the number of bytes in the buffer, not counting
+    the trailing zero
+ \param[in] selected_only write only the selected nodes in the widget_tree
+ \return 1 if successful. 0 if the operation failed
+ */
+int write_file_to_memory(char *&data, int &size, int selected_only) {
+  mem_out_size = mem_out_alloc = 0;
+  mem_out = 0;
+  mem_out_reserve(4096);
+  if (!mem_out) return 0;
+  write_design(selected_only);
+  mem_out[mem_out_size] = 0;
+  data = mem_out;
+  size = mem_out_size;
+  mem_out = 0;
+  mem_out_size = mem_out_alloc = 0;
+  return 1;
+}
+
 ////////////////////////////////////////////////////////////////
 // read all the objects out of the input file:
 
@@ -634,18 +766,14 @@ static void read_children(Fl_Type *p, int paste, Strategy strategy, char skip_op
 }
 
 /**
- Read a .fl design file.
- \param[in] filename read this file
+ Read the project settings and the design tree from the current input.
  \param[in] merge if this is set, merge the file into an existing design
     at Fl_Type::current
  \param[in] strategy add new nodes after current or as last child
- \return 0 if the operation failed, 1 if it succeeded
  */
-int read_file(const char *filename, int merge, Strategy strategy) {
+static void read_design(int merge, Strategy strategy) {
   Fl_Type *o;
   read_version = 0.0;
-  if (!open_read(filename))
-    return 0;
   if (merge)
     deselect();
   else
@@ -663,6 +791,41 @@ int read_file(const char *filename, int merge, Strategy strategy) {
     }
   selection_changed(Fl_Type::current);
   shell_settings_read();
+}
+
+/**
+ Read a .fl design file.
+ \param[in] filename read this file
+ \param[in] merge if this is set, merge the file into an existing design
+    at Fl_Type::current
+ \param[in] strategy add new nodes after current or as last child
+ \return 0 if the operation failed, 1 if it succeeded
+ */
+int read_file(const char *filename, int merge, Strategy strategy) {
+  if (!open_read(filename))
+    return 0;
+  read_design(merge, strategy);
+  return close_read();
+}
+
+/**
+ Read a .fl design from a memory buffer.
+ This is the counterpart to write_file_to_memory().
+ \param[in] data the design as it would be stored in a .fl file
+ \param[in] size number of bytes in data
+ \param[in] merge if this is set, merge the design into an existing design
+    at Fl_Type::current
+ \param[in] strategy add new nodes after current or as last child
+ \return 0 if the operation failed, 1 if it succeeded
+ */
+int read_file_from_memory(const char *data, int size, int merge, Strategy strategy) {
+  if (!data)
+    return 0;
+  lineno = 1;
+  fname = "memory";
+  mem_in = data;
+  mem_in_end = data + size;
+  read_design(merge, strategy);
   return close_read();
 }
 
@@ -674,8 +837,8 @@ static int read_fdesign_line(const char*& name, const char*& value) {
   int x;
   // find a colon:
   for (;;) {
-    x = getc(fin);
-    if (x < 0 && feof(fin)) return 0;
+    x = read_c();
+    if (x < 0 && read_eof()) return 0;
     if (x == '\n') {length = 0; continue;} // no colon this line...
     if (!isspace(x & 255)) {
       buffer[length++] = x;
@@ -688,8 +851,8 @@ static int read_fdesign_line(const char*& name, const char*& value) {
 
   // skip to start of value:
   for (;;) {
-    x = getc(fin);
-    if ((x < 0 && feof(fin)) || x == '\n' || !isspace(x & 255)) break;
+    x = read_c();
+    if ((x < 0 && read_eof()) || x == '\n' || !isspace(x & 255)) break;
   }
 
   // read the value:
@@ -698,7 +861,7 @@ static int read_fdesign_line(const char*& name, const char*& value) {
     else if (x == '\n') break;
     buffer[length++] = x;
     expand_buffer(length);
-    x = getc(fin);
+    x = read_c();
   }
   buffer[length] = 0;
   name = buffer;
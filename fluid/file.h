@@ -35,8 +35,10 @@ void read_error(const char *format, ...);
 const char *read_word(int wantbrace = 0);
 
 int write_file(const char *, int selected_only = 0);
+int write_file_to_memory(char *&data, int &size, int selected_only = 0);
 
 int read_file(const char *, int merge, Strategy strategy=kAddAsLastChild);
+int read_file_from_memory(const char *data, int size, int merge, Strategy strategy=kAddAsLastChild);
 void read_fdesign();
 
 #endif // _FLUID_FILE_H
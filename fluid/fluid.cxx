@@ -46,6 +46,11 @@
 #include <locale.h>     // setlocale()..
 #include "../src/flstring.h"
 
+#if !defined(_WIN32) || defined(__CYGWIN__)
+#  include <unistd.h>
+#  include <sys/wait.h>
+#endif
+
 extern "C"
 {
 #if defined(HAVE_LIBPNG) && defined(HAVE_LIBZ)
@@ -163,6 +168,12 @@ int compile_strings = 0;        // fluic -cs
 /// Set, if Fluid runs in batch mode, and no user interface is activated.
 int batch_mode = 0;             // if set (-c, -u) don't open display
 
+/// Number of worker processes when compiling multiple files in batch mode.
+int batch_jobs = 1;             // fluid -j <n>
+
+/// Set, if Fluid was started with the command line argument -stamp
+int use_code_stamp = 0;         // fluid -stamp
+
 /// command line arguments override settings in the projectfile
 Fd_String g_code_filename_arg;
 Fd_String g_header_filename_arg;
@@ -961,6 +972,64 @@ void new_from_template_cb(Fl_Widget *w, void *v) {
   undo_clear();
 }
 
+/**
+ Check if a previously generated source file was created from the same input.
+
+ The stamp is written by write_code() into the first lines of the source
+ code file. If the stamp matches the current \c code_stamp, and the header
+ file exists, there is no need to generate both files again.
+
+ \param[in] cname source code filename
+ \param[in] hname header filename
+ \return 1 if the code files are up to date, 0 if they must be written
+ */
+static int code_stamp_matches(const char *cname, const char *hname) {
+  FILE *f = fl_fopen(hname, "r");
+  if (!f) return 0;
+  fclose(f);
+  f = fl_fopen(cname, "r");
+  if (!f) return 0;
+  char line[256], match[64];
+  snprintf(match, sizeof(match), "// fluid stamp %s\n", code_stamp);
+  int found = 0;
+  for (int i = 0; i < 64 && fgets(line, sizeof(line), f); i++) {
+    if (strncmp(line, "// fluid stamp ", 15) == 0) {
+      found = (strcmp(line, match) == 0);
+      break;
+    }
+  }
+  fclose(f);
+  return found;
+}
+
+/**
+ Calculate a stamp for an .fl file in batch mode.
+
+ The stamp is a 64 bit FNV-1a hash over the contents of the .fl file, the
+ Fluid version, and all command line options that change the generated code.
+
+ \param[in] c filename of the .fl file
+ \param[out] stamp receives the stamp as a hexadecimal string
+ \param[in] size size of the stamp buffer
+ */
+static void calculate_code_stamp(const char *c, char *stamp, int size) {
+  unsigned long long h = 14695981039346656037ULL;
+  unsigned char buf[4096];
+  char opts[2*FL_PATH_MAX+64];
+  stamp[0] = 0;
+  FILE *f = fl_fopen(c, "rb");
+  if (!f) return;
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    for (size_t i = 0; i < n; i++) { h ^= buf[i]; h *= 1099511628211ULL; }
+  }
+  fclose(f);
+  snprintf(opts, sizeof(opts), "%.4f|%s|%s|%d", FL_VERSION,
+           g_code_filename_arg.value(), g_header_filename_arg.value(), compile_strings);
+  for (const char *p = opts; *p; p++) { h ^= (unsigned char)*p; h *= 1099511628211ULL; }
+  snprintf(stamp, size, "%08lx%08lx", (unsigned long)(h >> 32), (unsigned long)(h & 0xffffffffUL));
+}
+
 /**
  Generate the C++ source and header filenames and write those files.
 
@@ -970,7 +1039,7 @@ void new_from_template_cb(Fl_Widget *w, void *v) {
  settable by the user.
 
  In batch_mode, the function will either be silent, or write an error message
- to \c stderr and exit with exit code 1.
+ to \c stderr and return 1.
 
  In interactive mode, we will pop up an error message, or, if the user
  hasn't isabled that, pop up a confirmation message.
@@ -998,13 +1067,15 @@ int write_code_files() {
   } else {
     strlcpy(hname, P.header_file_name, FL_PATH_MAX);
   }
+  if (batch_mode && code_stamp[0] && code_stamp_matches(cname, hname))
+    return 0;
   if (!batch_mode) enter_project_dir();
   int x = write_code(cname,hname);
   if (!batch_mode) leave_project_dir();
   strlcat(cname, " and ", FL_PATH_MAX);
   strlcat(cname, hname, FL_PATH_MAX);
   if (batch_mode) {
-    if (!x) {fprintf(stderr,"%s : %s\n",cname,strerror(errno)); exit(1);}
+    if (!x) {fprintf(stderr,"%s : %s\n",cname,strerror(errno)); return 1;}
   } else {
     if (!x) {
       fl_message("Can't write %s: %s", cname, strerror(errno));
@@ -1027,12 +1098,17 @@ void write_cb(Fl_Widget *, void *) {
 
 /**
  Write the strings that are used in i18n.
+
+ In batch_mode, the function will either be silent, or write an error message
+ to \c stderr and return 1.
+
+ \return 1 if the operation failed, 0 if it succeeded
  */
-void write_strings_cb(Fl_Widget *, void *) {
+static int write_strings_file() {
   static const char *exts[] = { ".txt", ".po", ".msg" };
   if (!filename) {
     save_cb(0,0);
-    if (!filename) return;
+    if (!filename) return 1;
   }
   char sname[FL_PATH_MAX];
   strlcpy(sname, fl_filename_name(filename), sizeof(sname));
@@ -1041,7 +1117,7 @@ void write_strings_cb(Fl_Widget *, void *) {
   int x = write_strings(sname);
   if (!batch_mode) leave_project_dir();
   if (batch_mode) {
-    if (x) {fprintf(stderr,"%s : %s\n",sname,strerror(errno)); exit(1);}
+    if (x) {fprintf(stderr,"%s : %s\n",sname,strerror(errno)); return 1;}
   } else {
     if (x) {
       fl_message("Can't write %s: %s", sname, strerror(errno));
@@ -1049,6 +1125,14 @@ void write_strings_cb(Fl_Widget *, void *) {
       fl_message("Wrote %s", sname);
     }
   }
+  return 0;
+}
+
+/**
+ Callback to write the strings that are used in i18n.
+ */
+void write_strings_cb(Fl_Widget *, void *) {
+  write_strings_file();
 }
 
 /**
@@ -1914,6 +1998,13 @@ static int arg(int argc, char** argv, int& i) {
   if (argv[i][1] == 'u' && !argv[i][2]) {update_file++; batch_mode++; i++; return 1;}
   if (argv[i][1] == 'c' && !argv[i][2]) {compile_file++; batch_mode++; i++; return 1;}
   if (argv[i][1] == 'c' && argv[i][2] == 's' && !argv[i][3]) {compile_file++; compile_strings++; batch_mode++; i++; return 1;}
+  if (strcmp(argv[i], "-stamp") == 0) {use_code_stamp++; i++; return 1;}
+  if (argv[i][1] == 'j' && !argv[i][2] && i+1 < argc) {
+    batch_jobs = atoi(argv[i+1]);
+    if (batch_jobs < 1) batch_jobs = 1;
+    i += 2;
+    return 2;
+  }
   if (argv[i][1] == 'o' && !argv[i][2] && i+1 < argc) {
     g_code_filename_arg = argv[i+1];
     batch_mode++;
@@ -1934,6 +2025,177 @@ static int arg(int argc, char** argv, int& i) {
   return 0;
 }
 
+/**
+ Read a single .fl file in batch mode and write all requested files.
+ In case of an error, the function writes a message to stderr and returns 1,
+ so that the caller can continue with the next file.
+ \param[in] c filename of the .fl file
+ \return 1 if the file could not be read or written, 0 if it succeeded
+ */
+static int batch_process_file(const char *c) {
+  set_filename(c);
+  if (use_code_stamp)
+    calculate_code_stamp(c, code_stamp, sizeof(code_stamp));
+  undo_suspend();
+  int ok = read_file(c,0);
+  undo_resume();
+  if (!ok) {
+    fprintf(stderr,"%s : %s\n", c, strerror(errno));
+    return 1;
+  }
+
+  // command line args override code and header filenams from the project file
+  if (!g_code_filename_arg.empty()) {
+    P.code_file_set = 1;
+    P.code_file_name = g_code_filename_arg;
+  }
+  if (!g_header_filename_arg.empty()) {
+    P.header_file_set = 1;
+    P.header_file_name = g_header_filename_arg;
+  }
+
+  int ret = 0;
+  if (update_file) {            // fluid -u
+    if (!write_file(c,0)) {
+      fprintf(stderr,"%s : %s\n", c, strerror(errno));
+      ret = 1;
+    }
+  }
+
+  if (compile_file) {           // fluid -c[s]
+    if (compile_strings && write_strings_file())
+      ret = 1;
+    if (write_code_files())
+      ret = 1;
+  }
+  return ret;
+}
+
+/**
+ Add the filenames listed in a response file to the list of batch files.
+ Every line in the file holds one filename. Empty lines and lines starting
+ with a '#' are ignored.
+ \param[in] name filename of the response file
+ \param[inout] files growing array of filenames
+ \param[inout] n number of filenames in the array
+ \param[inout] alloc allocated size of the array
+ \return 1 if the response file could not be read, 0 if it succeeded
+ */
+static int batch_read_response_file(const char *name, char **&files, int &n, int &alloc) {
+  FILE *f = fl_fopen(name, "r");
+  if (!f) {
+    fprintf(stderr,"%s : %s\n", name, strerror(errno));
+    return 1;
+  }
+  char line[FL_PATH_MAX+2];
+  while (fgets(line, sizeof(line), f)) {
+    char *s = line, *e = line + strlen(line);
+    while (*s && isspace(*s & 255)) s++;
+    while (e > s && isspace(e[-1] & 255)) *--e = 0;
+    if (!*s || *s == '#') continue;
+    if (n >= alloc) {
+      alloc = alloc ? 2*alloc : 64;
+      files = (char**)realloc(files, alloc*sizeof(char*));
+    }
+    files[n++] = fl_strdup(s);
+  }
+  fclose(f);
+  return 0;
+}
+
+/**
+ Run Fluid in batch mode for one or more .fl files.
+
+ Filenames starting with a '@' are response files that contain a list of .fl
+ files. If more than one worker was requested with -j, the files are
+ distributed over that many child processes. Every worker has its own copy
+ of the project and code generator state, so no global state is shared
+ between files that are compiled in parallel. On platforms without fork(),
+ all files are compiled in sequence.
+
+ A file that can not be read or written does not stop the other files.
+
+ \param[in] argc number of filenames
+ \param[in] argv list of filenames
+ \return 0 if all files were processed successfully, 1 otherwise
+ */
+static int batch_main(int argc, char **argv) {
+  char **files = NULL;
+  int n = 0, alloc = 0, ret = 0;
+  for (int i = 0; i < argc; i++) {
+    if (argv[i][0] == '@') {
+      if (batch_read_response_file(argv[i]+1, files, n, alloc))
+        ret = 1;
+    } else {
+      if (n >= alloc) {
+        alloc = alloc ? 2*alloc : 64;
+        files = (char**)realloc(files, alloc*sizeof(char*));
+      }
+      files[n++] = fl_strdup(argv[i]);
+    }
+  }
+
+  // with several input files, -o and -h must give extensions, or all files
+  // would be written to the same output file
+  if (compile_file && n > 1) {
+    const char *arg = NULL;
+    if (!g_code_filename_arg.empty() && g_code_filename_arg[0] != '.') arg = "-o";
+    else if (!g_header_filename_arg.empty() && g_header_filename_arg[0] != '.') arg = "-h";
+    if (arg) {
+      fprintf(stderr, "%s <name> must be an extension starting with '.' when compiling more than one file\n", arg);
+      for (int i = 0; i < n; i++)
+        free(files[i]);
+      free(files);
+      return 1;
+    }
+  }
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  int jobs = (batch_jobs < n) ? batch_jobs : n;
+  if (jobs > 1) {
+    pid_t *pids = (pid_t*)calloc(jobs, sizeof(pid_t));
+    fflush(stdout);
+    fflush(stderr);
+    for (int j = 0; j < jobs; j++) {
+      pid_t pid = fork();
+      if (pid == 0) {
+        int err = 0;
+        for (int i = j; i < n; i += jobs)
+          if (batch_process_file(files[i]))
+            err = 1;
+        fflush(stdout);
+        fflush(stderr);
+        _exit(err);
+      }
+      if (pid < 0) {
+        // could not create a worker, compile the remaining files in this process
+        for (int i = j; i < n; i += jobs)
+          if (batch_process_file(files[i]))
+            ret = 1;
+      }
+      pids[j] = pid;
+    }
+    for (int j = 0; j < jobs; j++) {
+      int status = 0;
+      if (pids[j] <= 0) continue;
+      if (waitpid(pids[j], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        ret = 1;
+    }
+    free(pids);
+  } else
+#endif
+  {
+    for (int i = 0; i < n; i++)
+      if (batch_process_file(files[i]))
+        ret = 1;
+  }
+
+  for (int i = 0; i < n; i++)
+    free(files[i]);
+  free(files);
+  return ret;
+}
+
 #if ! (defined(_WIN32) && !defined (__CYGWIN__))
 
 int quit_flag = 0;
@@ -1982,16 +2244,20 @@ int main(int argc,char **argv) {
   setlocale(LC_NUMERIC, "C"); // make sure numeric values are written correctly
 
   if (   (Fl::args(argc,argv,i,arg) == 0)   // unsupported argument found
-      || (batch_mode && (i != argc-1))      // .fl filename missing
+      || (batch_mode && (i == argc))        // .fl filename missing
+      || (batch_mode && (i < argc-1) && !compile_file && !update_file)
       || (!batch_mode && (i < argc-1)) ) {  // more than one filename found
     static const char *msg =
-      "usage: %s <switches> name.fl\n"
+      "usage: %s <switches> name.fl [name.fl ...] [@list]\n"
       " -u : update .fl file and exit (may be combined with '-c' or '-cs')\n"
       " -c : write .cxx and .h and exit\n"
       " -cs : write .cxx and .h and strings and exit\n"
       " -o <name> : .cxx output filename, or extension if <name> starts with '.'\n"
       " -h <name> : .h output filename, or extension if <name> starts with '.'\n"
-      " -d : enable internal debugging\n";
+      " -j <n> : compile multiple .fl files with n parallel workers\n"
+      " -stamp : write a stamp into the .cxx file and skip files that are unchanged\n"
+      " -d : enable internal debugging\n"
+      " @list : read the names of .fl files from the file 'list'\n";
     const char *app_name = NULL;
     if ( (argc > 0) && argv[0] && argv[0][0] )
       app_name = fl_filename_name(argv[0]);
@@ -2011,6 +2277,9 @@ int main(int argc,char **argv) {
 
   make_main_window();
 
+  if (batch_mode && (compile_file || update_file))
+    exit(batch_main(argc-i, argv+i));
+
   if (c) set_filename(c);
   if (!batch_mode) {
 #ifdef __APPLE__
@@ -2048,18 +2317,6 @@ int main(int argc,char **argv) {
     P.header_file_name = g_header_filename_arg;
   }
 
-  if (update_file) {            // fluid -u
-    write_file(c,0);
-    if (!compile_file)
-      exit(0);
-  }
-
-  if (compile_file) {           // fluid -c[s]
-    if (compile_strings)
-      write_strings_cb(0,0);
-    write_cb(0,0);
-    exit(0);
-  }
   set_modflag(0);
   undo_clear();
 #ifndef _WIN32
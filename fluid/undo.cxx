@@ -15,6 +15,7 @@
 //
 
 #include "undo.h"
+#include "undo_store.h"
 
 #include "fluid.h"
 #include "file.h"
@@ -26,52 +27,70 @@
 #include <FL/Fl_Window.H>
 #include <FL/Fl_Preferences.H>
 #include <FL/Fl_Menu_Bar.H>
-#include <FL/filename.H>
 #include "../src/flstring.h"
 
-#if defined(_WIN32) && !defined(__CYGWIN__)
-#  include <io.h>
-#  include <windows.h>
-#  define getpid (int)GetCurrentProcessId
-#else
-#  include <unistd.h>
-#endif // _WIN32 && !__CYGWIN__
+#include <stdlib.h>
 
 
 //
-// This file implements an undo system using temporary files; ideally
-// we'd like to do this in memory, however the current data structures
-// and design aren't well-suited...  Instead, we save and restore
-// checkpoint files.
+// This file implements an undo system that keeps checkpoints in memory.
+//
+// Every checkpoint is the complete design as it would be written to a .fl
+// file, stored as a delta against the previous checkpoint by Fd_Undo_Store.
+// Since most edits change a single node, the delta is typically a few
+// hundred bytes. Writing a checkpoint still serializes the whole design, and
+// undo and redo still rebuild the whole Fl_Type tree from the stored text.
+//
+// The total memory used by all levels is limited by undo_memory_limit.
+// When the limit is exceeded, the oldest levels are discarded.
 //
 
 extern Fl_Window* the_panel;
 
 int undo_current = 0;                   // Current undo level in buffer
 int undo_last = 0;                      // Last undo level in buffer
-int undo_max = 0;                       // Maximum undo level used
 int undo_save = -1;                     // Last undo level that was saved
+static int undo_memory_limit = -1;      // Memory limit in bytes, -1 = read from preferences
 static int undo_paused = 0;             // Undo checkpointing paused?
+static Fd_Undo_Store undo_levels;       // Texts of all undo levels
 
 
-// Return the undo filename.
-// The filename is constructed in a static internal buffer and
-// this buffer is overwritten by every call of this function.
-// The return value is a pointer to this internal string.
-static char *undo_filename(int level) {
-  static char undo_path[FL_PATH_MAX] = ""; // Undo path
-  static unsigned int undo_path_len = 0;   // length w/o filename
+// Return the memory limit for all undo levels in bytes.
+static long undo_get_memory_limit() {
+  if (undo_memory_limit < 0) {
+    int mb;
+    fluid_prefs.get("undo_memory_limit_mb", mb, 64);
+    if (mb < 1) mb = 1;
+    if (mb > 2047) mb = 2047;
+    undo_memory_limit = mb * 1024 * 1024;
+  }
+  return undo_memory_limit;
+}
 
-  if (!undo_path_len) {
-    fluid_prefs.getUserdataPath(undo_path, sizeof(undo_path));
-    undo_path_len = (unsigned int)strlen(undo_path);
+// Store the current design as the given undo level.
+// All levels after the given level are discarded.
+static int undo_store(int level) {
+  char *text;
+  int size;
+  if (!write_file_to_memory(text, size)) return 0;
+  undo_levels.store(level, text, size);
+
+  while (undo_levels.memory_used() > undo_get_memory_limit() &&
+         undo_levels.count() > 2 && undo_current > 0) {
+    undo_levels.drop_oldest();
+    undo_current--;
+    undo_last--;
+    if (undo_save >= 0) undo_save--;
   }
+  return 1;
+}
 
-  // append filename: "undo_PID_LEVEL.fl"
-  snprintf(undo_path + undo_path_len,
-           sizeof(undo_path) - undo_path_len - 1,
-           "undo_%d_%d.fl", getpid(), level);
-  return undo_path;
+// Replace the current design with the given undo level.
+static int undo_load(int level) {
+  int size;
+  const char *text = undo_levels.text(level, size);
+  if (!text) return 0;
+  return read_file_from_memory(text, size, 0);
 }
 
 
@@ -85,7 +104,7 @@ void redo_cb(Fl_Widget *, void *) {
   undo_suspend();
   if (widget_browser) widget_browser->save_scroll_position();
   int reload_panel = (the_panel && the_panel->visible());
-  if (!read_file(undo_filename(undo_current + 1), 0)) {
+  if (!undo_load(undo_current + 1)) {
     // Unable to read checkpoint file, don't redo...
     widget_browser->rebuild();
     undo_resume();
@@ -118,7 +137,7 @@ void undo_cb(Fl_Widget *, void *) {
   if (undo_current <= 0) return;
 
   if (undo_current == undo_last) {
-    write_file(undo_filename(undo_current));
+    undo_store(undo_current);
   }
 
   undo_suspend();
@@ -126,7 +145,7 @@ void undo_cb(Fl_Widget *, void *) {
   // Save the current scroll position, so we don't scroll back to 0 at undo.
   if (widget_browser) widget_browser->save_scroll_position();
   int reload_panel = (the_panel && the_panel->visible());
-  if (!read_file(undo_filename(undo_current - 1), 0)) {
+  if (!undo_load(undo_current - 1)) {
     // Unable to read checkpoint file, don't undo...
     widget_browser->rebuild();
     undo_resume();
@@ -164,11 +183,9 @@ void undo_checkpoint() {
   // Don't checkpoint if undo_suspend() has been called...
   if (undo_paused) return;
 
-  // Save the current UI to a checkpoint file...
-  const char *filename = undo_filename(undo_current);
-  if (!write_file(filename)) {
-    // Don't attempt to do undo stuff if we can't write a checkpoint file...
-    perror(filename);
+  // Save the current UI to a checkpoint...
+  if (!undo_store(undo_current)) {
+    // Don't attempt to do undo stuff if we can't write a checkpoint...
     return;
   }
 
@@ -179,7 +196,6 @@ void undo_checkpoint() {
   // Update the current undo level...
   undo_current ++;
   undo_last = undo_current;
-  if (undo_current > undo_max) undo_max = undo_current;
 
   // Enable the Undo and disable the Redo menu items...
   Main_Menu[undo_item].activate();
@@ -190,13 +206,11 @@ void undo_checkpoint() {
 void undo_clear() {
   int undo_item = main_menubar->find_index(undo_cb);
   int redo_item = main_menubar->find_index(redo_cb);
-  // Remove old checkpoint files...
-  for (int i = 0; i <= undo_max; i ++) {
-    fl_unlink(undo_filename(i));
-  }
+  // Release all checkpoints...
+  undo_levels.truncate(0);
 
   // Reset current, last, and save indices...
-  undo_current = undo_last = undo_max = 0;
+  undo_current = undo_last = 0;
   if (modflag) undo_save = -1;
   else undo_save = 0;
 
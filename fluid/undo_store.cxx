@@ -0,0 +1,182 @@
+//
+// FLUID undo level storage for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "undo_store.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// A single undo level, stored as a delta against the previous level.
+struct Fd_Undo_Store::Level {
+  char *data;                           // bytes that differ from the previous level
+  int data_size;                        // number of bytes in data
+  int prefix;                           // bytes shared with the start of the previous level
+  int suffix;                           // bytes shared with the end of the previous level
+  int size;                             // total size of this level
+  char keyframe;                        // if set, data is a full copy
+};
+
+Fd_Undo_Store::Fd_Undo_Store() :
+  levels_(0),
+  count_(0),
+  alloc_(0),
+  memory_used_(0),
+  cache_(0),
+  cache_size_(0),
+  cache_level_(-1)
+{
+}
+
+Fd_Undo_Store::~Fd_Undo_Store() {
+  truncate(0);
+  free(levels_);
+}
+
+// Set the cache to the given text and take ownership of it.
+void Fd_Undo_Store::set_cache(int level, char *text, int size) {
+  if (cache_ != text) free(cache_);
+  cache_ = text;
+  cache_size_ = size;
+  cache_level_ = level;
+}
+
+/**
+ Returns the number of deltas that are applied to the last full copy
+ to rebuild the given level.
+ */
+int Fd_Undo_Store::chain_length(int level) const {
+  int n = 0;
+  while (level > 0 && !levels_[level].keyframe) {
+    level--;
+    n++;
+  }
+  return n;
+}
+
+// Rebuild the full text of an undo level and store it in the cache.
+// Returns 0 if the level does not exist.
+int Fd_Undo_Store::rebuild(int level) {
+  if (level < 0 || level >= count_) return 0;
+  if (level == cache_level_) return 1;
+
+  // Find the start of the chain of deltas
+  int first = level - chain_length(level);
+  if (cache_level_ >= first && cache_level_ < level)
+    first = cache_level_ + 1;
+  else {
+    Level &k = levels_[first];
+    char *text = (char*)malloc(k.size + 1);
+    memcpy(text, k.data, k.size);
+    text[k.size] = 0;
+    set_cache(first, text, k.size);
+    first++;
+  }
+
+  // Apply the deltas
+  for (int i = first; i <= level; i++) {
+    Level &u = levels_[i];
+    char *text = (char*)malloc(u.size + 1);
+    memcpy(text, cache_, u.prefix);
+    memcpy(text + u.prefix, u.data, u.data_size);
+    memcpy(text + u.prefix + u.data_size, cache_ + cache_size_ - u.suffix, u.suffix);
+    text[u.size] = 0;
+    set_cache(i, text, u.size);
+  }
+  return 1;
+}
+
+/**
+ Stores a text as the given undo level, discarding all later levels.
+ The store takes ownership of \p text, which must be allocated with malloc()
+ and hold \p size bytes plus a terminating nul byte.
+ */
+void Fd_Undo_Store::store(int level, char *text, int size) {
+  if (level < 0) level = 0;
+  if (level > count_) level = count_;
+  truncate(level);
+  if (count_ >= alloc_) {
+    alloc_ = alloc_ ? 2 * alloc_ : 32;
+    levels_ = (Level*)realloc(levels_, alloc_ * sizeof(Level));
+  }
+  Level &u = levels_[level];
+  u.size = size;
+  u.prefix = u.suffix = 0;
+  u.keyframe = 1;
+  if (level > 0 && chain_length(level - 1) + 1 < UNDO_KEYFRAME_INTERVAL && rebuild(level - 1)) {
+    // Find the range that differs from the previous level
+    int n = cache_size_ < size ? cache_size_ : size;
+    while (u.prefix < n && cache_[u.prefix] == text[u.prefix]) u.prefix++;
+    n -= u.prefix;
+    while (u.suffix < n && cache_[cache_size_ - u.suffix - 1] == text[size - u.suffix - 1]) u.suffix++;
+    u.keyframe = 0;
+  }
+  u.data_size = size - u.prefix - u.suffix;
+  u.data = (char*)malloc(u.data_size > 0 ? u.data_size : 1);
+  memcpy(u.data, text + u.prefix, u.data_size);
+  count_ = level + 1;
+  memory_used_ += u.data_size;
+  set_cache(level, text, size);
+}
+
+/**
+ Returns the nul terminated text of an undo level and its size, or NULL if
+ the level does not exist. The text is valid until the store is changed or
+ another level is requested.
+ */
+const char *Fd_Undo_Store::text(int level, int &size) {
+  if (!rebuild(level)) return 0;
+  size = cache_size_;
+  return cache_;
+}
+
+/**
+ Releases the memory used by all levels starting at the given level.
+ */
+void Fd_Undo_Store::truncate(int level) {
+  if (level < 0) level = 0;
+  for (int i = level; i < count_; i++) {
+    memory_used_ -= levels_[i].data_size;
+    free(levels_[i].data);
+  }
+  if (level < count_) count_ = level;
+  if (cache_level_ >= level) set_cache(-1, 0, 0);
+}
+
+/**
+ Removes the oldest undo level to free memory. All other levels move
+ down by one. The oldest remaining level becomes a full copy, so the
+ following levels are again at most UNDO_KEYFRAME_INTERVAL-1 deltas away
+ from a full copy.
+ */
+void Fd_Undo_Store::drop_oldest() {
+  if (count_ < 2) return;
+  if (!levels_[1].keyframe) {
+    rebuild(1);
+    Level &u = levels_[1];
+    memory_used_ += cache_size_ - u.data_size;
+    free(u.data);
+    u.data = (char*)malloc(cache_size_ > 0 ? cache_size_ : 1);
+    memcpy(u.data, cache_, cache_size_);
+    u.data_size = u.size = cache_size_;
+    u.prefix = u.suffix = 0;
+    u.keyframe = 1;
+  }
+  memory_used_ -= levels_[0].data_size;
+  free(levels_[0].data);
+  memmove(levels_, levels_ + 1, (count_ - 1) * sizeof(Level));
+  count_--;
+  if (cache_level_ >= 0) cache_level_--;
+}
@@ -0,0 +1,61 @@
+//
+// FLUID undo level storage for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#ifndef undo_store_h
+#define undo_store_h
+
+#define UNDO_KEYFRAME_INTERVAL 16       // Store a full copy every n levels
+
+/**
+ Stores the texts of all undo levels in memory.
+
+ Every level is the complete design as it would be written to a .fl file.
+ To keep memory usage low, a level is usually stored as a delta against the
+ previous level: the bytes at the start and at the end that did not change
+ are shared, and only the modified range in between is kept. At most
+ UNDO_KEYFRAME_INTERVAL-1 deltas follow a full copy, so that restoring a
+ level never needs to apply more than a few deltas, also after the oldest
+ levels were dropped.
+
+ This class does not depend on the rest of FLUID, see undo.cxx for the
+ undo and redo commands.
+ */
+class Fd_Undo_Store {
+  struct Level;
+  Level *levels_;                       // Array of undo levels
+  int count_;                           // Number of valid levels
+  int alloc_;                           // Allocated size of the array
+  long memory_used_;                    // Memory used by all levels
+  char *cache_;                         // Full text of level cache_level_
+  int cache_size_;
+  int cache_level_;
+  void set_cache(int level, char *text, int size);
+  int rebuild(int level);
+public:
+  Fd_Undo_Store();
+  ~Fd_Undo_Store();
+  void store(int level, char *text, int size);
+  const char *text(int level, int &size);
+  void truncate(int level);
+  void drop_oldest();
+  int chain_length(int level) const;
+  /** Returns the number of stored levels. */
+  int count() const { return count_; }
+  /** Returns the memory used by all levels in bytes, without the cache. */
+  long memory_used() const { return memory_used_; }
+};
+
+#endif // !undo_store_h
@@ -23,9 +23,11 @@
 #include "Fl_Screen_Driver.H"
 #include "Fl_Window_Driver.H"
 #include "Fl_System_Driver.H"
+#include "Fl_Shortcut_Registry.H"
 #include "Fl_Timeout.h"
 #include <FL/Fl_Window.H>
 #include <FL/Fl_Tooltip.H>
+#include <FL/Fl_Trace.H>
 #include <FL/fl_draw.H>
 
 #include <ctype.h>
@@ -61,7 +63,8 @@ int             Fl::damage_,
                 Fl::e_keysym,
                 Fl::e_original_keysym,
                 Fl::scrollbar_size_ = 16,
-                Fl::menu_linespacing_ = 4;      // 4: was a local macro in Fl_Menu.cxx called "LEADING"
+                Fl::menu_linespacing_ = 4,      // 4: was a local macro in Fl_Menu.cxx called "LEADING"
+                Fl::menu_lazy_items_ = 0;       // 0: all menus are measured completely
 
 char            *Fl::e_text = (char *)"";
 int             Fl::e_length;
@@ -176,6 +179,40 @@ void Fl::menu_linespacing(int H) {
   menu_linespacing_ = H;
 }
 
+/**
+  Gets the number of items above which popup menus are measured lazily.
+  \returns The number of items, 0 if all menus are measured completely.
+  \see menu_lazy_items(int)
+  \version 1.4.0
+*/
+int Fl::menu_lazy_items() {
+  return menu_lazy_items_;
+}
+
+/**
+  Sets the number of items above which popup menus are measured lazily.
+
+  Before a popup menu is shown, the labels of all its items are measured
+  to find the size of the menu. If a menu (or submenu) has more than
+  \p n items, only the items that can be visible on the screen when the
+  menu pops up are measured, and all items are assumed to be as high as
+  these. Labels of other items that are wider are clipped.
+
+  Such menus also support type-ahead filtering: typing text that is not
+  the shortcut of an item shows only the items whose labels contain the
+  typed text, ignoring case. BackSpace removes the last typed character.
+  Once typing has started, Space is part of the typed text and does not
+  pick the selected item.
+
+  Default is 0, which turns lazy measuring and type-ahead filtering off.
+  A value of a few hundred suits applications with very large menus.
+  \param[in] n The new number of items, 0 to measure all menus completely.
+  \version 1.4.0
+*/
+void Fl::menu_lazy_items(int n) {
+  menu_lazy_items_ = n;
+}
+
 
 /** Returns whether or not the mouse event is inside the given rectangle.
 
@@ -732,27 +769,136 @@ void Fl::redraw() {
   for (Fl_X* i = Fl_X::first; i; i = i->next) i->w->redraw();
 }
 
+////////////////////////////////////////////////////////////////
+// Frame pacing:
+// With a frame rate limit a damaged window is redrawn at most once per
+// frame interval. Damage arriving in between accumulates in the window
+// as usual and a timeout wakes up the event loop when the next frame is
+// due, so any number of redraw() calls collapse into one draw().
+// Fl::damage() is not kept set meanwhile because some platforms poll
+// without waiting while it is.
+
+static double max_fps_ = 0;             // application-wide limit, 0 = none
+static int flush_forced_ = 0;           // set by Fl::flush_now()
+static int frame_due_ = 0;              // a postponed frame must be drawn
+static unsigned long frames_flushed_ = 0;
+static unsigned long frames_coalesced_ = 0;
+
+// Wakes up the event loop so the next Fl::flush() draws the postponed frame.
+static void frame_timeout_cb(void *) {
+  frame_due_ = 1;
+}
+
+/**
+  Sets the maximum number of times per second Fl::flush() redraws a window.
+
+  By default (0) a window is redrawn as soon as the event loop flushes after
+  it was damaged. Applications that redraw much more often than the display
+  can show, for instance in response to a fast stream of mouse motion events
+  or from a timer, can set a limit so that all damage collected during one
+  frame interval is drawn at once. The interval is measured with a monotonic
+  clock; under Wayland a window is also not redrawn while the compositor has
+  not yet presented its previous frame.
+
+  Fl_Window::max_fps(double) overrides this for individual windows, and
+  Fl::flush_now() bypasses the limit for one flush.
+
+  \param[in] fps  maximum frames per second, 0 or less for no limit
+
+  \see frame_statistics()
+*/
+void Fl::max_fps(double fps) {
+  max_fps_ = fps > 0 ? fps : 0;
+}
+
+/**
+  Returns the application-wide frame rate limit set by max_fps(double).
+*/
+double Fl::max_fps() {
+  return max_fps_;
+}
+
+/**
+  Redraws all damaged windows immediately, ignoring any frame rate limit.
+
+  This is the same as Fl::flush() when no limit is set with max_fps(double)
+  or Fl_Window::max_fps(double). Use it when the display must not lag behind,
+  for instance to echo user input while the rest of the application is paced.
+*/
+void Fl::flush_now() {
+  flush_forced_++;
+  flush();
+  flush_forced_--;
+}
+
+/**
+  Returns frame pacing statistics since the program start or the last
+  reset_frame_statistics().
+
+  \param[out] flushed    number of window redraws done by Fl::flush()
+  \param[out] coalesced  number of times Fl::flush() postponed the redraw
+                         of a damaged window to a later frame
+*/
+void Fl::frame_statistics(unsigned long &flushed, unsigned long &coalesced) {
+  flushed = frames_flushed_;
+  coalesced = frames_coalesced_;
+}
+
+/**
+  Resets the counters returned by frame_statistics().
+*/
+void Fl::reset_frame_statistics() {
+  frames_flushed_ = frames_coalesced_ = 0;
+}
+
 /**
   Causes all the windows that need it to be redrawn and graphics forced
   out through the pipes.
 
   This is what wait() does before looking for events.
 
+  If a frame rate limit is set with max_fps(double) or Fl_Window::max_fps(double),
+  windows redrawn less than a frame interval ago keep their damage until
+  the next frame is due. Use flush_now() to redraw them regardless.
+
   Note: in multi-threaded applications you should only call Fl::flush()
   from the main thread. If a child thread needs to trigger a redraw event,
   it should instead call Fl::awake() to get the main thread to process the
   event queue.
 */
 void Fl::flush() {
-  if (damage()) {
+  double trace_start = Fl_Trace::start();
+  if (damage() || frame_due_) {
     damage_ = 0;
+    frame_due_ = 0;
+    double now = -1, next_frame = 0;
     for (Fl_X* i = Fl_X::first; i; i = i->next) {
       Fl_Window* wi = i->w;
-      if (Fl_Window_Driver::driver(wi)->wait_for_expose_value) {damage_ = 1; continue;}
+      Fl_Window_Driver *dr = Fl_Window_Driver::driver(wi);
+      if (dr->wait_for_expose_value) {damage_ = 1; continue;}
       if (!wi->visible_r()) continue;
       if (wi->damage()) {
-        Fl_Window_Driver::driver(wi)->flush();
+        double fps = dr->max_fps_ < 0 ? max_fps_ : dr->max_fps_;
+        if (fps > 0 && !flush_forced_) {
+          if (now < 0) now = system_driver()->monotonic_time();
+          double delay = dr->last_frame_ + 1 / fps - now;
+          if (delay > 0 || dr->frame_pending()) {
+            // keep the damage (and region) for the next frame
+            frames_coalesced_++;
+            if (delay > 0) {
+              if (!next_frame || delay < next_frame) next_frame = delay;
+            } else {
+              damage_ = 1; // retried when the compositor's frame event wakes us up
+            }
+            continue;
+          }
+          dr->last_frame_ = now;
+        }
+        double draw_start = Fl_Trace::start();
+        dr->flush();
+        if (draw_start) Fl_Trace::add(Fl_Trace::WINDOW_DRAW, draw_start, wi->label());
         wi->clear_damage();
+        frames_flushed_++;
       }
       // destroy damage regions for windows that don't use them:
       if (i->region) {
@@ -760,8 +906,13 @@ void Fl::flush() {
         i->region = 0;
       }
     }
+    if (next_frame > 0) {
+      Fl::remove_timeout(frame_timeout_cb);
+      Fl::add_timeout(next_frame, frame_timeout_cb);
+    }
   }
   screen_driver()->flush();
+  if (trace_start) Fl_Trace::add(Fl_Trace::FLUSH, trace_start);
 }
 
 
@@ -1243,11 +1394,15 @@ Fl_Event_Dispatch Fl::event_dispatch()
  */
 int Fl::handle(int e, Fl_Window* window)
 {
+  double trace_start = Fl_Trace::start();
+  int ret;
   if (e_dispatch) {
-    return e_dispatch(e, window);
+    ret = e_dispatch(e, window);
   } else {
-    return handle_(e, window);
+    ret = handle_(e, window);
   }
+  if (trace_start) Fl_Trace::add(Fl_Trace::EVENT, trace_start, NULL, e);
+  return ret;
 }
 
 
@@ -1406,8 +1561,16 @@ int Fl::handle_(int e, Fl_Window* window)
   case FL_SHORTCUT:
     if (grab()) {wi = grab(); break;} // send it to grab window
 
-    // Try it as shortcut, sending to mouse widget and all parents:
+    // If only one widget in the windows that get the shortcut registered
+    // it, try that widget before asking all widgets:
     wi = find_active(belowmouse()); // STR #3216
+    {
+      Fl_Window *top = wi ? wi->top_window() : (modal() ? modal() : window);
+      Fl_Widget *sc = Fl_Shortcut_Registry::find(top, wi ? first_window() : top);
+      if (sc && send_event(FL_SHORTCUT, sc, sc->window())) return 1;
+    }
+
+    // Try it as shortcut, sending to mouse widget and all parents:
     if (!wi) {
       wi = modal();
       if (!wi) wi = window;
@@ -0,0 +1,524 @@
+//
+// Animated GIF image code for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <FL/Fl.H>
+#include <FL/Fl_Anim_GIF_Image.H>
+#include <FL/Fl_Widget.H>
+#include <FL/fl_utf8.h>
+#include <FL/fl_string_functions.h>
+#include "Fl_Image_Reader.h"
+#include "Fl_System_Driver.H"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// in Fl_GIF_Image.cxx
+extern void fl_gif_lzw_decode(Fl_Image_Reader &rdr, int CodeSize, int ColorMapSize,
+                              uchar *Image, int Width, int Height, char Interlace,
+                              short *Prefix, uchar *Suffix);
+
+// Position and attributes of one frame in the GIF data
+struct Fl_Anim_GIF_Frame {
+  long data;                    // offset of the LZW Minimum Code Size byte
+  long palette;                 // offset of the color table
+  int palette_size;             // number of colors, 0 if there is no color table
+  int x, y, w, h;
+  int delay;                    // in 1/100 seconds
+  int transparent;              // transparent color index, or -1
+  uchar dispose;                // disposal method
+  char interlace;
+};
+
+static Fl_Anim_GIF_Image *playing_ = 0; // all playing animations
+
+static double now() {
+  return Fl::system_driver()->monotonic_time();
+}
+
+void Fl_Anim_GIF_Image::init_() {
+  name_ = 0;
+  gif_ = 0;
+  gif_size_ = 0;
+  frames_ = 0;
+  frame_count_ = 0;
+  loop_count_ = 1;
+  loops_ = 0;
+  frame_ = 0;
+  canvas_ = 0;
+  work_ = before_ = indexes_ = 0;
+  work_frame_ = -1;
+  prefix_ = 0;
+  suffix_ = 0;
+  cache_size_ = 4;
+  cache_ = (Fl_RGB_Image **)calloc(cache_size_, sizeof(Fl_RGB_Image *));
+  cache_frame_ = (int *)calloc(cache_size_, sizeof(int));
+  cache_next_ = 0;
+  due_ = 0;
+  next_playing_ = 0;
+  average_color_ = FL_BLACK;
+  average_weight_ = -1;
+  desaturated_ = 0;
+}
+
+/**
+  This constructor loads an animated GIF image from the given file.
+
+  Only the position of each frame is found when loading, the frames are
+  decoded when they are drawn. Use Fl_Image::fail() to check if loading
+  failed, as for Fl_GIF_Image. A GIF image that is not animated is shown
+  as an animation with a single frame.
+
+  \param[in] filename a full path and name pointing to a GIF image file.
+*/
+Fl_Anim_GIF_Image::Fl_Anim_GIF_Image(const char *filename) : Fl_Image(0, 0, 0) {
+  init_();
+  FILE *f = fl_fopen(filename, "rb");
+  long size = -1;
+  if (f && !fseek(f, 0, SEEK_END)) size = ftell(f);
+  if (size > 0) {
+    gif_ = new uchar[size];
+    rewind(f);
+    if (fread(gif_, 1, size, f) != (size_t)size) size = -1;
+  }
+  if (f) fclose(f);
+  if (size <= 0) {
+    Fl::error("Fl_Anim_GIF_Image: Unable to open %s!", filename);
+    ld(ERR_FILE_ACCESS);
+    return;
+  }
+  gif_size_ = size;
+  name_ = fl_strdup(filename);
+  parse_();
+}
+
+/**
+  This constructor loads an animated GIF image from memory.
+  The data is copied, it need not stay valid.
+
+  \param[in] imagename  A name given to this image or NULL
+  \param[in] data       Pointer to the start of the GIF image in memory.
+  \param[in] length     Length of the GIF image in memory.
+*/
+Fl_Anim_GIF_Image::Fl_Anim_GIF_Image(const char *imagename, const unsigned char *data,
+                                     const size_t length) : Fl_Image(0, 0, 0) {
+  init_();
+  if (!data || !length) {
+    ld(ERR_FILE_ACCESS);
+    return;
+  }
+  gif_ = new uchar[length];
+  memcpy(gif_, data, length);
+  gif_size_ = length;
+  if (imagename) name_ = fl_strdup(imagename);
+  parse_();
+}
+
+/** Stops the animation and frees all memory used by the image. */
+Fl_Anim_GIF_Image::~Fl_Anim_GIF_Image() {
+  stop();
+  canvas(0);
+  clear_cache_();
+  free(cache_);
+  free(cache_frame_);
+  free(frames_);
+  free(name_);
+  delete[] gif_;
+  delete[] work_;
+  delete[] before_;
+  delete[] indexes_;
+  delete[] prefix_;
+  delete[] suffix_;
+}
+
+// Skips data sub-blocks, blocklen is the size of the first one
+static void skip_blocks(Fl_Image_Reader &rdr, int blocklen) {
+  while (blocklen > 0 && !rdr.error()) {
+    rdr.skip(blocklen);
+    blocklen = rdr.read_byte();
+  }
+}
+
+// Finds the position and attributes of all frames
+void Fl_Anim_GIF_Image::parse_() {
+  Fl_Image_Reader rdr;
+  rdr.open(name_, gif_, gif_size_);
+  char b[6];
+  for (int i = 0; i < 6; i++) b[i] = rdr.read_byte();
+  if (b[0] != 'G' || b[1] != 'I' || b[2] != 'F') {
+    Fl::error("Fl_Anim_GIF_Image: %s is not a GIF file.\n", rdr.name());
+    ld(ERR_FORMAT);
+    return;
+  }
+  int Width = rdr.read_word();
+  int Height = rdr.read_word();
+  uchar ch = rdr.read_byte();
+  rdr.read_byte(); // Background Color index
+  rdr.read_byte(); // Aspect ratio
+  long palette = 0;
+  int palette_size = 0;
+  if (ch & 0x80) {
+    palette = rdr.tell();
+    palette_size = 2 << (ch & 7);
+    rdr.skip(3 * palette_size);
+  }
+  int delay = 0, dispose = 0, transparent = -1; // from the Graphic Control Extension
+  int alloc = 0, max_pixels = 0;
+  while (!rdr.error()) {
+    int i = rdr.read_byte();
+    if (rdr.error() || i == 0x3b) break; // Trailer
+    if (i == 0x21) { // extension
+      int type = rdr.read_byte();
+      int blocklen = rdr.read_byte();
+      if (type == 0xf9 && blocklen == 4) { // Graphic Control Extension
+        uchar bits = rdr.read_byte();
+        delay = rdr.read_word();
+        int t = rdr.read_byte();
+        dispose = (bits >> 2) & 7;
+        transparent = (bits & 1) ? t : -1;
+        blocklen = rdr.read_byte();
+      } else if (type == 0xff && blocklen == 11) { // Application Extension
+        char app[11];
+        for (int k = 0; k < 11; k++) app[k] = rdr.read_byte();
+        blocklen = rdr.read_byte();
+        if (!memcmp(app, "NETSCAPE2.0", 11) && blocklen == 3 && rdr.read_byte() == 1) {
+          int repeat = rdr.read_word();
+          loop_count_ = repeat ? repeat + 1 : 0;
+          blocklen = rdr.read_byte();
+        }
+      }
+      skip_blocks(rdr, blocklen);
+    } else if (i == 0x2c) { // Image Descriptor
+      Fl_Anim_GIF_Frame f;
+      f.x = rdr.read_word();
+      f.y = rdr.read_word();
+      f.w = rdr.read_word();
+      f.h = rdr.read_word();
+      ch = rdr.read_byte();
+      f.interlace = (ch & 0x40) != 0;
+      f.palette = palette;
+      f.palette_size = palette_size;
+      if (ch & 0x80) { // Local Color Table
+        f.palette = rdr.tell();
+        f.palette_size = 2 << (ch & 7);
+        rdr.skip(3 * f.palette_size);
+      }
+      f.data = rdr.tell();
+      f.delay = delay;
+      f.dispose = (uchar)dispose;
+      f.transparent = transparent;
+      rdr.read_byte(); // LZW Minimum Code Size
+      skip_blocks(rdr, rdr.read_byte());
+      if (rdr.error()) break;
+      if (frame_count_ >= alloc) {
+        alloc = alloc ? 2 * alloc : 16;
+        frames_ = (Fl_Anim_GIF_Frame *)realloc(frames_, alloc * sizeof(Fl_Anim_GIF_Frame));
+      }
+      frames_[frame_count_++] = f;
+      if (f.w * f.h > max_pixels) max_pixels = f.w * f.h;
+      delay = dispose = 0; // the extension applies to one image only
+      transparent = -1;
+    } else {
+      Fl::error("%s: unknown GIF code 0x%02x at offset %ld", rdr.name(), i, rdr.tell() - 1);
+      break;
+    }
+  }
+  if (!frame_count_) {
+    Fl::error("%s: no image data found.", rdr.name());
+    ld(ERR_NO_IMAGE);
+    return;
+  }
+  // frames after a read error are dropped, the others can still be shown
+  w(Width);
+  h(Height);
+  d(4);
+  indexes_ = new uchar[max_pixels > 0 ? max_pixels : 1];
+}
+
+/**
+  Returns the delay before frame \p n + 1 is shown, in seconds.
+  Like web browsers, delays shorter than 0.02 s are replaced by 0.1 s.
+*/
+double Fl_Anim_GIF_Image::delay(int n) const {
+  if (n < 0 || n >= frame_count_) return 0.0;
+  int d = frames_[n].delay;
+  if (d < 2) d = 10;
+  return d / 100.0;
+}
+
+// Composites frame work_frame_ + 1 in work_, after the disposal of work_frame_
+void Fl_Anim_GIF_Image::decode_next_() {
+  int W = data_w(), H = data_h(), line = W * 4;
+  if (!work_) {
+    work_ = new uchar[W * H * 4];
+    prefix_ = new short[4096];
+    suffix_ = new uchar[4096];
+  }
+  if (work_frame_ < 0 || work_frame_ >= frame_count_ - 1) {
+    memset(work_, 0, W * H * 4);
+    work_frame_ = -1;
+  } else {
+    const Fl_Anim_GIF_Frame &p = frames_[work_frame_];
+    int x0 = p.x, y0 = p.y, x1 = p.x + p.w, y1 = p.y + p.h;
+    if (x1 > W) x1 = W;
+    if (y1 > H) y1 = H;
+    for (int y = y0; y < y1 && x0 < x1; y++) {
+      uchar *row = work_ + y * line + x0 * 4;
+      if (p.dispose == 2)       // restore to background, which is transparent
+        memset(row, 0, (x1 - x0) * 4);
+      else if (p.dispose == 3)  // restore to previous
+        memcpy(row, before_ + (y - y0) * (x1 - x0) * 4, (x1 - x0) * 4);
+    }
+  }
+  const Fl_Anim_GIF_Frame &f = frames_[++work_frame_];
+  int x0 = f.x, y0 = f.y, x1 = f.x + f.w, y1 = f.y + f.h;
+  if (x1 > W) x1 = W;
+  if (y1 > H) y1 = H;
+  if (x0 >= x1 || y0 >= y1) return;
+  if (f.dispose == 3) {
+    if (!before_) before_ = new uchar[W * H * 4];
+    for (int y = y0; y < y1; y++)
+      memcpy(before_ + (y - y0) * (x1 - x0) * 4, work_ + y * line + x0 * 4, (x1 - x0) * 4);
+  }
+
+  Fl_Image_Reader rdr;
+  rdr.open(name_, gif_, gif_size_);
+  rdr.seek((unsigned)f.data);
+  int CodeSize = rdr.read_byte() + 1;
+  if (rdr.error() || CodeSize < 2 || CodeSize > 12) return;
+
+  // the color table and the number of colors, fixed up like in Fl_GIF_Image
+  uchar palette[256][3];
+  memset(palette, 0, sizeof(palette));
+  int ColorMapSize = f.palette_size;
+  if (ColorMapSize) {
+    memcpy(palette, gif_ + f.palette, ColorMapSize * 3);
+    if (ColorMapSize >= (1 << (CodeSize - 1)) * 2) // more bits per pixel than codes
+      ColorMapSize = 1 << (CodeSize - 1);
+  } else {
+    ColorMapSize = 1 << (CodeSize - 1);
+    for (int i = 1; i < ColorMapSize; i++)
+      palette[i][0] = palette[i][1] = palette[i][2] = (uchar)(255 * i / (ColorMapSize - 1));
+  }
+  if (f.transparent >= ColorMapSize) ColorMapSize = f.transparent + 1;
+
+  // pixels missing from truncated data are transparent, or black
+  memset(indexes_, f.transparent >= 0 ? f.transparent : 0, f.w * f.h);
+  fl_gif_lzw_decode(rdr, CodeSize, ColorMapSize, indexes_, f.w, f.h, f.interlace,
+                    prefix_, suffix_);
+
+  for (int y = y0; y < y1; y++) {
+    const uchar *s = indexes_ + (y - f.y) * f.w;
+    uchar *p = work_ + y * line + x0 * 4;
+    for (int x = x0; x < x1; x++, s++, p += 4) {
+      if (*s == f.transparent) continue;
+      p[0] = palette[*s][0];
+      p[1] = palette[*s][1];
+      p[2] = palette[*s][2];
+      p[3] = 255;
+    }
+  }
+}
+
+// Returns composited frame n from the cache, or composites and caches it
+Fl_RGB_Image *Fl_Anim_GIF_Image::composited_(int n) {
+  for (int i = 0; i < cache_size_; i++)
+    if (cache_[i] && cache_frame_[i] == n) return cache_[i];
+  if (n < work_frame_) work_frame_ = -1; // start over from the first frame
+  while (work_frame_ < n) decode_next_();
+  int size = data_w() * data_h() * 4;
+  uchar *pixels = new uchar[size];
+  memcpy(pixels, work_, size);
+  Fl_RGB_Image *img = new Fl_RGB_Image(pixels, data_w(), data_h(), 4);
+  img->alloc_array = 1;
+  if (average_weight_ >= 0) img->color_average(average_color_, average_weight_);
+  if (desaturated_) img->desaturate();
+  delete cache_[cache_next_]; // releases the graphics driver's copy too
+  cache_[cache_next_] = img;
+  cache_frame_[cache_next_] = n;
+  cache_next_ = (cache_next_ + 1) % cache_size_;
+  return img;
+}
+
+void Fl_Anim_GIF_Image::clear_cache_() {
+  for (int i = 0; i < cache_size_; i++) {
+    delete cache_[i];
+    cache_[i] = 0;
+  }
+  cache_next_ = 0;
+}
+
+/**
+  Sets the number of composited frames kept in memory, at least 1,
+  the default is 4. Each frame needs w() * h() * 4 bytes. If all frames
+  fit, each of them is decoded only once.
+*/
+void Fl_Anim_GIF_Image::frame_cache(int n) {
+  if (n < 1) n = 1;
+  clear_cache_();
+  cache_ = (Fl_RGB_Image **)realloc(cache_, n * sizeof(Fl_RGB_Image *));
+  cache_frame_ = (int *)realloc(cache_frame_, n * sizeof(int));
+  memset(cache_, 0, n * sizeof(Fl_RGB_Image *));
+  cache_size_ = n;
+}
+
+/**
+  Creates a copy of the animation with a drawing size of \p W x \p H.
+  The copy shows the same frame but is not playing.
+*/
+Fl_Image *Fl_Anim_GIF_Image::copy(int W, int H) const {
+  Fl_Anim_GIF_Image *img = new Fl_Anim_GIF_Image(name_, gif_, gif_size_);
+  if (img->fail()) return img;
+  img->frame_cache(cache_size_);
+  img->frame_ = frame_;
+  img->average_color_ = average_color_;
+  img->average_weight_ = average_weight_;
+  img->desaturated_ = desaturated_;
+  img->scale(W, H, 0, 1);
+  return img;
+}
+
+/**
+  Averages the colors of all frames with color \p c, see
+  Fl_RGB_Image::color_average(). Frames are converted when they are
+  composited.
+*/
+void Fl_Anim_GIF_Image::color_average(Fl_Color c, float i) {
+  if (i < 0) i = 0;
+  if (i > 1) i = 1;
+  average_color_ = c;
+  average_weight_ = i;
+  clear_cache_();
+}
+
+/**
+  Converts all frames to grayscale, see Fl_RGB_Image::desaturate().
+  Frames are converted when they are composited.
+*/
+void Fl_Anim_GIF_Image::desaturate() {
+  desaturated_ = 1;
+  clear_cache_();
+}
+
+/** Releases the graphics driver's copies of the cached frames. */
+void Fl_Anim_GIF_Image::uncache() {
+  for (int i = 0; i < cache_size_; i++)
+    if (cache_[i]) cache_[i]->uncache();
+}
+
+/** Draws the current frame, decoding it if it is not cached. */
+void Fl_Anim_GIF_Image::draw(int X, int Y, int W, int H, int cx, int cy) {
+  if (fail()) {
+    draw_empty(X, Y);
+    return;
+  }
+  Fl_RGB_Image *img = composited_(frame_);
+  img->scale(w(), h(), 0, 1);
+  img->draw(X, Y, W, H, cx, cy);
+}
+
+/**
+  Shows frame \p n, starting at 0. The canvas widget is redrawn.
+  A playing animation continues from this frame.
+*/
+void Fl_Anim_GIF_Image::frame(int n) {
+  if (n < 0 || n >= frame_count_) return;
+  frame_ = n;
+  if (playing()) {
+    due_ = now() + delay(n);
+    schedule_();
+  }
+  if (canvas_) canvas_->redraw();
+}
+
+/**
+  Sets the widget that is redrawn when the frame changes, usually the
+  widget that has this image as its label image. Use NULL to remove it.
+*/
+void Fl_Anim_GIF_Image::canvas(Fl_Widget *w) {
+  if (canvas_) Fl::release_widget_pointer(canvas_);
+  canvas_ = w;
+  if (canvas_) Fl::watch_widget_pointer(canvas_);
+}
+
+/**
+  Starts playing the animation from the current frame. An animation with
+  a single frame is not played.
+*/
+void Fl_Anim_GIF_Image::start() {
+  if (frame_count_ < 2 || playing()) return;
+  loops_ = 0;
+  due_ = now() + delay(frame_);
+  next_playing_ = playing_;
+  playing_ = this;
+  schedule_();
+}
+
+/** Stops playing the animation. The current frame stays visible. */
+void Fl_Anim_GIF_Image::stop() {
+  for (Fl_Anim_GIF_Image **p = &playing_; *p; p = &(*p)->next_playing_) {
+    if (*p == this) {
+      *p = next_playing_;
+      next_playing_ = 0;
+      schedule_();
+      return;
+    }
+  }
+}
+
+/** Returns non-zero while the animation is playing. */
+int Fl_Anim_GIF_Image::playing() const {
+  for (Fl_Anim_GIF_Image *img = playing_; img; img = img->next_playing_)
+    if (img == this) return 1;
+  return 0;
+}
+
+// Shows the next frame, or stops after the last loop
+void Fl_Anim_GIF_Image::next_frame_(double t) {
+  int n = frame_ + 1;
+  if (n >= frame_count_) {
+    if (loop_count_ && ++loops_ >= loop_count_) {
+      stop();
+      return;
+    }
+    n = 0;
+  }
+  frame_ = n;
+  due_ += delay(n);
+  if (due_ < t) due_ = t + delay(n); // don't catch up after a stall
+  if (canvas_) canvas_->redraw();
+}
+
+// Schedules the shared timeout for the earliest frame change
+void Fl_Anim_GIF_Image::schedule_() {
+  Fl::remove_timeout(timeout_);
+  if (!playing_) return;
+  double due = playing_->due_;
+  for (Fl_Anim_GIF_Image *img = playing_->next_playing_; img; img = img->next_playing_)
+    if (img->due_ < due) due = img->due_;
+  double delay = due - now();
+  Fl::add_timeout(delay > 0 ? delay : 0, timeout_);
+}
+
+void Fl_Anim_GIF_Image::timeout_(void *) {
+  double t = now();
+  Fl_Anim_GIF_Image *img = playing_;
+  while (img) {
+    Fl_Anim_GIF_Image *next = img->next_playing_;
+    if (img->due_ <= t + 0.001) img->next_frame_(t);
+    img = next;
+  }
+  schedule_();
+}
@@ -21,6 +21,7 @@
 
 #include <FL/Fl_Radio_Button.H>
 #include <FL/Fl_Toggle_Button.H>
+#include "Fl_Shortcut_Registry.H"
 
 
 Fl_Widget_Tracker *Fl_Button::key_release_tracker = 0;
@@ -218,6 +219,21 @@ Fl_Button::Fl_Button(int X, int Y, int W, int H, const char *L)
   set_flag(SHORTCUT_LABEL);
 }
 
+/**
+  Destroys the button and removes its shortcut.
+ */
+Fl_Button::~Fl_Button() {
+  Fl_Shortcut_Registry::remove(this, shortcut_);
+}
+
+// The shortcut is registered, so that FL_SHORTCUT events can be sent to
+// this button without asking all other widgets first.
+void Fl_Button::shortcut(int s) {
+  Fl_Shortcut_Registry::remove(this, shortcut_);
+  shortcut_ = s;
+  Fl_Shortcut_Registry::add(this, shortcut_);
+}
+
 /**
   The constructor creates the button using the given position, size, and label.
 
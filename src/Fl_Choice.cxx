@@ -17,6 +17,7 @@
 #include <FL/Fl.H>
 #include <FL/Fl_Choice.H>
 #include <FL/fl_draw.H>
+#include "Fl_Shortcut_Registry.H"
 #include "flstring.h"
 
 // Emulates the Forms choice widget.  This is almost exactly the same
@@ -212,7 +213,7 @@ int Fl_Choice::handle(int e) {
     return 1;
   case FL_SHORTCUT:
     if (Fl_Widget::test_shortcut()) goto J1;
-    v = menu()->test_shortcut();
+    v = Fl_Shortcut_Registry::find(this);
     if (!v) return 0;
     if (v != mvalue()) redraw();
     picked(v);
@@ -205,6 +205,140 @@ Fl_GIF_Image::Fl_GIF_Image(const char *imagename, const unsigned char *data) :
   }
 }
 
+/*
+  This function decodes the LZW compressed data of one GIF image into the
+  color indexes of its Width x Height pixels, de-interlacing if needed.
+  The reader must be positioned after the LZW Minimum Code Size byte, and
+  CodeSize is that byte plus 1. Prefix and Suffix are the 4096 entry
+  tables of the decompressor, supplied by the caller so that decoding
+  many images can reuse them. Read errors are left in rdr.error().
+  This is also used by Fl_Anim_GIF_Image.
+*/
+void fl_gif_lzw_decode(Fl_Image_Reader &rdr, int CodeSize, int ColorMapSize,
+                       uchar *Image, int Width, int Height, char Interlace,
+                       short *Prefix, uchar *Suffix)
+{
+  int YC = 0, Pass = 0; /* Used to de-interlace the picture */
+  uchar *p = Image;
+  uchar *eol = p+Width;
+
+  int InitCodeSize = CodeSize;
+  int ClearCode = (1 << (CodeSize-1));
+  int EOFCode = ClearCode + 1;
+  int FirstFree = ClearCode + 2;
+  int FinChar = 0;
+  int ReadMask = (1<<CodeSize) - 1;
+  int FreeCode = FirstFree;
+  int OldCode = ClearCode;
+
+  int blocklen = rdr.read_byte();
+  uchar thisbyte = rdr.read_byte(); blocklen--;
+  if (rdr.error()) return;
+  int frombit = 0;
+
+  // loop to read LZW compressed image data
+
+  for (;;) {
+
+    /* Fetch the next code from the raster data stream.  The codes can be
+     * any length from 3 to 12 bits, packed into 8-bit bytes, so we have to
+     * maintain our location as a pointer and a bit offset.
+     * In addition, GIF adds totally useless and annoying block counts
+     * that must be correctly skipped over. */
+    int CurCode = thisbyte;
+    if (frombit+CodeSize > 7) {
+      if (blocklen <= 0) {
+        blocklen = rdr.read_byte();
+        if (rdr.error()) return;
+        if (blocklen <= 0) break;
+      }
+      thisbyte = rdr.read_byte(); blocklen--;
+      if (rdr.error()) return;
+      CurCode |= thisbyte<<8;
+    }
+    if (frombit+CodeSize > 15) {
+      if (blocklen <= 0) {
+        blocklen = rdr.read_byte();
+        if (rdr.error()) return;
+        if (blocklen <= 0) break;
+      }
+      thisbyte = rdr.read_byte(); blocklen--;
+      if (rdr.error()) return;
+      CurCode |= thisbyte<<16;
+    }
+    CurCode = (CurCode>>frombit)&ReadMask;
+    frombit = (frombit+CodeSize)%8;
+
+    if (CurCode == ClearCode) {
+      CodeSize = InitCodeSize;
+      ReadMask = (1<<CodeSize) - 1;
+      FreeCode = FirstFree;
+      OldCode = ClearCode;
+      continue;
+    }
+
+    if (CurCode == EOFCode)
+      break;
+
+    uchar OutCode[4097]; // temporary array for reversing codes
+    uchar *tp = OutCode;
+    int i;
+    if (CurCode < FreeCode) {
+      i = CurCode;
+    } else if (CurCode == FreeCode) {
+      *tp++ = (uchar)FinChar;
+      i = OldCode;
+    } else {
+      Fl::error("Fl_GIF_Image: %s - LZW Barf at offset %ld", rdr.name(), rdr.tell());
+      break;
+    }
+
+    while (i >= ColorMapSize) {
+      if (i < FreeCode) {
+        *tp++ = Suffix[i];
+        i = Prefix[i];
+      } else { // FIXME - should never happen (?)
+        Fl::error("Fl_GIF_Image: %s - i(%d) >= FreeCode (%d) at offset %ld",
+                  rdr.name(), i, FreeCode, rdr.tell());
+        // NOTREACHED
+        i = FreeCode - 1; // fix broken index ???
+        break;
+      }
+    }
+    *tp++ = FinChar = i;
+    do {
+      *p++ = *--tp;
+      if (p >= eol) {
+        if (!Interlace) YC++;
+        else switch (Pass) {
+          case 0: YC += 8; if (YC >= Height) {Pass++; YC = 4;} break;
+          case 1: YC += 8; if (YC >= Height) {Pass++; YC = 2;} break;
+          case 2: YC += 4; if (YC >= Height) {Pass++; YC = 1;} break;
+          case 3: YC += 2; break;
+        }
+        if (YC>=Height) YC=0; /* cheap bug fix when excess data */
+        p = Image + YC*Width;
+        eol = p+Width;
+      }
+    } while (tp > OutCode);
+
+    if (OldCode != ClearCode) {
+      if (FreeCode < 4096) {
+        Prefix[FreeCode] = (short)OldCode;
+        Suffix[FreeCode] = FinChar;
+        FreeCode++;
+      }
+      if (FreeCode > ReadMask) {
+        if (CodeSize < 12) {
+          CodeSize++;
+          ReadMask = (1 << CodeSize) - 1;
+        }
+      }
+    }
+    OldCode = CurCode;
+  }
+}
+
 /*
   This method reads GIF image data and creates an RGB or RGBA image. The GIF
   format supports only 1 bit for alpha. The final image data is stored in
@@ -391,130 +525,15 @@ void Fl_GIF_Image::load_gif_(Fl_Image_Reader &rdr)
   // now read the LZW compressed image data
 
   Image = new uchar[Width*Height];
-
-  int YC = 0, Pass = 0; /* Used to de-interlace the picture */
-  uchar *p = Image;
-  uchar *eol = p+Width;
-
-  int InitCodeSize = CodeSize;
-  int ClearCode = (1 << (CodeSize-1));
-  int EOFCode = ClearCode + 1;
-  int FirstFree = ClearCode + 2;
-  int FinChar = 0;
-  int ReadMask = (1<<CodeSize) - 1;
-  int FreeCode = FirstFree;
-  int OldCode = ClearCode;
+  uchar *p;
 
   // tables used by LZW decompressor:
   short int Prefix[4096];
   uchar Suffix[4096];
 
-  int blocklen = rdr.read_byte();
-  uchar thisbyte = rdr.read_byte(); blocklen--;
+  fl_gif_lzw_decode(rdr, CodeSize, ColorMapSize, Image, Width, Height, Interlace,
+                    Prefix, Suffix);
   CHECK_ERROR
-  int frombit = 0;
-
-  // loop to read LZW compressed image data
-
-  for (;;) {
-
-    /* Fetch the next code from the raster data stream.  The codes can be
-     * any length from 3 to 12 bits, packed into 8-bit bytes, so we have to
-     * maintain our location as a pointer and a bit offset.
-     * In addition, GIF adds totally useless and annoying block counts
-     * that must be correctly skipped over. */
-    int CurCode = thisbyte;
-    if (frombit+CodeSize > 7) {
-      if (blocklen <= 0) {
-        blocklen = rdr.read_byte();
-        CHECK_ERROR
-        if (blocklen <= 0) break;
-      }
-      thisbyte = rdr.read_byte(); blocklen--;
-      CHECK_ERROR
-      CurCode |= thisbyte<<8;
-    }
-    if (frombit+CodeSize > 15) {
-      if (blocklen <= 0) {
-        blocklen = rdr.read_byte();
-        CHECK_ERROR
-        if (blocklen <= 0) break;
-      }
-      thisbyte = rdr.read_byte(); blocklen--;
-      CHECK_ERROR
-      CurCode |= thisbyte<<16;
-    }
-    CurCode = (CurCode>>frombit)&ReadMask;
-    frombit = (frombit+CodeSize)%8;
-
-    if (CurCode == ClearCode) {
-      CodeSize = InitCodeSize;
-      ReadMask = (1<<CodeSize) - 1;
-      FreeCode = FirstFree;
-      OldCode = ClearCode;
-      continue;
-    }
-
-    if (CurCode == EOFCode)
-      break;
-
-    uchar OutCode[4097]; // temporary array for reversing codes
-    uchar *tp = OutCode;
-    int i;
-    if (CurCode < FreeCode) {
-      i = CurCode;
-    } else if (CurCode == FreeCode) {
-      *tp++ = (uchar)FinChar;
-      i = OldCode;
-    } else {
-      Fl::error("Fl_GIF_Image: %s - LZW Barf at offset %ld", rdr.name(), rdr.tell());
-      break;
-    }
-
-    while (i >= ColorMapSize) {
-      if (i < FreeCode) {
-        *tp++ = Suffix[i];
-        i = Prefix[i];
-      } else { // FIXME - should never happen (?)
-        Fl::error("Fl_GIF_Image: %s - i(%d) >= FreeCode (%d) at offset %ld",
-                  rdr.name(), i, FreeCode, rdr.tell());
-        // NOTREACHED
-        i = FreeCode - 1; // fix broken index ???
-        break;
-      }
-    }
-    *tp++ = FinChar = i;
-    do {
-      *p++ = *--tp;
-      if (p >= eol) {
-        if (!Interlace) YC++;
-        else switch (Pass) {
-          case 0: YC += 8; if (YC >= Height) {Pass++; YC = 4;} break;
-          case 1: YC += 8; if (YC >= Height) {Pass++; YC = 2;} break;
-          case 2: YC += 4; if (YC >= Height) {Pass++; YC = 1;} break;
-          case 3: YC += 2; break;
-        }
-        if (YC>=Height) YC=0; /* cheap bug fix when excess data */
-        p = Image + YC*Width;
-        eol = p+Width;
-      }
-    } while (tp > OutCode);
-
-    if (OldCode != ClearCode) {
-      if (FreeCode < 4096) {
-        Prefix[FreeCode] = (short)OldCode;
-        Suffix[FreeCode] = FinChar;
-        FreeCode++;
-      }
-      if (FreeCode > ReadMask) {
-        if (CodeSize < 12) {
-          CodeSize++;
-          ReadMask = (1 << CodeSize) - 1;
-        }
-      }
-    }
-    OldCode = CurCode;
-  }
 
   // We are done reading the image, now convert to xpm
 
@@ -383,6 +383,9 @@ void Fl_Gl_Window::draw_begin() {
  \see \ref opengl_with_fltk_widgets
  */
 void Fl_Gl_Window::draw_end() {
+  // draw all batched primitives with the current matrices
+  ((Fl_OpenGL_Graphics_Driver*)Fl_Surface_Device::surface()->driver())->flush_batch();
+
   glMatrixMode(GL_MODELVIEW);
   glPopMatrix();
 
@@ -470,6 +473,41 @@ void Fl_Gl_Window::draw() {
   draw_end();
 }
 
+/**
+ Draws all rectangles, lines and points that FLTK drawing functions have
+ collected since draw_begin().
+ Between draw_begin() and draw_end(), the \c fl_...() drawing functions
+ collect these primitives and draw them with a few OpenGL calls when the
+ kind of primitive or the clipping changes, when text is drawn, and in
+ draw_end(). Call this before drawing with OpenGL directly between
+ draw_begin() and draw_end(), e.g. in the draw() method of a widget in an
+ Fl_Gl_Window, so that your OpenGL drawing appears above what FLTK drew
+ before it.
+ \see \ref opengl_with_fltk_widgets
+ \version 1.4.0
+ */
+void Fl_Gl_Window::draw_flush() {
+  ((Fl_OpenGL_Graphics_Driver*)Fl_OpenGL_Display_Device::display_device()->driver())->flush_batch();
+}
+
+/**
+ Reports how many OpenGL draw calls the FLTK drawing functions made in
+ OpenGL windows since the program started.
+ Both parameters are optional and may be NULL.
+ \param[out] draw_calls number of glDrawArrays() calls that drew rectangles,
+ lines and points
+ \param[out] primitives number of rectangles, lines and points they drew,
+ each of which took its own OpenGL call before FLTK 1.4
+ \see draw_flush()
+ \version 1.4.0
+ */
+void Fl_Gl_Window::batch_statistics(unsigned long *draw_calls, unsigned long *primitives) {
+  unsigned long d, p;
+  ((Fl_OpenGL_Graphics_Driver*)Fl_OpenGL_Display_Device::display_device()->driver())->batch_statistics(d, p);
+  if (draw_calls) *draw_calls = d;
+  if (primitives) *primitives = p;
+}
+
 /**
  Handle some FLTK events as needed.
  */
@@ -51,6 +51,7 @@ Fl_Graphics_Driver::Fl_Graphics_Driver()
   fl_clip_state_number=0;
   m = m0;
   font_descriptor_ = NULL;
+  Fl_Font_Descriptor::hold(&font_descriptor_);
   scale_ = 1;
   p_size = 0;
   xpoint = NULL;
@@ -60,6 +61,7 @@ Fl_Graphics_Driver::Fl_Graphics_Driver()
 
 /** Destructor */
 Fl_Graphics_Driver::~Fl_Graphics_Driver() {
+  Fl_Font_Descriptor::release(&font_descriptor_);
   if (xpoint) free(xpoint);
 }
 
@@ -724,15 +726,230 @@ int Fl_Graphics_Driver::antialias() {
 
 #ifndef FL_DOXYGEN
 
+static unsigned long font_serial = 0, font_clock = 0;
+
 Fl_Font_Descriptor::Fl_Font_Descriptor(const char* name, Fl_Fontsize Size) {
   next = 0;
-#  if HAVE_GL
   listbase = 0;
-#  endif
   // OpenGL needs those for its font handling
   size = Size;
+  angle = 0;
+  fnum = -1;
+  hash_next = 0;
+  used = 0;
+  serial = ++font_serial;
+}
+
+Fl_Font_Descriptor::~Fl_Font_Descriptor() {
+  uncache();
+}
+
+// The descriptors are chained by hash_next in a hash table keyed by face,
+// size and angle. The size is the size given to the platform, so that
+// scaled fonts have their own entries.
+static Fl_Font_Descriptor **font_hash = 0;
+static int font_hash_size = 0, font_hash_count = 0, font_hash_limit = 0;
+static unsigned long font_hash_lookups = 0, font_hash_probes = 0;
+
+static unsigned font_hash_key(Fl_Font fnum, Fl_Fontsize size, int angle) {
+  unsigned h = (unsigned)fnum * 2654435761U;
+  h ^= (unsigned)size * 2246822519U;
+  h ^= (unsigned)angle * 3266489917U;
+  return h ^ (h >> 15);
+}
+
+// Returns the cached descriptor of face fnum with this size and angle.
+Fl_Font_Descriptor *Fl_Font_Descriptor::find(Fl_Font fnum, Fl_Fontsize size, int angle) {
+  font_hash_lookups++;
+  if (!font_hash_count) return 0;
+  Fl_Font_Descriptor *f = font_hash[font_hash_key(fnum, size, angle) & (font_hash_size - 1)];
+  for (; f; f = f->hash_next) {
+    font_hash_probes++;
+    if (f->fnum == fnum && f->size == size && f->angle == angle) {
+      f->used = ++font_clock;
+      break;
+    }
+  }
+  return f;
+}
+
+static int font_cache_evict(int n, Fl_Font_Descriptor *keep);
+
+// Adds this descriptor to the cache as the descriptor of face fnum.
+void Fl_Font_Descriptor::cache(Fl_Font num) {
+  uncache();
+  if (font_hash_count >= font_hash_size) {
+    int n = font_hash_size ? 2 * font_hash_size : 64;
+    Fl_Font_Descriptor **t = (Fl_Font_Descriptor **)calloc(n, sizeof(Fl_Font_Descriptor *));
+    for (int i = 0; i < font_hash_size; i++) {
+      for (Fl_Font_Descriptor *f = font_hash[i], *nf; f; f = nf) {
+        nf = f->hash_next;
+        unsigned b = font_hash_key(f->fnum, f->size, f->angle) & (n - 1);
+        f->hash_next = t[b];
+        t[b] = f;
+      }
+    }
+    free(font_hash);
+    font_hash = t;
+    font_hash_size = n;
+  }
+  fnum = num;
+  unsigned b = font_hash_key(fnum, size, angle) & (font_hash_size - 1);
+  hash_next = font_hash[b];
+  font_hash[b] = this;
+  font_hash_count++;
+  used = ++font_clock;
+  if (font_hash_limit && font_hash_count > font_hash_limit)
+    font_cache_evict(font_hash_count - font_hash_limit * 3 / 4, this);
+}
+
+// Removes this descriptor from the cache.
+void Fl_Font_Descriptor::uncache() {
+  if (fnum < 0) return;
+  unsigned b = font_hash_key(fnum, size, angle) & (font_hash_size - 1);
+  for (Fl_Font_Descriptor **p = font_hash + b; *p; p = &(*p)->hash_next) {
+    if (*p == this) {
+      *p = hash_next;
+      font_hash_count--;
+      break;
+    }
+  }
+  fnum = -1;
+  hash_next = 0;
+}
+
+// The pointers that may refer to descriptors which must not be evicted
+static Fl_Font_Descriptor ***font_holders = 0;
+static int font_holder_count = 0, font_holder_size = 0;
+
+// Registers a pointer to a descriptor that the cache must not delete.
+void Fl_Font_Descriptor::hold(Fl_Font_Descriptor **holder) {
+  if (font_holder_count >= font_holder_size) {
+    font_holder_size = font_holder_size ? 2 * font_holder_size : 16;
+    font_holders = (Fl_Font_Descriptor ***)realloc(font_holders,
+                                                   font_holder_size * sizeof(Fl_Font_Descriptor **));
+  }
+  font_holders[font_holder_count++] = holder;
 }
 
+void Fl_Font_Descriptor::release(Fl_Font_Descriptor **holder) {
+  for (int i = font_holder_count - 1; i >= 0; i--) {
+    if (font_holders[i] == holder) {
+      font_holders[i] = font_holders[--font_holder_count];
+      break;
+    }
+  }
+}
+
+extern FL_EXPORT Fl_Fontdesc *fl_fonts;
+extern int fl_font_table_size(); // in fl_set_font.cxx
+
+// Removes an evicted descriptor from the list of sizes of its face
+static void unlink_from_face(Fl_Font_Descriptor *f) {
+  if (!fl_fonts || f->fnum >= fl_font_table_size()) return;
+  unsigned width = Fl_Graphics_Driver::default_driver().font_desc_size();
+  Fl_Fontdesc *s = (Fl_Fontdesc *)((char *)fl_fonts + f->fnum * width);
+  for (Fl_Font_Descriptor **p = &s->first; *p; p = &(*p)->next) {
+    if (*p == f) {
+      *p = f->next;
+      break;
+    }
+  }
+}
+
+static int compare_used(const void *a, const void *b) {
+  unsigned long ua = (*(Fl_Font_Descriptor **)a)->used, ub = (*(Fl_Font_Descriptor **)b)->used;
+  return ua < ub ? -1 : (ua > ub ? 1 : 0);
+}
+
+// Deletes the n least recently used descriptors but keep, those that a holder
+// refers to, and those with OpenGL display lists. Returns the number deleted.
+static int font_cache_evict(int n, Fl_Font_Descriptor *keep) {
+  if (n <= 0 || !font_hash_count) return 0;
+  Fl_Font_Descriptor **unused =
+    (Fl_Font_Descriptor **)malloc(font_hash_count * sizeof(Fl_Font_Descriptor *));
+  int count = 0, i, k;
+  for (i = 0; i < font_hash_size; i++) {
+    for (Fl_Font_Descriptor *f = font_hash[i]; f; f = f->hash_next) {
+      if (f == keep || f->listbase) continue;
+      for (k = 0; k < font_holder_count; k++)
+        if (*font_holders[k] == f) break;
+      if (k == font_holder_count) unused[count++] = f;
+    }
+  }
+  qsort(unused, count, sizeof(Fl_Font_Descriptor *), compare_used);
+  if (n > count) n = count;
+  for (i = 0; i < n; i++) {
+    unlink_from_face(unused[i]);
+    delete unused[i]; // also removes it from the cache
+  }
+  free(unused);
+  return n;
+}
+
+#endif // FL_DOXYGEN
+
+/**
+ Returns counters of the cache that finds the platform font of the face and
+ size selected by fl_font().
+ Selecting a font looks up the cache unless the font is already selected.
+ Divide \p probes by \p lookups to get the average number of cached fonts
+ that a lookup compares. This stays close to 1 however many fonts are
+ cached.
+ Only the X11 and Wayland platforms use this cache.
+ \param[out] lookups  number of lookups since the program started
+ \param[out] probes   number of cached fonts compared by these lookups
+ \param[out] fonts    number of fonts in the cache
+ \version 1.4.0
+ */
+void Fl_Graphics_Driver::font_cache_stats(unsigned long &lookups, unsigned long &probes, int &fonts) {
+  lookups = font_hash_lookups;
+  probes = font_hash_probes;
+  fonts = font_hash_count;
+}
+
+/**
+ Limits the number of platform fonts in the cache that font_cache_stats()
+ reports on.
+ Each face and size that a program draws with stays open until the program
+ ends, unless the cache is limited. When it holds more than \p n fonts, the
+ least recently selected fonts are closed until it holds 3/4 of \p n.
+ Fonts that a graphics driver has currently selected are never closed, so the
+ cache may hold more than \p n fonts if many drivers exist.
+ A closed font is opened again the next time it is selected.
+ \param n  the maximum number of cached fonts, 0 (the default) for no limit
+ \see font_cache_purge()
+ \version 1.4.0
+ */
+void Fl_Graphics_Driver::font_cache_limit(int n) {
+  font_hash_limit = n > 0 ? n : 0;
+  if (font_hash_limit && font_hash_count > font_hash_limit)
+    font_cache_evict(font_hash_count - font_hash_limit * 3 / 4, NULL);
+}
+
+/**
+ Returns the maximum number of cached platform fonts, 0 for no limit.
+ \see font_cache_limit(int)
+ \version 1.4.0
+ */
+int Fl_Graphics_Driver::font_cache_limit() {
+  return font_hash_limit;
+}
+
+/**
+ Closes all cached platform fonts that no graphics driver has selected.
+ Call this after drawing with many faces or sizes that will not be used
+ again, e.g. after printing. Fonts are opened again when they are selected.
+ \return the number of closed fonts
+ \see font_cache_limit(int)
+ \version 1.4.0
+ */
+int Fl_Graphics_Driver::font_cache_purge() {
+  return font_cache_evict(font_hash_count, NULL);
+}
+
+#ifndef FL_DOXYGEN
+
 Fl_Scalable_Graphics_Driver::Fl_Scalable_Graphics_Driver() : Fl_Graphics_Driver() {
   line_width_ = 0;
 }
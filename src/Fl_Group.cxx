@@ -24,6 +24,8 @@
 #include "Fl_Window_Driver.H"
 #include <FL/Fl_Rect.H>
 #include <FL/fl_draw.H>
+#include <FL/Fl_Image_Surface.H>
+#include <FL/Fl_Trace.H>
 
 #include <stdlib.h> // malloc etc.
 
@@ -357,6 +359,7 @@ Fl_Group::Fl_Group(int X,int Y,int W,int H,const char *l)
   resizable_ = this;
   bounds_ = 0; // this is allocated when first resize() is done
   sizes_ = 0; // see bounds_ (FLTK 1.3 compatibility)
+  layer_ = 0;
 
   // Subclasses may want to construct child objects as part of their
   // constructor, so make sure they are add()'d to this object.
@@ -445,6 +448,7 @@ Fl_Group::~Fl_Group() {
   if (current_ == this)
     end();
   clear();
+  delete_layer();
 }
 
 /**
@@ -931,6 +935,144 @@ void Fl_Group::draw() {
   draw_children();
 }
 
+////////////////////////////////////////////////////////////////
+// Layer caching:
+// A group with cache_layer() set is drawn by its parent from an offscreen
+// copy of itself. Its own damage bits tell what is stale: FL_DAMAGE_CHILD
+// redraws the damaged descendants into the layer, anything else redraws
+// the whole group, and no damage at all (e.g. an expose event or a
+// neighbour being redrawn) only copies the layer to the window.
+
+class Fl_Group_Layer {
+public:
+  Fl_Image_Surface *surface;
+  int w, h;                     // size in FLTK units
+  float scale;                  // scale factor the layer was drawn with
+  size_t bytes;
+};
+
+static size_t layer_bytes_ = 0;   // memory used by all layers
+static int layer_count_ = 0;      // number of layers
+static size_t layer_limit_ = 0;   // no new layers beyond this, 0 = no limit
+
+void Fl_Group::delete_layer() {
+  if (!layer_) return;
+  layer_bytes_ -= layer_->bytes;
+  layer_count_--;
+  delete layer_->surface;
+  delete layer_;
+  layer_ = 0;
+}
+
+/**
+  Sets whether the group is drawn from an offscreen layer.
+
+  When this is set the group and all its children are drawn once into an
+  offscreen buffer. Later redraws of the window, for instance after an
+  expose event or when a neighbouring widget changed, copy that buffer to
+  the screen instead of drawing the group again. The layer is updated when
+  the group or one of its descendants is damaged, and drawn anew when the
+  group is resized or the scale factor changes.
+
+  This pays off for complex groups that rarely change, like panels with
+  many decorated boxes, images or long labels. Everything must be drawn
+  inside the group's bounding box: outside labels of the group's children
+  and a transparent (FL_NO_BOX) background can't be represented; the layer
+  of a group without a box is filled with its color() first.
+
+  Layers are only used when drawing to the display, not when printing
+  or drawing to an image surface.
+
+  The default is not to use a layer (0). Setting \p c to 0 releases the
+  memory of an existing layer.
+
+  \see layer_memory(), layer_memory_limit(size_t)
+*/
+void Fl_Group::cache_layer(int c) {
+  if (c) {
+    set_flag(CACHE_LAYER);
+  } else {
+    clear_flag(CACHE_LAYER);
+    delete_layer();
+  }
+}
+
+/**
+  Returns the memory used by all group layers.
+
+  The value is the size in bytes of the pixel data of the offscreen
+  buffers of all groups with cache_layer() set that have been drawn.
+
+  \param[out] count  if not NULL, receives the number of these layers
+  \see cache_layer(int)
+*/
+size_t Fl_Group::layer_memory(int *count) {
+  if (count) *count = layer_count_;
+  return layer_bytes_;
+}
+
+/**
+  Limits the memory used by group layers.
+
+  A group whose layer would make layer_memory() exceed \p bytes is drawn
+  directly, as if cache_layer() was not set, until memory is released.
+  Layers that exist already are kept. The default is 0, no limit.
+*/
+void Fl_Group::layer_memory_limit(size_t bytes) {
+  layer_limit_ = bytes;
+}
+
+/**
+  Returns the limit set with layer_memory_limit(size_t).
+*/
+size_t Fl_Group::layer_memory_limit() {
+  return layer_limit_;
+}
+
+// Draws the group through its layer. \p d is the damage of the group before
+// its parent possibly forced a full redraw. Returns false if the group must
+// be drawn directly.
+bool Fl_Group::draw_layer(uchar d) {
+  if (Fl_Surface_Device::surface() != Fl_Display_Device::display_device())
+    return false;
+  float s = fl_graphics_driver->scale();
+  if (layer_ && (layer_->w != w() || layer_->h != h() || layer_->scale != s))
+    delete_layer();
+  if (!layer_) {
+    if (w() <= 0 || h() <= 0) return false;
+    size_t bytes = size_t(w() * s + 0.5) * size_t(h() * s + 0.5) * 4;
+    if (layer_limit_ && layer_bytes_ + bytes > layer_limit_) return false;
+    layer_ = new Fl_Group_Layer;
+    layer_->surface = new Fl_Image_Surface(w(), h(), 1);
+    layer_->w = w();
+    layer_->h = h();
+    layer_->scale = s;
+    layer_->bytes = bytes;
+    layer_bytes_ += bytes;
+    layer_count_++;
+    d = FL_DAMAGE_ALL;
+  }
+  if (d) {
+    // widgets draw in window coordinates, the layer starts at x(), y()
+    Fl_Widget_Surface *surface = layer_->surface;
+    Fl_Surface_Device::push_current(surface);
+    surface->translate(-x(), -y());
+    if (d & ~FL_DAMAGE_CHILD) {
+      clear_damage(FL_DAMAGE_ALL);
+      if (box() == FL_NO_BOX) {
+        fl_color(color());
+        fl_rectf(x(), y(), w(), h());
+      }
+    }
+    draw();
+    surface->untranslate();
+    Fl_Surface_Device::pop_current();
+  }
+  clear_damage();
+  fl_copy_offscreen(x(), y(), w(), h(), layer_->surface->offscreen(), 0, 0);
+  return true;
+}
+
 /**
   Draws a child only if it needs it.
 
@@ -942,8 +1084,12 @@ void Fl_Group::draw() {
 void Fl_Group::update_child(Fl_Widget& widget) const {
   if (widget.damage() && widget.visible() && widget.type() < FL_WINDOW &&
       fl_not_clipped(widget.x(), widget.y(), widget.w(), widget.h())) {
-    widget.draw();
+    double trace_start = Fl_Trace::start();
+    Fl_Group *g = widget.as_group();
+    if (!(g && g->cache_layer() && g->draw_layer(g->damage())))
+      widget.draw();
     widget.clear_damage();
+    if (trace_start) Fl_Trace::add(Fl_Trace::WIDGET_DRAW, trace_start, widget.label());
   }
 }
 
@@ -956,9 +1102,14 @@ void Fl_Group::update_child(Fl_Widget& widget) const {
 void Fl_Group::draw_child(Fl_Widget& widget) const {
   if (widget.visible() && widget.type() < FL_WINDOW &&
       fl_not_clipped(widget.x(), widget.y(), widget.w(), widget.h())) {
-    widget.clear_damage(FL_DAMAGE_ALL);
-    widget.draw();
-    widget.clear_damage();
+    double trace_start = Fl_Trace::start();
+    Fl_Group *g = widget.as_group();
+    if (!(g && g->cache_layer() && g->draw_layer(g->damage()))) {
+      widget.clear_damage(FL_DAMAGE_ALL);
+      widget.draw();
+      widget.clear_damage();
+    }
+    if (trace_start) Fl_Trace::add(Fl_Trace::WIDGET_DRAW, trace_start, widget.label());
   }
 }
 
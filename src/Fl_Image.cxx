@@ -327,9 +327,6 @@ bool Fl_Image::register_images_done = false;
 //
 size_t Fl_RGB_Image::max_size_ = ~((size_t)0);
 
-int fl_convert_pixmap(const char*const* cdata, uchar* out, Fl_Color bg);
-
-
 /**
   The constructor creates a new image from the specified data.
 
@@ -382,6 +379,8 @@ Fl_RGB_Image::Fl_RGB_Image(const uchar *bits, int W, int H, int D, int LD) :
 
   The RGBA image is built fully opaque except for the transparent area
   of the pixmap that is assigned the \p bg color with full transparency.
+  The pixels of the pixmap are decoded once and kept by the pixmap until
+  it is uncached, see Fl_Pixmap::decode().
 
   This constructor creates a new internal data array and sets
   Fl_RGB_Image::alloc_array to 1 so the data array is deleted when the
@@ -398,7 +397,7 @@ Fl_RGB_Image::Fl_RGB_Image(const Fl_Pixmap *pxm, Fl_Color bg):
   if (pxm && pxm->data_w() > 0 && pxm->data_h() > 0) {
     array = new uchar[data_w() * data_h() * d()];
     alloc_array = 1;
-    fl_convert_pixmap(pxm->data(), (uchar*)array, bg);
+    pxm->convert_((uchar*)array, bg, 1);
   }
   data((const char **)&array, 1);
   scale(pxm->w(), pxm->h(), 0, 1);
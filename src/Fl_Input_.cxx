@@ -19,6 +19,7 @@
 #include <FL/Fl_Window.H>
 #include "Fl_Screen_Driver.H"
 #include <FL/fl_draw.H>
+#include <FL/Fl_Graphics_Driver.H>
 #include <FL/fl_ask.H>
 #include <math.h>
 #include <FL/fl_utf8.h>
@@ -71,6 +72,136 @@ public:
   }
 };
 
+/* \internal
+  One line of text as drawn by Fl_Input_::drawtext(), i.e. the text
+  converted by one call to Fl_Input_::expand().
+*/
+struct Fl_Input_Line {
+  int start;    // index of the first byte of the line
+  int end;      // index of the '\n' or space that ends the line, or size()
+  float width;  // width of the expanded line in pixels, < 0 if not measured yet
+  int dirty;    // this entry stands for whole paragraphs that must be laid out again
+};
+
+/* \internal
+  Cached layout of the text of an Fl_Input_.
+
+  The lines of a paragraph (the text between two '\n') only depend on the
+  text of that paragraph. replace() therefore marks the paragraphs it touches
+  as dirty and merely shifts the indices of all following lines. Dirty
+  paragraphs are kept as a single entry and are expanded again by
+  Fl_Input_::layout() the next time the layout is needed, so drawing, cursor
+  movement and mouse hit-testing can use binary searches instead of
+  expanding all text from the beginning.
+*/
+class Fl_Input_Line_Cache {
+public:
+  Fl_Input_Line *line;
+  int count, alloc;
+  int dirty_min, dirty_max;     // entries that may be dirty
+  int valid;                    // 0 if the whole text must be laid out again
+  // parameters the layout depends on:
+  Fl_Font font;
+  Fl_Fontsize size;
+  int type;
+  int wrap_width;
+  float scale;
+
+  Fl_Input_Line_Cache() :
+  line(NULL),
+  count(0),
+  alloc(0),
+  valid(0)
+  { clean(); }
+  ~Fl_Input_Line_Cache() {
+    if (line)
+      ::free(line);
+  }
+
+  void clean() {
+    dirty_min = 0;
+    dirty_max = -1;
+  }
+
+  void mark_dirty(int i) {
+    if (dirty_min > dirty_max) dirty_min = dirty_max = i;
+    else if (i < dirty_min) dirty_min = i;
+    else if (i > dirty_max) dirty_max = i;
+  }
+
+  /*
+   Replaces the entries i to j-1 by n uninitialized entries.
+   */
+  void splice(int i, int j, int n) {
+    int newcount = count - (j-i) + n;
+    if (newcount > alloc) {
+      alloc = newcount + newcount/2 + 16;
+      line = (Fl_Input_Line *)realloc(line, alloc * sizeof(Fl_Input_Line));
+    }
+    if (j < count)
+      memmove(line+i+n, line+j, (count-j) * sizeof(Fl_Input_Line));
+    count = newcount;
+  }
+
+  /*
+   Returns the last line starting at or before index pos.
+   */
+  int find(int pos) const {
+    int lo = 0, hi = count-1;
+    while (lo < hi) {
+      int mid = (lo+hi+1)/2;
+      if (line[mid].start <= pos) lo = mid; else hi = mid-1;
+    }
+    return lo;
+  }
+
+  /*
+   Returns the first line ending at or after index pos.
+   */
+  int find_end(int pos) const {
+    int lo = 0, hi = count-1;
+    while (lo < hi) {
+      int mid = (lo+hi)/2;
+      if (line[mid].end >= pos) hi = mid; else lo = mid+1;
+    }
+    return lo;
+  }
+
+  void changed(const char *text, int size, int multiline, int b, int e, int ilen);
+};
+
+/*
+  Updates the cache after the bytes from b to e have been replaced by ilen
+  bytes. text and size describe the new text.
+*/
+void Fl_Input_Line_Cache::changed(const char *text, int size, int multiline, int b, int e, int ilen) {
+  if (!valid) return;
+  if (!multiline) { valid = 0; return; } // single line: the text is one paragraph
+  int delta = ilen - (e-b);
+  // first line of the paragraph containing b (text before b did not change):
+  int i = find(b);
+  while (i > 0 && text[line[i].start-1] != '\n') i--;
+  // first line of the first paragraph that starts after the change:
+  int j = i+1;
+  while (j < count && (line[j].start <= e || text[line[j].start-1+delta] != '\n')) j++;
+  int start = line[i].start;
+  int end = (j < count) ? line[j].start-1+delta : size;
+  for (int k = j; k < count; k++) {
+    line[k].start += delta;
+    line[k].end += delta;
+  }
+  // keep track of dirty entries behind the replaced ones:
+  if (dirty_min <= dirty_max) {
+    if (dirty_min >= j) dirty_min -= j-i-1; else if (dirty_min > i) dirty_min = i;
+    if (dirty_max >= j) dirty_max -= j-i-1; else if (dirty_max > i) dirty_max = i;
+  }
+  splice(i, j, 1);
+  line[i].start = start;
+  line[i].end = end;
+  line[i].width = -1;
+  line[i].dirty = 1;
+  mark_dirty(i);
+}
 
 /** \internal
   Converts a given text segment into the text that will be rendered on screen.
@@ -238,6 +369,68 @@ void Fl_Input_::setfont() const {
   fl_font(textfont(), textsize());
 }
 
+/** \internal
+  Returns the line layout of the text, updated if needed.
+
+  Expands the paragraphs changed since the last call again, or the whole
+  text if the font, the widget type, the wrap width or the scale factor
+  changed. The text font must have been set with setfont().
+
+  \return the line cache with at least one line
+*/
+Fl_Input_Line_Cache* Fl_Input_::layout() const {
+  Fl_Input_Line_Cache *c = lines_;
+  int ww = wrap() ? w() - Fl::box_dw(box()) - 2 : 0;
+  float s = fl_graphics_driver->scale();
+  if (!c->valid || c->font != textfont_ || c->size != textsize_ ||
+      c->type != type() || c->wrap_width != ww || c->scale != s) {
+    c->font = textfont_;
+    c->size = textsize_;
+    c->type = type();
+    c->wrap_width = ww;
+    c->scale = s;
+    c->count = 0;
+    c->splice(0, 0, 1);
+    c->line[0].start = 0;
+    c->line[0].end = size_;
+    c->line[0].dirty = 1;
+    c->clean();
+    c->mark_dirty(0);
+    c->valid = 1;
+  }
+  if (c->dirty_min > c->dirty_max) return c;
+
+  // Lay out dirty entries, from the last one so that the indices of the
+  // entries still to be processed do not change:
+  char buf[MAXBUF];
+  Fl_Input_Line *tmp = NULL;
+  int ntmp = 0, tmpalloc = 0;
+  for (int i = c->dirty_max; i >= c->dirty_min; i--) {
+    if (!c->line[i].dirty) continue;
+    const char *p = value_ + c->line[i].start;
+    const char *pe = value_ + c->line[i].end;
+    for (ntmp = 0; ; ntmp++) {
+      const char *e = expand(p, buf);
+      if (ntmp >= tmpalloc) {
+        tmpalloc = tmpalloc ? 2*tmpalloc : 64;
+        tmp = (Fl_Input_Line *)realloc(tmp, tmpalloc * sizeof(Fl_Input_Line));
+      }
+      tmp[ntmp].start = (int) (p-value_);
+      tmp[ntmp].end = (int) (e-value_);
+      tmp[ntmp].width = -1;
+      tmp[ntmp].dirty = 0;
+      if (e >= pe) { ntmp++; break; }
+      if (*e == '\n' || *e == ' ') e++;
+      p = e;
+    }
+    c->splice(i, i+1, ntmp);
+    memcpy(c->line+i, tmp, ntmp * sizeof(Fl_Input_Line));
+  }
+  if (tmp) ::free(tmp);
+  c->clean();
+  return c;
+}
+
 /**
   Draws the text in the passed bounding box.
 
@@ -270,39 +463,36 @@ void Fl_Input_::drawtext(int X, int Y, int W, int H) {
   setfont();
   const char *p, *e;
   char buf[MAXBUF];
+  Fl_Input_Line_Cache *lc = layout();
 
-  // count how many lines and put the last one into the buffer:
-  // And figure out where the cursor is:
+  // figure out where the cursor is and put its line into the buffer:
   int height = fl_height();
   int threshold = height/2;
-  int lines;
   int curx, cury;
-  for (p=value(), curx=cury=lines=0; ;) {
-    e = expand(p, buf);
-    if (position() >= p-value() && position() <= e-value()) {
-      curx = int(expandpos(p, value()+position(), buf, 0)+.5);
-      if (Fl::focus()==this && !was_up_down) up_down_pos = curx;
-      cury = lines*height;
-      int newscroll = xscroll_;
-      if (curx > newscroll+W-threshold) {
-        // figure out scrolling so there is space after the cursor:
-        newscroll = curx+threshold-W;
-        // figure out the furthest left we ever want to scroll:
-        int ex = int(expandpos(p, e, buf, 0))+4-W;
-        // use minimum of both amounts:
-        if (ex < newscroll) newscroll = ex;
-      } else if (curx < newscroll+threshold) {
-        newscroll = curx-threshold;
-      }
-      if (newscroll < 0) newscroll = 0;
-      if (newscroll != xscroll_) {
-        xscroll_ = newscroll;
-        mu_p = 0; erase_cursor_only = 0;
-      }
-    }
-    lines++;
-    if (e >= value_+size_) break;
-    p = e+1;
+  int cur_line = lc->find(position());
+  Fl_Input_Line *cl = lc->line + cur_line;
+  p = value() + cl->start;
+  e = expand(p, buf);
+  int buf_line = cur_line; // line currently expanded into buf
+  curx = int(expandpos(p, value()+position(), buf, 0)+.5);
+  if (Fl::focus()==this && !was_up_down) up_down_pos = curx;
+  cury = cur_line*height;
+  int newscroll = xscroll_;
+  if (curx > newscroll+W-threshold) {
+    // figure out scrolling so there is space after the cursor:
+    newscroll = curx+threshold-W;
+    // figure out the furthest left we ever want to scroll:
+    if (cl->width < 0) cl->width = (float)expandpos(p, e, buf, 0);
+    int ex = int(cl->width)+4-W;
+    // use minimum of both amounts:
+    if (ex < newscroll) newscroll = ex;
+  } else if (curx < newscroll+threshold) {
+    newscroll = curx-threshold;
+  }
+  if (newscroll < 0) newscroll = 0;
+  if (newscroll != xscroll_) {
+    xscroll_ = newscroll;
+    mu_p = 0; erase_cursor_only = 0;
   }
 
   // adjust the scrolling:
@@ -319,16 +509,20 @@ void Fl_Input_::drawtext(int X, int Y, int W, int H) {
   fl_push_clip(X, Y, W, H);
   Fl_Color tc = active_r() ? textcolor() : fl_inactive(textcolor());
 
-  p = value();
+  // start with the line just above the visible area:
+  int i = 0;
+  if (yscroll_ > height) i = yscroll_/height - 1;
+  if (i >= lc->count) i = lc->count-1;
+  p = value() + lc->line[i].start;
   // visit each line and draw it:
   int desc = height-fl_descent();
   float xpos = (float)(X - xscroll_ + 1);
-  int ypos = -yscroll_;
+  int ypos = i*height - yscroll_;
   int ypos_cur = 0; //fix issue #270
   for (; ypos < H;) {
 
-    // re-expand line unless it is the last one calculated above:
-    if (lines>1) e = expand(p, buf);
+    // expand line unless it is the one calculated above:
+    if (i != buf_line) {e = expand(p, buf); buf_line = i;}
 
     if (ypos <= -height) goto CONTINUE; // clipped off top
 
@@ -422,9 +616,8 @@ void Fl_Input_::drawtext(int X, int Y, int W, int H) {
 
   CONTINUE:
     ypos += height;
-    if (e >= value_+size_) break;
-    if (*e == '\n' || *e == ' ') e++;
-    p = e;
+    if (i+1 >= lc->count) break;
+    p = value() + lc->line[++i].start;
   }
 
   // for minimal update, erase all lines below last one if necessary:
@@ -505,18 +698,10 @@ int Fl_Input_::line_end(int i) const {
   if (input_type() != FL_MULTILINE_INPUT) return size();
 
   if (wrap()) {
-    // go to the start of the paragraph:
-    int j = i;
-    while (j > 0 && index(j-1) != '\n') j--;
-    // now measure lines until we get past i, end of that line is real eol:
+    // the first line ending at or after i:
     setfont();
-    for (const char* p=value()+j; ;) {
-      char buf[MAXBUF];
-      p = expand(p, buf);
-      int k = (int) (p-value());
-      if (k >= i) return k;
-      p++;
-    }
+    Fl_Input_Line_Cache *lc = layout();
+    return lc->line[lc->find_end(i)].end;
   } else {
     while (i < size() && index(i) != '\n') i++;
     return i;
@@ -534,18 +719,15 @@ int Fl_Input_::line_end(int i) const {
 */
 int Fl_Input_::line_start(int i) const {
   if (input_type() != FL_MULTILINE_INPUT) return 0;
-  int j = i;
-  while (j > 0 && index(j-1) != '\n') j--;
   if (wrap()) {
-    // now measure lines until we get past i, start of that line is real eol:
+    // the first line ending at or after i:
     setfont();
-    for (const char* p=value()+j; ;) {
-      char buf[MAXBUF];
-      const char* e = expand(p, buf);
-      if ((int) (e-value()) >= i) return (int) (p-value());
-      p = e+1;
-    }
-  } else return j;
+    Fl_Input_Line_Cache *lc = layout();
+    return lc->line[lc->find_end(i)].start;
+  }
+  int j = i;
+  while (j > 0 && index(j-1) != '\n') j--;
+  return j;
 }
 
 static int strict_word_start(const char *s, int i, int itype) {
@@ -576,14 +758,13 @@ void Fl_Input_::handle_mouse(int X, int Y, int /*W*/, int /*H*/, int drag) {
 
   int theline = (input_type()==FL_MULTILINE_INPUT) ?
     (Fl::event_y()-Y+yscroll_)/fl_height() : 0;
+  Fl_Input_Line_Cache *lc = layout();
+  if (theline >= lc->count) theline = lc->count-1;
+  if (theline < 0) theline = 0;
 
   int newpos = 0;
-  for (p=value();; ) {
-    e = expand(p, buf);
-    theline--; if (theline < 0) break;
-    if (e >= value_+size_) break;
-    p = e+1;
-  }
+  p = value() + lc->line[theline].start;
+  e = expand(p, buf);
   const char *l, *r, *t; double f0 = Fl::event_x()-X+xscroll_;
   for (l = p, r = e; l<r; ) {
     double f;
@@ -852,29 +1033,32 @@ int Fl_Input_::replace(int b, int e, const char* text, int ilen) {
 
   // we must count UTF-8 *characters* to determine whether we can insert
   // the full text or only a part of it (and how much this would be)
-
-  int nchars = 0;       // characters in value() - deleted + inserted
-  const char *p = value_;
-  while (p < (char *)(value_+size_)) {
-    if (p == (char *)(value_+b)) { // skip removed part
-      p = (char *)(value_+e);
-      if (p >= (char *)(value_+size_)) break;
+  // unless the new text has no more bytes than characters allowed
+
+  if (size_ - (e-b) + ilen > maximum_size()) {
+    int nchars = 0;       // characters in value() - deleted + inserted
+    const char *p = value_;
+    while (p < (char *)(value_+size_)) {
+      if (p == (char *)(value_+b)) { // skip removed part
+        p = (char *)(value_+e);
+        if (p >= (char *)(value_+size_)) break;
+      }
+      int ulen = fl_utf8len(*p);
+      if (ulen < 1) ulen = 1; // invalid UTF-8 character: count as 1
+      nchars++;
+      p += ulen;
     }
-    int ulen = fl_utf8len(*p);
-    if (ulen < 1) ulen = 1; // invalid UTF-8 character: count as 1
-    nchars++;
-    p += ulen;
-  }
-  int nlen = 0;         // length (in bytes) to be inserted
-  p = text;
-  while (p < (char *)(text+ilen) && nchars < maximum_size()) {
-    int ulen = fl_utf8len(*p);
-    if (ulen < 1) ulen = 1; // invalid UTF-8 character: count as 1
-    nchars++;
-    p += ulen;
-    nlen += ulen;
+    int nlen = 0;         // length (in bytes) to be inserted
+    p = text;
+    while (p < (char *)(text+ilen) && nchars < maximum_size()) {
+      int ulen = fl_utf8len(*p);
+      if (ulen < 1) ulen = 1; // invalid UTF-8 character: count as 1
+      nchars++;
+      p += ulen;
+      nlen += ulen;
+    }
+    ilen = nlen;
   }
-  ilen = nlen;
 
   put_in_buffer(size_+ilen);
 
@@ -913,6 +1097,7 @@ int Fl_Input_::replace(int b, int e, const char* text, int ilen) {
     memcpy(buffer+b, text, ilen);
     size_ += ilen;
   }
+  lines_->changed(value_, size_, input_type()==FL_MULTILINE_INPUT, b, e, ilen);
   om = mark_;
   op = position_;
   mark_ = position_ = undo_->undoat = b+ilen;
@@ -978,6 +1163,8 @@ int Fl_Input_::undo() {
     size_ -= xlen;
   }
 
+  lines_->changed(value_, size_, input_type()==FL_MULTILINE_INPUT, b1, b1+xlen, ilen);
+
   undo_->undocut = xlen;
   if (xlen) undo_->undoyankcut = xlen;
   undo_->undoinsert = ilen;
@@ -1169,6 +1356,7 @@ Fl_Input_::Fl_Input_(int X, int Y, int W, int H, const char* l)
   maximum_size_ = 32767;
   shortcut_ = 0;
   undo_ = new Fl_Input_Undo_Action();
+  lines_ = new Fl_Input_Line_Cache();
   set_flag(SHORTCUT_LABEL);
   set_flag(MAC_USE_ACCENTS_MENU);
   set_flag(NEEDS_KEYBOARD);
@@ -1237,6 +1425,7 @@ int Fl_Input_::static_value(const char* str, int len) {
   clear_changed();
   undo_->clear();
   if (str == value_ && len == size_) return 0;
+  lines_->valid = 0;
   if (len) { // non-empty new value:
     if (xscroll_ || yscroll_) {
       xscroll_ = yscroll_ = 0;
@@ -1337,6 +1526,7 @@ void Fl_Input_::resize(int X, int Y, int W, int H) {
 */
 Fl_Input_::~Fl_Input_() {
   delete undo_;
+  delete lines_;
   if (bufsize) free((void*)buffer);
 }
 
@@ -24,6 +24,7 @@
 #include <ctype.h>
 #include <stdarg.h>
 #include "Fl_System_Driver.H"
+#include "Fl_Shortcut_Registry.H"
 
 #import <Cocoa/Cocoa.h> // keep this after include of Fl_MacOS_Sys_Menu_Bar_Driver.H because of check() conflict
 
@@ -424,7 +425,7 @@ static int process_sys_menu_shortcuts(int event)
 {
   if (event != FL_SHORTCUT || !fl_sys_menu_bar || Fl::modal()) return 0;
   // is the last event the shortcut of an item of the fl_sys_menu_bar menu ?
-  const Fl_Menu_Item *item = fl_sys_menu_bar->menu()->test_shortcut();
+  const Fl_Menu_Item *item = Fl_Shortcut_Registry::find(fl_sys_menu_bar);
   if (!item) return 0;
   if (item->visible()) // have the system menu process the shortcut, highlighting the corresponding menu
     [[NSApp mainMenu] performKeyEquivalent:[NSApp currentEvent]];
@@ -123,6 +123,7 @@ class menuwindow : public Fl_Menu_Window {
   void drawentry(const Fl_Menu_Item*, int i, int erase);
   int handle_part1(int);
   int handle_part2(int e, int ret);
+  void measure_items(int from, int to, int &W, int &hotModsw, int &hotKeysw);
   static Fl_Window *parent_;
 public:
   menutitle* title;
@@ -133,6 +134,17 @@ public:
   int drawn_selected;   // last redraw has this selected
   int shortcutWidth;
   const Fl_Menu_Item* menu;
+  const Fl_Menu_Item** items;     // the items shown, matching filter
+  const Fl_Menu_Item** all_items; // all visible items
+  int all_count;
+  char lazy;                      // only the items on the screen were measured
+  char filter[64];                // type-ahead text of lazy menus
+  int filter_len;
+  /** Returns item \p n of the menu, or NULL. */
+  const Fl_Menu_Item* item(int n) const {
+    return (n >= 0 && n < numitems) ? items[n] : 0;
+  }
+  void filter_items();
   menuwindow(const Fl_Menu_Item* m, int X, int Y, int W, int H,
              const Fl_Menu_Item* picked, const Fl_Menu_Item* title,
              int menubar = 0, int menubar_title = 0, int right_edge = 0);
@@ -343,6 +355,17 @@ menuwindow::menuwindow(const Fl_Menu_Item* m, int X, int Y, int Wp, int Hp,
   }
   numitems = j;}
 
+  // index the items, so that item(n) does not have to walk the menu:
+  all_count = numitems;
+  all_items = items = numitems ? new const Fl_Menu_Item*[numitems] : 0;
+  {
+    const Fl_Menu_Item* m1 = m;
+    for (int j = 0; j < numitems; j++, m1 = m1->next()) items[j] = m1;
+  }
+  lazy = Fl::menu_lazy_items() > 0 && numitems > Fl::menu_lazy_items();
+  filter_len = 0;
+  filter[0] = 0;
+
   if (menubar) {
     itemheight = 0;
     title = 0;
@@ -357,32 +380,16 @@ menuwindow::menuwindow(const Fl_Menu_Item* m, int X, int Y, int Wp, int Hp,
   int Htitle = 0;
   if (t) Wtitle = t->measure(&Htitle, button) + 12;
   int W = 0;
-  if (m) for (; m->text; m = m->next()) {
-    int hh;
-    int w1 = m->measure(&hh, button);
-    if (hh+Fl::menu_linespacing()>itemheight) itemheight = hh+Fl::menu_linespacing();
-    if (m->flags&(FL_SUBMENU|FL_SUBMENU_POINTER))
-      w1 += FL_NORMAL_SIZE;
-    if (w1 > W) W = w1;
-    // calculate the maximum width of all shortcuts
-    if (m->shortcut_) {
-      // s is a pointer to the UTF-8 string for the entire shortcut
-      // k points only to the key part (minus the modifier keys)
-      const char *k, *s = fl_shortcut_label(m->shortcut_, &k);
-      if (fl_utf_nb_char((const unsigned char*)k, (int) strlen(k))<=4) {
-        // a regular shortcut has a right-justified modifier followed by a left-justified key
-        w1 = int(fl_width(s, (int) (k-s)));
-        if (w1 > hotModsw) hotModsw = w1;
-        w1 = int(fl_width(k))+4;
-        if (w1 > hotKeysw) hotKeysw = w1;
-      } else {
-        // a shortcut with a long modifier is right-justified to the menu
-        w1 = int(fl_width(s))+4;
-        if (w1 > (hotModsw+hotKeysw)) {
-          hotModsw = w1-hotKeysw;
-        }
-      }
-    }
+  if (lazy) {
+    // measure only the items that can be on the screen when the menu
+    // pops up, using the height of the first and the selected item:
+    measure_items(0, 1, W, hotModsw, hotKeysw);
+    if (selected > 0) measure_items(selected, selected+1, W, hotModsw, hotKeysw);
+    int n = scr_h/itemheight + 1;
+    if (selected >= 0) measure_items(selected-n, selected+n, W, hotModsw, hotKeysw);
+    else measure_items(0, n, W, hotModsw, hotKeysw);
+  } else {
+    measure_items(0, numitems, W, hotModsw, hotKeysw);
   }
   shortcutWidth = hotKeysw;
   if (selected >= 0 && !Wp) X -= W/2;
@@ -443,9 +450,84 @@ menuwindow::menuwindow(const Fl_Menu_Item* m, int X, int Y, int Wp, int Hp,
   }
 }
 
+// Measures items from to to-1, and updates itemheight and the widths
+// of the items and their shortcuts:
+void menuwindow::measure_items(int from, int to, int &W, int &hotModsw, int &hotKeysw) {
+  if (from < 0) from = 0;
+  if (to > numitems) to = numitems;
+  for (int i = from; i < to; i++) {
+    const Fl_Menu_Item* m = items[i];
+    int hh;
+    int w1 = m->measure(&hh, button);
+    if (hh+Fl::menu_linespacing()>itemheight) itemheight = hh+Fl::menu_linespacing();
+    if (m->flags&(FL_SUBMENU|FL_SUBMENU_POINTER))
+      w1 += FL_NORMAL_SIZE;
+    if (w1 > W) W = w1;
+    // calculate the maximum width of all shortcuts
+    if (m->shortcut_) {
+      // s is a pointer to the UTF-8 string for the entire shortcut
+      // k points only to the key part (minus the modifier keys)
+      const char *k, *s = fl_shortcut_label(m->shortcut_, &k);
+      if (fl_utf_nb_char((const unsigned char*)k, (int) strlen(k))<=4) {
+        // a regular shortcut has a right-justified modifier followed by a left-justified key
+        w1 = int(fl_width(s, (int) (k-s)));
+        if (w1 > hotModsw) hotModsw = w1;
+        w1 = int(fl_width(k))+4;
+        if (w1 > hotKeysw) hotKeysw = w1;
+      } else {
+        // a shortcut with a long modifier is right-justified to the menu
+        w1 = int(fl_width(s))+4;
+        if (w1 > (hotModsw+hotKeysw)) {
+          hotModsw = w1-hotKeysw;
+        }
+      }
+    }
+  }
+}
+
+// Returns non-zero if the label of item m contains the first n characters
+// of f, ignoring case:
+static int filter_match(const Fl_Menu_Item* m, const char* f, int n) {
+  if (m->labeltype_ == _FL_MULTI_LABEL || m->labeltype_ == _FL_ICON_LABEL ||
+      m->labeltype_ == _FL_IMAGE_LABEL || !m->text)
+    return 0;
+  for (const char* t = m->text; *t; t += fl_utf8len1(*t)) {
+    if (!fl_utf_strncasecmp(t, f, n)) return 1;
+  }
+  return 0;
+}
+
+// Shows only the items that contain the type-ahead text:
+void menuwindow::filter_items() {
+  if (items != all_items) delete[] items;
+  if (!filter_len) {
+    items = all_items;
+    numitems = all_count;
+  } else {
+    int n = fl_utf_nb_char((const unsigned char*)filter, filter_len);
+    items = new const Fl_Menu_Item*[all_count];
+    numitems = 0;
+    for (int i = 0; i < all_count; i++)
+      if (filter_match(all_items[i], filter, n)) items[numitems++] = all_items[i];
+  }
+  selected = drawn_selected = -1;
+  int BW = Fl::box_dx(box());
+  size(w(), (numitems ? itemheight*numitems : itemheight)-Fl::menu_linespacing()+2*BW+3);
+  // a long menu may have been scrolled far off the screen:
+  int sx, sy, sw, sh;
+  Fl_Window_Driver::driver(this)->menu_window_area(sx, sy, sw, sh);
+  int Y = y();
+  if (Y+h() > sy+sh) Y = sy+sh-h();
+  if (Y < sy) Y = sy;
+  if (Y != y()) Fl_Window_Driver::driver(this)->reposition_menu_window(x(), Y);
+  redraw();
+}
+
 menuwindow::~menuwindow() {
   hide();
   delete title;
+  if (items != all_items) delete[] items;
+  delete[] all_items;
 }
 
 void menuwindow::position(int X, int Y) {
@@ -543,13 +625,27 @@ void menuwindow::draw() {
     }
     fl_draw_box(box(), 0, 0, w(), h(), button ? button->color() : color());
     if (menu) {
-      const Fl_Menu_Item* m; int j;
-      for (m=menu->first(), j=0; m->text; j++, m = m->next()) drawentry(m, j, 0);
+      int first = 0, last = numitems;
+      if (lazy && itemheight) {
+        // only draw the items that can be on the screen, with a margin of a
+        // screen height for a window that is just being moved by autoscroll():
+        int BW = Fl::box_dx(box());
+        int X, Y, W, H, sx, sy, sw, sh;
+        fl_clip_box(0, 0, w(), h(), X, Y, W, H);
+        Fl_Window_Driver::driver(this)->menu_window_area(sx, sy, sw, sh);
+        if (Y < sy-sh-y()) { H -= sy-sh-y()-Y; Y = sy-sh-y(); }
+        if (Y+H > sy+2*sh-y()) H = sy+2*sh-y()-Y;
+        first = (Y-BW-1)/itemheight - 1;
+        last = (Y+H-BW-1)/itemheight + 2;
+        if (first < 0) first = 0;
+        if (last > numitems) last = numitems;
+      }
+      for (int j = first; j < last; j++) drawentry(items[j], j, 0);
     }
   } else {
     if (damage() & FL_DAMAGE_CHILD && selected!=drawn_selected) { // change selection
-      drawentry(menu->next(drawn_selected), drawn_selected, 1);
-      drawentry(menu->next(selected), selected, 1);
+      drawentry(item(drawn_selected), drawn_selected, 1);
+      drawentry(item(selected), selected, 1);
     }
   }
   drawn_selected = selected;
@@ -656,7 +752,7 @@ static inline void setitem(const Fl_Menu_Item* i, int m, int n) {
 
 static void setitem(int m, int n) {
   menustate &pp = *p;
-  pp.current_item = (n >= 0) ? pp.p[m]->menu->next(n) : 0;
+  pp.current_item = (n >= 0) ? pp.p[m]->item(n) : 0;
   pp.menu_number = m;
   pp.item_number = n;
 }
@@ -669,7 +765,7 @@ static int forward(int menu) { // go to next item in menu menu if possible
   menuwindow &m = *(pp.p[menu]);
   int item = (menu == pp.menu_number) ? pp.item_number : m.selected;
   while (++item < m.numitems) {
-    const Fl_Menu_Item* m1 = m.menu->next(item);
+    const Fl_Menu_Item* m1 = m.item(item);
     if (m1->activevisible()) {setitem(m1, menu, item); return 1;}
   }
   return 0;
@@ -684,12 +780,73 @@ static int backward(int menu) { // previous item in menu menu if possible
   int item = (menu == pp.menu_number) ? pp.item_number : m.selected;
   if (item < 0) item = m.numitems;
   while (--item >= 0) {
-    const Fl_Menu_Item* m1 = m.menu->next(item);
+    const Fl_Menu_Item* m1 = m.item(item);
     if (m1->activevisible()) {setitem(m1, menu, item); return 1;}
   }
   return 0;
 }
 
+// Picks the item of any open menu whose shortcut is the current event:
+static int menu_shortcut() {
+  menustate &pp = *p;
+  for (int mymenu = pp.nummenus; mymenu--;) {
+    menuwindow &mw = *(pp.p[mymenu]);
+    int item; const Fl_Menu_Item* m = mw.menu->find_shortcut(&item);
+    if (m) {
+      if (mw.items != mw.all_items) { // filtered, find the shown item
+        for (item = mw.numitems; item-- && mw.items[item] != m;) {}
+        if (item < 0) continue;
+      }
+      setitem(m, mymenu, item);
+      if (!m->submenu()) pp.state = DONE_STATE;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Returns non-zero if type-ahead text was typed into the current menu:
+static int type_ahead_started() {
+  menustate &pp = *p;
+  int menu = pp.menu_number < 0 ? 0 : pp.menu_number;
+  return menu < pp.nummenus && pp.p[menu]->filter_len > 0;
+}
+
+// Type-ahead filtering of lazy menus: adds the text of the current event
+// to the filter of the current menu, or removes the last character
+// if erase is set. Returns 1 if the event was used.
+static int type_ahead(int erase) {
+  menustate &pp = *p;
+  int menu = pp.menu_number < 0 ? 0 : pp.menu_number;
+  if (menu >= pp.nummenus || (pp.menubar && menu == 0)) return 0;
+  menuwindow &mw = *(pp.p[menu]);
+  if (!mw.lazy) return 0;
+  if (erase) {
+    if (!mw.filter_len) return 0;
+    while (mw.filter_len > 0 && (mw.filter[--mw.filter_len] & 0xc0) == 0x80) {}
+  } else {
+    int n = Fl::event_length();
+    const char *t = Fl::event_text();
+    if (!n || (uchar)t[0] < ' ' || t[0] == 0x7f ||
+        (Fl::event_state() & (FL_CTRL|FL_ALT|FL_META)))
+      return 0;
+    // shortcuts of the items take precedence:
+    if (menu_shortcut()) return 1;
+    if (mw.filter_len + n >= (int)sizeof(mw.filter)) return 1;
+    memcpy(mw.filter + mw.filter_len, t, n);
+    mw.filter_len += n;
+  }
+  mw.filter[mw.filter_len] = 0;
+  // close submenus and select the first item that matches:
+  while (pp.nummenus > menu+1) delete pp.p[--pp.nummenus];
+  mw.filter_items();
+  pp.menu_number = menu;
+  pp.item_number = -1;
+  if (!forward(menu)) setitem(0, menu, -1);
+  mw.selected = pp.item_number;
+  return 1;
+}
+
 int menuwindow::handle(int e) {
   /* In FLTK 1.3.4, the equivalent of handle_part2() is called for the Mac OS and X11 platforms
    and "svn blame" shows it is here to fix STR #449.
@@ -753,6 +910,7 @@ int menuwindow::handle_part1(int e) {
   case FL_KEYBOARD:
     switch (Fl::event_key()) {
     case FL_BackSpace:
+      if (type_ahead(1)) return 1;
     BACKTAB:
       if (!backward(pp.menu_number)) {
         pp.item_number = -1;
@@ -790,29 +948,25 @@ int menuwindow::handle_part1(int e) {
       else if (pp.menu_number>0)
         setitem(pp.menu_number-1, pp.p[pp.menu_number-1]->selected);
       return 1;
+    case ' ':
+      // a space continues the type-ahead text once typing has started
+      if (type_ahead_started() && type_ahead(0)) return 1;
+      /* FALLTHROUGH */
     case FL_Enter:
     case FL_KP_Enter:
-    case ' ':
       pp.state = DONE_STATE;
       return 1;
     case FL_Escape:
       setitem(0, -1, 0);
       pp.state = DONE_STATE;
       return 1;
+    default:
+      if (type_ahead(0)) return 1;
+      break;
     }
     break;
   case FL_SHORTCUT:
-    {
-      for (int mymenu = pp.nummenus; mymenu--;) {
-        menuwindow &mw = *(pp.p[mymenu]);
-        int item; const Fl_Menu_Item* m = mw.menu->find_shortcut(&item);
-        if (m) {
-          setitem(m, mymenu, item);
-          if (!m->submenu()) pp.state = DONE_STATE;
-          return 1;
-        }
-      }
-    }
+    if (menu_shortcut()) return 1;
     break;
   case FL_MOVE: {
     static int use_part1_extra = Fl::screen_driver()->need_menu_handle_part1_extra();
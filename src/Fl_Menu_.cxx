@@ -23,6 +23,7 @@
 
 #include <FL/Fl.H>
 #include <FL/Fl_Menu_.H>
+#include "Fl_Shortcut_Registry.H"
 #include "flstring.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -309,6 +310,56 @@ const Fl_Menu_Item* Fl_Menu_::picked(const Fl_Menu_Item* v) {
   return v;
 }
 
+/**
+  Returns the menu item with the entered shortcut (key value).
+
+  This searches the complete menu() for a shortcut that matches the
+  entered key value.  It must be called for a FL_KEYBOARD or FL_SHORTCUT
+  event.
+
+  The items are found with an index of the shortcuts of the menu that is
+  built the first time a shortcut is tested after the menu was changed,
+  so that this does not depend on the size of the menu. If the index
+  finds no item, or if the shortcut of an item was changed directly, or
+  if the menu includes submenus with FL_SUBMENU_POINTER, all items are
+  searched as by Fl_Menu_Item::test_shortcut().
+
+  If a match is found, the menu's callback will be called.
+
+  \return matched Fl_Menu_Item or NULL.
+  \see shortcuts_changed()
+*/
+const Fl_Menu_Item* Fl_Menu_::test_shortcut() {
+  return picked(Fl_Shortcut_Registry::find(this));
+}
+
+/**
+  Tells the menu that the shortcuts of its items have changed.
+
+  The menu keeps an index of the shortcuts of its items, which is updated
+  by all methods of Fl_Menu_ that change the menu. Shortcuts of items that
+  were changed directly are still found, but by searching all items, until
+  the index is rebuilt. Call this after you changed the shortcut or the
+  FL_SUBMENU flag of items of menu() directly, so that the index is
+  rebuilt for the next shortcut.
+  \version 1.4.0
+*/
+void Fl_Menu_::shortcuts_changed() {
+  Fl_Shortcut_Registry::menu_changed(this);
+}
+
+/** Changes the shortcut of item \p i to \p s. */
+void Fl_Menu_::shortcut(int i, int s) {
+  menu_[i].shortcut(s);
+  shortcuts_changed();
+}
+
+/** Sets the flags of item i.  For a list of the flags, see Fl_Menu_Item.  */
+void Fl_Menu_::mode(int i, int fl) {
+  menu_[i].flags = fl;
+  shortcuts_changed();
+}
+
 /* Scans an array of Fl_Menu_Item's that begins at start, searching for item.
  Returns NULL if item is not found.
  If item is present, returns start, unless item belongs to an
@@ -387,6 +438,7 @@ Fl_Menu_::Fl_Menu_(int X,int Y,int W,int H,const char* l)
   box(FL_UP_BOX);
   when(FL_WHEN_RELEASE_ALWAYS);
   value_ = menu_ = 0;
+  shortcut_index_ = 0;
   alloc = 0;
   selection_color(FL_SELECTION_COLOR);
   textfont(FL_HELVETICA);
@@ -440,6 +492,7 @@ void Fl_Menu_::copy(const Fl_Menu_Item* m, void* ud) {
 
 Fl_Menu_::~Fl_Menu_() {
   clear();
+  Fl_Shortcut_Registry::menu_deleted(this);
 }
 
 // Fl_Menu::add() uses this to indicate the owner of the dynamically-
@@ -464,6 +517,7 @@ void Fl_Menu_::clear() {
   }
   menu_ = 0;
   value_ = 0;
+  shortcuts_changed();
 }
 
 /**
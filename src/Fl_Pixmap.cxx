@@ -27,6 +27,7 @@
 #include <FL/Fl_Widget.H>
 #include <FL/Fl_Menu_Item.H>
 #include <FL/Fl_Pixmap.H>
+#include "Fl_System_Driver.H"
 
 #include <stdio.h>
 #include "flstring.h"
@@ -47,16 +48,78 @@ void Fl_Pixmap::draw(int XP, int YP, int WP, int HP, int cx, int cy) {
   fl_graphics_driver->draw_pixmap(this, XP, YP, WP, HP, cx, cy);
 }
 
+// Pixmaps waiting to be decoded by Fl_Pixmap::decode()
+static Fl_Pixmap **decode_queue = 0;
+static int decode_first = 0, decode_count = 0, decode_alloc = 0;
+
+static void unqueue(Fl_Pixmap *pxm) {
+  for (int i = decode_first; i < decode_count; i++) {
+    if (decode_queue[i] == pxm) decode_queue[i] = 0;
+  }
+}
+
 /**
   The destructor frees all memory and server resources that are used by
   the pixmap.
 */
 Fl_Pixmap::~Fl_Pixmap() {
+  if (decode_count) unqueue(this);
   uncache();
   delete_data();
 }
 
+/**
+  Decodes the pixels of a set of pixmaps while the application is idle.
+
+  Call this at startup with the icons of the application, so that drawing
+  them for the first time, or converting them to Fl_RGB_Image, doesn't
+  need to parse their XPM data. The pixmaps are decoded in time slices of
+  a few milliseconds while no events are waiting, and a pixmap that is
+  drawn before its turn is decoded when it is drawn.
+
+  The decoded pixels use as much memory as an Fl_RGB_Image of the same size
+  and are freed by uncache() and when the pixmap is deleted. Deleting a
+  pixmap that waits to be decoded is safe.
+
+  \param[in] pixmaps  array of pixmaps, NULL entries are ignored
+  \param[in] n        number of entries in \p pixmaps
+  \version 1.4.0
+*/
+void Fl_Pixmap::decode(Fl_Pixmap * const *pixmaps, int n) {
+  if (n <= 0) return;
+  if (decode_first == decode_count) decode_first = decode_count = 0;
+  if (decode_count + n > decode_alloc) {
+    decode_alloc = decode_count + n + 16;
+    decode_queue = (Fl_Pixmap **)realloc(decode_queue, decode_alloc * sizeof(Fl_Pixmap *));
+  }
+  for (int i = 0; i < n; i++) {
+    if (pixmaps[i] && !pixmaps[i]->rgba_) decode_queue[decode_count++] = pixmaps[i];
+  }
+  if (decode_first < decode_count && !Fl::has_idle(decode_cb_))
+    Fl::add_idle(decode_cb_);
+}
+
+void Fl_Pixmap::decode_cb_(void *) {
+  double end = Fl::system_driver()->monotonic_time() + 0.005;
+  while (decode_first < decode_count) {
+    Fl_Pixmap *pxm = decode_queue[decode_first++];
+    if (pxm) pxm->rgba_data_();
+    if (Fl::system_driver()->monotonic_time() >= end) break;
+  }
+  if (decode_first == decode_count) {
+    Fl::remove_idle(decode_cb_);
+    free(decode_queue);
+    decode_queue = 0;
+    decode_first = decode_count = decode_alloc = 0;
+  }
+}
+
 void Fl_Pixmap::uncache() {
+  if (rgba_) {
+    delete[] rgba_;
+    rgba_ = 0;
+  }
+
   if (id_) {
     Fl_Graphics_Driver::default_driver().uncache_pixmap(id_);
     id_ = 0;
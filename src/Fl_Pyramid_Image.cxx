@@ -0,0 +1,318 @@
+//
+// Tiled multi-resolution image code for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <FL/Fl.H>
+#include <FL/Fl_Pyramid_Image.H>
+#include <FL/fl_draw.H>
+#include <string.h>
+
+// One decoded tile, linked in a hash chain and in the LRU list
+struct Fl_Pyramid_Tile {
+  int level, col, row;
+  unsigned drawn;               // draw_count_ of the last draw() that drew it
+  Fl_RGB_Image *image;
+  Fl_Pyramid_Tile *hash_next, *prev, *next;
+};
+
+static inline unsigned tile_hash(int level, int col, int row) {
+  return (unsigned)level * 73856093U ^ (unsigned)col * 19349663U ^ (unsigned)row * 83492791U;
+}
+
+static inline size_t tile_bytes(const Fl_Pyramid_Tile *t) {
+  return (size_t)t->image->data_w() * t->image->data_h() * t->image->d();
+}
+
+/**
+  Creates an image of \p W x \p H pixels with \p D bytes per pixel whose
+  tiles are supplied by the callback \p provider.
+  \param W, H the size of the image at full resolution
+  \param D the number of bytes per pixel, 1 to 4, as for Fl_RGB_Image
+  \param tile_size the width and height of the tiles, rounded up to an
+    even number of at least 16 pixels
+  \param provided_levels the number of pyramid levels supplied by
+    \p provider, at least 1. Other levels are computed by FLTK.
+  \param provider the callback that decodes tiles
+  \param data user data passed to \p provider
+*/
+Fl_Pyramid_Image::Fl_Pyramid_Image(int W, int H, int D, int tile_size, int provided_levels,
+                                   Fl_Tile_Provider provider, void *data)
+: Fl_Image(W, H, D) {
+  provider_ = provider;
+  provider_data_ = data;
+  if (tile_size < 16) tile_size = 16;
+  tile_size_ = (tile_size + 1) & ~1;
+  cache_limit_ = 64 * 1024 * 1024;
+  cache_used_ = 0;
+  hash_size_ = 64;
+  hash_ = new Fl_Pyramid_Tile*[hash_size_];
+  memset(hash_, 0, hash_size_ * sizeof(Fl_Pyramid_Tile*));
+  tile_count_ = 0;
+  lru_first_ = lru_last_ = 0;
+  draw_count_ = 0;
+  if (!provider || D < 1 || D > 4 || W <= 0 || H <= 0) {
+    w(0); h(0); d(0);
+  }
+  levels_ = 1;
+  while (level_w(levels_ - 1) > tile_size_ || level_h(levels_ - 1) > tile_size_)
+    levels_++;
+  if (provided_levels < 1) provided_levels = 1;
+  provided_levels_ = provided_levels < levels_ ? provided_levels : levels_;
+}
+
+/** Deletes the image and all cached tiles. */
+Fl_Pyramid_Image::~Fl_Pyramid_Image() {
+  clear_cache();
+  delete[] hash_;
+}
+
+// Width and height of a pyramid level, in pixels
+int Fl_Pyramid_Image::level_w(int level) const {
+  return (data_w() + (1 << level) - 1) >> level;
+}
+
+int Fl_Pyramid_Image::level_h(int level) const {
+  return (data_h() + (1 << level) - 1) >> level;
+}
+
+/**
+  Creates an image that draws the same tiles with a drawing size of
+  \p W x \p H. The tile cache is not shared.
+*/
+Fl_Image *Fl_Pyramid_Image::copy(int W, int H) const {
+  Fl_Pyramid_Image *img = new Fl_Pyramid_Image(data_w(), data_h(), d(), tile_size_,
+                                               provided_levels_, provider_, provider_data_);
+  img->cache_limit(cache_limit_);
+  img->scale(W, H, 0, 1);
+  return img;
+}
+
+/**
+  Sets the maximum size of the decoded tiles kept in memory, in bytes.
+  The default is 64 MB. The tiles drawn by the last call of draw() are
+  kept even if they need more memory.
+*/
+void Fl_Pyramid_Image::cache_limit(size_t bytes) {
+  cache_limit_ = bytes;
+  trim_cache();
+}
+
+/**
+  Deletes all cached tiles. Call this when the pixels supplied by the
+  Fl_Tile_Provider callback have changed.
+*/
+void Fl_Pyramid_Image::clear_cache() {
+  while (lru_first_) remove_tile(lru_first_);
+}
+
+/**
+  Releases the graphics driver's copies of all cached tiles.
+  The decoded tiles stay in the cache.
+*/
+void Fl_Pyramid_Image::uncache() {
+  for (Fl_Pyramid_Tile *t = lru_first_; t; t = t->next)
+    t->image->uncache();
+}
+
+Fl_Pyramid_Tile *Fl_Pyramid_Image::find_tile(int level, int col, int row) const {
+  Fl_Pyramid_Tile *t = hash_[tile_hash(level, col, row) & (hash_size_ - 1)];
+  while (t && (t->level != level || t->col != col || t->row != row))
+    t = t->hash_next;
+  return t;
+}
+
+void Fl_Pyramid_Image::add_tile(Fl_Pyramid_Tile *t) {
+  if (tile_count_ >= hash_size_) {
+    // grow the hash table
+    int size = hash_size_ * 2;
+    Fl_Pyramid_Tile **h = new Fl_Pyramid_Tile*[size];
+    memset(h, 0, size * sizeof(Fl_Pyramid_Tile*));
+    for (Fl_Pyramid_Tile *p = lru_first_; p; p = p->next) {
+      unsigned i = tile_hash(p->level, p->col, p->row) & (size - 1);
+      p->hash_next = h[i];
+      h[i] = p;
+    }
+    delete[] hash_;
+    hash_ = h;
+    hash_size_ = size;
+  }
+  unsigned i = tile_hash(t->level, t->col, t->row) & (hash_size_ - 1);
+  t->hash_next = hash_[i];
+  hash_[i] = t;
+  t->prev = lru_last_;
+  t->next = 0;
+  if (lru_last_) lru_last_->next = t;
+  else lru_first_ = t;
+  lru_last_ = t;
+  tile_count_++;
+  cache_used_ += tile_bytes(t);
+}
+
+void Fl_Pyramid_Image::remove_tile(Fl_Pyramid_Tile *t) {
+  Fl_Pyramid_Tile **p = hash_ + (tile_hash(t->level, t->col, t->row) & (hash_size_ - 1));
+  while (*p != t) p = &(*p)->hash_next;
+  *p = t->hash_next;
+  if (t->prev) t->prev->next = t->next;
+  else lru_first_ = t->next;
+  if (t->next) t->next->prev = t->prev;
+  else lru_last_ = t->prev;
+  tile_count_--;
+  cache_used_ -= tile_bytes(t);
+  delete t->image; // also releases the graphics driver's copy
+  delete t;
+}
+
+// Drops the least recently used tiles that were not drawn by the current
+// or last draw() until \p room more bytes fit into the cache
+void Fl_Pyramid_Image::trim_cache(size_t room) {
+  Fl_Pyramid_Tile *t = lru_first_;
+  while (t && cache_used_ + room > cache_limit_) {
+    Fl_Pyramid_Tile *next = t->next;
+    if (t->drawn != draw_count_) remove_tile(t);
+    t = next;
+  }
+}
+
+// Averages 2x2 pixel blocks of src into dst; a missing last column or
+// row of src is replaced by the one before it
+static void downsample(const Fl_RGB_Image *src, uchar *dst, int dld) {
+  const uchar *s = (const uchar *)src->data()[0];
+  int sw = src->data_w(), sh = src->data_h(), D = src->d();
+  int sld = sw * D;
+  for (int y = 0; y < (sh + 1) / 2; y++) {
+    const uchar *s0 = s + 2 * y * sld;
+    const uchar *s1 = (2 * y + 1 < sh) ? s0 + sld : s0;
+    uchar *p = dst + y * dld;
+    for (int x = 0; x < (sw + 1) / 2; x++) {
+      int x0 = 2 * x * D;
+      int x1 = (2 * x + 1 < sw) ? x0 + D : x0;
+      for (int k = 0; k < D; k++)
+        *p++ = (uchar)((s0[x0 + k] + s0[x1 + k] + s1[x0 + k] + s1[x1 + k] + 2) >> 2);
+    }
+  }
+}
+
+// Fills buf with the tw x th pixels of a tile, from the provider or, for
+// levels the provider does not supply, from the 4 tiles of the level below
+int Fl_Pyramid_Image::fill_tile(int level, int col, int row, uchar *buf, int tw, int th) {
+  int ld = tw * d();
+  if (level < provided_levels_)
+    return provider_(provider_data_, level, col, row, buf, tw, th, ld);
+  int half = tile_size_ / 2;
+  int lw = level_w(level - 1), lh = level_h(level - 1);
+  for (int j = 0; j < 2; j++) {
+    int r = 2 * row + j;
+    if (r * tile_size_ >= lh) break;
+    for (int i = 0; i < 2; i++) {
+      int c = 2 * col + i;
+      if (c * tile_size_ >= lw) break;
+      Fl_Pyramid_Tile *t = get_tile(level - 1, c, r);
+      if (!t) return 1;
+      downsample(t->image, buf + j * half * ld + i * half * d(), ld);
+    }
+  }
+  return 0;
+}
+
+// Returns a tile from the cache, or decodes and caches it. The tile
+// stays valid until the next call.
+Fl_Pyramid_Tile *Fl_Pyramid_Image::get_tile(int level, int col, int row) {
+  Fl_Pyramid_Tile *t = find_tile(level, col, row);
+  if (t) {
+    if (t != lru_last_) { // make it the most recently used tile
+      if (t->prev) t->prev->next = t->next;
+      else lru_first_ = t->next;
+      t->next->prev = t->prev;
+      t->prev = lru_last_;
+      t->next = 0;
+      lru_last_->next = t;
+      lru_last_ = t;
+    }
+    return t;
+  }
+  int tw = level_w(level) - col * tile_size_;
+  int th = level_h(level) - row * tile_size_;
+  if (tw > tile_size_) tw = tile_size_;
+  if (th > tile_size_) th = tile_size_;
+  uchar *buf = new uchar[tw * th * d()];
+  if (fill_tile(level, col, row, buf, tw, th)) {
+    delete[] buf;
+    return 0;
+  }
+  Fl_RGB_Image *img = new Fl_RGB_Image(buf, tw, th, d());
+  img->alloc_array = 1;
+  trim_cache((size_t)tw * th * d()); // before adding, so that the new tile stays
+  t = new Fl_Pyramid_Tile;
+  t->level = level;
+  t->col = col;
+  t->row = row;
+  t->drawn = 0;
+  t->image = img;
+  add_tile(t);
+  return t;
+}
+
+/**
+  Draws the part of the image inside the box \p X, \p Y, \p W, \p H,
+  with the origin of the image at \p X - \p cx, \p Y - \p cy.
+  Only the tiles that intersect this box and the current clip region
+  are decoded and drawn.
+*/
+void Fl_Pyramid_Image::draw(int X, int Y, int W, int H, int cx, int cy) {
+  if (fail() || W <= 0 || H <= 0) return;
+  int cX, cY, cW, cH;
+  fl_clip_box(X, Y, W, H, cX, cY, cW, cH);
+  // visible part, in image units relative to the image origin
+  int u0 = cX - X + cx, v0 = cY - Y + cy;
+  int u1 = u0 + cW, v1 = v0 + cH;
+  if (u0 < 0) u0 = 0;
+  if (v0 < 0) v0 = 0;
+  if (u1 > w()) u1 = w();
+  if (v1 > h()) v1 = h();
+  if (u0 >= u1 || v0 >= v1) return;
+  // use the smallest level that has at least one pixel per drawn pixel
+  float s = fl_graphics_driver->scale();
+  double fx = data_w() / (w() * s), fy = data_h() / (h() * s);
+  double f = fx < fy ? fx : fy;
+  int level = 0;
+  while (level + 1 < levels_ && f >= 2) {
+    level++;
+    f /= 2;
+  }
+  int T = tile_size_;
+  long long lw = level_w(level), lh = level_h(level);
+  int col0 = int(u0 * lw / w()) / T, col1 = int((u1 * lw + w() - 1) / w() - 1) / T;
+  int row0 = int(v0 * lh / h()) / T, row1 = int((v1 * lh + h() - 1) / h() - 1) / T;
+  draw_count_++;
+  fl_push_clip(X, Y, W, H);
+  for (int row = row0; row <= row1; row++) {
+    long long b = (long long)(row + 1) * T;
+    int y0 = int((long long)row * T * h() / lh);
+    int y1 = int((b < lh ? b : lh) * h() / lh);
+    if (y1 <= y0) continue;
+    for (int col = col0; col <= col1; col++) {
+      long long e = (long long)(col + 1) * T;
+      int x0 = int((long long)col * T * w() / lw);
+      int x1 = int((e < lw ? e : lw) * w() / lw);
+      if (x1 <= x0) continue;
+      Fl_Pyramid_Tile *t = get_tile(level, col, row);
+      if (!t) continue;
+      t->drawn = draw_count_;
+      t->image->scale(x1 - x0, y1 - y0, 0, 1);
+      t->image->draw(X - cx + x0, Y - cy + y0);
+    }
+  }
+  fl_pop_clip();
+}
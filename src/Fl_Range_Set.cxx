@@ -0,0 +1,202 @@
+//
+// Integer range set for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <FL/Fl_Range_Set.H>
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The ranges are stored as pairs of start and end, where end is the first
+// integer after the range. They are sorted, do not overlap, and are never
+// adjacent, so that the end of a range is never in the set. If inverted_
+// is set, the set consists of all integers that are *not* in a range.
+
+/** Creates an empty set. */
+Fl_Range_Set::Fl_Range_Set()
+  : ranges_(0), count_(0), alloc_(0), inverted_(0) {
+}
+
+/** Destroys the set. */
+Fl_Range_Set::~Fl_Range_Set() {
+  free(ranges_);
+}
+
+// Returns the first range that ends after i, or count_ if there is none.
+int Fl_Range_Set::find_(int i) const {
+  int lo = 0, hi = count_;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (ranges_[2 * mid + 1] <= i) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+// Replaces the ranges k0 to k1-1 by the n ranges in r.
+void Fl_Range_Set::replace_(int k0, int k1, const int *r, int n) {
+  int count = count_ - (k1 - k0) + n;
+  if (count > alloc_) {
+    alloc_ = alloc_ ? 2 * alloc_ : 8;
+    if (alloc_ < count) alloc_ = count;
+    ranges_ = (int *)realloc(ranges_, 2 * alloc_ * sizeof(int));
+  }
+  if (k1 != k0 + n && k1 < count_)
+    memmove(ranges_ + 2 * (k0 + n), ranges_ + 2 * k1, 2 * (count_ - k1) * sizeof(int));
+  if (n) memcpy(ranges_ + 2 * k0, r, 2 * n * sizeof(int));
+  count_ = count;
+}
+
+// Returns non-zero if a range contains all of a..b-1.
+int Fl_Range_Set::covered_(int a, int b) const {
+  int k = find_(a);
+  return k < count_ && ranges_[2 * k] <= a && ranges_[2 * k + 1] >= b;
+}
+
+// Returns non-zero if a range contains any of a..b-1.
+int Fl_Range_Set::overlaps_(int a, int b) const {
+  int k = find_(a);
+  return k < count_ && ranges_[2 * k] < b;
+}
+
+// Adds a..b-1 to the ranges, merging it with all ranges it touches.
+void Fl_Range_Set::add_(int a, int b) {
+  int k0 = find_(a - 1), lo = k0, hi = count_;
+  while (lo < hi) {             // first range that starts after b
+    int mid = (lo + hi) / 2;
+    if (ranges_[2 * mid] <= b) lo = mid + 1;
+    else hi = mid;
+  }
+  int r[2] = { a, b };
+  if (k0 < lo) {
+    if (ranges_[2 * k0] < a) r[0] = ranges_[2 * k0];
+    if (ranges_[2 * lo - 1] > b) r[1] = ranges_[2 * lo - 1];
+  }
+  replace_(k0, lo, r, 1);
+}
+
+// Removes a..b-1 from the ranges, keeping the parts of ranges outside of it.
+void Fl_Range_Set::remove_(int a, int b) {
+  int k0 = find_(a), lo = k0, hi = count_;
+  while (lo < hi) {             // first range that starts at or after b
+    int mid = (lo + hi) / 2;
+    if (ranges_[2 * mid] < b) lo = mid + 1;
+    else hi = mid;
+  }
+  int r[4], n = 0;
+  if (k0 < lo) {
+    if (ranges_[2 * k0] < a) { r[n++] = ranges_[2 * k0]; r[n++] = a; }
+    if (ranges_[2 * lo - 1] > b) { r[n++] = b; r[n++] = ranges_[2 * lo - 1]; }
+  }
+  replace_(k0, lo, r, n / 2);
+}
+
+/** Returns non-zero if \p i is in the set. */
+int Fl_Range_Set::contains(int i) const {
+  int k = find_(i);
+  int in = k < count_ && ranges_[2 * k] <= i;
+  return in ^ inverted_;
+}
+
+/**
+  Adds or removes the integers \p first to \p last, inclusive.
+
+  Negative integers are ignored.
+
+  \param first, last the range to change
+  \param flag 0 removes the range, 1 adds it, 2 toggles each integer in it
+  \returns 1 if the set changed, 0 if not
+*/
+int Fl_Range_Set::set(int first, int last, int flag) {
+  if (first < 0) first = 0;
+  if (last < first) return 0;
+  int a = first, b = (last < INT_MAX) ? last + 1 : INT_MAX;
+  if (flag == 2) {
+    // save the gaps between the ranges in a..b-1, then replace them
+    int k = find_(a), n = 0;
+    int *gaps = (int *)malloc(2 * (count_ - k + 1) * sizeof(int));
+    int pos = a;
+    for (; k < count_ && ranges_[2 * k] < b; k++) {
+      if (ranges_[2 * k] > pos) { gaps[n++] = pos; gaps[n++] = ranges_[2 * k]; }
+      pos = ranges_[2 * k + 1];
+    }
+    if (pos < b) { gaps[n++] = pos; gaps[n++] = b; }
+    remove_(a, b);
+    for (int i = 0; i < n; i += 2) add_(gaps[i], gaps[i + 1]);
+    free(gaps);
+    return 1;
+  }
+  if ((flag != 0) != (inverted_ != 0)) { // add to the ranges
+    if (covered_(a, b)) return 0;
+    add_(a, b);
+  } else {                               // remove from the ranges
+    if (!overlaps_(a, b)) return 0;
+    remove_(a, b);
+  }
+  return 1;
+}
+
+/** Removes all integers from the set. */
+void Fl_Range_Set::clear() {
+  count_ = 0;
+  inverted_ = 0;
+}
+
+/**
+  Replaces the set by its complement.
+
+  Afterwards the set contains all non-negative integers that were not in
+  it before. Users usually limit it to the integers they are interested
+  in with set(limit, INT_MAX, 0).
+*/
+void Fl_Range_Set::invert() {
+  inverted_ = !inverted_;
+}
+
+/**
+  Returns the smallest integer in the set that is not less than \p from.
+  \returns the integer, or -1 if there is none
+*/
+int Fl_Range_Set::next_set(int from) const {
+  if (from < 0) from = 0;
+  int k = find_(from);
+  if (!inverted_) {
+    if (k >= count_) return -1;
+    return ranges_[2 * k] > from ? ranges_[2 * k] : from;
+  }
+  if (k < count_ && ranges_[2 * k] <= from)
+    return ranges_[2 * k + 1] < INT_MAX ? ranges_[2 * k + 1] : -1;
+  return from;
+}
+
+/**
+  Returns the smallest integer not in the set that is not less than \p from.
+
+  When iterating over the set, this is one more than the last integer of
+  the range that starts at \p from.
+  \returns the integer, or -1 if there is none
+*/
+int Fl_Range_Set::next_unset(int from) const {
+  if (from < 0) from = 0;
+  int k = find_(from);
+  if (inverted_) {
+    if (k >= count_) return -1;
+    return ranges_[2 * k] > from ? ranges_[2 * k] : from;
+  }
+  if (k < count_ && ranges_[2 * k] <= from)
+    return ranges_[2 * k + 1] < INT_MAX ? ranges_[2 * k + 1] : -1;
+  return from;
+}
@@ -0,0 +1,557 @@
+//
+// Implementation of class Fl_Recording_Surface for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <FL/Fl_Recording_Surface.H>
+#include <FL/Fl_Graphics_Driver.H>
+#include <FL/Fl_RGB_Image.H>
+#include <FL/Fl_Pixmap.H>
+#include <FL/Fl_Bitmap.H>
+#include <FL/fl_utf8.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The graphics driver of Fl_Recording_Surface.
+ Every drawing function counts itself in counts_[] and, when recording,
+ appends one line to log_. Coordinates in the log are surface coordinates,
+ i.e., they include the current origin and translation of the surface.
+ The clip stack is kept as plain rectangles in surface coordinates.
+ */
+class Fl_Recording_Graphics_Driver : public Fl_Graphics_Driver {
+  friend class Fl_Recording_Surface;
+  struct Clip {
+    int x, y, w, h;             // w < 0 means no clipping
+  };
+  unsigned long counts_[Fl_Recording_Surface::OPERATION_COUNT];
+  int record_;
+  char *log_;                   // nul-terminated command log
+  size_t log_length_, log_alloc_;
+  Clip *clips_;                 // clip stack, clips_[nclips_-1] is current
+  int nclips_, aclips_;
+  int origin_x_, origin_y_;     // set by Fl_Recording_Surface::origin()
+  int tx_, ty_;                 // sum of translate() calls
+  int tstack_[2 * 32];          // saved tx_, ty_
+  int tdepth_;
+  void append(const char *s, size_t n);
+  void add(Fl_Recording_Surface::Operation op, const char *format, ...);
+  void add_text(const char *what, const char *str, int n, int x, int y);
+  int dx() const { return origin_x_ + tx_; }
+  int dy() const { return origin_y_ + ty_; }
+  void push_clip_(int x, int y, int w, int h);
+public:
+  Fl_Recording_Graphics_Driver();
+  ~Fl_Recording_Graphics_Driver();
+  void point(int x, int y);
+  void rect(int x, int y, int w, int h);
+  void rectf(int x, int y, int w, int h);
+  void line(int x, int y, int x1, int y1);
+  void line(int x, int y, int x1, int y1, int x2, int y2);
+  void xyline(int x, int y, int x1);
+  void xyline(int x, int y, int x1, int y2);
+  void xyline(int x, int y, int x1, int y2, int x3);
+  void yxline(int x, int y, int y1);
+  void yxline(int x, int y, int y1, int x2);
+  void yxline(int x, int y, int y1, int x2, int y3);
+  void loop(int x0, int y0, int x1, int y1, int x2, int y2);
+  void loop(int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3);
+  void polygon(int x0, int y0, int x1, int y1, int x2, int y2);
+  void polygon(int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3);
+  void end_points();
+  void end_line();
+  void end_polygon();
+  void end_complex_polygon();
+  void circle(double x, double y, double r);
+  void arc(double x, double y, double r, double start, double end);
+  void arc(int x, int y, int w, int h, double a1, double a2);
+  void pie(int x, int y, int w, int h, double a1, double a2);
+  void push_clip(int x, int y, int w, int h);
+  void push_no_clip();
+  void pop_clip();
+  int clip_box(int x, int y, int w, int h, int &X, int &Y, int &W, int &H);
+  int not_clipped(int x, int y, int w, int h);
+  void line_style(int style, int width = 0, char *dashes = 0);
+  void color(Fl_Color c);
+  Fl_Color color() { return Fl_Graphics_Driver::color(); }
+  void color(uchar r, uchar g, uchar b);
+  void font(Fl_Font face, Fl_Fontsize fsize);
+  Fl_Font font() { return Fl_Graphics_Driver::font(); }
+  void draw(const char *str, int n, int x, int y);
+  void draw(const char *str, int n, float x, float y);
+  void draw(int angle, const char *str, int n, int x, int y);
+  void rtl_draw(const char *str, int n, int x, int y);
+  double width(const char *str, int n);
+  double width(unsigned int c);
+  void text_extents(const char *str, int n, int &dx, int &dy, int &w, int &h);
+  int height();
+  int descent();
+protected:
+  void draw_rgb(Fl_RGB_Image *rgb, int XP, int YP, int WP, int HP, int cx, int cy);
+  void draw_pixmap(Fl_Pixmap *pxm, int XP, int YP, int WP, int HP, int cx, int cy);
+  void draw_bitmap(Fl_Bitmap *bm, int XP, int YP, int WP, int HP, int cx, int cy);
+  void draw_image(const uchar *buf, int X, int Y, int W, int H, int D, int L);
+  void draw_image_mono(const uchar *buf, int X, int Y, int W, int H, int D, int L);
+  void draw_image(Fl_Draw_Image_Cb cb, void *data, int X, int Y, int W, int H, int D);
+  void draw_image_mono(Fl_Draw_Image_Cb cb, void *data, int X, int Y, int W, int H, int D);
+  void copy_offscreen(int x, int y, int w, int h, Fl_Offscreen pixmap, int srcx, int srcy);
+};
+
+// Fixed text metrics, in units of the font size
+static const double char_width = 0.6;
+static const double line_height = 1.2;
+static const double descent_height = 0.25;
+
+Fl_Recording_Graphics_Driver::Fl_Recording_Graphics_Driver() {
+  memset(counts_, 0, sizeof(counts_));
+  record_ = 0;
+  log_ = NULL;
+  log_length_ = log_alloc_ = 0;
+  clips_ = NULL;
+  nclips_ = aclips_ = 0;
+  origin_x_ = origin_y_ = 0;
+  tx_ = ty_ = 0;
+  tdepth_ = 0;
+}
+
+Fl_Recording_Graphics_Driver::~Fl_Recording_Graphics_Driver() {
+  free(log_);
+  free(clips_);
+}
+
+void Fl_Recording_Graphics_Driver::append(const char *s, size_t n) {
+  if (log_length_ + n + 1 > log_alloc_) {
+    size_t a = log_alloc_ ? 2 * log_alloc_ : 4096;
+    while (a < log_length_ + n + 1) a *= 2;
+    log_ = (char*)realloc(log_, a);
+    log_alloc_ = a;
+  }
+  memcpy(log_ + log_length_, s, n);
+  log_length_ += n;
+  log_[log_length_] = 0;
+}
+
+void Fl_Recording_Graphics_Driver::add(Fl_Recording_Surface::Operation op, const char *format, ...) {
+  counts_[op]++;
+  if (!record_) return;
+  char line[256];
+  va_list ap;
+  va_start(ap, format);
+  int l = vsnprintf(line, sizeof(line) - 1, format, ap);
+  va_end(ap);
+  if (l < 0) return;
+  if (l > (int)sizeof(line) - 2) l = sizeof(line) - 2;
+  line[l++] = '\n';
+  append(line, l);
+}
+
+// Logs a string with newlines and backslashes escaped so it stays on one line.
+void Fl_Recording_Graphics_Driver::add_text(const char *what, const char *str, int n, int x, int y) {
+  counts_[Fl_Recording_Surface::TEXT]++;
+  if (!record_) return;
+  char line[64];
+  int l = snprintf(line, sizeof(line), "%s %d %d ", what, x + dx(), y + dy());
+  append(line, l);
+  const char *start = str;
+  for (int i = 0; i < n; i++) {
+    if (str[i] != '\n' && str[i] != '\\') continue;
+    append(start, str + i - start);
+    append(str[i] == '\n' ? "\\n" : "\\\\", 2);
+    start = str + i + 1;
+  }
+  append(start, str + n - start);
+  append("\n", 1);
+}
+
+void Fl_Recording_Graphics_Driver::point(int x, int y) {
+  add(Fl_Recording_Surface::POINT, "point %d %d", x + dx(), y + dy());
+}
+
+void Fl_Recording_Graphics_Driver::rect(int x, int y, int w, int h) {
+  add(Fl_Recording_Surface::RECT, "rect %d %d %d %d", x + dx(), y + dy(), w, h);
+}
+
+void Fl_Recording_Graphics_Driver::rectf(int x, int y, int w, int h) {
+  add(Fl_Recording_Surface::RECTF, "rectf %d %d %d %d", x + dx(), y + dy(), w, h);
+}
+
+void Fl_Recording_Graphics_Driver::line(int x, int y, int x1, int y1) {
+  add(Fl_Recording_Surface::LINE, "line %d %d %d %d", x + dx(), y + dy(), x1 + dx(), y1 + dy());
+}
+
+void Fl_Recording_Graphics_Driver::line(int x, int y, int x1, int y1, int x2, int y2) {
+  add(Fl_Recording_Surface::LINE, "line %d %d %d %d %d %d",
+      x + dx(), y + dy(), x1 + dx(), y1 + dy(), x2 + dx(), y2 + dy());
+}
+
+void Fl_Recording_Graphics_Driver::xyline(int x, int y, int x1) {
+  add(Fl_Recording_Surface::LINE, "xyline %d %d %d", x + dx(), y + dy(), x1 + dx());
+}
+
+void Fl_Recording_Graphics_Driver::xyline(int x, int y, int x1, int y2) {
+  add(Fl_Recording_Surface::LINE, "xyline %d %d %d %d", x + dx(), y + dy(), x1 + dx(), y2 + dy());
+}
+
+void Fl_Recording_Graphics_Driver::xyline(int x, int y, int x1, int y2, int x3) {
+  add(Fl_Recording_Surface::LINE, "xyline %d %d %d %d %d",
+      x + dx(), y + dy(), x1 + dx(), y2 + dy(), x3 + dx());
+}
+
+void Fl_Recording_Graphics_Driver::yxline(int x, int y, int y1) {
+  add(Fl_Recording_Surface::LINE, "yxline %d %d %d", x + dx(), y + dy(), y1 + dy());
+}
+
+void Fl_Recording_Graphics_Driver::yxline(int x, int y, int y1, int x2) {
+  add(Fl_Recording_Surface::LINE, "yxline %d %d %d %d", x + dx(), y + dy(), y1 + dy(), x2 + dx());
+}
+
+void Fl_Recording_Graphics_Driver::yxline(int x, int y, int y1, int x2, int y3) {
+  add(Fl_Recording_Surface::LINE, "yxline %d %d %d %d %d",
+      x + dx(), y + dy(), y1 + dy(), x2 + dx(), y3 + dy());
+}
+
+void Fl_Recording_Graphics_Driver::loop(int x0, int y0, int x1, int y1, int x2, int y2) {
+  add(Fl_Recording_Surface::LINE, "loop %d %d %d %d %d %d",
+      x0 + dx(), y0 + dy(), x1 + dx(), y1 + dy(), x2 + dx(), y2 + dy());
+}
+
+void Fl_Recording_Graphics_Driver::loop(int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3) {
+  add(Fl_Recording_Surface::LINE, "loop %d %d %d %d %d %d %d %d",
+      x0 + dx(), y0 + dy(), x1 + dx(), y1 + dy(), x2 + dx(), y2 + dy(), x3 + dx(), y3 + dy());
+}
+
+void Fl_Recording_Graphics_Driver::polygon(int x0, int y0, int x1, int y1, int x2, int y2) {
+  add(Fl_Recording_Surface::POLYGON, "polygon %d %d %d %d %d %d",
+      x0 + dx(), y0 + dy(), x1 + dx(), y1 + dy(), x2 + dx(), y2 + dy());
+}
+
+void Fl_Recording_Graphics_Driver::polygon(int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3) {
+  add(Fl_Recording_Surface::POLYGON, "polygon %d %d %d %d %d %d %d %d",
+      x0 + dx(), y0 + dy(), x1 + dx(), y1 + dy(), x2 + dx(), y2 + dy(), x3 + dx(), y3 + dy());
+}
+
+void Fl_Recording_Graphics_Driver::end_points() {
+  add(Fl_Recording_Surface::POINT, "points %d", n);
+}
+
+void Fl_Recording_Graphics_Driver::end_line() {
+  add(Fl_Recording_Surface::LINE, "polyline %d", n);
+}
+
+void Fl_Recording_Graphics_Driver::end_polygon() {
+  fixloop();
+  add(Fl_Recording_Surface::POLYGON, "polygon_path %d", n);
+}
+
+void Fl_Recording_Graphics_Driver::end_complex_polygon() {
+  gap();
+  add(Fl_Recording_Surface::POLYGON, "complex_polygon %d", n);
+}
+
+void Fl_Recording_Graphics_Driver::circle(double x, double y, double r) {
+  add(Fl_Recording_Surface::ARC, "circle %g %g %g", x, y, r);
+}
+
+void Fl_Recording_Graphics_Driver::arc(double x, double y, double r, double start, double end) {
+  // this adds to the current path: keep the vertices the path is made of
+  Fl_Graphics_Driver::arc(x, y, r, start, end);
+  add(Fl_Recording_Surface::ARC, "arc_path %g %g %g %g %g", x, y, r, start, end);
+}
+
+void Fl_Recording_Graphics_Driver::arc(int x, int y, int w, int h, double a1, double a2) {
+  add(Fl_Recording_Surface::ARC, "arc %d %d %d %d %g %g", x + dx(), y + dy(), w, h, a1, a2);
+}
+
+void Fl_Recording_Graphics_Driver::pie(int x, int y, int w, int h, double a1, double a2) {
+  add(Fl_Recording_Surface::ARC, "pie %d %d %d %d %g %g", x + dx(), y + dy(), w, h, a1, a2);
+}
+
+void Fl_Recording_Graphics_Driver::push_clip_(int x, int y, int w, int h) {
+  if (nclips_ >= aclips_) {
+    aclips_ = aclips_ ? 2 * aclips_ : 16;
+    clips_ = (Clip*)realloc(clips_, aclips_ * sizeof(Clip));
+  }
+  Clip &c = clips_[nclips_++];
+  c.x = x; c.y = y; c.w = w; c.h = h;
+}
+
+void Fl_Recording_Graphics_Driver::push_clip(int x, int y, int w, int h) {
+  int X, Y, W, H;
+  if (w > 0 && h > 0) {
+    clip_box(x, y, w, h, X, Y, W, H);
+  } else {
+    X = x; Y = y; W = H = 0;
+  }
+  push_clip_(X + dx(), Y + dy(), W, H);
+  add(Fl_Recording_Surface::CLIP, "push_clip %d %d %d %d", x + dx(), y + dy(), w, h);
+}
+
+void Fl_Recording_Graphics_Driver::push_no_clip() {
+  push_clip_(0, 0, -1, -1);
+  add(Fl_Recording_Surface::CLIP, "push_no_clip");
+}
+
+void Fl_Recording_Graphics_Driver::pop_clip() {
+  if (nclips_ > 0) nclips_--;
+  add(Fl_Recording_Surface::CLIP, "pop_clip");
+}
+
+int Fl_Recording_Graphics_Driver::clip_box(int x, int y, int w, int h, int &X, int &Y, int &W, int &H) {
+  X = x; Y = y; W = w; H = h;
+  if (!nclips_ || clips_[nclips_-1].w < 0) return 0;
+  const Clip &c = clips_[nclips_-1];
+  int cx = c.x - dx(), cy = c.y - dy();
+  int r = x + w, b = y + h;
+  if (X < cx) X = cx;
+  if (Y < cy) Y = cy;
+  if (r > cx + c.w) r = cx + c.w;
+  if (b > cy + c.h) b = cy + c.h;
+  W = r - X; H = b - Y;
+  if (W <= 0 || H <= 0) {
+    W = H = 0;
+    return 2;
+  }
+  return (X != x || Y != y || W != w || H != h);
+}
+
+int Fl_Recording_Graphics_Driver::not_clipped(int x, int y, int w, int h) {
+  int X, Y, W, H;
+  return clip_box(x, y, w, h, X, Y, W, H) != 2;
+}
+
+void Fl_Recording_Graphics_Driver::line_style(int style, int width, char *dashes) {
+  add(Fl_Recording_Surface::LINE_STYLE, "line_style %d %d", style, width);
+}
+
+void Fl_Recording_Graphics_Driver::color(Fl_Color c) {
+  Fl_Graphics_Driver::color(c);
+  add(Fl_Recording_Surface::COLOR, "color 0x%08x", (unsigned)c);
+}
+
+void Fl_Recording_Graphics_Driver::color(uchar r, uchar g, uchar b) {
+  color(fl_rgb_color(r, g, b));
+}
+
+void Fl_Recording_Graphics_Driver::font(Fl_Font face, Fl_Fontsize fsize) {
+  Fl_Graphics_Driver::font(face, fsize);
+  add(Fl_Recording_Surface::FONT, "font %d %d", (int)face, (int)fsize);
+}
+
+void Fl_Recording_Graphics_Driver::draw(const char *str, int n, int x, int y) {
+  add_text("text", str, n, x, y);
+}
+
+void Fl_Recording_Graphics_Driver::draw(const char *str, int n, float x, float y) {
+  add_text("text", str, n, int(x + 0.5f), int(y + 0.5f));
+}
+
+void Fl_Recording_Graphics_Driver::draw(int angle, const char *str, int n, int x, int y) {
+  char what[24];
+  snprintf(what, sizeof(what), "rotated_text %d", angle);
+  add_text(what, str, n, x, y);
+}
+
+void Fl_Recording_Graphics_Driver::rtl_draw(const char *str, int n, int x, int y) {
+  add_text("rtl_text", str, n, x, y);
+}
+
+double Fl_Recording_Graphics_Driver::width(const char *str, int n) {
+  return fl_utf_nb_char((const unsigned char*)str, n) * char_width * size();
+}
+
+double Fl_Recording_Graphics_Driver::width(unsigned int c) {
+  return char_width * size();
+}
+
+void Fl_Recording_Graphics_Driver::text_extents(const char *str, int n, int &dx, int &dy, int &w, int &h) {
+  dx = 0;
+  dy = descent() - height();
+  w = int(width(str, n) + 0.5);
+  h = height();
+}
+
+int Fl_Recording_Graphics_Driver::height() {
+  return int(line_height * size() + 0.5);
+}
+
+int Fl_Recording_Graphics_Driver::descent() {
+  return int(descent_height * size() + 0.5);
+}
+
+void Fl_Recording_Graphics_Driver::draw_rgb(Fl_RGB_Image *rgb, int XP, int YP, int WP, int HP, int cx, int cy) {
+  add(Fl_Recording_Surface::IMAGE, "rgb_image %d %d %d %d", XP + dx(), YP + dy(), WP, HP);
+}
+
+void Fl_Recording_Graphics_Driver::draw_pixmap(Fl_Pixmap *pxm, int XP, int YP, int WP, int HP, int cx, int cy) {
+  add(Fl_Recording_Surface::IMAGE, "pixmap %d %d %d %d", XP + dx(), YP + dy(), WP, HP);
+}
+
+void Fl_Recording_Graphics_Driver::draw_bitmap(Fl_Bitmap *bm, int XP, int YP, int WP, int HP, int cx, int cy) {
+  add(Fl_Recording_Surface::IMAGE, "bitmap %d %d %d %d", XP + dx(), YP + dy(), WP, HP);
+}
+
+void Fl_Recording_Graphics_Driver::draw_image(const uchar *buf, int X, int Y, int W, int H, int D, int L) {
+  add(Fl_Recording_Surface::IMAGE, "image %d %d %d %d %d", X + dx(), Y + dy(), W, H, D);
+}
+
+void Fl_Recording_Graphics_Driver::draw_image_mono(const uchar *buf, int X, int Y, int W, int H, int D, int L) {
+  add(Fl_Recording_Surface::IMAGE, "image_mono %d %d %d %d %d", X + dx(), Y + dy(), W, H, D);
+}
+
+void Fl_Recording_Graphics_Driver::draw_image(Fl_Draw_Image_Cb cb, void *data, int X, int Y, int W, int H, int D) {
+  add(Fl_Recording_Surface::IMAGE, "image %d %d %d %d %d", X + dx(), Y + dy(), W, H, D);
+}
+
+void Fl_Recording_Graphics_Driver::draw_image_mono(Fl_Draw_Image_Cb cb, void *data, int X, int Y, int W, int H, int D) {
+  add(Fl_Recording_Surface::IMAGE, "image_mono %d %d %d %d %d", X + dx(), Y + dy(), W, H, D);
+}
+
+void Fl_Recording_Graphics_Driver::copy_offscreen(int x, int y, int w, int h, Fl_Offscreen pixmap, int srcx, int srcy) {
+  add(Fl_Recording_Surface::IMAGE, "offscreen %d %d %d %d", x + dx(), y + dy(), w, h);
+}
+
+
+// driver() is not const
+static inline Fl_Recording_Graphics_Driver *recorder(const Fl_Recording_Surface *s) {
+  return (Fl_Recording_Graphics_Driver*)((Fl_Recording_Surface*)s)->driver();
+}
+
+/**
+ Constructor of the recording surface.
+ \param width,height Width and height of the surface in FLTK drawing units,
+   as reported by printable_rect(). Drawings are not clipped to this area.
+ \param record If non-zero, the command log is filled, see record(int).
+ */
+Fl_Recording_Surface::Fl_Recording_Surface(int width, int height, int record) :
+  Fl_Widget_Surface(new Fl_Recording_Graphics_Driver()) {
+  width_ = width;
+  height_ = height;
+  ((Fl_Recording_Graphics_Driver*)driver())->record_ = record;
+}
+
+/** Destructor. */
+Fl_Recording_Surface::~Fl_Recording_Surface() {
+  delete driver();
+}
+
+/**
+ Returns the number of operations of category \p op counted since
+ construction or the last reset().
+ */
+unsigned long Fl_Recording_Surface::count(Operation op) const {
+  if (op < 0 || op >= OPERATION_COUNT) return 0;
+  return recorder(this)->counts_[op];
+}
+
+/**
+ Returns the number of operations of all categories counted since
+ construction or the last reset().
+ */
+unsigned long Fl_Recording_Surface::total() const {
+  unsigned long t = 0;
+  for (int i = 0; i < OPERATION_COUNT; i++)
+    t += recorder(this)->counts_[i];
+  return t;
+}
+
+/**
+ Sets all counts to zero and empties the command log.
+ */
+void Fl_Recording_Surface::reset() {
+  Fl_Recording_Graphics_Driver *d = (Fl_Recording_Graphics_Driver*)driver();
+  memset(d->counts_, 0, sizeof(d->counts_));
+  d->log_length_ = 0;
+  if (d->log_) d->log_[0] = 0;
+}
+
+/**
+ Turns recording of the command log on or off.
+ Operations are counted in any case. Recording costs time and memory,
+ turn it off to time drawing code.
+ */
+void Fl_Recording_Surface::record(int on) {
+  ((Fl_Recording_Graphics_Driver*)driver())->record_ = on;
+}
+
+/** Returns non-zero if the command log is being recorded. */
+int Fl_Recording_Surface::record() const {
+  return recorder(this)->record_;
+}
+
+/**
+ Returns the command log, one operation per line.
+ The returned pointer remains valid until the next drawing operation or
+ call to reset().
+ */
+const char *Fl_Recording_Surface::commands() const {
+  const char *log = recorder(this)->log_;
+  return log ? log : "";
+}
+
+/** Returns the length in bytes of the command log. */
+size_t Fl_Recording_Surface::commands_length() const {
+  return recorder(this)->log_length_;
+}
+
+/**
+ Returns the name of an operation category, e.g. "rectf" for RECTF,
+ or NULL if \p op is not a valid category.
+ */
+const char *Fl_Recording_Surface::operation_name(Operation op) {
+  static const char *names[OPERATION_COUNT] = {
+    "point", "line", "rect", "rectf", "polygon", "arc", "text", "image",
+    "clip", "color", "font", "line_style"
+  };
+  if (op < 0 || op >= OPERATION_COUNT) return NULL;
+  return names[op];
+}
+
+void Fl_Recording_Surface::origin(int x, int y) {
+  Fl_Recording_Graphics_Driver *d = (Fl_Recording_Graphics_Driver*)driver();
+  d->origin_x_ = x;
+  d->origin_y_ = y;
+  Fl_Widget_Surface::origin(x, y);
+}
+
+void Fl_Recording_Surface::origin(int *x, int *y) {
+  Fl_Widget_Surface::origin(x, y);
+}
+
+void Fl_Recording_Surface::translate(int x, int y) {
+  Fl_Recording_Graphics_Driver *d = (Fl_Recording_Graphics_Driver*)driver();
+  if (d->tdepth_ < (int)(sizeof(d->tstack_) / sizeof(int)) / 2) {
+    d->tstack_[2 * d->tdepth_] = d->tx_;
+    d->tstack_[2 * d->tdepth_ + 1] = d->ty_;
+  }
+  d->tdepth_++;
+  d->tx_ += x;
+  d->ty_ += y;
+}
+
+void Fl_Recording_Surface::untranslate() {
+  Fl_Recording_Graphics_Driver *d = (Fl_Recording_Graphics_Driver*)driver();
+  if (d->tdepth_ <= 0) return;
+  d->tdepth_--;
+  if (d->tdepth_ < (int)(sizeof(d->tstack_) / sizeof(int)) / 2) {
+    d->tx_ = d->tstack_[2 * d->tdepth_];
+    d->ty_ = d->tstack_[2 * d->tdepth_ + 1];
+  }
+}
+
+int Fl_Recording_Surface::printable_rect(int *w, int *h) {
+  *w = width_;
+  *h = height_;
+  return 0;
+}
@@ -18,6 +18,7 @@
 #include <FL/Fl_Tiled_Image.H>
 #include <FL/Fl_Scroll.H>
 #include <FL/fl_draw.H>
+#include <stdlib.h>
 
 /** Clear all but the scrollbars... */
 void Fl_Scroll::clear() {
@@ -31,6 +32,8 @@ void Fl_Scroll::clear() {
   Fl_Group::clear();
   add(scrollbar);
   add(hscrollbar);
+  row_widgets_ = 0;
+  delete_spare_rows();
 }
 
 /**
@@ -42,6 +45,8 @@ Fl_Scroll::~Fl_Scroll() {
   remove(hscrollbar); // remove last child first
   remove(scrollbar);
   Fl_Group::clear();
+  free(row_of_);
+  delete_spare_rows();
 }
 
 /** Ensure the scrollbars are the last children.
@@ -220,8 +225,13 @@ void Fl_Scroll::recalc_scrollbars(ScrollInfo &si) const {
   si.child.b = si.innerbox.y;
   si.child.t = si.innerbox.y;
   int first = 1;
+  if (recycler_) { // row mode: the rows are the children
+    first = 0;
+    si.child.t = si.innerbox.y - yposition_;
+    si.child.b = si.child.t + rows_ * row_height_;
+  }
   Fl_Widget*const* a = array();
-  for (int i=children(); i--;) {
+  for (int i=first ? children() : 0; i--;) {
     Fl_Widget* o = *a++;
     if ( o==&scrollbar || o==&hscrollbar || o->visible()==0 ) continue;
     if ( first ) {
@@ -257,7 +267,7 @@ void Fl_Scroll::recalc_scrollbars(ScrollInfo &si) const {
       }
     }
     if (type() & HORIZONTAL) {
-      if ((type() & ALWAYS_ON) || si.child.l < X || si.child.r > X+W) {
+      if ((type() & ALWAYS_ON) || (!recycler_ && (si.child.l < X || si.child.r > X+W))) {
         si.hneeded = 1;
         H -= si.scrollsize;
         if (scrollbar.align() & FL_ALIGN_TOP) Y += si.scrollsize;
@@ -276,6 +286,12 @@ void Fl_Scroll::recalc_scrollbars(ScrollInfo &si) const {
     si.innerchild.w = W;
     si.innerchild.h = H;
   }
+  if (recycler_) { // rows are as wide as the scroll area
+    si.child.l = si.innerchild.x;
+    si.child.r = si.innerchild.x + si.innerchild.w;
+    si.child.t = si.innerchild.y - yposition_;
+    si.child.b = si.child.t + rows_ * row_height_;
+  }
 
   // calculate hor scrollbar position
   si.hscroll.x = si.innerchild.x;
@@ -464,9 +480,10 @@ void Fl_Scroll::resize(int X, int Y, int W, int H) {
   int dw = W-w(), dh = H-h();
   Fl_Widget::resize(X,Y,W,H); // resize _before_ moving children around
   fix_scrollbar_order();
+  if (recycler_) recycle_rows(0);
   // move all the children:
   Fl_Widget*const* a = array();
-  for (int i=children()-2; i--;) {
+  for (int i=recycler_ ? 0 : children()-2; i--;) {
     Fl_Widget* o = *a++;
     o->position(o->x()+dx, o->y()+dy);
   }
@@ -499,13 +516,15 @@ void Fl_Scroll::resize(int X, int Y, int W, int H) {
   be visible in the top left corner of the scroll area.
 */
 void Fl_Scroll::scroll_to(int X, int Y) {
+  if (recycler_) X = 0; // no horizontal scrolling in row mode
   int dx = xposition_-X;
   int dy = yposition_-Y;
   if (!dx && !dy) return;
   xposition_ = X;
   yposition_ = Y;
+  if (recycler_) recycle_rows(0);
   Fl_Widget*const* a = array();
-  for (int i=children(); i--;) {
+  for (int i=recycler_ ? 0 : children(); i--;) {
     Fl_Widget* o = *a++;
     if (o == &hscrollbar || o == &scrollbar) continue;
     o->position(o->x()+dx, o->y()+dy);
@@ -545,6 +564,12 @@ Fl_Scroll::Fl_Scroll(int X, int Y, int W, int H, const char *L)
   xposition_ = oldx = 0;
   yposition_ = oldy = 0;
   scrollbar_size_ = 0;
+  rows_ = row_height_ = 0;
+  recycler_ = 0;
+  recycler_data_ = 0;
+  row_of_ = 0;
+  row_widgets_ = 0;
+  nspare_rows_ = 0;
   hscrollbar.type(FL_HORIZONTAL);
   hscrollbar.callback(hscrollbar_cb);
   scrollbar.callback(scrollbar_cb);
@@ -554,3 +579,166 @@ int Fl_Scroll::handle(int event) {
   fix_scrollbar_order();
   return Fl_Group::handle(event);
 }
+
+/**
+  Switches to row mode, in which the scroll area shows \p n rows of height
+  \p row_height, as wide as the area inside the scrollbars.
+
+  Widgets exist only for the visible rows. They are requested from
+  \p recycler, which gets the widgets of rows that were scrolled out of
+  view for reuse, and are positioned by Fl_Scroll. The scroll offset and
+  the size of the scrolled area are computed from the number of rows,
+  without looking at the children, and only the visible widgets are moved
+  when scrolling. Horizontal scrolling is not available in row mode.
+
+  All children other than the scrollbars belong to the rows. Call this
+  again when the number of rows changes, and update_rows() when the
+  contents of the rows change.
+
+  Use a \p recycler of NULL to leave row mode, this deletes all children
+  except the scrollbars.
+
+  \param[in] n number of rows
+  \param[in] row_height height of each row
+  \param[in] recycler callback that supplies the row widgets
+  \param[in] data user data passed to \p recycler
+
+  \version 1.4.0
+*/
+void Fl_Scroll::rows(int n, int row_height, Fl_Scroll_Recycler recycler, void *data) {
+  if (!recycler || n < 0 || row_height < 1) {
+    if (recycler_) clear();
+    rows_ = row_height_ = 0;
+    recycler_ = 0;
+    recycler_data_ = 0;
+    redraw();
+    return;
+  }
+  if (!recycler_) { // the children are not rows yet
+    clear();
+    xposition_ = yposition_ = 0;
+  }
+  int refresh = recycler != recycler_ || data != recycler_data_ || row_height != row_height_;
+  rows_ = n;
+  row_height_ = row_height;
+  recycler_ = recycler;
+  recycler_data_ = data;
+  recycle_rows(refresh);
+  redraw();
+}
+
+/**
+  Calls the recycler again for all visible rows, e.g. after the data
+  shown in the rows changed. Each row gets its current widget for reuse.
+  This does nothing if not in row mode.
+  \version 1.4.0
+*/
+void Fl_Scroll::update_rows() {
+  if (!recycler_) return;
+  recycle_rows(1);
+  redraw();
+}
+
+/**
+  Returns the widget that shows row \p row in row mode, or NULL if the
+  row is not visible.
+  \version 1.4.0
+*/
+Fl_Widget *Fl_Scroll::row_widget(int row) const {
+  if (!recycler_ || row_widgets_ != children() - 2) return 0;
+  for (int i = 0; i < row_widgets_; i++)
+    if (row_of_[i] == row) return child(i);
+  return 0;
+}
+
+// Creates, reuses, or deletes row widgets so that there is one for each
+// visible row, in row order, and positions them. With refresh set, the
+// widgets of all visible rows are passed to the recycler again.
+void Fl_Scroll::recycle_rows(int refresh) {
+  fix_scrollbar_order();
+  ScrollInfo si;
+  xposition_ = 0;
+  if (yposition_ < 0) yposition_ = 0;
+  recalc_scrollbars(si);
+  int max_pos = rows_ * row_height_ - si.innerchild.h;
+  if (yposition_ > max_pos) {
+    yposition_ = max_pos > 0 ? max_pos : 0;
+    recalc_scrollbars(si); // the scrollbar may no longer be needed
+  }
+  int first = yposition_ / row_height_;
+  int last = (yposition_ + si.innerchild.h - 1) / row_height_;
+  if (last >= rows_) last = rows_ - 1;
+  int n = (si.innerchild.h > 0 && last >= first) ? last - first + 1 : 0;
+
+  // sort the current widgets into the new rows and spares; if children
+  // were added or removed behind our back, all of them are spares
+  int old_n = children() - 2;
+  int known = (old_n == row_widgets_);
+  Fl_Widget **row_w = (Fl_Widget **)calloc(n + 1, sizeof(Fl_Widget *));
+  Fl_Widget **old_w = (Fl_Widget **)calloc(n + 1, sizeof(Fl_Widget *));
+  Fl_Widget **spare = (Fl_Widget **)malloc((old_n + nspare_rows_ + 1) * sizeof(Fl_Widget *));
+  int nspare = 0;
+  while (nspare_rows_) spare[nspare++] = spare_rows_[--nspare_rows_];
+  for (int i = 0; i < old_n; i++) {
+    Fl_Widget *o = child(i);
+    int row = known ? row_of_[i] : -1;
+    if (row >= first && row <= last) {
+      if (refresh) old_w[row - first] = o;
+      else row_w[row - first] = o;
+    } else {
+      spare[nspare++] = o;
+    }
+  }
+
+  // ask the recycler for the missing rows
+  Fl_Group *current = Fl_Group::current();
+  Fl_Group::current(0);
+  for (int k = 0; k < n; k++) {
+    if (row_w[k]) continue;
+    Fl_Widget *reuse = old_w[k] ? old_w[k] : (nspare ? spare[--nspare] : 0);
+    Fl_Widget *o = recycler_(this, first + k, reuse, recycler_data_);
+    if (reuse && o != reuse) {
+      remove(reuse);
+      Fl::delete_widget(reuse);
+    }
+    if (o && o->parent() != this) add(o);
+    row_w[k] = o;
+  }
+  Fl_Group::current(current);
+  // keep a few spares, the number of visible rows changes by one when
+  // scrolling by less than a row
+  while (nspare) {
+    Fl_Widget *o = spare[--nspare];
+    remove(o);
+    if (nspare_rows_ < 2) spare_rows_[nspare_rows_++] = o;
+    else Fl::delete_widget(o);
+  }
+
+  // put the children in row order, followed by the scrollbars, and
+  // remember the row of each one
+  row_of_ = (int *)realloc(row_of_, (n + 1) * sizeof(int));
+  Fl_Widget **a = (Fl_Widget **)array();
+  int j = 0;
+  for (int k = 0; k < n; k++) {
+    Fl_Widget *o = row_w[k];
+    if (!o) continue;
+    row_of_[j] = first + k;
+    a[j++] = o;
+    int Y = si.innerchild.y + (first + k) * row_height_ - yposition_;
+    if (o->x() != si.innerchild.x || o->y() != Y ||
+        o->w() != si.innerchild.w || o->h() != row_height_)
+      o->resize(si.innerchild.x, Y, si.innerchild.w, row_height_);
+  }
+  a[j++] = &scrollbar;
+  a[j++] = &hscrollbar;
+  row_widgets_ = j - 2;
+  free(row_w);
+  free(old_w);
+  free(spare);
+}
+
+// Deletes the row widgets kept for reuse by recycle_rows()
+void Fl_Scroll::delete_spare_rows() {
+  while (nspare_rows_)
+    Fl::delete_widget(spare_rows_[--nspare_rows_]);
+}
@@ -0,0 +1,349 @@
+//
+// Shortcut registry for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "Fl_Shortcut_Registry.H"
+#include <FL/Fl.H>
+#include <FL/Fl_Window.H>
+#include <FL/Fl_Menu_.H>
+#include <FL/fl_utf8.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Shortcuts are stored in hash tables by their key, converted to lower
+// case. Fl::test_shortcut() accepts an event if the key of the shortcut is
+// the event key, the first character of the event text, or, with Ctrl, that
+// character with bit 0x40 flipped. event_keys() returns these keys, so
+// looking them up finds all shortcuts that may match the event.
+
+static unsigned shortcut_key(unsigned shortcut) {
+  return (unsigned)fl_tolower(shortcut & FL_KEY_MASK);
+}
+
+static unsigned hash_key(unsigned key) {
+  return key * 2654435761U;
+}
+
+static int event_keys(unsigned keys[3]) {
+  int n = 0;
+  keys[n++] = (unsigned)fl_tolower(Fl::event_key());
+  const char *text = Fl::event_text();
+  if (Fl::event_length()) {
+    unsigned c = fl_utf8decode(text, text + Fl::event_length(), 0);
+    unsigned k = (unsigned)fl_tolower(c);
+    if (k != keys[0]) keys[n++] = k;
+    if ((Fl::event_state() & FL_CTRL) && (c ^ 0x40) >= 0x3f && (c ^ 0x40) <= 0x5f) {
+      k = (unsigned)fl_tolower(c ^ 0x40);
+      if (k != keys[0] && k != keys[n - 1]) keys[n++] = k;
+    }
+  }
+  return n;
+}
+
+// Returns the next item at the same level as m, visible or not.
+static const Fl_Menu_Item *next_item(const Fl_Menu_Item *m) {
+  int nest = 0;
+  do {
+    if (!m->text) {
+      if (!nest) return m;
+      nest--;
+    } else if (m->flags & FL_SUBMENU) {
+      nest++;
+    }
+    m++;
+  } while (nest);
+  return m;
+}
+
+//
+// Registered widgets
+//
+
+struct Fl_Shortcut_Entry {
+  unsigned shortcut;
+  Fl_Widget *widget;
+  int refs;                     // how many items of a menu use the shortcut
+  Fl_Shortcut_Entry *next;
+};
+
+static Fl_Shortcut_Entry **table = 0;
+static int table_size = 0, table_count = 0;
+
+static void grow_table() {
+  int size = table_size ? 2 * table_size : 64;
+  Fl_Shortcut_Entry **t = (Fl_Shortcut_Entry **)calloc(size, sizeof(Fl_Shortcut_Entry *));
+  for (int i = 0; i < table_size; i++) {
+    for (Fl_Shortcut_Entry *e = table[i], *next; e; e = next) {
+      next = e->next;
+      unsigned b = hash_key(shortcut_key(e->shortcut)) & (size - 1);
+      e->next = t[b];
+      t[b] = e;
+    }
+  }
+  free(table);
+  table = t;
+  table_size = size;
+}
+
+// Adds shortcut s of widget w.
+void Fl_Shortcut_Registry::add(Fl_Widget *w, unsigned s) {
+  if (!(s & FL_KEY_MASK)) return;
+  if (table_count >= table_size) grow_table();
+  unsigned b = hash_key(shortcut_key(s)) & (table_size - 1);
+  for (Fl_Shortcut_Entry *e = table[b]; e; e = e->next) {
+    if (e->widget == w && e->shortcut == s) { e->refs++; return; }
+  }
+  Fl_Shortcut_Entry *e = new Fl_Shortcut_Entry;
+  e->shortcut = s;
+  e->widget = w;
+  e->refs = 1;
+  e->next = table[b];
+  table[b] = e;
+  table_count++;
+}
+
+// Removes shortcut s of widget w.
+void Fl_Shortcut_Registry::remove(Fl_Widget *w, unsigned s) {
+  if (!(s & FL_KEY_MASK) || !table_size) return;
+  unsigned b = hash_key(shortcut_key(s)) & (table_size - 1);
+  for (Fl_Shortcut_Entry **p = &table[b]; *p; p = &(*p)->next) {
+    Fl_Shortcut_Entry *e = *p;
+    if (e->widget == w && e->shortcut == s) {
+      if (--e->refs == 0) {
+        *p = e->next;
+        delete e;
+        table_count--;
+      }
+      return;
+    }
+  }
+}
+
+// Returns non-zero if an FL_SHORTCUT event sent to win1 or win2 reaches w.
+static int reachable(Fl_Widget *w, Fl_Window *win1, Fl_Window *win2) {
+  for (;;) {
+    Fl_Widget *p = w->parent();
+    if (!p) return w == win1 || w == win2;
+    if (!w->takesevents()) return 0;
+    w = p;
+  }
+}
+
+// Returns the only registered widget in windows win1 and win2 that owns
+// the shortcut of the current event, or NULL if there are none or several.
+Fl_Widget *Fl_Shortcut_Registry::find(Fl_Window *win1, Fl_Window *win2) {
+  update_menus_();
+  if (!table_count) return 0;
+  unsigned keys[3];
+  int n = event_keys(keys);
+  Fl_Widget *found = 0;
+  for (int i = 0; i < n; i++) {
+    unsigned b = hash_key(keys[i]) & (table_size - 1);
+    for (Fl_Shortcut_Entry *e = table[b]; e; e = e->next) {
+      if (e->widget == found || shortcut_key(e->shortcut) != keys[i]) continue;
+      if (!Fl::test_shortcut(e->shortcut)) continue;
+      if (!reachable(e->widget, win1, win2)) continue;
+      if (found) return 0;      // let the widget tree decide
+      found = e->widget;
+    }
+  }
+  return found;
+}
+
+//
+// Menu item indexes
+//
+
+struct Fl_Menu_Shortcut {
+  const Fl_Menu_Item *item;
+  unsigned shortcut;
+  int parent;                   // the submenu title, or -1
+  int next;                     // next item with the same hash
+};
+
+// The items of a menu that have a shortcut or a submenu, in the order in
+// which Fl_Menu_Item::test_shortcut() prefers them: all items of a level
+// come before the items of its submenus.
+//
+// The index is only a cache: the application may change the items without
+// telling the menu. find() only trusts a match if the shortcuts of all
+// items of the menu array are still the ones the index was built from.
+// Otherwise, and for an event that matches no indexed item, it searches
+// all items, and the index is rebuilt later. The items of submenus
+// included with FL_SUBMENU_POINTER may be freed by the application at any
+// time, so that menus with such submenus are always searched.
+struct Fl_Menu_Shortcut_Index {
+  const Fl_Menu_Item *menu;     // Fl_Menu_::menu() when the index was built
+  Fl_Menu_Shortcut *items;
+  int count, alloc;
+  int *shortcuts;               // the shortcut of each item of the menu array
+  int nshortcuts;
+  int *buckets;
+  int size;
+  char queued;                  // the index needs to be rebuilt
+  char pointers;                // the menu has FL_SUBMENU_POINTER submenus
+};
+
+static Fl_Menu_ **changed_menus = 0;
+static int changed_count = 0, changed_alloc = 0;
+
+static void add_level(Fl_Menu_Shortcut_Index *ix, const Fl_Menu_Item *m, int parent, int depth) {
+  if (!m || depth > 32) return;
+  int first = ix->count;
+  const Fl_Menu_Item *i;
+  for (i = m; i->text; i = next_item(i)) {
+    if (!i->shortcut_ && !i->submenu()) continue;
+    if (ix->count >= ix->alloc) {
+      ix->alloc = ix->alloc ? 2 * ix->alloc : 16;
+      ix->items = (Fl_Menu_Shortcut *)realloc(ix->items, ix->alloc * sizeof(Fl_Menu_Shortcut));
+    }
+    Fl_Menu_Shortcut &s = ix->items[ix->count++];
+    s.item = i;
+    s.shortcut = i->shortcut_;
+    s.parent = parent;
+    s.next = -1;
+  }
+  int last = ix->count;
+  for (int k = first; k < last; k++) {
+    i = ix->items[k].item;
+    if (!i->submenu()) continue;
+    if (!(i->flags & FL_SUBMENU)) ix->pointers = 1;
+    add_level(ix, (i->flags & FL_SUBMENU) ? i + 1 : (const Fl_Menu_Item *)i->user_data_, k, depth + 1);
+  }
+}
+
+static void unregister_items(Fl_Menu_ *m, Fl_Menu_Shortcut_Index *ix) {
+  for (int k = 0; k < ix->count; k++)
+    Fl_Shortcut_Registry::remove(m, ix->items[k].shortcut);
+}
+
+static void rebuild(Fl_Menu_ *m, Fl_Menu_Shortcut_Index *ix) {
+  unregister_items(m, ix);
+  ix->count = 0;
+  ix->pointers = 0;
+  ix->menu = m->menu();
+  add_level(ix, ix->menu, -1, 0);
+  int n = ix->menu->size();
+  ix->shortcuts = (int *)realloc(ix->shortcuts, n * sizeof(int));
+  for (int i = 0; i < n; i++) ix->shortcuts[i] = ix->menu[i].shortcut_;
+  ix->nshortcuts = n;
+  int size = 8;
+  while (size < ix->count) size *= 2;
+  if (size != ix->size) {
+    free(ix->buckets);
+    ix->buckets = (int *)malloc(size * sizeof(int));
+    ix->size = size;
+  }
+  memset(ix->buckets, 0xff, size * sizeof(int));
+  for (int k = ix->count - 1; k >= 0; k--) {
+    Fl_Menu_Shortcut &s = ix->items[k];
+    if (!s.shortcut) continue;
+    unsigned b = hash_key(shortcut_key(s.shortcut)) & (size - 1);
+    s.next = ix->buckets[b];
+    ix->buckets[b] = k;
+    Fl_Shortcut_Registry::add(m, s.shortcut);
+  }
+  ix->queued = 0;
+}
+
+// Rebuilds the indexes of all changed menus, so that their shortcuts are
+// registered.
+void Fl_Shortcut_Registry::update_menus_() {
+  for (int i = 0; i < changed_count; i++) {
+    Fl_Menu_ *m = changed_menus[i];
+    if (m->shortcut_index_->queued) rebuild(m, m->shortcut_index_);
+  }
+  changed_count = 0;
+}
+
+// Marks the index of the items of menu m as outdated.
+void Fl_Shortcut_Registry::menu_changed(Fl_Menu_ *m) {
+  Fl_Menu_Shortcut_Index *ix = m->shortcut_index_;
+  if (!ix) {
+    ix = m->shortcut_index_ = (Fl_Menu_Shortcut_Index *)calloc(1, sizeof(Fl_Menu_Shortcut_Index));
+  }
+  if (ix->queued) return;
+  ix->queued = 1;
+  if (changed_count >= changed_alloc) {
+    changed_alloc = changed_alloc ? 2 * changed_alloc : 16;
+    changed_menus = (Fl_Menu_ **)realloc(changed_menus, changed_alloc * sizeof(Fl_Menu_ *));
+  }
+  changed_menus[changed_count++] = m;
+}
+
+// Removes menu m from the registry.
+void Fl_Shortcut_Registry::menu_deleted(Fl_Menu_ *m) {
+  Fl_Menu_Shortcut_Index *ix = m->shortcut_index_;
+  if (!ix) return;
+  for (int i = 0; i < changed_count; i++) {
+    if (changed_menus[i] == m) {
+      changed_menus[i] = changed_menus[--changed_count];
+      break;
+    }
+  }
+  unregister_items(m, ix);
+  free(ix->items);
+  free(ix->shortcuts);
+  free(ix->buckets);
+  free(ix);
+  m->shortcut_index_ = 0;
+}
+
+// Returns non-zero if no shortcut of the menu array changed since the index
+// was built.
+static int unchanged(const Fl_Menu_Shortcut_Index *ix) {
+  const Fl_Menu_Item *m = ix->menu;
+  for (int i = 0; i < ix->nshortcuts; i++)
+    if (m[i].shortcut_ != ix->shortcuts[i]) return 0;
+  return 1;
+}
+
+// Returns the item of menu m that matches the current event, the same item
+// as m->menu()->test_shortcut().
+const Fl_Menu_Item *Fl_Shortcut_Registry::find(Fl_Menu_ *m) {
+  if (!m->menu()) return 0;
+  Fl_Menu_Shortcut_Index *ix = m->shortcut_index_;
+  if (!ix) {
+    menu_changed(m);
+    ix = m->shortcut_index_;
+  }
+  if (ix->queued || ix->menu != m->menu()) rebuild(m, ix);
+  if (ix->pointers) return m->menu()->test_shortcut();
+  unsigned keys[3];
+  int n = event_keys(keys);
+  int best = -1;
+  for (int i = 0; i < n; i++) {
+    unsigned b = hash_key(keys[i]) & (ix->size - 1);
+    for (int k = ix->buckets[b]; k >= 0; k = ix->items[k].next) {
+      if (best >= 0 && k > best) continue;
+      const Fl_Menu_Shortcut &s = ix->items[k];
+      if (shortcut_key(s.shortcut) != keys[i]) continue;
+      if (s.shortcut != (unsigned)s.item->shortcut_) {
+        menu_changed(m);        // the item was changed directly
+        return m->menu()->test_shortcut();
+      }
+      if (!Fl::test_shortcut(s.item->shortcut_)) continue;
+      int p;
+      for (p = k; p >= 0 && ix->items[p].item->active(); p = ix->items[p].parent) {}
+      if (p < 0) best = k;
+    }
+  }
+  if (best >= 0) {
+    if (unchanged(ix)) return ix->items[best].item;
+    menu_changed(m);            // an item before best may match now
+  }
+  // items whose shortcut was changed directly are not in the index yet
+  return m->menu()->test_shortcut();
+}
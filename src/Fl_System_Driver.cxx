@@ -334,6 +334,15 @@ void Fl_System_Driver::gettime(time_t *sec, int *usec) {
   *usec = 0;
 }
 
+// Used by the frame pacing of Fl::flush(): platforms with a monotonic clock
+// should override this so wall clock adjustments don't stall redraws.
+double Fl_System_Driver::monotonic_time() {
+  time_t sec;
+  int usec;
+  gettime(&sec, &usec);
+  return double(sec) + usec / 1000000.;
+}
+
 /**
   Execute platform independent parts of Fl::wait(double).
 
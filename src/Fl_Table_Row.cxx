@@ -26,6 +26,7 @@
 #include <FL/Fl.H>
 #include <FL/fl_draw.H>
 #include <stdlib.h>
+#include <limits.h>
 
 // for debugging...
 // #define DEBUG 1
@@ -38,36 +39,20 @@
 #define PRINTEVENT
 #endif
 
-// An STL-ish vector without templates (private to Fl_Table_Row)
-
-void Fl_Table_Row::CharVector::copy(char *newarr, int newsize) {
-  size(newsize);
-  memcpy(arr, newarr, newsize * sizeof(char));
-}
-
-Fl_Table_Row::CharVector::~CharVector() {       // DTOR
-  if (arr) free(arr);
-  arr = 0;
-}
-
-void Fl_Table_Row::CharVector::size(int count) {
-  if (count <= 0 ) {    // Same state as init() - (issue #296)
-    if ( arr ) free(arr);
-    arr   = 0;
-    _size = 0;
-    return;
-  }
-  if (count != _size) {
-    arr = (char*)realloc(arr, (unsigned)count * sizeof(char));
-    _size = count;
+// Redraw the visible part of a range of rows whose selection changed
+void Fl_Table_Row::redraw_selection(int first, int last) {
+  int top = ( first > toprow ) ? first : toprow;
+  int bot = ( last < botrow ) ? last : botrow;
+  if ( top <= bot ) {
+    redraw_range(top, bot, leftcol, rightcol);
   }
+  selection_changed(first, last);
 }
 
-
 // Is row selected?
 int Fl_Table_Row::row_selected(int row) {
   if ( row < 0 || row >= rows() ) return(-1);
-  return(_rowselect[row]);
+  return(_rowselect.contains(row));
 }
 
 // Change row selection type
@@ -75,20 +60,15 @@ void Fl_Table_Row::type(TableRowSelectMode val) {
   _selectmode = val;
   switch ( _selectmode ) {
     case SELECT_NONE: {
-      for ( int row=0; row<rows(); row++ ) {
-        _rowselect[row] = 0;
-      }
+      _rowselect.clear();
       redraw();
       break;
     }
     case SELECT_SINGLE: {
-      int count = 0;
-      for ( int row=0; row<rows(); row++ ) {
-        if ( _rowselect[row] ) {
-          if ( ++count > 1 ) {  // only one allowed
-            _rowselect[row] = 0;
-          }
-        }
+      int row = _rowselect.next_set(0);         // only one allowed
+      _rowselect.clear();
+      if ( row >= 0 && row < rows() ) {
+        _rowselect.set(row, row, 1);
       }
       redraw();
       break;
@@ -111,41 +91,51 @@ void Fl_Table_Row::type(TableRowSelectMode val) {
 //       -1 - row out of range or incorrect selection mode
 //
 int Fl_Table_Row::select_row(int row, int flag) {
-  int ret = 0;
   if ( row < 0 || row >= rows() ) { return(-1); }
+  return(select_rows(row, row, flag));
+}
+
+/**
+ Changes the selection state of the rows \p first to \p last, inclusive,
+ depending on the value of \p flag: 0=deselect, 1=select, 2=toggle
+ existing state.
+
+ The time this takes depends on the number of selected ranges of rows,
+ not on the number of rows in the range. The range is clipped to the rows
+ of the table. In SELECT_SINGLE mode only the state of row \p last is
+ changed, and all other rows are deselected.
+
+ \returns 0 if no selection state changed, 1 if it changed, -1 if the
+   range is outside of the table or the selection mode is SELECT_NONE.
+ \version 1.4.0
+ */
+int Fl_Table_Row::select_rows(int first, int last, int flag) {
+  if ( first < 0 ) first = 0;
+  if ( last >= rows() ) last = rows() - 1;
+  if ( first > last ) { return(-1); }
+  int ret = 0;
   switch ( _selectmode ) {
     case SELECT_NONE:
       return(-1);
 
     case SELECT_SINGLE: {
-      int oldval;
-      for ( int t=0; t<rows(); t++ ) {
-        if ( t == row ) {
-          oldval = _rowselect[row];
-          if ( flag == 2 ) { _rowselect[row] ^= 1; }
-          else             { _rowselect[row] = flag; }
-          if ( oldval != _rowselect[row] ) {
-            redraw_range(row, row, leftcol, rightcol);
-            ret = 1;
-          }
-        }
-        else if ( _rowselect[t] ) {
-          _rowselect[t] = 0;
-          redraw_range(t, t, leftcol, rightcol);
+      int row = last;
+      for ( int t = _rowselect.next_set(0); t >= 0 && t < rows(); t = _rowselect.next_set(t + 1) ) {
+        if ( t != row ) {
+          _rowselect.set(t, t, 0);
+          redraw_selection(t, t);
         }
       }
+      if ( _rowselect.set(row, row, flag) ) {
+        redraw_selection(row, row);
+        ret = 1;
+      }
       break;
     }
 
     case SELECT_MULTI: {
-      int oldval = _rowselect[row];
-      if ( flag == 2 ) { _rowselect[row] ^= 1; }
-      else             { _rowselect[row] = flag; }
-      if ( _rowselect[row] != oldval ) {                // select state changed?
-        if ( row >= toprow && row <= botrow ) {         // row visible?
-          // Extend partial redraw range
-          redraw_range(row, row, leftcol, rightcol);
-        }
+      if ( _rowselect.set(first, last, flag) ) {        // select state changed?
+        redraw_selection(first, last);
         ret = 1;
       }
     }
@@ -164,20 +154,26 @@ void Fl_Table_Row::select_all_rows(int flag) {
       //FALLTHROUGH
 
     case SELECT_MULTI: {
+      int nrows = rows();
+      if ( nrows <= 0 ) return;
       char changed = 0;
       if ( flag == 2 ) {
-        for ( int row=0; row<(int)_rowselect.size(); row++ ) {
-          _rowselect[row] ^= 1;
-        }
+        _rowselect.invert();
+        _rowselect.set(nrows, INT_MAX, 0);      // rows past the end stay deselected
         changed = 1;
+      } else if ( flag ) {
+        int row = _rowselect.next_unset(0);
+        changed = ( row >= 0 && row < nrows ) ? 1 : 0;
+        _rowselect.clear();
+        _rowselect.set(0, nrows - 1, 1);
       } else {
-        for ( int row=0; row<(int)_rowselect.size(); row++ ) {
-          changed |= (_rowselect[row] != flag)?1:0;
-          _rowselect[row] = flag;
-        }
+        int row = _rowselect.next_set(0);
+        changed = ( row >= 0 && row < nrows ) ? 1 : 0;
+        _rowselect.clear();
       }
       if ( changed ) {
         redraw();
+        selection_changed(0, nrows - 1);
       }
     }
   }
@@ -186,8 +182,8 @@ void Fl_Table_Row::select_all_rows(int flag) {
 // Set number of rows
 void Fl_Table_Row::rows(int val) {
   Fl_Table::rows(val);
-  while ( val > (int)_rowselect.size() ) { _rowselect.push_back(0); }   // enlarge
-  while ( val < (int)_rowselect.size() ) { _rowselect.pop_back(); }     // shrink
+  if ( val <= 0 ) { _rowselect.clear(); }
+  else            { _rowselect.set(val, INT_MAX, 0); }  // deselect removed rows
 }
 
 // Handle events
@@ -244,9 +240,7 @@ int Fl_Table_Row::handle(int event) {
                   srow = _last_row;
                   erow = R;
                 }
-                for ( int row = srow; row <= erow; row++ ) {
-                  select_row(row, 1);
-                }
+                select_rows(srow, erow, 1);
               }
               break;
             }
@@ -310,9 +304,7 @@ int Fl_Table_Row::handle(int event) {
                   srow = _last_row;
                   erow = R;
                 }
-                for ( int row = srow; row <= erow; row++ ) {
-                  select_row(row, 1);
-                }
+                select_rows(srow, erow, 1);
               }
               break;
           }
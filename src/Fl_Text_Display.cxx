@@ -31,6 +31,7 @@
 #include <FL/Fl_Text_Display.H>
 #include <FL/Fl_Window.H>
 #include "Fl_Screen_Driver.H"
+#include "Fl_System_Driver.H"
 
 #undef min
 #undef max
@@ -76,6 +77,71 @@ static int max( int i1, int i2 );
 static int min( int i1, int i2 );
 static int countlines( const char *string );
 
+
+/*
+ In continuous wrap mode the display keeps the number of wrapped rows of
+ blocks of whole lines, so that neither an edit nor a new wrap width
+ requires to measure all text. An edit measures the blocks it touches.
+ The row counts are exact for the width and the fonts recorded in the
+ cache. When these change, the counts are replaced by estimates, which the
+ idle callback measures block by block while the scrollbar follows the
+ corrected counts.
+ */
+
+// Text is measured in blocks of whole lines of about this many bytes.
+#define WRAP_BLOCK 4096
+
+// Time in seconds the idle callback spends measuring blocks.
+#define WRAP_TIME_SLICE 0.005
+
+struct Fl_Text_Wrap_Block {
+  int length;                   // all blocks but the last end after a newline
+  int lines;                    // number of newlines
+  int rows;                     // number of wrapped rows
+  int exact;                    // 0 if rows is an estimate
+};
+
+struct Fl_Text_Wrap_Cache {
+  Fl_Text_Wrap_Block *blocks;
+  int count, alloc;
+  int width;                    // wrap width of the row counts
+  unsigned fonts;               // hash of the fonts of the row counts
+  int last_row;                 // the row after the last newline, see last_wrapped_row()
+};
+
+// Makes room for n blocks at index k.
+static void insert_wrap_blocks(Fl_Text_Wrap_Cache *c, int k, int n) {
+  if (c->count + n > c->alloc) {
+    c->alloc = c->count + n + c->count / 2 + 8;
+    c->blocks = (Fl_Text_Wrap_Block *)realloc(c->blocks, c->alloc * sizeof(Fl_Text_Wrap_Block));
+  }
+  memmove(c->blocks + k + n, c->blocks + k, (c->count - k) * sizeof(Fl_Text_Wrap_Block));
+  c->count += n;
+}
+
+// Removes n blocks at index k.
+static void remove_wrap_blocks(Fl_Text_Wrap_Cache *c, int k, int n) {
+  memmove(c->blocks + k, c->blocks + k + n, (c->count - k - n) * sizeof(Fl_Text_Wrap_Block));
+  c->count -= n;
+}
+
+// Returns a hash of everything but the wrap width that changes the rows.
+static unsigned wrap_fonts(Fl_Font font, Fl_Fontsize size, int tab,
+                           const Fl_Text_Display::Style_Table_Entry *styles, int n) {
+  unsigned h = ((unsigned)font * 31 + (unsigned)size) * 31 + (unsigned)tab;
+  for (int i = 0; i < n; i++)
+    h = (h * 31 + (unsigned)styles[i].font) * 31 + (unsigned)styles[i].size;
+  return h;
+}
+
+// Returns the number of wrapped rows of the buffer as count_lines() counts them.
+static int wrap_cache_rows(const Fl_Text_Wrap_Cache *c) {
+  int rows = c->last_row;
+  for (int k = 0; k < c->count; k++) rows += c->blocks[k].rows;
+  return rows;
+}
+
+
 /* The variables below are used in a timer event to allow smooth
  scrolling of the text area when the pointer has left the area. */
 static int scroll_direction = 0;
@@ -137,6 +203,7 @@ Fl_Text_Display::Fl_Text_Display(int X, int Y, int W, int H, const char* l)
   mSuppressResync = 0;
   mNLinesDeleted = 0;
   mModifyingTabDistance = 0;    // XXX: UNUSED
+  mWrapCache = 0;
   mColumnScale = 0;
   mCursor_color = FL_FOREGROUND_COLOR;
 
@@ -205,6 +272,7 @@ Fl_Text_Display::~Fl_Text_Display() {
     mBuffer->remove_modify_callback(buffer_modified_cb, this);
     mBuffer->remove_predelete_callback(buffer_predelete_cb, this);
   }
+  clear_wrap_cache();
   if (mLineStarts) delete[] mLineStarts;
   if (linenumber_format_) {
     free((void*)linenumber_format_);
@@ -360,6 +428,7 @@ void Fl_Text_Display::buffer( Fl_Text_Buffer *buf ) {
     buffer_modified_cb( 0, 0, mBuffer->length(), 0, deletedText, this );
     free(deletedText);
     mNBufferLines = 0;
+    clear_wrap_cache();
     mBuffer->remove_modify_callback( buffer_modified_cb, this );
     mBuffer->remove_predelete_callback( buffer_predelete_cb, this );
   }
@@ -410,7 +479,8 @@ void Fl_Text_Display::buffer( Fl_Text_Buffer *buf ) {
 
  \param styleBuffer this buffer works in parallel to the text buffer. For every
    character in the text buffer, the style buffer has a byte at the same offset
-   that contains an index into an array of possible styles.
+   that contains an index into an array of possible styles. NULL turns
+   highlighting off.
  \param styleTable a list of styles indexed by the style buffer
  \param nStyles number of styles in the style table
  \param unfinishedStyle if this style is found, the callback below is called
@@ -421,7 +491,7 @@ void Fl_Text_Display::buffer( Fl_Text_Buffer *buf ) {
 
  \todo  "extendRangeForStyleMods" does not exist (might be a hangover
          from the port from nedit). Find the correct function.
- \see Fl_Text_Display::style_buffer()
+ \see Fl_Text_Display::style_buffer(), Fl_Text_Highlighter
  */
 void Fl_Text_Display::highlight_data(Fl_Text_Buffer *styleBuffer,
                                      const Style_Table_Entry *styleTable,
@@ -436,7 +506,7 @@ void Fl_Text_Display::highlight_data(Fl_Text_Buffer *styleBuffer,
   mHighlightCBArg = cbArg;
   mColumnScale = 0;
 
-  mStyleBuffer->canUndo(0);
+  if (mStyleBuffer) mStyleBuffer->canUndo(0);
   damage(FL_DAMAGE_EXPOSE);
 }
 
@@ -526,7 +596,12 @@ void Fl_Text_Display::recalc_display() {
   if (mContinuousWrap && !mWrapMarginPix) {
 
     int nvlines = (text_area.h + mMaxsize - 1) / mMaxsize;
-    int nlines = buffer()->count_lines(0,buffer()->length());
+    int nlines = 0;
+    if (mWrapCache) {
+      for (int k = 0; k < mWrapCache->count; k++) nlines += mWrapCache->blocks[k].lines;
+    } else {
+      nlines = buffer()->count_lines(0,buffer()->length());
+    }
     if (nvlines < 1) nvlines = 1;
     if (nlines >= nvlines-1) {
       mVScrollBar->set_visible(); // we need a vertical scrollbar
@@ -549,9 +624,8 @@ void Fl_Text_Display::recalc_display() {
     if (mContinuousWrap && !mWrapMarginPix && text_area.w != oldTAWidth) {
 
       int oldFirstChar = mFirstChar;
-      mNBufferLines = count_lines(0, buffer()->length(), true);
       mFirstChar = line_start(mFirstChar);
-      mTopLineNum = count_lines(0, mFirstChar, true)+1;
+      count_wrapped_lines();
       absolute_top_line_number(oldFirstChar);
 #ifdef DEBUG2
       printf("    mNBufferLines=%d\n", mNBufferLines);
@@ -948,15 +1022,21 @@ void Fl_Text_Display::wrap_mode(int wrap, int wrapMargin) {
       break;
   }
 
-  if (buffer()) {
-    /* wrapping can change the total number of lines, re-count */
-    mNBufferLines = count_lines(0, buffer()->length(), true);
+  if (!mContinuousWrap) clear_wrap_cache();
 
+  if (buffer()) {
     /* changing wrap margins or changing from wrapped mode to non-wrapped
      can leave the character at the top no longer at a line start, and/or
      change the line number */
     mFirstChar = line_start(mFirstChar);
-    mTopLineNum = count_lines(0, mFirstChar, true) + 1;
+
+    /* wrapping can change the total number of lines, re-count */
+    if (mContinuousWrap) {
+      count_wrapped_lines();
+    } else {
+      mNBufferLines = count_lines(0, buffer()->length(), true);
+      mTopLineNum = count_lines(0, mFirstChar, true) + 1;
+    }
 
     reset_absolute_top_line_number();
 
@@ -1440,6 +1520,275 @@ int Fl_Text_Display::count_lines(int startPos, int endPos,
 }
 
 
+/**
+ \brief Updates the wrapped line counts after the wrap width changed.
+
+ Sets mNBufferLines and mTopLineNum from the wrapped row counts of the
+ cache, which only requires to measure the text between mFirstChar and the
+ start of its block. If the wrap width or the fonts changed since the rows
+ were counted, the counts are estimated and measured later in the
+ background, so that resizing a display with a large buffer does not
+ measure all text.
+
+ mFirstChar must be the start of a wrapped line.
+ */
+void Fl_Text_Display::count_wrapped_lines() {
+  Fl_Text_Wrap_Cache *c = mWrapCache;
+  int width = mWrapMarginPix ? mWrapMarginPix : text_area.w;
+  unsigned fonts = wrap_fonts(textfont(), textsize(), mBuffer->tab_distance(),
+                              mStyleTable, mNStyles);
+  if (!c) {
+    reset_wrap_cache(-1);
+    c = mWrapCache;
+  } else if (c->width != width || c->fonts != fonts) {
+    for (int k = 0, start = 0; k < c->count; start += c->blocks[k++].length) {
+      Fl_Text_Wrap_Block &b = c->blocks[k];
+      // the number of wrap points is about inversely proportional to the width
+      if (width > 0 && c->width > 0)
+        b.rows = b.lines + (int)((double)(b.rows - b.lines) * c->width / width);
+      else
+        b.rows = b.lines;
+      b.exact = 0;
+      if (b.length > 2 * WRAP_BLOCK) split_wrap_block(k, start);
+    }
+    c->width = width;
+    c->fonts = fonts;
+    c->last_row = last_wrapped_row();
+    if (!Fl::has_idle(wrap_cache_idle_cb, this))
+      Fl::add_idle(wrap_cache_idle_cb, this);
+  }
+  mNBufferLines = wrap_cache_rows(c);
+  mTopLineNum = wrapped_top_line();
+}
+
+/**
+ \brief Starts a new wrapped line cache for the whole buffer.
+
+ The rows are measured later in the background.
+ \param rows estimated number of wrapped rows of the buffer, or -1
+ */
+void Fl_Text_Display::reset_wrap_cache(int rows) {
+  Fl_Text_Wrap_Cache *c = mWrapCache;
+  if (!c) c = mWrapCache = (Fl_Text_Wrap_Cache *)calloc(1, sizeof(Fl_Text_Wrap_Cache));
+  c->count = 0;
+  c->width = mWrapMarginPix ? mWrapMarginPix : text_area.w;
+  c->fonts = wrap_fonts(textfont(), textsize(), mBuffer->tab_distance(),
+                        mStyleTable, mNStyles);
+  c->last_row = 0;
+  int length = mBuffer->length();
+  if (!length) return;
+  insert_wrap_blocks(c, 0, 1);
+  Fl_Text_Wrap_Block &b = c->blocks[0];
+  b.length = length;
+  b.lines = 0;
+  b.rows = max(rows, 0);
+  b.exact = 0;
+  c->last_row = last_wrapped_row();
+  split_wrap_block(0, 0);
+}
+
+/**
+ \brief Frees the wrapped line cache and stops measuring it.
+ */
+void Fl_Text_Display::clear_wrap_cache() {
+  Fl::remove_idle(wrap_cache_idle_cb, this);
+  if (!mWrapCache) return;
+  free(mWrapCache->blocks);
+  free(mWrapCache);
+  mWrapCache = 0;
+}
+
+/**
+ \brief Follows a modification of the buffer in the wrapped line cache.
+
+ The blocks that contain the modification are merged and measured again.
+ The rows found by find_wrap_range() are not exact in all cases, they
+ are only used as an estimate if too much text was inserted to measure
+ it right away.
+
+ \param pos, nInserted, nDeleted the modification
+ \param linesDelta change of the number of newlines
+ \param rowsDelta change of the number of wrapped rows
+ */
+void Fl_Text_Display::wrap_cache_changed(int pos, int nInserted, int nDeleted,
+                                         int linesDelta, int rowsDelta) {
+  Fl_Text_Wrap_Cache *c = mWrapCache;
+  if (!c->count) {
+    insert_wrap_blocks(c, 0, 1);
+    c->blocks[0].length = c->blocks[0].lines = c->blocks[0].rows = 0;
+    c->blocks[0].exact = 1;
+  }
+  // find the blocks that contain pos and pos+nDeleted, or the last block
+  int k0 = -1, k1 = c->count - 1, start0 = 0, start = 0, k;
+  for (k = 0; k < c->count; k++) {
+    int end = start + c->blocks[k].length;
+    if (k0 < 0 && pos < end) { k0 = k; start0 = start; }
+    if (pos + nDeleted < end) { k1 = k; break; }
+    start = end;
+  }
+  if (k0 < 0) { k0 = c->count - 1; start0 = start - c->blocks[k0].length; }
+
+  Fl_Text_Wrap_Block m = c->blocks[k0];
+  for (k = k0 + 1; k <= k1; k++) {
+    m.length += c->blocks[k].length;
+    m.lines += c->blocks[k].lines;
+    m.rows += c->blocks[k].rows;
+  }
+  m.length += nInserted - nDeleted;
+  m.lines += linesDelta;
+  m.rows += rowsDelta;
+  if (k1 == c->count - 1)       // the last line may have changed
+    c->last_row = last_wrapped_row();
+  remove_wrap_blocks(c, k0 + 1, k1 - k0);
+  c->blocks[k0] = m;
+
+  if (!m.length && c->count > 1) {
+    remove_wrap_blocks(c, k0, 1);
+  } else if (m.length > 2 * WRAP_BLOCK) {
+    split_wrap_block(k0, start0);
+  } else {
+    Fl_Text_Wrap_Block &b = c->blocks[k0];
+    b.rows = wrap_block_rows(start0, start0 + b.length);
+    b.exact = 1;
+    if (b.length < WRAP_BLOCK / 4 && k0 + 1 < c->count) {
+      Fl_Text_Wrap_Block &next = c->blocks[k0 + 1];
+      next.length += b.length;
+      next.lines += b.lines;
+      next.rows += b.rows;
+      remove_wrap_blocks(c, k0, 1);
+    }
+  }
+}
+
+/**
+ \brief Splits a block of the wrapped line cache.
+
+ Block \p k, which starts at \p start, is split into blocks of whole lines
+ of about WRAP_BLOCK bytes. Their newlines are counted and the rows of the
+ block are distributed among them as estimates, which are measured later
+ in the background.
+ */
+void Fl_Text_Display::split_wrap_block(int k, int start) {
+  Fl_Text_Wrap_Cache *c = mWrapCache;
+  Fl_Text_Wrap_Block b = c->blocks[k];
+  int end = start + b.length, n = 0, pos;
+  for (pos = start; pos < end; n++) {
+    int cut = end;
+    if (end - pos > 2 * WRAP_BLOCK) {
+      cut = mBuffer->line_end(mBuffer->utf8_align(pos + WRAP_BLOCK)) + 1;
+      if (cut > end) cut = end;
+    }
+    if (n) insert_wrap_blocks(c, k + n, 1);
+    Fl_Text_Wrap_Block &p = c->blocks[k + n];
+    p.length = cut - pos;
+    p.lines = mBuffer->count_lines(pos, cut);
+    p.exact = 0;
+    pos = cut;
+  }
+  int rest = b.rows;
+  for (int i = 0; i < n; i++) {
+    Fl_Text_Wrap_Block &p = c->blocks[k + i];
+    if (i < n - 1)
+      p.rows = p.lines + (int)((double)(b.rows - b.lines) * p.length / b.length);
+    else
+      p.rows = max(p.lines, rest);  // keep the total if possible
+    rest -= p.rows;
+  }
+  if (n && !Fl::has_idle(wrap_cache_idle_cb, this))
+    Fl::add_idle(wrap_cache_idle_cb, this);
+}
+
+// Returns the number of wrapped rows of the whole lines from start to end,
+// not counting the row after the last newline of the buffer.
+int Fl_Text_Display::wrap_block_rows(int start, int end) const {
+  if (end <= start) return 0;
+  if (mBuffer->byte_at(end - 1) == '\n')
+    return count_lines(start, end - 1, true) + 1;
+  int retPos, retLines, retLineStart, retLineEnd;
+  wrapped_line_counter(mBuffer, start, end, INT_MAX, true, 0, &retPos, &retLines,
+                       &retLineStart, &retLineEnd, false);
+  return retLines;
+}
+
+// Returns what count_lines() adds for the row after the last newline of
+// the buffer if it is not empty.
+int Fl_Text_Display::last_wrapped_row() const {
+  int length = mBuffer->length();
+  if (!length || mBuffer->byte_at(length - 1) == '\n') return 0;
+  int start = mBuffer->line_start(length);
+  return count_lines(start, length, true) - wrap_block_rows(start, length);
+}
+
+// Returns the line number of mFirstChar, using the wrapped line cache.
+int Fl_Text_Display::wrapped_top_line() const {
+  const Fl_Text_Wrap_Cache *c = mWrapCache;
+  int rows = 0, start = 0;
+  for (int k = 0; k < c->count; k++) {
+    int end = start + c->blocks[k].length;
+    if (mFirstChar < end || k == c->count - 1) {
+      if (mFirstChar > start) rows += count_lines(start, mFirstChar, true);
+      break;
+    }
+    rows += c->blocks[k].rows;
+    start = end;
+  }
+  return rows + 1;
+}
+
+/**
+ \brief Measures estimated blocks of the wrapped line cache.
+
+ Blocks are measured until \p endTime, and the line counts and the
+ scrollbar are corrected.
+ \return non-zero if blocks are left to be measured
+ */
+int Fl_Text_Display::refine_wrap_cache(double endTime) {
+  Fl_Text_Wrap_Cache *c = mWrapCache;
+  if (!c || !mBuffer) return 0;
+  int changed = 0, left = 0, start = 0, k;
+  for (k = 0; k < c->count; start += c->blocks[k++].length) {
+    if (c->blocks[k].exact) continue;
+    if (changed && Fl::system_driver()->monotonic_time() >= endTime) {
+      left = 1;
+      break;
+    }
+    if (c->blocks[k].length > 2 * WRAP_BLOCK) split_wrap_block(k, start);
+    Fl_Text_Wrap_Block &b = c->blocks[k];
+    int rows = wrap_block_rows(start, start + b.length);
+    int delta = rows - b.rows;
+    b.rows = rows;
+    b.exact = 1;
+    if (start + b.length <= mFirstChar) {
+      if (mTopLineNumHint == mTopLineNum) mTopLineNumHint += delta;
+      mTopLineNum += delta;
+    }
+    changed = 1;
+  }
+  if (!changed) return left;
+
+  mNBufferLines = wrap_cache_rows(c);
+  if (!left) {                  // all counts are exact now
+    int top = wrapped_top_line();
+    if (mTopLineNumHint == mTopLineNum) mTopLineNumHint = top;
+    mTopLineNum = top;
+  }
+  if ((mNBufferLines >= mNVisibleLines) != (mVScrollBar->visible() != 0)) {
+    recalc_display();           // may change the wrap width and estimate again
+    for (k = 0; k < c->count; k++)
+      if (!c->blocks[k].exact) return 1;
+  } else {
+    update_v_scrollbar();
+  }
+  return left;
+}
+
+void Fl_Text_Display::wrap_cache_idle_cb(void *cbArg) {
+  Fl_Text_Display *d = (Fl_Text_Display *)cbArg;
+  double endTime = Fl::system_driver()->monotonic_time() + WRAP_TIME_SLICE;
+  if (!d->refine_wrap_cache(endTime)) Fl::remove_idle(wrap_cache_idle_cb, d);
+}
+
+
 
 /**
  \brief Skip a number of lines forward.
@@ -1704,6 +2053,15 @@ void Fl_Text_Display::buffer_modified_cb( int pos, int nInserted, int nDeleted,
   if (textD->mContinuousWrap) {
     textD->find_wrap_range(deletedText, pos, nInserted, nDeleted,
                            &wrapModStart, &wrapModEnd, &linesInserted, &linesDeleted);
+    if (!textD->mWrapCache) {
+      if (nDeleted == 0 && nInserted == buf->length()) // all text is new
+        textD->reset_wrap_cache(linesInserted);
+    } else if (nInserted != 0 || nDeleted != 0) {
+      textD->wrap_cache_changed(pos, nInserted, nDeleted,
+                                buf->count_lines(pos, pos + nInserted) -
+                                (nDeleted ? countlines(deletedText) : 0),
+                                linesInserted - linesDeleted);
+    }
   } else {
     linesInserted = nInserted == 0 ? 0 : buf->count_lines( pos, pos + nInserted );
     linesDeleted = nDeleted == 0 ? 0 : countlines( deletedText );
@@ -1734,7 +2092,10 @@ void Fl_Text_Display::buffer_modified_cb( int pos, int nInserted, int nDeleted,
   }
 
   /* Update the line count for the whole buffer */
-  textD->mNBufferLines += linesInserted - linesDeleted;
+  if (textD->mWrapCache)
+    textD->mNBufferLines = wrap_cache_rows(textD->mWrapCache);
+  else
+    textD->mNBufferLines += linesInserted - linesDeleted;
 
   /* Update the cursor position */
   if ( textD->mCursorToHint != NO_HINT ) {
@@ -3656,7 +4017,7 @@ void Fl_Text_Display::wrapped_line_counter(Fl_Text_Buffer *buf, int startPos,
   *retPos = buf->length();
   *retLines = nLines;
   if (countLastLineMissingNewLine && colNum > 0)
-    *retLines = buf->next_char(*retLines);
+    *retLines = nLines + 1;
   *retLineStart = lineStart;
   *retLineEnd = buf->length();
 }
@@ -0,0 +1,355 @@
+//
+// Incremental syntax highlighting for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <FL/Fl_Text_Highlighter.H>
+#include <FL/Fl.H>
+#include "Fl_System_Driver.H"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Text is styled in batches of whole lines of about this many bytes.
+#define BATCH_BYTES 16384
+
+// When text must be drawn that the background work has not reached yet,
+// the work is done right away if it is at most this many bytes behind.
+// Further away the displayed lines are styled provisionally.
+#define ON_DEMAND_BYTES 262144
+
+// Number of lines styled when the display asks for unfinished text.
+#define ON_DEMAND_LINES 64
+
+/**
+ Creates a highlighter that is not attached to a display.
+ */
+Fl_Text_Highlighter::Fl_Text_Highlighter() {
+  display_ = 0;
+  tracker_ = 0;
+  text_ = 0;
+  style_ = 0;
+  unfinished_ = 0;
+  state_ = 0;
+  nlines_ = alloc_ = 0;
+  dirty_ = dirty_pos_ = clean_ = 0;
+  anchor_ = anchor_pos_ = 0;
+  time_slice_ = 0.005;
+  in_draw_ = 0;
+}
+
+/**
+ Detaches the highlighter from its display and frees its style buffer.
+ */
+Fl_Text_Highlighter::~Fl_Text_Highlighter() {
+  detach();
+  free(state_);
+}
+
+/**
+ Starts highlighting the text of a display.
+
+ The highlighter creates a style buffer for the text buffer currently shown
+ by \p display and installs it with Fl_Text_Display::highlight_data(). It
+ follows all later changes of that text buffer. If the display is given a
+ different text buffer, attach() must be called again.
+
+ Styles of the style table are referred to by the characters 'A' (first
+ entry) to 'A' + \p nStyles - 1; the character 'A' + \p nStyles is used for
+ text that was not styled yet, so \p nStyles must not exceed 61.
+
+ \param display shows the text to highlight, must have a buffer()
+ \param styleTable table of fonts and colors, managed by the caller
+ \param nStyles number of entries in \p styleTable
+ */
+void Fl_Text_Highlighter::attach(Fl_Text_Display *display,
+                                 const Fl_Text_Display::Style_Table_Entry *styleTable,
+                                 int nStyles) {
+  detach();
+  if (!display || !display->buffer()) return;
+  display_ = display;
+  tracker_ = new Fl_Widget_Tracker(display);
+  text_ = display->buffer();
+  style_ = new Fl_Text_Buffer(text_->length());
+  unfinished_ = char('A' + nStyles);
+  display->highlight_data(style_, styleTable, nStyles, unfinished_, unfinished_cb, this);
+  // added last, so it is called before the display's own modify callback
+  text_->add_modify_callback(modify_cb, this);
+  restyle();
+}
+
+/**
+ Stops highlighting.
+
+ The display no longer uses a style buffer, and the text buffer must still
+ exist when this is called (this includes deleting the highlighter).
+ */
+void Fl_Text_Highlighter::detach() {
+  if (!display_) return;
+  Fl::remove_idle(idle_cb, this);
+  text_->remove_modify_callback(modify_cb, this);
+  if (!tracker_->deleted())
+    display_->highlight_data(NULL, NULL, 0, 0, NULL, NULL);
+  delete tracker_;
+  delete style_;
+  display_ = 0;
+  tracker_ = 0;
+  text_ = 0;
+  style_ = 0;
+  nlines_ = dirty_ = dirty_pos_ = clean_ = 0;
+  anchor_ = anchor_pos_ = 0;
+}
+
+/**
+ Styles the whole text again.
+
+ Call this when the rules of the tokenizer changed. All text is marked
+ unfinished and styled in the background, starting with the part that
+ is visible.
+ */
+void Fl_Text_Highlighter::restyle() {
+  if (!display_) return;
+  int length = text_->length();
+  nlines_ = text_->count_lines(0, length) + 1;
+  if (nlines_ > alloc_) {
+    alloc_ = nlines_ + nlines_ / 4 + 16;
+    state_ = (int *)realloc(state_, alloc_ * sizeof(int));
+  }
+  memset(state_, 0, nlines_ * sizeof(int));
+  char *fill = (char *)malloc(length + 1);
+  memset(fill, unfinished_, length);
+  fill[length] = 0;
+  style_->text(fill);
+  free(fill);
+  dirty_ = dirty_pos_ = 0;
+  clean_ = nlines_;
+  anchor_ = anchor_pos_ = 0;
+  display_->redisplay_range(0, length);
+  schedule();
+}
+
+/**
+ Styles all text that still needs it before returning.
+
+ This may be used before printing or exporting the styled text.
+ */
+void Fl_Text_Highlighter::finish() {
+  if (!display_) return;
+  run(INT_MAX, 0);
+  schedule();
+}
+
+void Fl_Text_Highlighter::modify_cb(int pos, int nInserted, int nDeleted, int,
+                                    const char *deletedText, void *cbArg) {
+  ((Fl_Text_Highlighter *)cbArg)->changed(pos, nInserted, nDeleted, deletedText);
+}
+
+void Fl_Text_Highlighter::unfinished_cb(int pos, void *cbArg) {
+  ((Fl_Text_Highlighter *)cbArg)->style_on_demand(pos);
+}
+
+void Fl_Text_Highlighter::idle_cb(void *cbArg) {
+  Fl_Text_Highlighter *h = (Fl_Text_Highlighter *)cbArg;
+  h->run(-1, Fl::system_driver()->monotonic_time() + h->time_slice_);
+  if (!h->pending()) Fl::remove_idle(idle_cb, h);
+}
+
+void Fl_Text_Highlighter::schedule() {
+  if (pending()) {
+    if (!Fl::has_idle(idle_cb, this)) Fl::add_idle(idle_cb, this);
+  } else {
+    Fl::remove_idle(idle_cb, this);
+  }
+}
+
+// Returns the line containing pos, counting from the closest known line
+// start: the buffer start, the last edit, the start of the pending work or
+// the buffer end (nlines is the current number of lines).
+int Fl_Text_Highlighter::line_of(int pos, int nlines) const {
+  int line = 0, from = 0;
+  if (anchor_pos_ <= pos && anchor_pos_ > from) {
+    line = anchor_; from = anchor_pos_;
+  }
+  if (dirty_ < nlines_ && dirty_pos_ <= pos && dirty_pos_ > from) {
+    line = dirty_; from = dirty_pos_;
+  }
+  int length = text_->length();
+  if (length - pos < pos - from)
+    return nlines - 1 - text_->count_lines(pos, length);
+  return line + text_->count_lines(from, pos);
+}
+
+// Replaces the states of the \p deleted lines after \p line by \p inserted
+// new entries.
+void Fl_Text_Highlighter::splice_lines(int line, int deleted, int inserted) {
+  int n = nlines_ - deleted + inserted;
+  if (n > alloc_) {
+    alloc_ = n + n / 4 + 16;
+    state_ = (int *)realloc(state_, alloc_ * sizeof(int));
+  }
+  int tail = nlines_ - (line + 1 + deleted);
+  if (tail > 0 && deleted != inserted)
+    memmove(state_ + line + 1 + inserted, state_ + line + 1 + deleted, tail * sizeof(int));
+  for (int i = 1; i <= inserted; i++) state_[line + i] = state_[line];
+  nlines_ = n;
+}
+
+// Follows a change of the text buffer: keeps the style buffer in step,
+// restyles the edited lines and the following ones as long as time permits
+// and leaves the rest to the idle callback.
+void Fl_Text_Highlighter::changed(int pos, int nInserted, int nDeleted,
+                                  const char *deletedText) {
+  if (nInserted == 0 && nDeleted == 0) return; // selection change
+  if (nDeleted && nDeleted == style_->length()) { // all text replaced
+    restyle();
+    return;
+  }
+
+  if (nInserted) {
+    char *fill = (char *)malloc(nInserted + 1);
+    memset(fill, unfinished_, nInserted);
+    fill[nInserted] = 0;
+    style_->replace(pos, pos + nDeleted, fill);
+    free(fill);
+  } else {
+    style_->remove(pos, pos + nDeleted);
+  }
+
+  int del = 0;
+  if (deletedText)
+    for (int i = 0; i < nDeleted; i++) if (deletedText[i] == '\n') del++;
+  int ins = nInserted ? text_->count_lines(pos, pos + nInserted) : 0;
+
+  // the last edit position moves with the text behind it
+  if (anchor_pos_ > pos) {
+    if (anchor_pos_ >= pos + nDeleted) {
+      anchor_pos_ += nInserted - nDeleted;
+      anchor_ += ins - del;
+    } else {
+      anchor_ = anchor_pos_ = 0;
+    }
+  }
+  int line = line_of(pos, nlines_ + ins - del);
+  int line_pos = text_->line_start(pos);
+
+  int was_pending = pending();
+  int old_clean = clean_;
+  splice_lines(line, del, ins);
+
+  // lines from line to line + ins must be styled, in addition to what was
+  // pending already
+  int after = line + ins + 1;
+  if (!was_pending) {
+    clean_ = after;
+  } else {
+    clean_ = old_clean > line + del ? old_clean + ins - del : old_clean;
+    if (clean_ < after) clean_ = after;
+  }
+  if (clean_ > nlines_) clean_ = nlines_;
+  if (!was_pending || dirty_ > line) {
+    dirty_ = line;
+    dirty_pos_ = line_pos;
+  }
+  anchor_ = line;
+  anchor_pos_ = line_pos;
+
+  run(line + ins, Fl::system_driver()->monotonic_time() + time_slice_);
+  schedule();
+}
+
+// Called by the display for text with the unfinished style at pos.
+void Fl_Text_Highlighter::style_on_demand(int pos) {
+  int line = line_of(pos, nlines_);
+  if (line < dirty_ || line >= nlines_) return;
+  in_draw_++;
+  if (pos - dirty_pos_ <= ON_DEMAND_BYTES) {
+    run(line + ON_DEMAND_LINES, 0);
+  } else {
+    // Too far ahead of the pending work: style the lines with the state they
+    // had before (0 if never styled). The pending work corrects them later.
+    int start = text_->line_start(pos);
+    int end = text_->skip_lines(start, ON_DEMAND_LINES);
+    int n = end - start;
+    char *text = text_->text_range(start, end);
+    char *style = (char *)calloc(n + 1, 1); // unwritten bytes are 0
+    int state = state_[line];
+    for (int p = 0; p < n; ) {
+      const char *nl = (const char *)memchr(text + p, '\n', n - p);
+      int l = nl ? int(nl - (text + p)) + 1 : n - p;
+      state = style_line(text + p, l, style + p, state);
+      p += l;
+    }
+    for (int i = 0; i < n; i++) if (!style[i]) style[i] = i ? style[i-1] : 'A';
+    style[n] = 0;
+    style_->replace(start, end, style);
+    free(style);
+    free(text);
+    anchor_ = line;
+    anchor_pos_ = start;
+  }
+  in_draw_--;
+  schedule();
+}
+
+// Styles lines from dirty_ on, in batches, until all text is consistent
+// or line \p until was styled and the monotonic clock passed \p deadline.
+void Fl_Text_Highlighter::run(int until, double deadline) {
+  int length = text_->length();
+  while (dirty_ < nlines_) {
+    int start = dirty_pos_;
+    if (start >= length) { // only an empty last line is left
+      dirty_ = nlines_;
+      break;
+    }
+    int end = start + BATCH_BYTES;
+    if (end >= length) {
+      end = length;
+    } else {
+      end = text_->line_start(end);
+      if (end <= start) { // a very long line
+        end = text_->line_end(start);
+        if (end < length) end++;
+      }
+    }
+    int n = end - start, p = 0, converged = 0;
+    char *text = text_->text_range(start, end);
+    char *style = (char *)calloc(n + 1, 1); // unwritten bytes are 0
+    int state = state_[dirty_];
+    while (p < n) {
+      const char *nl = (const char *)memchr(text + p, '\n', n - p);
+      int l = nl ? int(nl - (text + p)) + 1 : n - p;
+      state = style_line(text + p, l, style + p, state);
+      p += l;
+      if (++dirty_ >= nlines_) break;
+      if (dirty_ >= clean_) {
+        // the following lines were styled from this state before
+        if (state_[dirty_] == state) { converged = 1; break; }
+        clean_ = dirty_ + 1;
+      }
+      state_[dirty_] = state;
+    }
+    for (int i = 0; i < p; i++) if (!style[i]) style[i] = i ? style[i-1] : 'A';
+    style[p] = 0;
+    style_->replace(start, start + p, style);
+    free(style);
+    free(text);
+    dirty_pos_ = start + p;
+    if (converged) dirty_ = nlines_;
+    if (!in_draw_) display_->redisplay_range(start, start + p);
+    if (dirty_ > until &&
+        (deadline <= 0 || Fl::system_driver()->monotonic_time() >= deadline))
+      break;
+  }
+}
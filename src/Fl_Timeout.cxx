@@ -17,6 +17,7 @@
 
 #include "Fl_Timeout.h"
 #include "Fl_System_Driver.H"
+#include <FL/Fl_Trace.H>
 
 #include <stdio.h>
 
@@ -396,7 +397,10 @@ void Fl_Timeout::do_timeouts() {
       // make this timeout the "current" timeout
       t->make_current();
       // now it is safe for the callback to do add_timeout:
+      double trace_start = Fl_Trace::start();
+      if (trace_start) Fl_Trace::value(Fl_Trace::TIMEOUT_LATENESS, -t->time);
       t->callback(t->data);
+      if (trace_start) Fl_Trace::add(Fl_Trace::TIMEOUT, trace_start);
       // release the timer entry
       t->release();
 
@@ -0,0 +1,309 @@
+//
+// Event loop and redraw tracing for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <FL/Fl_Trace.H>
+#include <FL/Fl.H>
+#include <FL/fl_utf8.h>
+#include <FL/names.h>
+#include "Fl_System_Driver.H"
+#include <stdlib.h>
+#include <string.h>
+
+char Fl_Trace::enabled_ = 0;
+
+struct Trace_Stat {
+  unsigned long count;
+  double total, max;
+  unsigned long histogram[Fl_Trace::BUCKETS];
+};
+
+// One recorded measurement. For AWAKE_QUEUE and TIMEOUT_LATENESS,
+// 'duration' holds the measured value.
+struct Trace_Event {
+  double start, duration;
+  int metric, arg;
+  char name[28];
+};
+
+static Trace_Stat stats_[Fl_Trace::METRIC_COUNT];
+static Trace_Event *events_ = NULL;     // ring buffer of recorded events
+static int capacity_ = 0;               // size of events_
+static int nevents_ = 0;                // recorded events, up to capacity_
+static int next_event_ = 0;             // where the next event goes
+static double origin_ = 0;              // time of the first recorded event
+static double wake_ = 0;                // end of the last wait for events
+
+static const char *metric_names_[Fl_Trace::METRIC_COUNT] = {
+  "event latency", "event", "flush", "window draw", "widget draw",
+  "timeout", "timeout lateness", "awake queue", "idle"
+};
+
+/**
+  Enables or disables tracing.
+  Statistics and recorded events are kept when tracing is disabled,
+  call reset() to clear them.
+*/
+void Fl_Trace::enable(int on) {
+  enabled_ = on ? 1 : 0;
+  wake_ = 0;
+}
+
+/**
+  Clears all statistics and recorded events.
+*/
+void Fl_Trace::reset() {
+  memset(stats_, 0, sizeof(stats_));
+  nevents_ = next_event_ = 0;
+  origin_ = 0;
+  wake_ = 0;
+}
+
+static const Trace_Stat *stat(Fl_Trace::Metric m) {
+  static const Trace_Stat empty = { 0, 0, 0, { 0 } };
+  if (m < 0 || m >= Fl_Trace::METRIC_COUNT) return &empty;
+  return stats_ + m;
+}
+
+/** Returns the number of measurements of metric \p m. */
+unsigned long Fl_Trace::count(Metric m) {
+  return stat(m)->count;
+}
+
+/** Returns the sum of all measurements of metric \p m. */
+double Fl_Trace::total(Metric m) {
+  return stat(m)->total;
+}
+
+/** Returns the mean of the measurements of metric \p m, or 0 if there was none. */
+double Fl_Trace::mean(Metric m) {
+  const Trace_Stat *s = stat(m);
+  return s->count ? s->total / s->count : 0.0;
+}
+
+/** Returns the largest measurement of metric \p m. */
+double Fl_Trace::maximum(Metric m) {
+  return stat(m)->max;
+}
+
+/**
+  Returns the number of measurements of metric \p m that fell into
+  histogram bucket \p bucket.
+  \see bucket_limit()
+*/
+unsigned long Fl_Trace::histogram(Metric m, int bucket) {
+  if (bucket < 0 || bucket >= BUCKETS) return 0;
+  return stat(m)->histogram[bucket];
+}
+
+// Unit of the histogram buckets of metric m
+static double bucket_unit(Fl_Trace::Metric m) {
+  return m == Fl_Trace::AWAKE_QUEUE ? 1.0 : 1e-6;
+}
+
+/**
+  Returns the upper limit of histogram bucket \p bucket of metric \p m,
+  in seconds or, for AWAKE_QUEUE, in number of queued callbacks.
+  The last bucket has no upper limit, and its lower limit is returned.
+*/
+double Fl_Trace::bucket_limit(Metric m, int bucket) {
+  if (bucket < 0) bucket = 0;
+  if (bucket >= BUCKETS) bucket = BUCKETS - 1;
+  if (bucket == BUCKETS - 1) bucket--;
+  return double(1UL << bucket) * bucket_unit(m);
+}
+
+/**
+  Returns an upper estimate of the \p p-th percentile of metric \p m.
+  The result is the upper limit of the histogram bucket holding the
+  percentile, so it is exact within a factor of two. For instance,
+  percentile(Fl_Trace::FLUSH, 99) is a duration that 99 percent of all
+  flushes didn't exceed.
+*/
+double Fl_Trace::percentile(Metric m, double p) {
+  const Trace_Stat *s = stat(m);
+  if (!s->count) return 0.0;
+  double want = s->count * p / 100.0;
+  unsigned long sum = 0;
+  for (int i = 0; i < BUCKETS - 1; i++) {
+    sum += s->histogram[i];
+    if (sum >= want) {
+      double limit = bucket_limit(m, i);
+      return limit < s->max ? limit : s->max;
+    }
+  }
+  return s->max;
+}
+
+/** Returns a printable name of metric \p m, or NULL. */
+const char *Fl_Trace::metric_name(Metric m) {
+  if (m < 0 || m >= METRIC_COUNT) return NULL;
+  return metric_names_[m];
+}
+
+/**
+  Keeps the last \p capacity measurements for write_chrome_trace().
+  Each event needs 56 bytes. Use 0, the default, to stop recording
+  events and free the memory. This clears previously recorded events.
+*/
+void Fl_Trace::record_events(int capacity) {
+  if (capacity < 0) capacity = 0;
+  free(events_);
+  events_ = capacity ? (Trace_Event*)malloc(capacity * sizeof(Trace_Event)) : NULL;
+  capacity_ = events_ ? capacity : 0;
+  nevents_ = next_event_ = 0;
+  origin_ = 0;
+}
+
+/** Returns the number of events currently recorded. */
+int Fl_Trace::recorded_events() {
+  return nevents_;
+}
+
+/**
+  Returns the current time in seconds of a monotonic clock.
+*/
+double Fl_Trace::now() {
+  return Fl::system_driver()->monotonic_time();
+}
+
+static void add_value(Fl_Trace::Metric m, double start, double value, const char *name, int arg) {
+  Trace_Stat &s = stats_[m];
+  s.count++;
+  s.total += value;
+  if (value > s.max) s.max = value;
+  double v = value / bucket_unit(m);
+  int b = 0;
+  for (double limit = 1; b < Fl_Trace::BUCKETS - 1 && v >= limit; limit *= 2) b++;
+  s.histogram[b]++;
+  if (!capacity_) return;
+  if (!origin_) origin_ = start;
+  Trace_Event &e = events_[next_event_];
+  e.start = start;
+  e.duration = value;
+  e.metric = m;
+  e.arg = arg;
+  e.name[0] = 0;
+  if (name) {
+    // copy, but don't cut an UTF-8 sequence in two
+    int l = (int)strlen(name);
+    if (l >= (int)sizeof(e.name)) {
+      l = sizeof(e.name) - 1;
+      while (l > 0 && (name[l] & 0xC0) == 0x80) l--;
+    }
+    memcpy(e.name, name, l);
+    e.name[l] = 0;
+  }
+  if (++next_event_ >= capacity_) next_event_ = 0;
+  if (nevents_ < capacity_) nevents_++;
+}
+
+/**
+  Adds the duration of a code section to metric \p m.
+  \param m the metric
+  \param start the value returned by start() before the code section;
+    nothing is done if it is 0
+  \param name optional name shown in the trace viewers, e.g. the widget label
+  \param arg optional argument, the event number for Fl_Trace::EVENT
+*/
+void Fl_Trace::add(Metric m, double start, const char *name, int arg) {
+  if (!start) return;
+  double t = now();
+  if (m == EVENT && wake_ && start >= wake_)
+    add_value(EVENT_LATENCY, wake_, start - wake_, NULL, arg);
+  else if (m == FLUSH)
+    wake_ = 0; // events handled after a flush were not waited for
+  add_value(m, start, t - start, name, arg);
+}
+
+/**
+  Adds a value that is not a duration of code, e.g. the length of the
+  awake queue, to metric \p m.
+*/
+void Fl_Trace::value(Metric m, double value, const char *name) {
+  if (!enabled_) return;
+  add_value(m, now(), value, name, 0);
+}
+
+/**
+  Adds the time spent waiting for events, and remembers when waiting ended
+  to measure the latency of the events that follow.
+  \param wait_start the value of start() when waiting began; nothing
+    is done if it is 0
+*/
+void Fl_Trace::woke_up(double wait_start) {
+  if (!wait_start) return;
+  double t = now();
+  add_value(IDLE, wait_start, t - wait_start, NULL, 0);
+  wake_ = t;
+}
+
+static void write_json_string(FILE *out, const char *s) {
+  putc('"', out);
+  for (; *s; s++) {
+    unsigned char c = (unsigned char)*s;
+    if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+    else if (c < 0x20) fprintf(out, "\\u%04x", c);
+    else putc(c, out);
+  }
+  putc('"', out);
+}
+
+/**
+  Writes the recorded events as a Chrome / Perfetto JSON trace file.
+  Durations appear as slices named after the metric, or after the widget
+  or window label, values of AWAKE_QUEUE and TIMEOUT_LATENESS appear as
+  counters.
+  \return 0 on success, -1 on error
+  \see record_events()
+*/
+int Fl_Trace::write_chrome_trace(FILE *out) {
+  if (!out) return -1;
+  fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", out);
+  int first = nevents_ < capacity_ ? 0 : next_event_;
+  for (int i = 0; i < nevents_; i++) {
+    const Trace_Event &e = events_[(first + i) % capacity_];
+    const char *cat = metric_names_[e.metric];
+    const char *name = e.name[0] ? e.name : cat;
+    if (e.metric == EVENT && !e.name[0] && e.arg >= 0 &&
+        e.arg < (int)(sizeof(fl_eventnames) / sizeof(fl_eventnames[0])))
+      name = fl_eventnames[e.arg];
+    double ts = (e.start - origin_) * 1e6;
+    fputs(i ? ",\n{\"name\":" : "{\"name\":", out);
+    write_json_string(out, name);
+    fprintf(out, ",\"cat\":\"%s\",\"pid\":1,\"tid\":1,\"ts\":%.3f,", cat, ts);
+    if (e.metric == AWAKE_QUEUE)
+      fprintf(out, "\"ph\":\"C\",\"args\":{\"queued\":%g}}", e.duration);
+    else if (e.metric == TIMEOUT_LATENESS)
+      fprintf(out, "\"ph\":\"C\",\"args\":{\"ms\":%.3f}}", e.duration * 1e3);
+    else
+      fprintf(out, "\"ph\":\"X\",\"dur\":%.3f}", e.duration * 1e6);
+  }
+  fputs("\n]}\n", out);
+  return ferror(out) ? -1 : 0;
+}
+
+/**
+  Writes the recorded events as a Chrome / Perfetto JSON trace file
+  named \p filename.
+  \return 0 on success, -1 on error
+*/
+int Fl_Trace::write_chrome_trace(const char *filename) {
+  FILE *out = fl_fopen(filename, "w");
+  if (!out) return -1;
+  int ret = write_chrome_trace(out);
+  if (fclose(out)) ret = -1;
+  return ret;
+}
@@ -465,6 +465,32 @@ void Fl_Window::wait_for_expose() {
   pWindowDriver->wait_for_expose();
 }
 
+/**
+  Limits how often Fl::flush() redraws this window.
+
+  This overrides Fl::max_fps(double) for this window only: a window showing
+  an animation may for instance be limited to a lower rate than the rest of
+  the application, or a latency sensitive window can be exempted with a
+  value of 0.
+
+  \param[in] fps  maximum frames per second, 0 for no limit, or a negative
+                  value to use the application-wide Fl::max_fps()
+
+  \see Fl::max_fps(double), Fl::flush_now()
+*/
+void Fl_Window::max_fps(double fps) {
+  pWindowDriver->max_fps_ = fps < 0 ? -1 : fps;
+}
+
+/**
+  Returns the frame rate limit of this window.
+  \return the value set by max_fps(double), or -1 if the window follows
+    the application-wide Fl::max_fps()
+*/
+double Fl_Window::max_fps() const {
+  return pWindowDriver->max_fps_;
+}
+
 
 int Fl_Window::decorated_w() const
 {
@@ -40,6 +40,8 @@ extern void fl_throw_focus(Fl_Widget *o);
 Fl_Window_Driver::Fl_Window_Driver(Fl_Window *win)
   : pWindow(win) {
   wait_for_expose_value = 0;
+  max_fps_ = -1;
+  last_frame_ = 0;
   other_xid = 0;
   screen_num_ = 0;
 }
@@ -17,6 +17,7 @@
 #include <config.h>
 #include <FL/Fl.H>
 #include "Fl_System_Driver.H"
+#include <FL/Fl_Trace.H>
 
 #include <stdlib.h>
 
@@ -106,6 +107,11 @@ int Fl::get_awake_handler_(Fl_Awake_Handler &func, void *&data)
   if ((!awake_ring_) || (awake_ring_head_ == awake_ring_tail_)) {
     ret = -1;
   } else {
+    if (Fl_Trace::enabled_) {
+      int queued = awake_ring_head_ - awake_ring_tail_;
+      if (queued < 0) queued += awake_ring_size_;
+      Fl_Trace::value(Fl_Trace::AWAKE_QUEUE, queued);
+    }
     func = awake_ring_[awake_ring_tail_];
     data = awake_data_[awake_ring_tail_];
     ++awake_ring_tail_;
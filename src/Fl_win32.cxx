@@ -67,6 +67,7 @@ void fl_cleanup_dc_list(void);
 #include <FL/fl_draw.H>
 #include <FL/Enumerations.H>
 #include <FL/Fl_Tooltip.H>
+#include <FL/Fl_Trace.H>
 #include <FL/Fl_Paged_Device.H>
 #include <FL/Fl_Image_Surface.H>
 #include "flstring.h"
@@ -467,9 +468,11 @@ double Fl_WinAPI_System_Driver::wait(double time_to_wait) {
   time_to_wait = Fl_Timeout::time_to_wait(time_to_wait);
 
   int t_msec = (int)(time_to_wait * 1000.0 + 0.5);
+  double trace_start = Fl_Trace::start();
   MsgWaitForMultipleObjects(0, NULL, FALSE, t_msec, QS_ALLINPUT);
 
   fl_lock_function();
+  if (trace_start) Fl_Trace::woke_up(trace_start);
 
   // Execute the message we got, and all other pending messages:
   // have_message = PeekMessage(&fl_msg, NULL, 0, 0, PM_REMOVE);
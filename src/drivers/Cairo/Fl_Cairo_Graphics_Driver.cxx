@@ -23,6 +23,7 @@
 
 #include "Fl_Cairo_Graphics_Driver.H"
 #include "../../Fl_Screen_Driver.H"
+#include "../Unix/Fl_Unix_System_Driver.H"
 #include <FL/platform.H>
 #include <FL/fl_draw.H>
 #include <cairo/cairo.h>
@@ -1037,11 +1038,16 @@ static int font_sort(Fl_Fontdesc *fa, Fl_Fontdesc *fb) {
 
 Fl_Font Fl_Cairo_Graphics_Driver::set_fonts(const char* /*pattern_name*/)
 {
+  static int found = -1; // number of fonts found by a previous call
+  if (found >= 0) return FL_FREE_FONT + found;
   fl_open_display();
   int n_families, count = 0;
   PangoFontFamily **families;
   static PangoFontMap *pfmap_ = pango_cairo_font_map_get_default(); // 1.10
   Fl_Cairo_Graphics_Driver::init_built_in_fonts();
+  // the names found by a previous run, if the installed fonts didn't change
+  found = Fl_Unix_System_Driver::load_font_cache("pango");
+  if (found >= 0) return FL_FREE_FONT + found;
   pango_font_map_list_families(pfmap_, &families, &n_families);
   for (int fam = 0; fam < n_families; fam++) {
     PangoFontFace **faces;
@@ -1062,6 +1068,8 @@ Fl_Font Fl_Cairo_Graphics_Driver::set_fonts(const char* /*pattern_name*/)
   /*g_*/free(families);
   // Sort the list into alphabetic order
   qsort(fl_fonts + FL_FREE_FONT, count, sizeof(Fl_Fontdesc), (sort_f_type)font_sort);
+  Fl_Unix_System_Driver::save_font_cache("pango", count);
+  found = count;
   return FL_FREE_FONT + count;
 }
 
@@ -1158,12 +1166,13 @@ Fl_Cairo_Font_Descriptor::~Fl_Cairo_Font_Descriptor() {
 static Fl_Font_Descriptor* find(Fl_Font fnum, Fl_Fontsize size, PangoContext *context) {
   Fl_Fontdesc* s = fl_fonts+fnum;
   if (!s->name) s = fl_fonts; // use 0 if fnum undefined
-  Fl_Font_Descriptor* f;
-  for (f = s->first; f; f = f->next)
-    if (f->size == size) return f;
+  Fl_Font num = Fl_Font(s - fl_fonts);
+  Fl_Font_Descriptor* f = Fl_Font_Descriptor::find(num, size);
+  if (f) return f;
   f = new Fl_Cairo_Font_Descriptor(s->name, size, context);
   f->next = s->first;
   s->first = f;
+  f->cache(num);
   return f;
 }
 
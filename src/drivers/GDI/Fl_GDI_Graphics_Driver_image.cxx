@@ -800,8 +800,8 @@ void Fl_GDI_Graphics_Driver::cache(Fl_Pixmap *img) {
   Fl_Image_Surface *surf = new Fl_Image_Surface(img->data_w(), img->data_h());
   Fl_Surface_Device::push_current(surf);
   uchar **pbitmap = surf->driver()->mask_bitmap();
-  *pbitmap = (uchar*)1;// will instruct fl_draw_pixmap() to compute the image's mask
-  fl_draw_pixmap(img->data(), 0, 0, FL_BLACK);
+  *pbitmap = (uchar*)1;// will instruct draw_pixmap_data() to compute the image's mask
+  draw_pixmap_data(img, 0, 0, FL_BLACK);
   uchar *bitmap = *pbitmap;
   if (bitmap) {
     *Fl_Graphics_Driver::mask(img) =
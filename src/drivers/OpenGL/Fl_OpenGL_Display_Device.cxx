@@ -22,6 +22,13 @@ Fl_OpenGL_Display_Device *Fl_OpenGL_Display_Device::display_device() {
   return display;
 };
 
+// Draw all primitives that were batched by the driver before another surface
+// becomes current.
+void Fl_OpenGL_Display_Device::end_current() {
+  ((Fl_OpenGL_Graphics_Driver*)driver())->flush_batch();
+  Fl_Surface_Device::end_current();
+}
+
 Fl_OpenGL_Display_Device::Fl_OpenGL_Display_Device(Fl_OpenGL_Graphics_Driver *graphics_driver)
 : Fl_Surface_Device(graphics_driver)
 {
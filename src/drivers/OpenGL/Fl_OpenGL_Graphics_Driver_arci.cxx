@@ -30,6 +30,7 @@
 #include <FL/math.h>
 
 void Fl_OpenGL_Graphics_Driver::arc(int x,int y,int w,int h,double a1,double a2) {
+  flush_batch();
   if (w <= 0 || h <= 0) return;
   while (a2<a1) a2 += 360.0;  // TODO: write a sensible fmod angle alignment here
   a1 = a1/180.0*M_PI; a2 = a2/180.0*M_PI;
@@ -52,6 +53,7 @@ void Fl_OpenGL_Graphics_Driver::arc(double x, double y, double r, double start,
 }
 
 void Fl_OpenGL_Graphics_Driver::pie(int x,int y,int w,int h,double a1,double a2) {
+  flush_batch();
   if (w <= 0 || h <= 0) return;
   while (a2<a1) a2 += 360.0;  // TODO: write a sensible fmod angle alignment here
   a1 = a1/180.0*M_PI; a2 = a2/180.0*M_PI;
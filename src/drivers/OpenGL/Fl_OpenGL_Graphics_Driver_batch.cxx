@@ -0,0 +1,145 @@
+//
+// Primitive batching for the OpenGL graphics driver for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2023 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+/**
+  \file Fl_OpenGL_Graphics_Driver_batch.cxx
+  \brief Collect rectangles, lines, and points into vertex arrays.
+
+  Drawing a widget tree into an Fl_Gl_Window generates a large number of
+  rectangles and short lines. Instead of sending every primitive with
+  glBegin()/glEnd(), primitives of the same kind are collected in a client
+  side vertex array with one color per vertex, and sent with a single call to
+  glDrawArrays() when the primitive kind or the GL state changes.
+
+  Changing the color does not flush the batch. Changing the clipping area or
+  the line style, drawing text or curves, and Fl_Gl_Window::draw_end() do.
+  The vertex arrays require OpenGL 1.1 and work with software renderers
+  like Mesa's llvmpipe.
+*/
+
+#include <config.h>
+#include "Fl_OpenGL_Graphics_Driver.H"
+#include <FL/gl.h>
+
+#include <stdlib.h>
+
+/**
+ A single vertex in the batch.
+ */
+struct Fl_OpenGL_Batch_Vertex {
+  GLfloat x, y;
+  GLubyte rgba[4];
+};
+
+/**
+ Make room for \p n more vertices of the given primitive kind.
+ If the kind of primitive changes, the current batch is sent to OpenGL first.
+ \return a pointer to the first of the new vertices
+ */
+Fl_OpenGL_Batch_Vertex *Fl_OpenGL_Graphics_Driver::batch_reserve(unsigned int mode, int n) {
+  if (batch_count_ && (batch_mode_ != mode || batch_count_ + n > FL_OPENGL_BATCH_MAX))
+    flush_batch();
+  batch_mode_ = mode;
+  if (batch_count_ + n > batch_alloc_) {
+    batch_alloc_ = batch_alloc_ ? 2*batch_alloc_ : 1024;
+    batch_ = (Fl_OpenGL_Batch_Vertex*)realloc(batch_, batch_alloc_ * sizeof(Fl_OpenGL_Batch_Vertex));
+  }
+  Fl_OpenGL_Batch_Vertex *v = batch_ + batch_count_;
+  batch_count_ += n;
+  batch_primitives_++;
+  return v;
+}
+
+static inline void batch_vertex(Fl_OpenGL_Batch_Vertex *v, float x, float y, const unsigned char *rgba) {
+  v->x = x; v->y = y;
+  v->rgba[0] = rgba[0]; v->rgba[1] = rgba[1]; v->rgba[2] = rgba[2]; v->rgba[3] = rgba[3];
+}
+
+/**
+ Add a filled rectangle as two triangles to the batch.
+ */
+void Fl_OpenGL_Graphics_Driver::batch_rectf(float l, float t, float r, float b) {
+  Fl_OpenGL_Batch_Vertex *v = batch_reserve(GL_TRIANGLES, 6);
+  batch_vertex(v++, l, t, rgba_);
+  batch_vertex(v++, r, t, rgba_);
+  batch_vertex(v++, r, b, rgba_);
+  batch_vertex(v++, l, t, rgba_);
+  batch_vertex(v++, r, b, rgba_);
+  batch_vertex(v,   l, b, rgba_);
+}
+
+/**
+ Add a filled triangle to the batch.
+ */
+void Fl_OpenGL_Graphics_Driver::batch_triangle(float x0, float y0, float x1, float y1, float x2, float y2) {
+  Fl_OpenGL_Batch_Vertex *v = batch_reserve(GL_TRIANGLES, 3);
+  batch_vertex(v++, x0, y0, rgba_);
+  batch_vertex(v++, x1, y1, rgba_);
+  batch_vertex(v,   x2, y2, rgba_);
+}
+
+/**
+ Add a line with the current line width and style to the batch.
+ */
+void Fl_OpenGL_Graphics_Driver::batch_line(float x0, float y0, float x1, float y1) {
+  Fl_OpenGL_Batch_Vertex *v = batch_reserve(GL_LINES, 2);
+  batch_vertex(v++, x0, y0, rgba_);
+  batch_vertex(v,   x1, y1, rgba_);
+}
+
+/**
+ Add a point to the batch.
+ */
+void Fl_OpenGL_Graphics_Driver::batch_point(float x, float y) {
+  Fl_OpenGL_Batch_Vertex *v = batch_reserve(GL_POINTS, 1);
+  batch_vertex(v, x, y, rgba_);
+}
+
+/**
+ Send all collected primitives to OpenGL.
+ This must be called before the GL state that affects the collected
+ primitives changes, and before any primitive is drawn directly.
+ */
+void Fl_OpenGL_Graphics_Driver::flush_batch() {
+  if (!batch_count_) return;
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+  glVertexPointer(2, GL_FLOAT, sizeof(Fl_OpenGL_Batch_Vertex), &batch_->x);
+  glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Fl_OpenGL_Batch_Vertex), batch_->rgba);
+  glDrawArrays(batch_mode_, 0, batch_count_);
+  glPopClientAttrib();
+  // the current color is undefined after drawing with a color array
+  glColor4ubv(rgba_);
+  batch_count_ = 0;
+  batch_draw_calls_++;
+}
+
+/**
+ Return the number of glDrawArrays() calls and batched primitives since the
+ last call to reset_batch_statistics().
+ */
+void Fl_OpenGL_Graphics_Driver::batch_statistics(unsigned long &draw_calls, unsigned long &primitives) const {
+  draw_calls = batch_draw_calls_;
+  primitives = batch_primitives_;
+}
+
+/**
+ Reset the counters reported by batch_statistics().
+ */
+void Fl_OpenGL_Graphics_Driver::reset_batch_statistics() {
+  batch_draw_calls_ = batch_primitives_ = 0;
+}
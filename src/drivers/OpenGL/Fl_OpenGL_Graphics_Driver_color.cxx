@@ -32,19 +32,30 @@
 
 extern unsigned fl_cmap[256]; // defined in fl_color.cxx
 
+// The color is stored for batched primitives, and set as the GL color for
+// primitives that are drawn directly.
+void Fl_OpenGL_Graphics_Driver::set_rgba(unsigned rgba) {
+  rgba_[0] = (uchar)(rgba>>24);
+  rgba_[1] = (uchar)(rgba>>16);
+  rgba_[2] = (uchar)(rgba>>8);
+  rgba_[3] = (uchar)rgba;
+  glColor4ubv(rgba_);
+}
+
 void Fl_OpenGL_Graphics_Driver::color(Fl_Color i) {
   if (i & 0xffffff00) {
     unsigned rgba = ((unsigned)i)^0x000000ff;
     Fl_Graphics_Driver::color(i);
-    glColor4ub(rgba>>24, rgba>>16, rgba>>8, rgba);
+    set_rgba(rgba);
   } else {
     unsigned rgba = ((unsigned)fl_cmap[i])^0x000000ff;
     Fl_Graphics_Driver::color(fl_cmap[i]);
-    glColor4ub(rgba>>24, rgba>>16, rgba>>8, rgba);
+    set_rgba(rgba);
   }
 }
 
 void Fl_OpenGL_Graphics_Driver::color(uchar r, uchar g, uchar b) {
   Fl_Graphics_Driver::color( fl_rgb_color(r, g, b) );
+  rgba_[0] = r; rgba_[1] = g; rgba_[2] = b; rgba_[3] = 255;
   glColor3ub(r,g,b);
 }
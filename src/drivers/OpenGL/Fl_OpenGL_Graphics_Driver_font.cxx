@@ -116,6 +116,7 @@ void Fl_OpenGL_Graphics_Driver::text_extents(const char *str, int n, int& dx, in
 
 void Fl_OpenGL_Graphics_Driver::draw(const char *str, int n, int x, int y)
 {
+  flush_batch();
   int i;
   for (i=0; i<n; i++) {
     char c = str[i] & 0x7f;
@@ -189,6 +190,7 @@ void Fl_OpenGL_Graphics_Driver::draw(const char *str, int n, float x, float y) {
 void Fl_OpenGL_Graphics_Driver::draw(int angle, const char *str, int n, int x, int y) {}
 
 void Fl_OpenGL_Graphics_Driver::draw(const char* str, int n, int x, int y) {
+  flush_batch();
   Fl_Surface_Device::push_current(Fl_Display_Device::display_device());
   gl_draw(str, n, x, y);
   Fl_Surface_Device::pop_current();
@@ -31,24 +31,22 @@
 // --- line and polygon drawing with integer coordinates
 
 void Fl_OpenGL_Graphics_Driver::point(int x, int y) {
-  glBegin(GL_POINTS);
-  glVertex2f(x+0.5f, y+0.5f);
-  glEnd();
+  batch_point(x+0.5f, y+0.5f);
 }
 
 void Fl_OpenGL_Graphics_Driver::rect(int x, int y, int w, int h) {
   float offset = line_width_ / 2.0f;
   float xx = x+0.5f, yy = y+0.5f;
   float rr = x+w-0.5f, bb = y+h-0.5f;
-  glRectf(xx-offset, yy-offset, rr+offset, yy+offset);
-  glRectf(xx-offset, bb-offset, rr+offset, bb+offset);
-  glRectf(xx-offset, yy-offset, xx+offset, bb+offset);
-  glRectf(rr-offset, yy-offset, rr+offset, bb+offset);
+  batch_rectf(xx-offset, yy-offset, rr+offset, yy+offset);
+  batch_rectf(xx-offset, bb-offset, rr+offset, bb+offset);
+  batch_rectf(xx-offset, yy-offset, xx+offset, bb+offset);
+  batch_rectf(rr-offset, yy-offset, rr+offset, bb+offset);
 }
 
 void Fl_OpenGL_Graphics_Driver::rectf(int x, int y, int w, int h) {
   if (w<=0 || h<=0) return;
-  glRectf((GLfloat)x, (GLfloat)y, (GLfloat)(x+w), (GLfloat)(y+h));
+  batch_rectf((float)x, (float)y, (float)(x+w), (float)(y+h));
 }
 
 void Fl_OpenGL_Graphics_Driver::line(int x, int y, int x1, int y1) {
@@ -64,22 +62,15 @@ void Fl_OpenGL_Graphics_Driver::line(int x, int y, int x1, int y1) {
   float xx = x+0.5f, xx1 = x1+0.5f;
   float yy = y+0.5f, yy1 = y1+0.5f;
   if (line_width_==1.0f) {
-    glBegin(GL_LINE_STRIP);
-    glVertex2f(xx, yy);
-    glVertex2f(xx1, yy1);
-    glEnd();
+    batch_line(xx, yy, xx1, yy1);
   } else {
     float dx = xx1-xx, dy = yy1-yy;
     float len = sqrtf(dx*dx+dy*dy);
     dx = dx/len*line_width_*0.5f;
     dy = dy/len*line_width_*0.5f;
 
-    glBegin(GL_TRIANGLE_STRIP);
-    glVertex2f(xx-dy, yy+dx);
-    glVertex2f(xx+dy, yy-dx);
-    glVertex2f(xx1-dy, yy1+dx);
-    glVertex2f(xx1+dy, yy1-dx);
-    glEnd();
+    batch_triangle(xx-dy, yy+dx, xx+dy, yy-dx, xx1-dy, yy1+dx);
+    batch_triangle(xx+dy, yy-dx, xx1-dy, yy1+dx, xx1+dy, yy1-dx);
   }
 }
 
@@ -92,46 +83,47 @@ void Fl_OpenGL_Graphics_Driver::line(int x, int y, int x1, int y1, int x2, int y
 void Fl_OpenGL_Graphics_Driver::xyline(int x, int y, int x1) {
   float offset = line_width_ / 2.0f;
   float xx = (float)x, yy = y+0.5f, rr = x1+1.0f;
-  glRectf(xx, yy-offset, rr, yy+offset);
+  batch_rectf(xx, yy-offset, rr, yy+offset);
 }
 
 void Fl_OpenGL_Graphics_Driver::xyline(int x, int y, int x1, int y2) {
   float offset = line_width_ / 2.0f;
   float xx = (float)x, yy = y+0.5f, rr = x1+0.5f, bb = y2+1.0f;
-  glRectf(xx, yy-offset, rr+offset, yy+offset);
-  glRectf(rr-offset, yy+offset, rr+offset, bb);
+  batch_rectf(xx, yy-offset, rr+offset, yy+offset);
+  batch_rectf(rr-offset, yy+offset, rr+offset, bb);
 }
 
 void Fl_OpenGL_Graphics_Driver::xyline(int x, int y, int x1, int y2, int x3) {
   float offset = line_width_ / 2.0f;
   float xx = (float)x, yy = y+0.5f, xx1 = x1+0.5f, rr = x3+1.0f, bb = y2+0.5f;
-  glRectf(xx, yy-offset, xx1+offset, yy+offset);
-  glRectf(xx1-offset, yy+offset, xx1+offset, bb+offset);
-  glRectf(xx1+offset, bb-offset, rr, bb+offset);
+  batch_rectf(xx, yy-offset, xx1+offset, yy+offset);
+  batch_rectf(xx1-offset, yy+offset, xx1+offset, bb+offset);
+  batch_rectf(xx1+offset, bb-offset, rr, bb+offset);
 }
 
 void Fl_OpenGL_Graphics_Driver::yxline(int x, int y, int y1) {
   float offset = line_width_ / 2.0f;
   float xx = x+0.5f, yy = (float)y, bb = y1+1.0f;
-  glRectf(xx-offset, yy, xx+offset, bb);
+  batch_rectf(xx-offset, yy, xx+offset, bb);
 }
 
 void Fl_OpenGL_Graphics_Driver::yxline(int x, int y, int y1, int x2) {
   float offset = line_width_ / 2.0f;
   float xx = x+0.5f, yy = (float)y, rr = x2+1.0f, bb = y1+0.5f;
-  glRectf(xx-offset, yy, xx+offset, bb+offset);
-  glRectf(xx+offset, bb-offset, rr, bb+offset);
+  batch_rectf(xx-offset, yy, xx+offset, bb+offset);
+  batch_rectf(xx+offset, bb-offset, rr, bb+offset);
 }
 
 void Fl_OpenGL_Graphics_Driver::yxline(int x, int y, int y1, int x2, int y3) {
   float offset = line_width_ / 2.0f;
   float xx = x+0.5f, yy = (float)y, yy1 = y1+0.5f, rr = x2+0.5f, bb = y3+1.0f;
-  glRectf(xx-offset, yy, xx+offset, yy1+offset);
-  glRectf(xx+offset, yy1-offset, rr+offset, yy1+offset);
-  glRectf(rr-offset, yy1+offset, rr+offset, bb);
+  batch_rectf(xx-offset, yy, xx+offset, yy1+offset);
+  batch_rectf(xx+offset, yy1-offset, rr+offset, yy1+offset);
+  batch_rectf(rr-offset, yy1+offset, rr+offset, bb);
 }
 
 void Fl_OpenGL_Graphics_Driver::loop(int x0, int y0, int x1, int y1, int x2, int y2) {
+  flush_batch();
   glBegin(GL_LINE_LOOP);
   glVertex2i(x0, y0);
   glVertex2i(x1, y1);
@@ -140,6 +132,7 @@ void Fl_OpenGL_Graphics_Driver::loop(int x0, int y0, int x1, int y1, int x2, int
 }
 
 void Fl_OpenGL_Graphics_Driver::loop(int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3) {
+  flush_batch();
   glBegin(GL_LINE_LOOP);
   glVertex2i(x0, y0);
   glVertex2i(x1, y1);
@@ -149,26 +142,19 @@ void Fl_OpenGL_Graphics_Driver::loop(int x0, int y0, int x1, int y1, int x2, int
 }
 
 void Fl_OpenGL_Graphics_Driver::polygon(int x0, int y0, int x1, int y1, int x2, int y2) {
-  glBegin(GL_POLYGON);
-  glVertex2i(x0, y0);
-  glVertex2i(x1, y1);
-  glVertex2i(x2, y2);
-  glEnd();
+  batch_triangle((float)x0, (float)y0, (float)x1, (float)y1, (float)x2, (float)y2);
 }
 
 void Fl_OpenGL_Graphics_Driver::polygon(int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3) {
-  glBegin(GL_POLYGON);
-  glVertex2i(x0, y0);
-  glVertex2i(x1, y1);
-  glVertex2i(x2, y2);
-  glVertex2i(x3, y3);
-  glEnd();
+  // like GL_POLYGON, this assumes that the quadrilateral is convex
+  batch_triangle((float)x0, (float)y0, (float)x1, (float)y1, (float)x2, (float)y2);
+  batch_triangle((float)x0, (float)y0, (float)x2, (float)y2, (float)x3, (float)y3);
 }
 
 void Fl_OpenGL_Graphics_Driver::focus_rect(int x, int y, int w, int h) {
   float width = line_width_;
   int stipple = line_stipple_;
-  line_style(FL_DOT, 1);
+  line_style(FL_DOT, 1); // flushes the batch
   glBegin(GL_LINE_LOOP);
   glVertex2f(x+0.5f, y+0.5f);
   glVertex2f(x+w+0.5f, y+0.5f);
@@ -254,6 +240,7 @@ void Fl_OpenGL_Graphics_Driver::push_clip(int x, int y, int w, int h) {
     Fl::warning("Fl_OpenGL_Graphics_Driver::push_clip: clip stack overflow!\n");
     return;
   }
+  flush_batch();
   if (gl_rstackptr==0) {
     gl_rstack[gl_rstackptr].set(x, y, w, h);
   } else {
@@ -267,6 +254,7 @@ void Fl_OpenGL_Graphics_Driver::push_clip(int x, int y, int w, int h) {
  Remove the current clipping area and apply the previous one on the stack.
  */
 void Fl_OpenGL_Graphics_Driver::pop_clip() {
+  flush_batch();
   if (gl_rstackptr==0) {
     glDisable(GL_SCISSOR_TEST);
     Fl::warning("Fl_OpenGL_Graphics_Driver::pop_clip: clip stack underflow!\n");
@@ -284,6 +272,7 @@ void Fl_OpenGL_Graphics_Driver::push_no_clip() {
     Fl::warning("Fl_OpenGL_Graphics_Driver::push_no_clip: clip stack overflow!\n");
     return;
   }
+  flush_batch();
   gl_rstack[gl_rstackptr].set_full();
   gl_rstack[gl_rstackptr].apply();
   gl_rstackptr++;
@@ -301,6 +290,7 @@ Fl_Region Fl_OpenGL_Graphics_Driver::clip_region() {
  we can.
  */
 void Fl_OpenGL_Graphics_Driver::clip_region(Fl_Region r) {
+  flush_batch();
   if (r==NULL) {
     glDisable(GL_SCISSOR_TEST);
   } else {
@@ -312,6 +302,7 @@ void Fl_OpenGL_Graphics_Driver::clip_region(Fl_Region r) {
  Apply the current clipping rect.
  */
 void Fl_OpenGL_Graphics_Driver::restore_clip() {
+  flush_batch();
   if (gl_rstackptr==0) {
     glDisable(GL_SCISSOR_TEST);
   } else {
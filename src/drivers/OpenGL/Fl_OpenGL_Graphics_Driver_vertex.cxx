@@ -58,6 +58,7 @@
 // double Fl_OpenGL_Graphics_Driver::transform_dy(double x, double y)
 
 void Fl_OpenGL_Graphics_Driver::begin_points() {
+  flush_batch();
   n = 0; gap_ = 0;
   what = POINTS;
   glBegin(GL_POINTS);
@@ -68,6 +69,7 @@ void Fl_OpenGL_Graphics_Driver::end_points() {
 }
 
 void Fl_OpenGL_Graphics_Driver::begin_line() {
+  flush_batch();
   n = 0; gap_ = 0;
   what = LINE;
   glBegin(GL_LINE_STRIP);
@@ -78,6 +80,7 @@ void Fl_OpenGL_Graphics_Driver::end_line() {
 }
 
 void Fl_OpenGL_Graphics_Driver::begin_loop() {
+  flush_batch();
   n = 0; gap_ = 0;
   what = LOOP;
   glBegin(GL_LINE_LOOP);
@@ -88,6 +91,7 @@ void Fl_OpenGL_Graphics_Driver::end_loop() {
 }
 
 void Fl_OpenGL_Graphics_Driver::begin_polygon() {
+  flush_batch();
   n = 0; gap_ = 0;
   what = POLYGON;
   glBegin(GL_POLYGON);
@@ -98,6 +102,7 @@ void Fl_OpenGL_Graphics_Driver::end_polygon() {
 }
 
 void Fl_OpenGL_Graphics_Driver::begin_complex_polygon() {
+  flush_batch();
   n = 0;
   what = COMPLEX_POLYGON;
 #ifndef SLOW_COMPLEX_POLY
@@ -243,6 +248,7 @@ void Fl_OpenGL_Graphics_Driver::transformed_vertex(double xf, double yf) {
 }
 
 void Fl_OpenGL_Graphics_Driver::circle(double cx, double cy, double r) {
+  flush_batch();
   double rx = r * (m.c ? sqrt(m.a*m.a+m.c*m.c) : fabs(m.a));
   double ry = r * (m.b ? sqrt(m.b*m.b+m.d*m.d) : fabs(m.d));
   double rMax;
@@ -326,6 +326,7 @@ int Fl_Posix_Printer_Driver::begin_job(int pages, int *firstpage, int *lastpage,
     }
     return 2;
   }
+  setvbuf(ps->output, NULL, _IOFBF, 65536);
   ps->close_command(pclose);
   return ps->start_postscript(pages, format, layout); // start printing
 }
@@ -98,6 +98,15 @@ void Fl_Posix_System_Driver::gettime(time_t *sec, int *usec) {
   *usec = tv.tv_usec;
 }
 
+double Fl_Posix_System_Driver::monotonic_time() {
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+    return double(ts.tv_sec) + ts.tv_nsec / 1000000000.;
+#endif
+  return Fl_System_Driver::monotonic_time();
+}
+
 // Run the specified program, returning 1 on success and 0 on failure
 int Fl_Posix_System_Driver::run_program(const char *program, char **argv, char *msg, int msglen) {
   pid_t pid;                            // Process ID of first child
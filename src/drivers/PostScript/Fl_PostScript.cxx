@@ -61,6 +61,7 @@ int Fl_PostScript_File_Device::begin_job (int pagecount, enum Fl_Paged_Device::P
   Fl_PostScript_Graphics_Driver *ps = driver();
   ps->output = fl_fopen(fnfc.filename(), "w");
   if(ps->output == NULL) return 2;
+  setvbuf(ps->output, NULL, _IOFBF, 65536);
   ps->ps_filename_ = fl_strdup(fnfc.filename());
   ps->start_postscript(pagecount, format, layout);
   return 0;
@@ -144,6 +145,7 @@ Fl_PostScript_Graphics_Driver::Fl_PostScript_Graphics_Driver(void)
   //lang_level_ = 3;
   lang_level_ = 2;
   mask = 0;
+  image_cache_ = NULL;
 #endif
   ps_filename_ = NULL;
   scale_x = scale_y = 1.;
@@ -155,6 +157,9 @@ Fl_PostScript_Graphics_Driver::Fl_PostScript_Graphics_Driver(void)
 /** \brief The destructor. */
 Fl_PostScript_Graphics_Driver::~Fl_PostScript_Graphics_Driver() {
   if(ps_filename_) free(ps_filename_);
+#if ! USE_PANGO
+  share_images_(0);
+#endif
 }
 
 
@@ -341,7 +346,18 @@ static const char * prolog =
 "/GL { setgray } bind def\n"
 "/SRGB { setrgbcolor } bind def\n"
 
-"/A85RLE { /ASCII85Decode filter /RunLengthDecode filter } bind def\n" // ASCII85Decode followed by RunLengthDecode filters
+"/A85LZW { /ASCII85Decode filter /LZWDecode filter } bind def\n" // ASCII85Decode followed by LZWDecode filters
+
+// filter decoding an image resource part, an array of LZW-encoded strings: array IR file
+"/IR { 2 dict begin /A exch def /i 0 def currentdict end\n"
+"[ exch /begin load { i A length lt { A i get /i i 1 add def } { () } ifelse end } /exec load ] cvx\n"
+"/LZWDecode filter } bind def\n"
+
+// data source of the next image: the current file, or the next part of
+// the image resource stored in IDQ
+"/IDQ [] def\n"
+"/IDS { IDQ length 0 eq { currentfile A85LZW }\n"
+"{ IDQ 0 get IR /IDQ IDQ 1 IDQ length 1 sub getinterval store } ifelse } bind def\n"
 
 //  color images
 
@@ -349,7 +365,7 @@ static const char * prolog =
 "translate \n"
 "sx sy scale px py 8 \n"
 "[ px 0 0 py neg 0 py ]\n"
-"currentfile A85RLE\n false 3"
+"IDS\n false 3"
 " colorimage GR\n"
 "} bind def\n"
 
@@ -361,7 +377,7 @@ static const char * prolog =
 
 
 "[ px 0 0 py neg 0 py ]\n"
-"currentfile A85RLE\n"
+"IDS\n"
 "image GR\n"
 "} bind def\n"
 
@@ -371,7 +387,7 @@ static const char * prolog =
 "translate \n"
 "sx sy scale px py true \n"
 "[ px 0 0 py neg 0 py ]\n"
-"currentfile A85RLE\n"
+"IDS\n"
 "imagemask GR\n"
 "} bind def\n"
 
@@ -422,7 +438,7 @@ static const char * prolog_2 =  // prolog relevant only if lang_level >1
 "/Height py def\n"
 "/BitsPerComponent 8 def\n"
 "/Interpolate inter def\n"
-"/DataSource currentfile A85RLE def\n"
+"/DataSource IDS def\n"
 "/MultipleDataSources false def\n"
 "/ImageMatrix [ px 0 0 py neg 0 py ] def\n"
 "/Decode [ 0 1 0 1 0 1 ] def\n"
@@ -442,7 +458,7 @@ static const char * prolog_2 =  // prolog relevant only if lang_level >1
 "/BitsPerComponent 8 def\n"
 
 "/Interpolate inter def\n"
-"/DataSource currentfile A85RLE def\n"
+"/DataSource IDS def\n"
 "/MultipleDataSources false def\n"
 "/ImageMatrix [ px 0 0 py neg 0 py ] def\n"
 "/Decode [ 0 1 ] def\n"
@@ -547,7 +563,7 @@ static const char * prolog_2_pixmap =  // prolog relevant only if lang_level ==
 "pixmap_w pixmap_h scale "
 "pixmap_sx pixmap_sy 8 "
 "pixmap_mat "
-"currentfile A85RLE "
+"IDS "
 "false 3 "
 "colorimage "
 "end "
@@ -565,7 +581,7 @@ static const char * prolog_2_pixmap =  // prolog relevant only if lang_level ==
 "pixmap_sx pixmap_sy\n"
 "true\n"
 "pixmap_mat\n"
-"currentfile A85RLE\n"
+"IDS\n"
 "imagemask\n"
 "GR\n"
 "} bind def\n"
@@ -587,7 +603,7 @@ static const char * prolog_3 = // prolog relevant only if lang_level >2
 "/Height py def\n"
 "/BitsPerComponent 8 def\n"
 "/Interpolate inter def\n"
-"/DataSource currentfile A85RLE def\n"
+"/DataSource IDS def\n"
 "/MultipleDataSources false def\n"
 "/ImageMatrix [ px 0 0 py neg 0 py ] def\n"
 
@@ -628,7 +644,7 @@ static const char * prolog_3 = // prolog relevant only if lang_level >2
 "/Height py def\n"
 "/BitsPerComponent 8 def\n"
 "/Interpolate inter def\n"
-"/DataSource currentfile A85RLE def\n"
+"/DataSource IDS def\n"
 "/MultipleDataSources false def\n"
 "/ImageMatrix [ px 0 0 py neg 0 py ] def\n"
 
@@ -714,7 +730,10 @@ int Fl_PostScript_Graphics_Driver::start_postscript (int pagecount,
     fputs("/CR { GR } bind def\n", output);
   }
   page_policy_ = 1;
-
+  // images drawn more than once go to this dictionary
+  share_images_(lang_level_ > 1);
+  if (lang_level_ > 1)
+    fputs("currentglobal true setglobal /FLI 64 dict def setglobal\n", output);
 
   fputs("%%EndProlog\n",output);
   if (lang_level_ >= 2)
@@ -1154,18 +1173,8 @@ void Fl_PostScript_Graphics_Driver::transformed_draw_extra(const char* str, int
   delete[] img;
   // write the string image to PostScript as a scaled bitmask
   scale = w2 / float(w);
-  clocale_printf("%g %g %g %g %d %d MI\n", x, y - h*0.77/scale, w2/scale, h/scale, w2, h);
-  uchar *di;
   int wmask = (w2+7)/8;
-  void *rle85 = prepare_rle85();
-  for (int j = h - 1; j >= 0; j--){
-    di = img_mask + j * wmask;
-    for (int i = 0; i < wmask; i++){
-      write_rle85(*di, rle85);
-      di++;
-    }
-  }
-  close_rle85(rle85); fputc('\n', output);
+  mask_image_(x, y - h*0.77/scale, w2/scale, h/scale, w2, h, img_mask + (h - 1) * wmask, -wmask, 0);
   delete[] img_mask;
 }
 
@@ -1224,7 +1233,8 @@ void Fl_PostScript_Graphics_Driver::transformed_draw(const char* str, int n, dou
       utf = code;
       }
     else { // unhandled character: draw all string as bitmap image
-      fprintf(output, "~> pop pop\n"); // close and ignore the opened hex string
+      close85(data);
+      fprintf(output, " pop pop\n"); // close and ignore the opened hex string
       transformed_draw_extra(str, n, x, y, w, false);
       return;
     }
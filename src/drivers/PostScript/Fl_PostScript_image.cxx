@@ -24,11 +24,10 @@
 #include <FL/Fl_Bitmap.H>
 #include <stdlib.h>  // abs(int)
 #include <string.h>  // memcpy()
+#include <stdio.h>   // snprintf(), fprintf()
 
 #if USE_PANGO
 #  include <cairo/cairo.h>
-#else
-#  include <stdio.h>   // fprintf()
 #endif
 
 struct callback_data {
@@ -74,6 +73,20 @@ static void destroy_BGRA(void *data) {
   delete[] (uchar*)data;
 }
 
+#ifdef CAIRO_MIME_TYPE_UNIQUE_ID
+// Returns an identifier of the image in a cairo surface, computed from a
+// FNV-1a hash of its data. Cairo embeds only once in the PostScript output
+// the surfaces that have the same identifier.
+static char *unique_id(const uchar *data, int stride, int w, int h, cairo_format_t format) {
+  unsigned long long hash = 14695981039346656037ULL;
+  for (const uchar *p = data, *last = data + stride * h; p < last; p++)
+    hash = (hash ^ *p) * 1099511628211ULL;
+  char *id = (char*)malloc(64);
+  snprintf(id, 64, "fltk-%d-%d-%d-%016llx", int(format), w, h, hash);
+  return id;
+}
+#endif
+
 
 void Fl_PostScript_Graphics_Driver::draw_pixmap(Fl_Pixmap *pxm,int XP, int YP, int WP, int HP, int cx, int cy) {
   Fl_RGB_Image *rgb =  new Fl_RGB_Image(pxm);
@@ -163,6 +176,10 @@ void Fl_PostScript_Graphics_Driver::draw_rgb_bitmap_(Fl_Image *img,int XP, int Y
   if (cairo_surface_status(surf) == CAIRO_STATUS_SUCCESS) {
     static cairo_user_data_key_t key = {};
     (void)cairo_surface_set_user_data(surf, &key, BGRA, destroy_BGRA);
+#ifdef CAIRO_MIME_TYPE_UNIQUE_ID
+    char *id = unique_id(BGRA, stride, img->data_w(), img->data_h(), format);
+    (void)cairo_surface_set_mime_data(surf, CAIRO_MIME_TYPE_UNIQUE_ID, (const uchar*)id, strlen(id), free, id);
+#endif
     cairo_pattern_t *pat = cairo_pattern_create_for_surface(surf);
     cairo_save(cairo_);
     cairo_rectangle(cairo_, XP-0.5, YP-0.5, WP+1, HP+1);
@@ -190,7 +207,8 @@ struct struct85 {
   uchar bytes4[4]; // holds up to 4 input bytes
   int l4;          // # of unencoded input bytes
   int blocks;      // counter to insert newlines after 80 output characters
-  uchar chars5[5]; // holds 5 output characters
+  int count;       // # of output characters in buffer
+  char buffer[4096]; // output characters not yet written to the file
 };
 
 
@@ -199,6 +217,7 @@ void *Fl_PostScript_Graphics_Driver::prepare85() // prepare to produce ASCII85-e
   struct85 *big = new struct85;
   big->l4 = 0;
   big->blocks = 0;
+  big->count = 0;
   return big;
 }
 
@@ -228,16 +247,25 @@ void Fl_PostScript_Graphics_Driver::write85(void *data, const uchar *p, int len)
   struct85 *big = (struct85 *)data;
   const uchar *last = p + len;
   while (p < last) {
-    int c = 4 - big->l4;
-    if (last-p < c) c = int(last-p);
-    memcpy(big->bytes4 + big->l4, p, c);
-    p += c;
-    big->l4 += c;
-    if (big->l4 == 4) {
-      c = convert85(big->bytes4, big->chars5);
-      fwrite(big->chars5, c, 1, output);
+    const uchar *bytes4;
+    if (big->l4 == 0 && last - p >= 4) { // encode 4 bytes of the input
+      bytes4 = p;
+      p += 4;
+    } else {
+      int c = 4 - big->l4;
+      if (last-p < c) c = int(last-p);
+      memcpy(big->bytes4 + big->l4, p, c);
+      p += c;
+      big->l4 += c;
+      if (big->l4 < 4) break;
+      bytes4 = big->bytes4;
       big->l4 = 0;
-      if (++big->blocks >= 16) { fputc('\n', output); big->blocks = 0; }
+    }
+    big->count += convert85(bytes4, (uchar*)big->buffer + big->count);
+    if (++big->blocks >= 16) { big->buffer[big->count++] = '\n'; big->blocks = 0; }
+    if (big->count > int(sizeof(big->buffer)) - 6) {
+      fwrite(big->buffer, 1, big->count, output);
+      big->count = 0;
     }
   }
 }
@@ -250,10 +278,12 @@ void Fl_PostScript_Graphics_Driver::close85(void *data)  // stops ASCII85-encodi
   if (big->l4) { // # of remaining unencoded input bytes
     l = big->l4;
     while (l < 4) big->bytes4[l++] = 0; // complete them with 0s
-    l = convert85(big->bytes4, big->chars5); // encode them
-    if (l == 1) memset(big->chars5, '!', 5);
-    fwrite(big->chars5, big->l4 + 1, 1, output);
+    uchar *chars5 = (uchar*)big->buffer + big->count;
+    l = convert85(big->bytes4, chars5); // encode them
+    if (l == 1) memset(chars5, '!', 5);
+    big->count += big->l4 + 1;
   }
+  fwrite(big->buffer, 1, big->count, output);
   fputs("~>", output); // write EOD mark
   delete big;
 }
@@ -263,87 +293,284 @@ void Fl_PostScript_Graphics_Driver::close85(void *data)  // stops ASCII85-encodi
 //
 
 //
-// Implementation of the /RunLengthEncode + /ASCII85Encode PostScript filter
-// as described in "PostScript LANGUAGE REFERENCE third edition" p. 142
+// Implementation of the /LZWEncode + /ASCII85Encode PostScript filter
+// as described in "PostScript LANGUAGE REFERENCE third edition", LZWDecode filter
+//
+// Codes are 9 to 12 bits long, with the default EarlyChange of 1.
+// When the output goes to ASCII85 strings, a new string is started every
+// chunk bytes, so that strings don't exceed the implementation limit.
 //
 
-struct struct_rle85 {
+enum {
+  LZW_CLEAR = 256,  // code to clear the table
+  LZW_EOD = 257,    // end of data code
+  LZW_FIRST = 258,  // first code of the table
+  LZW_HSIZE = 5003  // size of the hash table of the encoder
+};
+
+struct struct_lzw85 {
   struct85 *data85;  // aux data for ASCII85 encoding
-  uchar buffer[128]; // holds non-run data
-  int count;  // current buffer length
-  int run_length; // current length of run
+  int chunk;         // max # of bytes per ASCII85 string, 0 if not in strings
+  int chunk_count;   // # of bytes in the current string
+  int prefix;        // code of the input matched so far, or -1
+  int next_code;     // code of the next table entry
+  int nbits;         // current code length
+  unsigned bits;     // output bits not yet in buffer
+  int nbits_out;     // # of output bits not yet in buffer
+  int count;         // # of bytes in buffer
+  uchar buffer[256]; // output bytes not yet ASCII85-encoded
+  int keys[LZW_HSIZE];    // prefix and byte of each table entry, -1 if free
+  short codes[LZW_HSIZE]; // code of each table entry
 };
 
-void *Fl_PostScript_Graphics_Driver::prepare_rle85() // prepare to produce RLE+ASCII85-encoded output
+static void put_code(struct_lzw85 *lzw, int code)
 {
-  struct_rle85 *rle = new struct_rle85;
-  rle->count = 0;
-  rle->run_length = 0;
-  rle->data85 = (struct85*)prepare85();
-  return rle;
+  lzw->bits = (lzw->bits << lzw->nbits) | code;
+  lzw->nbits_out += lzw->nbits;
+  while (lzw->nbits_out >= 8) {
+    lzw->nbits_out -= 8;
+    lzw->buffer[lzw->count++] = uchar(lzw->bits >> lzw->nbits_out);
+  }
+  lzw->bits &= (1U << lzw->nbits_out) - 1;
+}
+
+void *Fl_PostScript_Graphics_Driver::prepare_lzw85(int chunk) // prepare to produce LZW+ASCII85-encoded output
+{
+  struct_lzw85 *lzw = new struct_lzw85;
+  if (chunk) fputs("<~", output);
+  lzw->data85 = (struct85*)prepare85();
+  lzw->chunk = chunk;
+  lzw->chunk_count = 0;
+  lzw->prefix = -1;
+  lzw->next_code = LZW_FIRST;
+  lzw->nbits = 9;
+  lzw->bits = 0;
+  lzw->nbits_out = 0;
+  lzw->count = 0;
+  memset(lzw->keys, 0xff, sizeof(lzw->keys));
+  put_code(lzw, LZW_CLEAR);
+  return lzw;
 }
 
 
-void Fl_PostScript_Graphics_Driver::write_rle85(uchar b, void *data) // sends one input byte to RLE+ASCII85 encoding
+void Fl_PostScript_Graphics_Driver::flush_lzw85(void *data) // sends the LZW output to ASCII85 encoding
 {
-  struct_rle85 *rle = (struct_rle85 *)data;
-  uchar c;
-  if (rle->run_length > 0) { // if within a run
-    if (b == rle->buffer[0] &&  rle->run_length < 128) { // the run can be extended
-      rle->run_length++;
-      return;
-    } else { // output the run
-      c = (uchar)(257 - rle->run_length);
-      write85(rle->data85, &c, 1); // the run-length info
-      write85(rle->data85, rle->buffer, 1); // the byte of the run
-      rle->run_length = 0;
+  struct_lzw85 *lzw = (struct_lzw85 *)data;
+  const uchar *p = lzw->buffer;
+  int n = lzw->count;
+  while (n > 0) {
+    int c = n;
+    if (lzw->chunk) {
+      if (lzw->chunk_count >= lzw->chunk) { // start a new string
+        close85(lzw->data85);
+        fputs("\n<~", output);
+        lzw->data85 = (struct85*)prepare85();
+        lzw->chunk_count = 0;
+      }
+      if (c > lzw->chunk - lzw->chunk_count) c = lzw->chunk - lzw->chunk_count;
+      lzw->chunk_count += c;
     }
+    write85(lzw->data85, p, c);
+    p += c;
+    n -= c;
   }
-  if (rle->count >= 2 && b == rle->buffer[rle->count-1] && b == rle->buffer[rle->count-2]) {
-    // about to begin a run
-    if (rle->count > 2) { // there is non-run data before the run in the buffer
-      c = (uchar)(rle->count-2 - 1);
-      write85(rle->data85, &c, 1); // length of non-run data
-      write85(rle->data85, rle->buffer, rle->count-2); // non-run data
+  lzw->count = 0;
+}
+
+
+void Fl_PostScript_Graphics_Driver::write_lzw85(void *data, const uchar *p, int len) // sends len input bytes to LZW+ASCII85 encoding
+{
+  struct_lzw85 *lzw = (struct_lzw85 *)data;
+  const uchar *last = p + len;
+  if (p < last && lzw->prefix < 0) lzw->prefix = *p++;
+  while (p < last) {
+    int c = *p++;
+    int key = (lzw->prefix << 8) | c;
+    int h = (c << 4) ^ lzw->prefix;
+    int disp = (h ? LZW_HSIZE - h : 1);
+    while (lzw->keys[h] != key && lzw->keys[h] >= 0) { // probe the hash table
+      if ((h -= disp) < 0) h += LZW_HSIZE;
+    }
+    if (lzw->keys[h] == key) { // the table has prefix + c, try to extend it
+      lzw->prefix = lzw->codes[h];
+      continue;
+    }
+    if (lzw->count > int(sizeof(lzw->buffer)) - 4) flush_lzw85(lzw);
+    put_code(lzw, lzw->prefix);
+    lzw->prefix = c;
+    lzw->keys[h] = key;
+    lzw->codes[h] = (short)lzw->next_code++;
+    if (lzw->next_code == 4094) { // the table is full, start a new one
+      put_code(lzw, LZW_CLEAR);
+      memset(lzw->keys, 0xff, sizeof(lzw->keys));
+      lzw->next_code = LZW_FIRST;
+      lzw->nbits = 9;
+    } else if (lzw->next_code > (1 << lzw->nbits) - 1) {
+      lzw->nbits++;
     }
-    rle->run_length = 3;
-    rle->buffer[0] = b;
-    rle->count = 0;
-    return;
-  }
-  if (rle->count >= 128) { // the non-run buffer is full, output it
-    c = (uchar)(rle->count - 1);
-    write85(rle->data85, &c, 1); // length of non-run data
-    write85(rle->data85, rle->buffer, rle->count); // non-run data
-    rle->count = 0;
   }
-  rle->buffer[rle->count++] = b; // add byte to end of non-run buffer
 }
 
 
-void Fl_PostScript_Graphics_Driver::close_rle85(void *data) // stop doing RLE+ASCII85 encoding
+void Fl_PostScript_Graphics_Driver::close_lzw85(void *data) // stop doing LZW+ASCII85 encoding
 {
-  struct_rle85 *rle = (struct_rle85 *)data;
-  uchar c;
-  if (rle->run_length > 0) { // if within a run, output it
-    c = (uchar)(257 - rle->run_length);
-    write85(rle->data85, &c, 1);
-    write85(rle->data85, rle->buffer, 1);
-  } else if (rle->count) { // output the non-run buffer, if not empty
-    c = (uchar)(rle->count - 1);
-    write85(rle->data85, &c, 1);
-    write85(rle->data85, rle->buffer, rle->count);
+  struct_lzw85 *lzw = (struct_lzw85 *)data;
+  if (lzw->count > int(sizeof(lzw->buffer)) - 6) flush_lzw85(lzw);
+  if (lzw->prefix >= 0) {
+    put_code(lzw, lzw->prefix);
+    // the decoder adds a table entry when it reads this code
+    if (++lzw->next_code > (1 << lzw->nbits) - 1 && lzw->nbits < 12) lzw->nbits++;
   }
-  c = (uchar)128;
-  write85(rle->data85, &c, 1); // output EOD mark
-  close85(rle->data85); // close ASCII85 encoding process
-  delete rle;
+  put_code(lzw, LZW_EOD);
+  if (lzw->nbits_out) lzw->buffer[lzw->count++] = uchar(lzw->bits << (8 - lzw->nbits_out));
+  flush_lzw85(lzw);
+  close85(lzw->data85); // close ASCII85 encoding process
+  delete lzw;
 }
 
 //
-// End of implementation of the /RunLengthEncode + /ASCII85Encode PostScript filter
+// End of implementation of the /LZWEncode + /ASCII85Encode PostScript filter
 //
 
+//
+// Output of the data of images
+//
+// The data of an image follows the command that draws it, unless the image
+// was drawn before. The second time an image is drawn, its data is stored
+// in a resource in global VM, which survives the save/restore around each
+// page, and the commands that draw the image read it from there. The
+// resource holds the LZW-encoded data of each part of the image as an
+// array of ASCII85 strings. Images are identified by a hash of their data.
+//
+// Images are not shared in EPS files, which should not change global VM,
+// nor when their data comes from a callback of the application.
+//
+
+class Fl_PostScript_Graphics_Driver::Image_Sink {
+public:
+  virtual void write(const uchar *p, int len) = 0;
+  virtual ~Image_Sink() {}
+};
+
+class Fl_PostScript_Graphics_Driver::Image_Data {
+public:
+  int parts;  // # of data streams read by the drawing command
+  int shared; // non-zero if the image can go to a resource
+  int key[5]; // kind and sizes of the image
+  Image_Data() : parts(1), shared(1) { memset(key, 0, sizeof(key)); }
+  virtual void write(int part, Image_Sink &out) = 0;
+  virtual ~Image_Data() {}
+};
+
+// sends the data of an image to LZW+ASCII85 encoding
+class Fl_PostScript_Graphics_Driver::LZW_Sink : public Image_Sink {
+  Fl_PostScript_Graphics_Driver *ps;
+public:
+  void *data;
+  LZW_Sink(Fl_PostScript_Graphics_Driver *d, int chunk) : ps(d) { data = ps->prepare_lzw85(chunk); }
+  void write(const uchar *p, int len) { ps->write_lzw85(data, p, len); }
+  void close() { ps->close_lzw85(data); }
+};
+
+// computes the FNV-1a hash of the data of an image
+class Hash_Sink : public Fl_PostScript_Graphics_Driver::Image_Sink {
+public:
+  unsigned long long hash;
+  Hash_Sink() : hash(14695981039346656037ULL) {}
+  void write(const uchar *p, int len) {
+    unsigned long long h = hash;
+    for (const uchar *last = p + len; p < last; p++) h = (h ^ *p) * 1099511628211ULL;
+    hash = h;
+  }
+};
+
+struct Fl_PostScript_Graphics_Driver::Image_Cache {
+  struct Entry {
+    unsigned long long hash;
+    int id;      // # of the resource, 0 if the image was drawn only once
+    Entry *next;
+  };
+  Entry **table;
+  int size, count;
+  int last_id;
+  Image_Cache() : table(0), size(0), count(0), last_id(0) {}
+  ~Image_Cache() {
+    for (int i = 0; i < size; i++) {
+      for (Entry *e = table[i], *next; e; e = next) { next = e->next; delete e; }
+    }
+    free(table);
+  }
+  // returns the entry of the image with this hash, or NULL after adding one
+  Entry *find(unsigned long long hash) {
+    if (size) {
+      for (Entry *e = table[hash & (size - 1)]; e; e = e->next) {
+        if (e->hash == hash) return e;
+      }
+    }
+    if (count >= size) {
+      int s = size ? 2 * size : 64;
+      Entry **t = (Entry **)calloc(s, sizeof(Entry *));
+      for (int i = 0; i < size; i++) {
+        for (Entry *e = table[i], *next; e; e = next) {
+          next = e->next;
+          e->next = t[e->hash & (s - 1)];
+          t[e->hash & (s - 1)] = e;
+        }
+      }
+      free(table);
+      table = t;
+      size = s;
+    }
+    Entry *e = new Entry;
+    e->hash = hash;
+    e->id = 0;
+    e->next = table[hash & (size - 1)];
+    table[hash & (size - 1)] = e;
+    count++;
+    return NULL;
+  }
+};
+
+void Fl_PostScript_Graphics_Driver::share_images_(int on) {
+  delete image_cache_;
+  image_cache_ = on ? new Image_Cache : NULL;
+}
+
+// Sends the data of an image to a resource if the image was drawn before,
+// and makes the next drawing command read it from there.
+// Returns 1 if the data must follow the drawing command instead.
+int Fl_PostScript_Graphics_Driver::image_resource_(Image_Data &img) {
+  if (!image_cache_ || !img.shared) return 1;
+  Hash_Sink hash;
+  hash.write((const uchar*)img.key, sizeof(img.key));
+  for (int part = 0; part < img.parts; part++) img.write(part, hash);
+  Image_Cache::Entry *e = image_cache_->find(hash.hash);
+  if (!e) return 1;
+  if (!e->id) {
+    e->id = ++image_cache_->last_id;
+    fprintf(output, "currentglobal true setglobal FLI /I%d [\n", e->id);
+    for (int part = 0; part < img.parts; part++) {
+      fputc('[', output);
+      LZW_Sink lzw(this, 32768);
+      img.write(part, lzw);
+      lzw.close();
+      fputs("]\n", output);
+    }
+    fputs("] put setglobal\n", output);
+  }
+  fprintf(output, "/IDQ FLI /I%d get store\n", e->id);
+  return 0;
+}
+
+// Sends the data of an image after the command that draws it.
+void Fl_PostScript_Graphics_Driver::image_inline_(Image_Data &img) {
+  for (int part = 0; part < img.parts; part++) {
+    LZW_Sink lzw(this, 0);
+    img.write(part, lzw);
+    lzw.close();
+    fputc('\n', output);
+  }
+}
 
 int Fl_PostScript_Graphics_Driver::alpha_mask(const uchar * data, int w, int h, int D, int LD){
 
@@ -500,12 +727,85 @@ static inline uchar swap_byte(const uchar b) {
   return (swapped[b & 0xF] << 4) | swapped[b >> 4];
 }
 
+// The data of a color image, with its mask if any
+class Color_Image_Data : public Fl_PostScript_Graphics_Driver::Image_Data {
+  Fl_PostScript_Graphics_Driver *ps;
+  Fl_Draw_Image_Cb call;
+  void *data;
+  int iw, ih, D;
+  uchar *rgbdata, *row;
+public:
+  Color_Image_Data(Fl_PostScript_Graphics_Driver *d, Fl_Draw_Image_Cb cb, void *cb_data,
+                   int w, int h, int delta, int level2_mask) :
+      ps(d), call(cb), data(cb_data), iw(w), ih(h), D(delta) {
+    shared = (call == draw_image_cb);
+    if (level2_mask) parts = 2; // full image data, then mask data
+    key[0] = 1 + level2_mask; key[1] = iw; key[2] = ih;
+    if (ps->mask) { key[3] = ps->mx; key[4] = ps->my; }
+    rgbdata = new uchar[iw*abs(D)];
+    int lmask = ps->mask ? (ps->my/ih) * ((ps->mx+7)/8) : 0;
+    row = new uchar[iw*3 > lmask ? iw*3 : lmask];
+  }
+  ~Color_Image_Data() {
+    delete[] rgbdata;
+    delete[] row;
+  }
+  void write(int part, Fl_PostScript_Graphics_Driver::Image_Sink &out) {
+    int i, j, k;
+    int lmask = ps->mask ? (ps->my/ih) * ((ps->mx+7)/8) : 0;
+    uchar *curmask = ps->mask;
+    if (parts == 2) {
+      for (j = ih - 1; j >= 0; j--) {
+        uchar *q = row;
+        if (part == 0) { // output full image data
+          call(data, 0, j, iw, rgbdata);
+          uchar *curdata = rgbdata;
+          for (i=0 ; i<iw ; i++) {
+            *q++ = curdata[0]; *q++ = curdata[1]; *q++ = curdata[2];
+            curdata += D;
+          }
+        } else { // output mask data
+          curmask = ps->mask + j * lmask;
+          for (k = 0; k < lmask; k++) *q++ = swap_byte(*curmask++);
+        }
+        out.write(row, int(q - row));
+      }
+      return;
+    }
+    for (j=0; j<ih;j++) {
+      if (ps->mask && ps->lang_level_ > 2) {  // InterleaveType 2 mask data
+        for (k = 0; k < lmask; k++) row[k] = swap_byte(*curmask++); //for alpha pseudo-masking
+        out.write(row, lmask);
+      }
+      call(data,0,j,iw,rgbdata);
+      uchar *curdata=rgbdata, *q = row;
+      for (i=0 ; i<iw ; i++) {
+        uchar r = curdata[0];
+        uchar g =  curdata[1];
+        uchar b =  curdata[2];
+
+        if (ps->lang_level_<3 && abs(D)>3) { //can do  mixing using bg_* colors)
+          unsigned int a2 = curdata[3]; //must be int
+          unsigned int a = 255-a2;
+          r = (a2 * r + ps->bg_r * a)/255;
+          g = (a2 * g + ps->bg_g * a)/255;
+          b = (a2 * b + ps->bg_b * a)/255;
+        }
+
+        *q++ = r; *q++ = g; *q++ = b;
+        curdata +=D;
+      }
+      out.write(row, iw*3);
+    }
+  }
+};
+
 void Fl_PostScript_Graphics_Driver::draw_image(Fl_Draw_Image_Cb call, void *data, int ix, int iy, int iw, int ih, int D) {
   double x = ix, y = iy, w = iw, h = ih;
 
-  int level2_mask = 0;
+  Color_Image_Data img(this, call, data, iw, ih, D, mask && lang_level_ == 2);
   fprintf(output,"save\n");
-  int i,j,k;
+  int inline_data = image_resource_(img);
   const char * interpol;
   if (lang_level_ > 1) {
     if (interpolate_) interpol="true";
@@ -514,84 +814,81 @@ void Fl_PostScript_Graphics_Driver::draw_image(Fl_Draw_Image_Cb call, void *data
       fprintf(output, "%g %g %g %g %i %i %i %i %s CIM\n", x , y+h , w , -h , iw , ih, mx, my, interpol);
     }
     else if (mask && lang_level_ == 2) {
-      level2_mask = 1; // use method for drawing masked color image with PostScript level 2
+      // use method for drawing masked color image with PostScript level 2
       fprintf(output, " %g %g %g %g %d %d pixmap_plot\n", x, y, w, h, iw, ih);
     }
     else {
       fprintf(output, "%g %g %g %g %i %i %s CII\n", x , y+h , w , -h , iw , ih, interpol);
     }
   } else {
-    fprintf(output , "%g %g %g %g %i %i CI", x , y+h , w , -h , iw , ih);
+    fprintf(output , "%g %g %g %g %i %i CI\n", x , y+h , w , -h , iw , ih);
   }
+  if (inline_data) image_inline_(img);
+  fprintf(output,"restore\n");
+}
 
-  int LD=iw*abs(D);
-  uchar *rgbdata=new uchar[LD];
-  uchar *curmask=mask;
-  void *big = prepare_rle85();
-
-  if (level2_mask) {
-    for (j = ih - 1; j >= 0; j--) { // output full image data
-      call(data, 0, j, iw, rgbdata);
-      uchar *curdata = rgbdata;
-      for (i=0 ; i<iw ; i++) {
-        write_rle85(curdata[0], big); write_rle85(curdata[1], big); write_rle85(curdata[2], big);
-        curdata += D;
-      }
-    }
-    close_rle85(big); fputc('\n', output);
-    big = prepare_rle85();
-    for (j = ih - 1; j >= 0; j--) { // output mask data
-      curmask = mask + j * (my/ih) * ((mx+7)/8);
-      for (k=0; k < my/ih; k++) {
-        for (i=0; i < ((mx+7)/8); i++) {
-          write_rle85(swap_byte(*curmask), big);
-          curmask++;
-        }
-      }
-    }
+// The data of a gray image, with its mask if any
+class Gray_Image_Data : public Fl_PostScript_Graphics_Driver::Image_Data {
+  Fl_PostScript_Graphics_Driver *ps;
+  Fl_Draw_Image_Cb call; // NULL if the data is in memory
+  const uchar *data;
+  int iw, ih, D, LD;
+  uchar *graydata, *row;
+public:
+  Gray_Image_Data(Fl_PostScript_Graphics_Driver *d, Fl_Draw_Image_Cb cb, const uchar *image_data,
+                  int w, int h, int delta, int ldelta) :
+      ps(d), call(cb), data(image_data), iw(w), ih(h), D(delta), LD(ldelta) {
+    shared = (call == NULL);
+    key[0] = 3; key[1] = iw; key[2] = ih;
+    if (ps->mask) { key[3] = ps->mx; key[4] = ps->my; }
+    graydata = call ? new uchar[iw*D] : NULL;
+    int lmask = ps->mask ? (ps->my/ih) * ((ps->mx+7)/8) : 0;
+    row = new uchar[iw > lmask ? iw : lmask];
   }
-  else {
-    for (j=0; j<ih;j++) {
-      if (mask && lang_level_ > 2) {  // InterleaveType 2 mask data
-        for (k=0; k<my/ih;k++) { //for alpha pseudo-masking
-          for (i=0; i<((mx+7)/8);i++) {
-            write_rle85(swap_byte(*curmask), big);
-            curmask++;
-          }
-        }
+  ~Gray_Image_Data() {
+    delete[] graydata;
+    delete[] row;
+  }
+  void write(int, Fl_PostScript_Graphics_Driver::Image_Sink &out) {
+    int i, j, k;
+    int bg = (ps->bg_r + ps->bg_g + ps->bg_b)/3;
+    int lmask = ps->mask ? (ps->my/ih) * ((ps->mx+7)/8) : 0;
+    uchar *curmask = ps->mask;
+    for (j=0; j<ih;j++){
+      if (ps->mask && (!call || ps->lang_level_ > 2)) {  // InterleaveType 2 mask data
+        for (k = 0; k < lmask; k++) row[k] = swap_byte(*curmask++);
+        out.write(row, lmask);
+      }
+      const uchar *curdata;
+      if (call) {
+        call((void*)data, 0, j, iw, graydata);
+        curdata = graydata;
+      } else {
+        curdata = data + j*LD;
       }
-      call(data,0,j,iw,rgbdata);
-      uchar *curdata=rgbdata;
       for (i=0 ; i<iw ; i++) {
         uchar r = curdata[0];
-        uchar g =  curdata[1];
-        uchar b =  curdata[2];
+        if (!call && ps->lang_level_<3 && abs(D)>1) { //can do  mixing
 
-        if (lang_level_<3 && abs(D)>3) { //can do  mixing using bg_* colors)
-          unsigned int a2 = curdata[3]; //must be int
+          unsigned int a2 = curdata[1]; //must be int
           unsigned int a = 255-a2;
-          r = (a2 * r + bg_r * a)/255;
-          g = (a2 * g + bg_g * a)/255;
-          b = (a2 * b + bg_b * a)/255;
+          r = (a2 * r + bg * a)/255;
         }
-
-        write_rle85(r, big); write_rle85(g, big); write_rle85(b, big);
+        row[i] = r;
         curdata +=D;
       }
-
+      out.write(row, iw);
     }
   }
-  close_rle85(big);
-  fprintf(output,"\nrestore\n");
-  delete[] rgbdata;
-}
+};
 
 void Fl_PostScript_Graphics_Driver::draw_image_mono(const uchar *data, int ix, int iy, int iw, int ih, int D, int LD) {
   double x = ix, y = iy, w = iw, h = ih;
 
+  if (!LD) LD = iw*abs(D);
+  Gray_Image_Data img(this, NULL, data, iw, ih, D, LD);
   fprintf(output,"save\n");
-
-  int i,j, k;
+  int inline_data = image_resource_(img);
 
   const char * interpol;
   if (lang_level_>1){
@@ -604,40 +901,9 @@ void Fl_PostScript_Graphics_Driver::draw_image_mono(const uchar *data, int ix, i
     else
       fprintf(output, "%g %g %g %g %i %i %s GII\n", x , y+h , w , -h , iw , ih, interpol);
   }else
-    fprintf(output , "%g %g %g %g %i %i GI", x , y+h , w , -h , iw , ih);
-
-
-  if (!LD) LD = iw*abs(D);
-
-
-  int bg = (bg_r + bg_g + bg_b)/3;
-
-  uchar *curmask=mask;
-  void *big = prepare_rle85();
-  for (j=0; j<ih;j++){
-    if (mask){
-      for (k=0;k<my/ih;k++){
-        for (i=0; i<((mx+7)/8);i++){
-          write_rle85(swap_byte(*curmask), big);
-          curmask++;
-        }
-      }
-    }
-    const uchar *curdata=data+j*LD;
-    for (i=0 ; i<iw ; i++) {
-      uchar r = curdata[0];
-      if (lang_level_<3 && abs(D)>1) { //can do  mixing
-
-        unsigned int a2 = curdata[1]; //must be int
-        unsigned int a = 255-a2;
-        r = (a2 * r + bg * a)/255;
-      }
-      write_rle85(r, big);
-      curdata +=D;
-    }
+    fprintf(output , "%g %g %g %g %i %i GI\n", x , y+h , w , -h , iw , ih);
 
-  }
-  close_rle85(big);
+  if (inline_data) image_inline_(img);
   fprintf(output,"restore\n");
 }
 
@@ -646,8 +912,8 @@ void Fl_PostScript_Graphics_Driver::draw_image_mono(const uchar *data, int ix, i
 void Fl_PostScript_Graphics_Driver::draw_image_mono(Fl_Draw_Image_Cb call, void *data, int ix, int iy, int iw, int ih, int D) {
   double x = ix, y = iy, w = iw, h = ih;
 
+  Gray_Image_Data img(this, call, (const uchar*)data, iw, ih, D, 0);
   fprintf(output,"save\n");
-  int i,j,k;
   const char * interpol;
   if (lang_level_>1){
     if (interpolate_) interpol="true";
@@ -657,32 +923,46 @@ void Fl_PostScript_Graphics_Driver::draw_image_mono(Fl_Draw_Image_Cb call, void
     else
       fprintf(output, "%g %g %g %g %i %i %s GII\n", x , y+h , w , -h , iw , ih, interpol);
   } else
-    fprintf(output , "%g %g %g %g %i %i GI", x , y+h , w , -h , iw , ih);
-
-  int LD=iw*D;
-  uchar *rgbdata=new uchar[LD];
-  uchar *curmask=mask;
-  void *big = prepare_rle85();
-  for (j=0; j<ih;j++){
-
-    if (mask && lang_level_>2){  // InterleaveType 2 mask data
-      for (k=0; k<my/ih;k++){ //for alpha pseudo-masking
-        for (i=0; i<((mx+7)/8);i++){
-          write_rle85(swap_byte(*curmask), big);
-          curmask++;
-        }
+    fprintf(output , "%g %g %g %g %i %i GI\n", x , y+h , w , -h , iw , ih);
+
+  image_inline_(img);
+  fprintf(output,"restore\n");
+}
+
+// The data of a bitmask
+class Mask_Image_Data : public Fl_PostScript_Graphics_Driver::Image_Data {
+  const uchar *data;
+  int LD, swap;
+  uchar *row;
+public:
+  Mask_Image_Data(const uchar *mask_data, int w, int h, int ldelta, int swap_bits) :
+      data(mask_data), LD(ldelta), swap(swap_bits) {
+    key[0] = 4; key[1] = w; key[2] = h;
+    row = new uchar[(w+7)/8];
+  }
+  ~Mask_Image_Data() { delete[] row; }
+  void write(int, Fl_PostScript_Graphics_Driver::Image_Sink &out) {
+    int xx = (key[1]+7)/8;
+    for (int j = 0; j < key[2]; j++) {
+      const uchar *di = data + j*LD;
+      if (swap) {
+        for (int i = 0; i < xx; i++) row[i] = swap_byte(di[i]);
+        di = row;
       }
-    }
-    call(data,0,j,iw,rgbdata);
-    uchar *curdata=rgbdata;
-    for (i=0 ; i<iw ; i++) {
-      write_rle85(curdata[0], big);
-      curdata +=D;
+      out.write(di, xx);
     }
   }
-  close_rle85(big);
-  fprintf(output,"restore\n");
-  delete[] rgbdata;
+};
+
+// Draws a bitmask of iw x ih pixels in the current color with the MI command.
+// Rows of the mask are LD bytes apart, and the bits of their bytes are reversed
+// if swap is non-zero.
+void Fl_PostScript_Graphics_Driver::mask_image_(double x, double y, double w, double h, int iw, int ih,
+                                                const uchar *data, int LD, int swap) {
+  Mask_Image_Data img(data, iw, ih, LD, swap);
+  int inline_data = image_resource_(img);
+  clocale_printf("%g %g %g %g %d %d MI\n", x, y, w, h, iw, ih);
+  if (inline_data) image_inline_(img);
 }
 
 
@@ -693,10 +973,10 @@ void Fl_PostScript_Graphics_Driver::draw_pixmap(Fl_Pixmap * pxm,int XP, int YP,
   const char * const * di =pxm->data();
   int w,h;
   if (!fl_measure_pixmap(di, w, h)) return;
-  mask=(uchar*)1;// will instruct fl_draw_pixmap() to compute the image's mask
+  mask=(uchar*)1;// will instruct draw_pixmap_data() to compute the image's mask
   mx = w;
   my = h;
-  fl_draw_pixmap(di, 0, 0, FL_BLACK); // assigns mask to an array
+  draw_pixmap_data(pxm, 0, 0, FL_BLACK); // assigns mask to an array
   delete[] mask;
   mask=0;
   clocale_printf("GR GR\n");
@@ -722,17 +1002,7 @@ void Fl_PostScript_Graphics_Driver::draw_rgb(Fl_RGB_Image * rgb,int XP, int YP,
 void Fl_PostScript_Graphics_Driver::draw_bitmap(Fl_Bitmap * bitmap,int XP, int YP, int WP, int HP, int cx, int cy) {
   if (scale_for_image_(bitmap, XP, YP, WP, HP, cx, cy)) return;
   WP = bitmap->data_w(), HP = bitmap->data_h();
-  const uchar * di = bitmap->array;
-  int i, j, xx = (WP+7)/8;
-  fprintf(output , "%i %i %i %i %i %i MI\n", 0, HP, WP, -HP, WP, HP);
-  void *rle85 = prepare_rle85();
-  for (j=0; j<HP; j++){
-    for (i=0; i<xx; i++){
-      write_rle85(swap_byte(*di), rle85);
-      di++;
-    }
-  }
-  close_rle85(rle85); fputc('\n', output);
+  mask_image_(0, HP, WP, -HP, WP, HP, bitmap->array, (WP+7)/8, 1);
   clocale_printf("GR GR\n");
   pop_clip(); // matches push_no_clip in scale_for_image_
 }
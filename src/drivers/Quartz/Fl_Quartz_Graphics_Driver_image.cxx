@@ -248,7 +248,7 @@ static void pmProviderRelease (void *ctxt, const void *data, size_t size) {
 void Fl_Quartz_Graphics_Driver::cache(Fl_Pixmap *img) {
   Fl_Image_Surface *surf = new Fl_Image_Surface(img->data_w(), img->data_h());
   Fl_Surface_Device::push_current(surf);
-  fl_draw_pixmap(img->data(), 0, 0, FL_BLACK);
+  draw_pixmap_data(img, 0, 0, FL_BLACK);
   Fl_Surface_Device::pop_current();
   CGContextRef src = (CGContextRef)Fl_Graphics_Driver::get_offscreen_and_delete_image_surface(surf);
   void *cgdata = CGBitmapContextGetData(src);
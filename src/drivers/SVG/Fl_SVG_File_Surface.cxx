@@ -62,7 +62,11 @@ class Fl_SVG_Graphics_Driver : public Fl_Graphics_Driver {
   };
   Clip * clip_; // top of pile of clips
   int clip_count_; // to generate distinct SVG clip Ids
-  char *last_rgb_name_; // NULL or SVG Id of last defined RGB image
+  struct Image_Def; // an image defined in the <defs> of the SVG output
+  Image_Def **image_defs_; // hash table of defined images
+  int image_defs_size_, image_count_;
+  int image_id_(unsigned long long hash, int w, int h, int d, int dw, int dh, bool &defined);
+  void use_image_(int id, int XP, int YP, int WP, int HP, int cx, int cy, int w, int h);
   const char *family_;
   const char *bold_;
   const char *style_;
@@ -93,8 +97,8 @@ protected:
   int height() ;
   int descent() ;
   void draw_rgb(Fl_RGB_Image *rgb, int XP, int YP, int WP, int HP, int cx, int cy);
-  void define_rgb_png(Fl_RGB_Image *rgb, const char *name, int x, int y);
-  void define_rgb_jpeg(Fl_RGB_Image *rgb, const char *name, int x, int y);
+  void define_rgb_png(Fl_RGB_Image *rgb, int id);
+  void define_rgb_jpeg(Fl_RGB_Image *rgb, int id);
   void draw_pixmap(Fl_Pixmap *pxm,int XP, int YP, int WP, int HP, int cx, int cy);
   void draw_bitmap(Fl_Bitmap *bm,int XP, int YP, int WP, int HP, int cx, int cy);
   void draw_image(const uchar* buf, int x, int y, int w, int h, int d, int l);
@@ -122,6 +126,17 @@ protected:
   void arc_pie(char AorP, int x, int y, int w, int h, double a1, double a2);
 };
 
+// An image defined once in the SVG output and drawn by <use> elements.
+// Images are identified by the hash of their data, so that all drawings of
+// the same data share their definition whatever the image object drawn.
+struct Fl_SVG_Graphics_Driver::Image_Def {
+  unsigned long long hash; // FNV-1a hash of the image data
+  int w, h, d; // size and depth of the image data, d is 0 for bitmaps
+  int dw, dh; // drawn size of the image
+  int id; // the image is "FLimg<id>" in the SVG output
+  Image_Def *next;
+};
+
 Fl_SVG_Graphics_Driver::Fl_SVG_Graphics_Driver(FILE *f) {
   out_ = f;
   width_ = 1;
@@ -137,7 +152,8 @@ Fl_SVG_Graphics_Driver::Fl_SVG_Graphics_Driver(FILE *f) {
   user_dash_array_ = 0;
   dasharray_ = fl_strdup("none");
   p_size = 0;
-  last_rgb_name_ = NULL;
+  image_defs_ = NULL;
+  image_defs_size_ = image_count_ = 0;
 }
 
 Fl_SVG_Graphics_Driver::~Fl_SVG_Graphics_Driver()
@@ -149,7 +165,15 @@ Fl_SVG_Graphics_Driver::~Fl_SVG_Graphics_Driver()
     clip_= clip_->prev;
     delete c;
   }
-  if (last_rgb_name_) free(last_rgb_name_);
+  for (int i = 0; i < image_defs_size_; i++) {
+    Image_Def *def = image_defs_[i];
+    while (def) {
+      Image_Def *next = def->next;
+      delete def;
+      def = next;
+    }
+  }
+  free(image_defs_);
 }
 
 void Fl_SVG_Graphics_Driver::rect(int x, int y, int w, int h) {
@@ -259,12 +283,18 @@ void Fl_SVG_Graphics_Driver::draw(const char *str, int n, int x, int y) {
   fprintf(out_, "<text x=\"%d\" y=\"%d\" font-family=\"%s\"%s%s font-size=\"%d\" "
           "xml:space=\"preserve\" "
           " fill=\"rgb(%u,%u,%u)\" textLength=\"%d\">", x, y, family_, bold_, style_, size(), red_, green_, blue_, (int)width(str, n));
+  const char *run = str; // characters that need no escaping are output by runs
   for (int i = 0; i < n; i++) {
-    if (str[i] == '&') fputs("&amp;", out_);
-    else if (str[i] == '<') fputs("&lt;", out_);
-    else if (str[i] == '>') fputs("&gt;", out_);
-    else fputc(str[i], out_);
+    const char *entity;
+    if (str[i] == '&') entity = "&amp;";
+    else if (str[i] == '<') entity = "&lt;";
+    else if (str[i] == '>') entity = "&gt;";
+    else continue;
+    fwrite(run, 1, str + i - run, out_);
+    fputs(entity, out_);
+    run = str + i + 1;
   }
+  fwrite(run, 1, str + n - run, out_);
   fputs("</text>\n", out_);
 }
 
@@ -378,27 +408,38 @@ struct svg_base64_t { // holds data useful to perform base64-encoding of a strea
   int lline; // follows length of current line in svg file
   uchar buff[3]; // holds up to 3 bytes that still need encoding
   int lbuf; // # of valid bytes in buff
+  char out[4096]; // base64-encoded data not yet written to the svg file
+  int lout; // # of valid bytes in out
 };
 
+// Writes to the svg file the base64-encoded data held in svg_base64->out.
+static void flush_base64(svg_base64_t *svg_base64) {
+  fwrite(svg_base64->out, 1, svg_base64->lout, svg_base64->svg);
+  svg_base64->lout = 0;
+}
+
 // Performs base64 encoding of up to 3 bytes.
 // To be called successively with 3 consecutive bytes (l=3),
 // and possibly with l=1 or l=2 only at the end of the byte stream.
-// Always writes 4 printable characters to the output FILE.
+// Always adds 4 printable characters to the output buffer.
 static void to_base64(uchar *p, int l, svg_base64_t *svg_base64) {
   static char base64_table[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
   uchar B0 = *p++;
   uchar B1 = (l == 1 ? 0 : *p++);
   uchar B2 = (l <= 2 ? 0 : *p);
-  fputc(base64_table[ B0 >> 2 ], svg_base64->svg);
-  fputc(base64_table[ ((B0 & 0x3) << 4) + (B1 >> 4) ], svg_base64->svg);
-  fputc( (l == 1 ? '=' : base64_table[ ((B1 & 0xF) << 2) + (B2 >> 6) ]), svg_base64->svg );
-  fputc( (l < 3 ? '=' : base64_table[ B2 & 0x3F ]), svg_base64->svg );
+  if (svg_base64->lout > (int)sizeof(svg_base64->out) - 5) flush_base64(svg_base64);
+  char *q = svg_base64->out + svg_base64->lout;
+  *q++ = base64_table[ B0 >> 2 ];
+  *q++ = base64_table[ ((B0 & 0x3) << 4) + (B1 >> 4) ];
+  *q++ = (l == 1 ? '=' : base64_table[ ((B1 & 0xF) << 2) + (B2 >> 6) ]);
+  *q++ = (l < 3 ? '=' : base64_table[ B2 & 0x3F ]);
   svg_base64->lline += 4;
   if (svg_base64->lline >= 80) {
-    fputc('\n', svg_base64->svg);
+    *q++ = '\n';
     svg_base64->lline = 0;
   }
+  svg_base64->lout = int(q - svg_base64->out);
 }
 
 // Writes to the svg file, in base64-encoded form, a block of length bytes.
@@ -436,10 +477,9 @@ static void user_write_data(png_structp png_ptr, png_bytep data, png_size_t leng
   }
 }
 
-// processes last bytes to be base64 encoded
+// outputs the bytes of the png stream that were base64 encoded so far
 static void user_flush_data(png_structp png_ptr) {
-  svg_base64_t *svg_base64_data = (svg_base64_t*)png_get_io_ptr(png_ptr);
-  if (svg_base64_data->lbuf) to_base64(svg_base64_data->buff, svg_base64_data->lbuf, svg_base64_data);
+  flush_base64((svg_base64_t*)png_get_io_ptr(png_ptr));
 }
 
 /* How to define first the image data and next use it, possibly several times:
@@ -460,7 +500,7 @@ AxhQP6QxgAEM+LYBf9sdYcTRmp6pAAAAAElFTkSuQmCCAAAAAElFTkSuQmCC"/>
  AxhQP6QxgAEM+LYBf9sdYcTRmp6pAAAAAElFTkSuQmCCAAAAAElFTkSuQmCC"/>
  */
 
-void Fl_SVG_Graphics_Driver::define_rgb_png(Fl_RGB_Image *rgb, const char *name, int x, int y) {
+void Fl_SVG_Graphics_Driver::define_rgb_png(Fl_RGB_Image *rgb, int id) {
   png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
   if (!png_ptr) return;
   png_infop info_ptr = png_create_info_struct(png_ptr);
@@ -468,13 +508,8 @@ void Fl_SVG_Graphics_Driver::define_rgb_png(Fl_RGB_Image *rgb, const char *name,
     png_destroy_write_struct(&png_ptr, (png_infopp)NULL);
     return;
   }
-  if (name) {
-    if (last_rgb_name_) free(last_rgb_name_);
-    last_rgb_name_ = fl_strdup(name);
-  }
   float f = rgb->data_w() > rgb->data_h() ? float(rgb->w()) / rgb->data_w(): float(rgb->h()) / rgb->data_h();
-  if (name) fprintf(out_, "<defs><image id=\"%s\" ", name);
-  else fprintf(out_, "<image x=\"%d\" y=\"%d\" ", x, y);
+  fprintf(out_, "<defs><image id=\"FLimg%d\" ", id);
   fprintf(out_, "width=\"%f\" height=\"%f\" href=\"data:image/png;base64,\n", f*rgb->data_w(), f*rgb->data_h());
   // Transforms the image into a stream of bytes in PNG format,
   // base64-encode this byte stream, and outputs the result to the svg FILE.
@@ -482,6 +517,7 @@ void Fl_SVG_Graphics_Driver::define_rgb_png(Fl_RGB_Image *rgb, const char *name,
   svg_base64_data.svg = out_;
   svg_base64_data.lline = 0;
   svg_base64_data.lbuf = 0;
+  svg_base64_data.lout = 0;
   // user_write_data is a function repetitively called by libpng which receives blocks of bytes.
   png_set_write_fn(png_ptr, &svg_base64_data, user_write_data, user_flush_data);
   int color_type;
@@ -506,11 +542,12 @@ void Fl_SVG_Graphics_Driver::define_rgb_png(Fl_RGB_Image *rgb, const char *name,
   png_set_rows(png_ptr, info_ptr, (png_bytepp)row_pointers);
   png_write_png(png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
   png_write_end(png_ptr, NULL);
-  user_flush_data(png_ptr);
+  // processes last bytes to be base64 encoded
+  if (svg_base64_data.lbuf) to_base64(svg_base64_data.buff, svg_base64_data.lbuf, &svg_base64_data);
+  flush_base64(&svg_base64_data);
   png_destroy_write_struct(&png_ptr, &info_ptr);
   delete[] row_pointers;
-  if (name) fputs("\"/></defs>\n", out_);
-  else fputs("\"/>\n", out_);
+  fputs("\"/></defs>\n", out_);
 }
 
 #endif // HAVE_LIBPNG
@@ -554,16 +591,12 @@ static void term_destination(jpeg_compress_struct *cinfo) {
   if (new_l) {
     to_base64(client_data->JPEG_BUFFER, (int)new_l, &client_data->base64_data);
   }
+  flush_base64(&client_data->base64_data);
 }
 
-void Fl_SVG_Graphics_Driver::define_rgb_jpeg(Fl_RGB_Image *rgb, const char *name, int x, int y) {
-  if (name) {
-    if (last_rgb_name_) free(last_rgb_name_);
-    last_rgb_name_ = fl_strdup(name);
-  }
+void Fl_SVG_Graphics_Driver::define_rgb_jpeg(Fl_RGB_Image *rgb, int id) {
   float f = rgb->data_w() > rgb->data_h() ? float(rgb->w()) / rgb->data_w(): float(rgb->h()) / rgb->data_h();
-  if (name) fprintf(out_, "<defs><image id=\"%s\" ", name);
-  else fprintf(out_, "<image x=\"%d\" y=\"%d\" ", x, y);
+  fprintf(out_, "<defs><image id=\"FLimg%d\" ", id);
   fprintf(out_, "width=\"%f\" height=\"%f\" href=\"data:image/jpeg;base64,\n", f*rgb->data_w(), f*rgb->data_h());
   // Transforms the image into a stream of bytes in JPEG format,
   // base64-encode this byte stream, and outputs the result to the svg FILE.
@@ -587,6 +620,7 @@ void Fl_SVG_Graphics_Driver::define_rgb_jpeg(Fl_RGB_Image *rgb, const char *name
   jpeg_client_data.base64_data.svg = out_;
   jpeg_client_data.base64_data.lline = 0;
   jpeg_client_data.base64_data.lbuf = 0;
+  jpeg_client_data.base64_data.lout = 0;
   jpeg_start_compress(&cinfo, TRUE);
   int ld = rgb->ld() ? rgb->ld() : rgb->data_w() * rgb->d();
   JSAMPROW row_pointer[1];
@@ -596,69 +630,130 @@ void Fl_SVG_Graphics_Driver::define_rgb_jpeg(Fl_RGB_Image *rgb, const char *name
   }
   jpeg_finish_compress(&cinfo);
   jpeg_destroy_compress(&cinfo);
-  if (name) fputs("\"/></defs>\n", out_);
-  else fputs("\"/>\n", out_);
+  fputs("\"/></defs>\n", out_);
 }
 #endif // HAVE_LIBJPEG
 
+#if defined(HAVE_LIBPNG)
+
+// Updates an FNV-1a hash with n bytes.
+static unsigned long long hash_bytes(unsigned long long hash, const uchar *p, size_t n) {
+  while (n--) {
+    hash ^= *p++;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+static const unsigned long long hash_start = 14695981039346656037ULL;
+
+// Returns the hash of the data of an RGB image.
+static unsigned long long hash_rgb(Fl_RGB_Image *rgb) {
+  int ld = rgb->ld() ? rgb->ld() : rgb->d() * rgb->data_w();
+  unsigned long long hash = hash_start;
+  for (int j = 0; j < rgb->data_h(); j++)
+    hash = hash_bytes(hash, rgb->array + j*ld, rgb->data_w() * rgb->d());
+  return hash;
+}
+
+#endif // HAVE_LIBPNG
+
+// Returns the id of the image with these data, and sets defined to true
+// if the image was already defined in the SVG output.
+int Fl_SVG_Graphics_Driver::image_id_(unsigned long long hash, int w, int h, int d,
+                                      int dw, int dh, bool &defined) {
+  if (image_defs_size_) {
+    Image_Def *def = image_defs_[hash & (image_defs_size_ - 1)];
+    for ( ; def; def = def->next) {
+      if (def->hash == hash && def->w == w && def->h == h && def->d == d &&
+          def->dw == dw && def->dh == dh) {
+        defined = true;
+        return def->id;
+      }
+    }
+  }
+  if (image_count_ >= image_defs_size_) {
+    int size = image_defs_size_ ? 2 * image_defs_size_ : 64;
+    Image_Def **defs = (Image_Def**)calloc(size, sizeof(Image_Def*));
+    for (int i = 0; i < image_defs_size_; i++) {
+      Image_Def *def = image_defs_[i];
+      while (def) {
+        Image_Def *next = def->next;
+        int b = int(def->hash & (size - 1));
+        def->next = defs[b];
+        defs[b] = def;
+        def = next;
+      }
+    }
+    free(image_defs_);
+    image_defs_ = defs;
+    image_defs_size_ = size;
+  }
+  Image_Def *def = new Image_Def;
+  def->hash = hash;
+  def->w = w; def->h = h; def->d = d;
+  def->dw = dw; def->dh = dh;
+  def->id = image_count_++;
+  int b = int(hash & (image_defs_size_ - 1));
+  def->next = image_defs_[b];
+  image_defs_[b] = def;
+  defined = false;
+  return def->id;
+}
+
+// Draws the image defined with this id.
+void Fl_SVG_Graphics_Driver::use_image_(int id, int XP, int YP, int WP, int HP, int cx, int cy, int w, int h) {
+  bool need_clip = (cx || cy || WP != w || HP != h);
+  if (need_clip) push_clip(XP, YP, WP, HP);
+  fprintf(out_, "<use href=\"#FLimg%d\" x=\"%d\" y=\"%d\"/>\n", id, XP-cx, YP-cy);
+  if (need_clip) pop_clip();
+}
+
 void Fl_SVG_Graphics_Driver::draw_rgb(Fl_RGB_Image *rgb, int XP, int YP, int WP, int HP, int cx, int cy) {
 #if defined(HAVE_LIBPNG)
-  char name[24];
-  bool need_clip = (cx || cy || WP != rgb->w() || HP != rgb->h());
-  void *p = (void*)*Fl_Graphics_Driver::id(rgb);
-  if (p) snprintf(name, 24, "FLrgb%p", p); else name[0] = 0;
-  if (!p || !last_rgb_name_ || strcmp(name, last_rgb_name_) != 0) {
-    if (*name==0 && need_clip) push_clip(XP, YP, WP, HP);
+  if (!rgb->array) return;
+  bool defined;
+  int id = image_id_(hash_rgb(rgb), rgb->data_w(), rgb->data_h(), rgb->d(), rgb->w(), rgb->h(), defined);
+  if (!defined) {
 #if defined(HAVE_LIBJPEG)
-    if (rgb->d() == 3 || rgb->d() == 1) define_rgb_jpeg(rgb, *name ? name : NULL, XP-cx, YP-cy);
+    if (rgb->d() == 3 || rgb->d() == 1) define_rgb_jpeg(rgb, id);
     else
 #endif // HAVE_LIBJPEG
-      define_rgb_png(rgb, *name ? name : NULL, XP-cx, YP-cy);
-    if (*name==0 && need_clip) pop_clip();
-  }
-  if (*name) {
-    if (need_clip) push_clip(XP, YP, WP, HP);
-    fprintf(out_, "<use href=\"#%s\" x=\"%d\" y=\"%d\"/>\n", last_rgb_name_, XP-cx, YP-cy);
-    if (need_clip) pop_clip();
+      define_rgb_png(rgb, id);
   }
+  use_image_(id, XP, YP, WP, HP, cx, cy, rgb->w(), rgb->h());
 #endif // HAVE_LIBPNG
 }
 
 void Fl_SVG_Graphics_Driver::draw_pixmap(Fl_Pixmap *pxm, int XP, int YP, int WP, int HP, int cx, int cy) {
 #if defined(HAVE_LIBPNG)
-  char name[24];
-  bool need_clip = (cx || cy || WP != pxm->w() || HP != pxm->h());
-  void *p = (void*)*Fl_Graphics_Driver::id(pxm);
-  if (p) snprintf(name, 24, "FLpx%p", p); else name[0] = 0;
-  if (!p || !last_rgb_name_ || strcmp(name, last_rgb_name_) != 0) {
-    Fl_RGB_Image *rgb = new Fl_RGB_Image(pxm);
-    if (*name==0 && need_clip) push_clip(XP, YP, WP, HP);
-    define_rgb_png(rgb, *name ? name : NULL, XP-cx, YP-cy);
-    if (*name==0 && need_clip) pop_clip();
-    delete rgb;
-  }
-  if (*name) {
-    if (need_clip) push_clip(XP, YP, WP, HP);
-    fprintf(out_, "<use href=\"#%s\" x=\"%d\" y=\"%d\"/>\n", last_rgb_name_, XP-cx, YP-cy);
-    if (need_clip) pop_clip();
+  Fl_RGB_Image *rgb = new Fl_RGB_Image(pxm);
+  if (rgb->array) {
+    bool defined;
+    int id = image_id_(hash_rgb(rgb), rgb->data_w(), rgb->data_h(), rgb->d(), pxm->w(), pxm->h(), defined);
+    if (!defined) define_rgb_png(rgb, id);
+    use_image_(id, XP, YP, WP, HP, cx, cy, pxm->w(), pxm->h());
   }
+  delete rgb;
 #endif // HAVE_LIBPNG
 }
 
 void Fl_SVG_Graphics_Driver::draw_bitmap(Fl_Bitmap *bm, int XP, int YP, int WP, int HP, int cx, int cy) {
 #if defined(HAVE_LIBPNG)
-  char name[45];
-  bool need_clip = (cx || cy || WP != bm->w() || HP != bm->h());
-  void *p = (void*)*Fl_Graphics_Driver::id(bm);
-  if (p) snprintf(name, 45, "FLbm%p%X", p, fl_color()); else name[0] = 0;
-  if (!p || !last_rgb_name_ || strcmp(name, last_rgb_name_) != 0) {
-    uchar R, G, B;
-    Fl::get_color(fl_color(), R, G, B);
+  if (!bm->array) return;
+  uchar R, G, B;
+  Fl::get_color(fl_color(), R, G, B);
+  uchar color[3] = {R, G, B};
+  int rowBytes = (bm->data_w()+7)>>3 ;
+  unsigned long long hash = hash_bytes(hash_start, color, 3);
+  hash = hash_bytes(hash, bm->array, size_t(rowBytes) * bm->data_h());
+  bool defined;
+  int id = image_id_(hash, bm->data_w(), bm->data_h(), 0, bm->w(), bm->h(), defined);
+  if (!defined) {
     uchar *data = new uchar[bm->data_w() * bm->data_h() * 4];
     memset(data, 0, bm->data_w() * bm->data_h() * 4);
     Fl_RGB_Image *rgb = new Fl_RGB_Image(data, bm->data_w(), bm->data_h(), 4);
     rgb->alloc_array = 1;
-    int rowBytes = (bm->data_w()+7)>>3 ;
     for (int j = 0; j < bm->data_h(); j++) {
       const uchar *p = bm->array + j*rowBytes;
       for (int i = 0; i < rowBytes; i++) {
@@ -674,16 +769,10 @@ void Fl_SVG_Graphics_Driver::draw_bitmap(Fl_Bitmap *bm, int XP, int YP, int WP,
         p++;
       }
     }
-    if (*name==0 && need_clip) push_clip(XP, YP, WP, HP);
-    define_rgb_png(rgb, *name ? name : NULL, XP-cx, YP-cy);
-    if (*name==0 && need_clip) pop_clip();
+    define_rgb_png(rgb, id);
     delete rgb;
   }
-  if (*name) {
-    if (need_clip) push_clip(XP, YP, WP, HP);
-    fprintf(out_, "<use href=\"#%s\" x=\"%d\" y=\"%d\"/>\n", last_rgb_name_, XP-cx, YP-cy);
-    if (need_clip) pop_clip();
-  }
+  use_image_(id, XP, YP, WP, HP, cx, cy, bm->w(), bm->h());
 #endif // HAVE_LIBPNG
 }
 
@@ -16,6 +16,7 @@
 
 #include <config.h>
 #include "Fl_Unix_Screen_Driver.H"
+#include <FL/Fl_Trace.H>
 
 fd_set Fl_Unix_Screen_Driver::fdsets[3];
 int Fl_Unix_Screen_Driver::maxfd = 0;
@@ -39,6 +40,7 @@ int Fl_Unix_Screen_Driver::poll_or_select_with_delay(double time_to_wait) {
   fdt[2] = fdsets[2];
 #  endif
   int n;
+  double trace_start = Fl_Trace::start();
 
   fl_unlock_function();
 
@@ -60,6 +62,7 @@ int Fl_Unix_Screen_Driver::poll_or_select_with_delay(double time_to_wait) {
   }
 
   fl_lock_function();
+  if (trace_start) Fl_Trace::woke_up(trace_start);
 
   if (n > 0) {
     for (int i=0; i<nfds; i++) {
@@ -20,6 +20,7 @@
 #include <FL/Fl_File_Browser.H>
 #include <FL/fl_string_functions.h>  // fl_strdup
 #include <FL/platform.H>
+#include <FL/fl_utf8.h>
 #include "../../flstring.h"
 #include "../../Fl_Timeout.h"
 
@@ -27,6 +28,8 @@
 #include <time.h>
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
 #include <pwd.h>
 #include <string.h>     // strerror(errno)
 #include <errno.h>      // errno
@@ -851,3 +854,167 @@ Fl_RGB_Image *Fl_Unix_System_Driver::own_bmp_to_RGB(char *bmp) {
   img->alloc_array = 1;
   return img;
 }
+
+
+// Fl::set_fonts() enumerates all installed fonts, which can take a long
+// time with thousands of fonts. The names it finds are kept in a file
+// of the user's cache directory, with a key made of the timestamps of
+// the fontconfig configuration and cache directories, and of the usual
+// font directories and their subdirectories. The key changes when fonts
+// are installed or removed, even if fc-cache was not run, and the fonts
+// are enumerated again. Removing the file also makes the fonts enumerated
+// again. Setting the environment variable FLTK_NO_FONT_CACHE turns the
+// cache off.
+
+// Returns the path of the cache file of the backend in buf, or NULL if
+// there is none or the cache is turned off.
+static char *font_cache_path(const char *backend, char *buf, int size) {
+  if (getenv("FLTK_NO_FONT_CACHE")) return NULL;
+  const char *home = getenv("HOME");
+  if (!home || !*home) {
+    struct passwd *pw = getpwuid(getuid());
+    home = pw ? pw->pw_dir : NULL;
+  }
+  const char *xdg = getenv("XDG_CACHE_HOME");
+  if (xdg && *xdg == '/') snprintf(buf, size, "%s/fltk/fonts-%s.cache", xdg, backend);
+  else if (home && *home) snprintf(buf, size, "%s/.cache/fltk/fonts-%s.cache", home, backend);
+  else return NULL;
+  return buf;
+}
+
+// Appends the timestamp of path, or "-" if it doesn't exist, to key.
+static void add_font_cache_key(char *key, int size, const char *path) {
+  struct stat st;
+  int l = (int)strlen(key);
+  if (path && stat(path, &st) == 0)
+    snprintf(key + l, size - l, "%ld.%ld ", (long)st.st_mtime, (long)st.st_size);
+  else
+    snprintf(key + l, size - l, "- ");
+}
+
+// Adds to hash the timestamps of directory path and of its subdirectories.
+// The hashes of the directories are summed, so that the order in which
+// they are read doesn't matter.
+static void hash_font_dir(unsigned &hash, const char *path, int depth) {
+  struct stat st;
+  if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode)) return;
+  unsigned h = 2166136261U;
+  for (const char *p = path; *p; p++) h = (h ^ (unsigned char)*p) * 16777619U;
+  h = (h ^ (unsigned)st.st_mtime) * 16777619U;
+  hash += h;
+  if (depth >= 8) return;
+  DIR *dir = opendir(path);
+  if (!dir) return;
+  char child[FL_PATH_MAX];
+  struct dirent *e;
+  while ((e = readdir(dir)) != NULL) {
+    if (e->d_name[0] == '.') continue;
+    if (snprintf(child, sizeof(child), "%s/%s", path, e->d_name) >= (int)sizeof(child)) continue;
+#ifdef DT_DIR
+    if (e->d_type != DT_DIR && e->d_type != DT_LNK && e->d_type != DT_UNKNOWN) continue;
+#endif
+    hash_font_dir(hash, child, depth + 1);
+  }
+  closedir(dir);
+}
+
+static void font_cache_key(char *key, int size) {
+  char path[FL_PATH_MAX];
+  const char *home = getenv("HOME");
+  const char *xdg_cache = getenv("XDG_CACHE_HOME");
+  const char *xdg_config = getenv("XDG_CONFIG_HOME");
+  const char *fc_file = getenv("FONTCONFIG_FILE");
+  const char *fc_path = getenv("FONTCONFIG_PATH");
+  snprintf(key, size, "%s %s ", fc_file ? fc_file : "-", fc_path ? fc_path : "-");
+  add_font_cache_key(key, size, "/etc/fonts/fonts.conf");
+  add_font_cache_key(key, size, "/etc/fonts/conf.d");
+  add_font_cache_key(key, size, "/var/cache/fontconfig");
+  add_font_cache_key(key, size, "/usr/local/etc/fonts/fonts.conf");
+  add_font_cache_key(key, size, "/usr/local/var/cache/fontconfig");
+  if (xdg_cache && *xdg_cache == '/') snprintf(path, sizeof(path), "%s/fontconfig", xdg_cache);
+  else if (home) snprintf(path, sizeof(path), "%s/.cache/fontconfig", home);
+  else path[0] = 0;
+  add_font_cache_key(key, size, path[0] ? path : NULL);
+  if (xdg_config && *xdg_config == '/') snprintf(path, sizeof(path), "%s/fontconfig", xdg_config);
+  else if (home) snprintf(path, sizeof(path), "%s/.config/fontconfig", home);
+  else path[0] = 0;
+  add_font_cache_key(key, size, path[0] ? path : NULL);
+  if (home) snprintf(path, sizeof(path), "%s/.fontconfig", home);
+  add_font_cache_key(key, size, home ? path : NULL);
+  // the font directories, whose timestamps change when fonts are added
+  unsigned hash = 0;
+  hash_font_dir(hash, "/usr/share/fonts", 0);
+  hash_font_dir(hash, "/usr/local/share/fonts", 0);
+  hash_font_dir(hash, "/usr/share/X11/fonts", 0);
+  const char *xdg_data = getenv("XDG_DATA_HOME");
+  if (xdg_data && *xdg_data == '/') {
+    snprintf(path, sizeof(path), "%s/fonts", xdg_data);
+    hash_font_dir(hash, path, 0);
+  } else if (home) {
+    snprintf(path, sizeof(path), "%s/.local/share/fonts", home);
+    hash_font_dir(hash, path, 0);
+  }
+  if (home) {
+    snprintf(path, sizeof(path), "%s/.fonts", home);
+    hash_font_dir(hash, path, 0);
+  }
+  int l = (int)strlen(key);
+  snprintf(key + l, size - l, "%08x", hash);
+}
+
+// Every font name is written on a line of its own, after a '=' so that
+// empty names can be told from a truncated file.
+static const char font_cache_header[] = "FLTK font cache 2\n";
+
+// Sets the fonts from FL_FREE_FONT on to the names in the cache file of
+// the backend. Returns the number of fonts, or -1 if there is no valid
+// cache file.
+int Fl_Unix_System_Driver::load_font_cache(const char *backend) {
+  char path[FL_PATH_MAX], key[1024], line[1024];
+  if (!font_cache_path(backend, path, sizeof(path))) return -1;
+  FILE *f = fl_fopen(path, "r");
+  if (!f) return -1;
+  font_cache_key(key, sizeof(key) - 1);
+  strlcat(key, "\n", sizeof(key));
+  int count = -1;
+  if (fgets(line, sizeof(line), f) && !strcmp(line, font_cache_header) &&
+      fgets(line, sizeof(line), f) && !strcmp(line, key) &&
+      fgets(line, sizeof(line), f) && sscanf(line, "%d", &count) == 1 && count >= 0) {
+    char **names = (char **)calloc(count + 1, sizeof(char *));
+    int n;
+    for (n = 0; n < count && fgets(line, sizeof(line), f); n++) {
+      size_t l = strlen(line);
+      if (line[0] != '=' || line[l - 1] != '\n') break; // truncated file
+      line[l - 1] = 0;
+      names[n] = fl_strdup(line + 1);
+    }
+    if (n == count) {
+      for (n = 0; n < count; n++) Fl::set_font((Fl_Font)(FL_FREE_FONT + n), names[n]);
+    } else {
+      for (n = 0; n < count; n++) free(names[n]);
+      count = -1;
+    }
+    free(names);
+  }
+  fclose(f);
+  return count;
+}
+
+// Saves the names of the count fonts from FL_FREE_FONT on in the cache
+// file of the backend.
+void Fl_Unix_System_Driver::save_font_cache(const char *backend, int count) {
+  char path[FL_PATH_MAX], tmp[FL_PATH_MAX + 24], key[1024];
+  if (!font_cache_path(backend, path, sizeof(path))) return;
+  fl_make_path_for_file(path);
+  if (snprintf(tmp, sizeof(tmp), "%s.%ld", path, (long)getpid()) >= (int)sizeof(tmp)) return;
+  FILE *f = fl_fopen(tmp, "w");
+  if (!f) return;
+  font_cache_key(key, sizeof(key) - 1);
+  fprintf(f, "%s%s\n%d\n", font_cache_header, key, count);
+  for (int i = 0; i < count; i++) {
+    const char *name = Fl::get_font((Fl_Font)(FL_FREE_FONT + i));
+    fprintf(f, "=%s\n", name ? name : "");
+  }
+  if (fclose(f) == 0) ::rename(tmp, path);
+  else ::unlink(tmp);
+}
@@ -34,42 +34,146 @@ extern "C" {
 }
 
 
-struct fl_wld_buffer *Fl_Wayland_Graphics_Driver::create_shm_buffer(int width, int height)
-{
-  struct fl_wld_buffer *buffer;
-  int stride = cairo_format_stride_for_width(Fl_Cairo_Graphics_Driver::cairo_format, width);
-  int size = stride * height;
-  static char *pool_memory = NULL;
-  static int pool_size = 10000000; // gets increased if necessary
-  static int chunk_offset = pool_size;
-  static int fd = -1;
-  static struct wl_shm_pool *pool = NULL;
-  if (chunk_offset + size > pool_size) {
-    chunk_offset = 0;
-    if (pool) {
-      wl_shm_pool_destroy(pool);
-      close(fd);
-    }
-    if (size > pool_size) pool_size = 2 * size;
-    fd = os_create_anonymous_file(pool_size);
-    pool_memory = (char*)mmap(NULL, pool_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-    if (pool_memory == MAP_FAILED) {
-      close(fd);
-      Fl::fatal("mmap failed: %s\n", strerror(errno));
+// A shared memory pool from which wl_buffer objects are created.
+struct fl_wld_shm_pool {
+  struct wl_shm_pool *pool;
+  char *memory;
+  int fd;
+  int size;
+  int chunk_offset; // start of the unused part of the pool
+  int buffer_count; // number of wl_buffer objects created from this pool and not yet destroyed
+};
+
+#define FL_WLD_POOL_SIZE 10000000 // default size of a pool, increased if necessary
+#define FL_WLD_MAX_IDLE_BUFFERS 8 // idle wl_buffer objects kept for reuse
+
+static struct fl_wld_shm_pool *current_pool = NULL;
+static struct fl_wld_buffer *idle_buffers = NULL;
+static int idle_buffer_count = 0;
+
+static struct {
+  unsigned long allocated;
+  unsigned long reused;
+  unsigned long long bytes_committed;
+} shm_stats = {0, 0, 0};
+
+
+static struct fl_wld_shm_pool *create_shm_pool(int size) {
+  struct fl_wld_shm_pool *pool = (struct fl_wld_shm_pool*)calloc(1, sizeof(struct fl_wld_shm_pool));
+  pool->size = (size > FL_WLD_POOL_SIZE ? 2 * size : FL_WLD_POOL_SIZE);
+  pool->fd = os_create_anonymous_file(pool->size);
+  pool->memory = (char*)mmap(NULL, pool->size, PROT_READ | PROT_WRITE, MAP_SHARED, pool->fd, 0);
+  if (pool->memory == MAP_FAILED) {
+    close(pool->fd);
+    Fl::fatal("mmap failed: %s\n", strerror(errno));
+  }
+  Fl_Wayland_Screen_Driver *scr_driver = (Fl_Wayland_Screen_Driver*)Fl::screen_driver();
+  pool->pool = wl_shm_create_pool(scr_driver->wl_shm, pool->fd, pool->size);
+  return pool;
+}
+
+
+static void destroy_shm_pool(struct fl_wld_shm_pool *pool) {
+  wl_shm_pool_destroy(pool->pool);
+  munmap(pool->memory, pool->size);
+  close(pool->fd);
+  free(pool);
+}
+
+
+// Destroys a wl_buffer and the pool it comes from when the pool becomes empty.
+static void destroy_wl_buffer(struct fl_wld_buffer *buffer) {
+  struct fl_wld_shm_pool *pool = buffer->pool;
+  wl_buffer_destroy(buffer->wl_buffer);
+  free(buffer);
+  if (--pool->buffer_count == 0) {
+    if (pool == current_pool) pool->chunk_offset = 0; // the whole pool is free again
+    else destroy_shm_pool(pool);
+  }
+}
+
+
+static void buffer_release_cb(void *data, struct wl_buffer *wl_buffer) {
+  struct fl_wld_buffer *buffer = (struct fl_wld_buffer*)data;
+  buffer->busy = false;
+}
+
+static const struct wl_buffer_listener buffer_listener = {
+  .release = buffer_release_cb,
+};
+
+
+// Keeps the wl_buffer of a released buffer for reuse by a later buffer of the same size.
+static void add_idle_buffer(struct fl_wld_buffer *buffer) {
+  buffer->next_idle = idle_buffers;
+  idle_buffers = buffer;
+  if (++idle_buffer_count > FL_WLD_MAX_IDLE_BUFFERS) { // destroy the oldest idle buffer
+    struct fl_wld_buffer **p = &idle_buffers;
+    while ((*p)->next_idle) p = &(*p)->next_idle;
+    struct fl_wld_buffer *oldest = *p;
+    *p = NULL;
+    idle_buffer_count--;
+    destroy_wl_buffer(oldest);
+  }
+}
+
+
+// Returns an idle buffer of the given size that the compositor has released, or NULL.
+static struct fl_wld_buffer *find_idle_buffer(int width, int height, int stride) {
+  for (struct fl_wld_buffer **p = &idle_buffers; *p; p = &(*p)->next_idle) {
+    struct fl_wld_buffer *buffer = *p;
+    if (!buffer->busy && buffer->width == width && buffer->stride == stride &&
+        buffer->data_size == (size_t)stride * height) {
+      *p = buffer->next_idle;
+      idle_buffer_count--;
+      return buffer;
     }
-    Fl_Wayland_Screen_Driver *scr_driver = (Fl_Wayland_Screen_Driver*)Fl::screen_driver();
-    pool = wl_shm_create_pool(scr_driver->wl_shm, fd, pool_size);
+  }
+  return NULL;
+}
+
+
+// Returns a buffer with a wl_buffer of the given size that the compositor does not use,
+// either an idle one or a new one. Its draw_buffer and cairo_ are not set.
+static struct fl_wld_buffer *get_wl_buffer(int width, int height, int stride) {
+  struct fl_wld_buffer *buffer = find_idle_buffer(width, height, stride);
+  if (buffer) {
+    shm_stats.reused++;
+    return buffer;
+  }
+  int size = stride * height;
+  if (!current_pool || current_pool->chunk_offset + size > current_pool->size) {
+    // Buffers of the previous pool remain valid, the pool is destroyed with its last buffer
+    if (current_pool && current_pool->buffer_count == 0) destroy_shm_pool(current_pool);
+    current_pool = create_shm_pool(size);
   }
   buffer = (struct fl_wld_buffer*)calloc(1, sizeof(struct fl_wld_buffer));
   buffer->stride = stride;
-  buffer->wl_buffer = wl_shm_pool_create_buffer(pool, chunk_offset, width, height, stride, Fl_Wayland_Graphics_Driver::wld_format);
-  buffer->data = (void*)(pool_memory + chunk_offset);
-  chunk_offset += size;
+  buffer->wl_buffer = wl_shm_pool_create_buffer(current_pool->pool, current_pool->chunk_offset,
+                                                width, height, stride,
+                                                Fl_Wayland_Graphics_Driver::wld_format);
+  wl_buffer_add_listener(buffer->wl_buffer, &buffer_listener, buffer);
+  buffer->pool = current_pool;
+  buffer->data = (void*)(current_pool->memory + current_pool->chunk_offset);
+  current_pool->chunk_offset += size;
+  current_pool->buffer_count++;
   buffer->data_size = size;
   buffer->width = width;
+  shm_stats.allocated++;
+  return buffer;
+}
+
+
+struct fl_wld_buffer *Fl_Wayland_Graphics_Driver::create_shm_buffer(int width, int height)
+{
+  int stride = cairo_format_stride_for_width(Fl_Cairo_Graphics_Driver::cairo_format, width);
+  struct fl_wld_buffer *buffer = get_wl_buffer(width, height, stride);
+  buffer->next_idle = NULL;
+  buffer->damage_count = 0;
+  buffer->damage_all = true;
   buffer->draw_buffer = new uchar[buffer->data_size];
   buffer->draw_buffer_needs_commit = true;
-//fprintf(stderr, "create_shm_buffer: %dx%d = %d\n", width, height, size);
+//fprintf(stderr, "create_shm_buffer: %dx%d = %d\n", width, height, (int)buffer->data_size);
   cairo_init(buffer, width, height, stride, Fl_Cairo_Graphics_Driver::cairo_format);
   return buffer;
 }
@@ -89,22 +193,92 @@ static void surface_frame_done(void *data, struct wl_callback *cb, uint32_t time
   window->buffer->cb = NULL;
   if (window->buffer->draw_buffer_needs_commit) {
 //fprintf(stderr,"surface_frame_done: new cb=%p \n", window->buffer->cb);
-    Fl_Wayland_Graphics_Driver::buffer_commit(window);
+    Fl_Wayland_Graphics_Driver::buffer_commit(window, false);
+  }
+}
+
+
+// Records that a rectangle of the buffer, in buffer pixels, has changed.
+// Too many rectangles are replaced by damaging the whole buffer.
+void Fl_Wayland_Graphics_Driver::buffer_damage(struct fl_wld_buffer *buffer, int x, int y, int w, int h) {
+  if (buffer->damage_all) return;
+  // rectangles computed from scaled FLTK coordinates may be truncated
+  x--; y--; w += 2; h += 2;
+  int height = buffer->data_size / buffer->stride;
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > buffer->width) w = buffer->width - x;
+  if (y + h > height) h = height - y;
+  if (w <= 0 || h <= 0) return;
+  if (buffer->damage_count >= FL_WLD_MAX_DAMAGE) {
+    buffer->damage_all = true;
+    return;
   }
+  cairo_rectangle_int_t *r = buffer->damage + buffer->damage_count++;
+  r->x = x; r->y = y; r->width = w; r->height = h;
+}
+
+
+// Gives the buffer a wl_buffer that the compositor does not read, because
+// the compositor has not released the one that was committed last.
+// The busy wl_buffer goes to the idle buffers until it is released.
+static void swap_busy_wl_buffer(struct fl_wld_buffer *buffer) {
+  int height = buffer->data_size / buffer->stride;
+  struct fl_wld_buffer *spare = get_wl_buffer(buffer->width, height, buffer->stride);
+  struct wl_buffer *wl_buffer = buffer->wl_buffer;
+  void *data = buffer->data;
+  struct fl_wld_shm_pool *pool = buffer->pool;
+  buffer->wl_buffer = spare->wl_buffer;
+  buffer->data = spare->data;
+  buffer->pool = spare->pool;
+  buffer->busy = false;
+  spare->wl_buffer = wl_buffer;
+  spare->data = data;
+  spare->pool = pool;
+  spare->busy = true;
+  // the release event goes to the buffer that owns the wl_buffer
+  wl_buffer_set_user_data(buffer->wl_buffer, buffer);
+  wl_buffer_set_user_data(spare->wl_buffer, spare);
+  add_idle_buffer(spare);
 }
 
 
 void Fl_Wayland_Graphics_Driver::buffer_commit(struct wld_window *window, bool need_damage) {
-  cairo_surface_t *surf = cairo_get_target(window->buffer->cairo_);
+  struct fl_wld_buffer *buffer = window->buffer;
+  cairo_surface_t *surf = cairo_get_target(buffer->cairo_);
   cairo_surface_flush(surf);
-  memcpy(window->buffer->data, window->buffer->draw_buffer, window->buffer->data_size);
-  wl_surface_attach(window->wl_surface, window->buffer->wl_buffer, 0, 0);
+  if (need_damage || buffer->damage_count == 0) buffer->damage_all = true;
+  if (buffer->busy) {
+    // Don't write to memory the compositor may still be reading. The other
+    // wl_buffer holds an older scene or nothing, so all of it is copied.
+    swap_busy_wl_buffer(buffer);
+    buffer->damage_all = true;
+  }
+  if (buffer->damage_all) {
+    memcpy(buffer->data, buffer->draw_buffer, buffer->data_size);
+    wl_surface_damage_buffer(window->wl_surface, 0, 0, 1000000, 1000000);
+    shm_stats.bytes_committed += buffer->data_size;
+  } else {
+    // copy only the damaged parts: buffer->data still holds the previous frame
+    for (int i = 0; i < buffer->damage_count; i++) {
+      cairo_rectangle_int_t *r = buffer->damage + i;
+      size_t offset = r->y * buffer->stride + 4 * r->x;
+      for (int j = 0; j < r->height; j++, offset += buffer->stride) {
+        memcpy((uchar*)buffer->data + offset, buffer->draw_buffer + offset, 4 * r->width);
+      }
+      wl_surface_damage_buffer(window->wl_surface, r->x, r->y, r->width, r->height);
+      shm_stats.bytes_committed += 4 * r->width * r->height;
+    }
+  }
+  buffer->damage_count = 0;
+  buffer->damage_all = false;
+  wl_surface_attach(window->wl_surface, buffer->wl_buffer, 0, 0);
   wl_surface_set_buffer_scale(window->wl_surface, window->scale);
-  window->buffer->cb = wl_surface_frame(window->wl_surface);
-  if (need_damage) wl_surface_damage_buffer(window->wl_surface, 0, 0, 1000000, 1000000);
-  wl_callback_add_listener(window->buffer->cb, &surface_frame_listener, window);
+  buffer->cb = wl_surface_frame(window->wl_surface);
+  wl_callback_add_listener(buffer->cb, &surface_frame_listener, window);
   wl_surface_commit(window->wl_surface);
-  window->buffer->draw_buffer_needs_commit = false;
+  buffer->busy = true;
+  buffer->draw_buffer_needs_commit = false;
 //fprintf(stderr,"buffer_commit %s\n", window->fl_win->parent()?"child":"top");
 }
 
@@ -133,15 +307,50 @@ void Fl_Wayland_Graphics_Driver::buffer_release(struct wld_window *window)
 {
   if (window->buffer) {
     if (window->buffer->cb) wl_callback_destroy(window->buffer->cb);
-    wl_buffer_destroy(window->buffer->wl_buffer);
+    window->buffer->cb = NULL;
     delete[] window->buffer->draw_buffer;
     window->buffer->draw_buffer = NULL;
     cairo_destroy(window->buffer->cairo_);
-    free(window->buffer);
+    window->buffer->cairo_ = NULL;
+    add_idle_buffer(window->buffer); // keep wl_buffer for reuse
     window->buffer = NULL;
   }
 }
 
+
+// Destroys a buffer without keeping its wl_buffer for reuse.
+// This is for buffers attached by other means than buffer_commit(), such as
+// cursor and drag icon images: they are not marked busy while the compositor
+// uses them, so that they must not go to the idle buffers.
+void Fl_Wayland_Graphics_Driver::buffer_destroy(struct fl_wld_buffer *buffer)
+{
+  if (buffer->cb) wl_callback_destroy(buffer->cb);
+  delete[] buffer->draw_buffer;
+  cairo_destroy(buffer->cairo_);
+  destroy_wl_buffer(buffer);
+}
+
+
+void Fl_Wayland_Graphics_Driver::buffer_statistics(unsigned long *allocated, unsigned long *reused,
+                                                   unsigned long long *bytes_committed) {
+  if (allocated) *allocated = shm_stats.allocated;
+  if (reused) *reused = shm_stats.reused;
+  if (bytes_committed) *bytes_committed = shm_stats.bytes_committed;
+}
+
+
+/** Gives statistics about the shared memory buffers used to display windows.
+ \param[out] allocated number of wl_buffer objects that were created
+ \param[out] reused number of times an idle wl_buffer was used again for a new window buffer
+ \param[out] bytes_committed number of bytes copied to shared memory when committing
+ window contents
+ Any of the parameters may be NULL.
+ */
+void fl_wl_buffer_statistics(unsigned long *allocated, unsigned long *reused,
+                             unsigned long long *bytes_committed) {
+  Fl_Wayland_Graphics_Driver::buffer_statistics(allocated, reused, bytes_committed);
+}
+
 // this refers to the same memory layout for pixel data as does CAIRO_FORMAT_ARGB32
 const uint32_t Fl_Wayland_Graphics_Driver::wld_format = WL_SHM_FORMAT_ARGB8888;
 
@@ -78,9 +78,7 @@ void Fl_Wayland_Window_Driver::delete_cursor_() {
   if (cursor_) {
     struct cursor_image *new_image = (struct cursor_image*)cursor_->images[0];
     struct fl_wld_buffer *offscreen = (struct fl_wld_buffer *)wl_buffer_get_user_data(new_image->buffer);
-    struct wld_window fake_xid;
-    fake_xid.buffer = offscreen;
-    Fl_Wayland_Graphics_Driver::buffer_release(&fake_xid);
+    Fl_Wayland_Graphics_Driver::buffer_destroy(offscreen);
     free(new_image);
     free(cursor_->images);
     free(cursor_->name);
@@ -335,6 +333,8 @@ void Fl_Wayland_Window_Driver::make_current() {
   if (window->buffer) {
     ((Fl_Cairo_Graphics_Driver*)fl_graphics_driver)->needs_commit_tag(
                                             &window->buffer->draw_buffer_needs_commit);
+    // drawing outside of flush() can change any part of the buffer
+    if (!Fl_Wayland_Window_Driver::in_flush) window->buffer->damage_all = true;
   }
 
   // to support progressive drawing
@@ -394,20 +394,30 @@ void Fl_Wayland_Window_Driver::flush() {
       int top = r->rects[i].y * window->scale * f;
       int width = r->rects[i].width * window->scale * f;
       int height = r->rects[i].height * window->scale * f;
-      wl_surface_damage_buffer(window->wl_surface, left, top, width, height);
+      Fl_Wayland_Graphics_Driver::buffer_damage(window->buffer, left, top, width, height);
 //fprintf(stderr, "damage %dx%d %dx%d\n", left, top, width, height);
     }
-  } else {
-    wl_surface_damage_buffer(window->wl_surface, 0, 0,
-    pWindow->w() * window->scale * f, pWindow->h() * window->scale * f);
-//fprintf(stderr, "damage 0x0 %dx%d\n", pWindow->w() * window->scale, pWindow->h() * window->scale);
+  } else if (window->buffer) {
+    window->buffer->damage_all = true;
   }
 
   Fl_Wayland_Window_Driver::in_flush = true;
   Fl_Window_Driver::flush();
   Fl_Wayland_Window_Driver::in_flush = false;
-  if (window->buffer->cb) wl_callback_destroy(window->buffer->cb);
-  Fl_Wayland_Graphics_Driver::buffer_commit(window, false);
+  if (window->buffer->cb) {
+    // The compositor has not yet displayed the previous frame: damage accumulates
+    // in the buffer and is committed by the frame callback.
+    window->buffer->draw_buffer_needs_commit = true;
+  } else {
+    Fl_Wayland_Graphics_Driver::buffer_commit(window, false);
+  }
+}
+
+
+// A frame callback is pending until the compositor has used the last committed buffer.
+bool Fl_Wayland_Window_Driver::frame_pending() {
+  struct wld_window *window = fl_wl_xid(pWindow);
+  return window && window->buffer && window->buffer->cb;
 }
 
 
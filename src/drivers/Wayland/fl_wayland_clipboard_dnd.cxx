@@ -100,9 +100,7 @@ static void data_source_handle_cancelled(void *data, struct wl_data_source *sour
   doing_dnd = false;
   if (dnd_icon) {
     struct fl_wld_buffer * off = (struct fl_wld_buffer *)wl_surface_get_user_data(dnd_icon);
-    struct wld_window fake_window;
-    fake_window.buffer = off;
-    Fl_Wayland_Graphics_Driver::buffer_release(&fake_window);
+    Fl_Wayland_Graphics_Driver::buffer_destroy(off);
     wl_surface_destroy(dnd_icon);
     dnd_icon = NULL;
   }
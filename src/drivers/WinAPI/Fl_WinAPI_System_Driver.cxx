@@ -963,6 +963,16 @@ void Fl_WinAPI_System_Driver::gettime(time_t *sec, int *usec) {
   *usec = t.millitm * 1000;
 }
 
+double Fl_WinAPI_System_Driver::monotonic_time() {
+  static LARGE_INTEGER freq;
+  LARGE_INTEGER count;
+  if (!freq.QuadPart && !QueryPerformanceFrequency(&freq))
+    freq.QuadPart = -1;
+  if (freq.QuadPart < 0 || !QueryPerformanceCounter(&count))
+    return Fl_System_Driver::monotonic_time();
+  return double(count.QuadPart) / double(freq.QuadPart);
+}
+
 //
 // Code for lock support
 //
@@ -19,6 +19,9 @@
 #include "Fl_X11_Screen_Driver.H"
 #include "Fl_X11_Window_Driver.H"
 #include "../Posix/Fl_Posix_System_Driver.H"
+#if !FLTK_USE_CAIRO
+#  include "../Xlib/Fl_Xlib_Graphics_Driver.H"
+#endif
 #include <FL/Fl.H>
 #include <FL/platform.H>
 #include <FL/fl_ask.H>
@@ -414,11 +417,73 @@ void Fl_X11_Screen_Driver::beep(int type)
 
 void Fl_X11_Screen_Driver::flush()
 {
+#if !FLTK_USE_CAIRO
+  Fl_Xlib_Graphics_Driver::end_batch_frame();
+#endif
   if (fl_display)
     XFlush(fl_display);
 }
 
 
+/** Turns the batching of rectangles, lines and points on or off.
+ When batching is on, the Xlib graphics driver queues filled rectangles,
+ lines and points drawn with the same color and clip region and sends them
+ as a few X requests, which is much faster over a remote X connection.
+ Batching is off by default, because the queued primitives reach the X server
+ only when FLTK draws something else or the GC is fetched with fl_x11_gc().
+ Turn it on only if all code that draws with Xlib directly gets the GC with
+ fl_x11_gc() rather than reading the \c fl_gc variable.
+ \param on non-zero to queue primitives, 0 to send each one at once
+ \note This has no effect when FLTK draws with Cairo.
+ \see fl_x11_batch_statistics()
+ \version 1.4.0
+ */
+void fl_x11_batching(int on)
+{
+#if !FLTK_USE_CAIRO
+  Fl_Xlib_Graphics_Driver::batching(on != 0);
+#endif
+}
+
+/** Returns non-zero if rectangles, lines and points are batched.
+ \see fl_x11_batching(int)
+ \version 1.4.0
+ */
+int fl_x11_batching()
+{
+#if !FLTK_USE_CAIRO
+  return Fl_Xlib_Graphics_Driver::batching();
+#else
+  return 0;
+#endif
+}
+
+/** Reports how many X requests the Xlib graphics driver sent for rectangles,
+ lines and points, which it queues and sends in batches.
+ All parameters are optional and may be NULL.
+ \param[out] frames number of Fl::flush() calls that drew such primitives
+ \param[out] primitives number of primitives drawn, i.e. the number of X requests
+ needed without batching
+ \param[out] requests number of X requests actually sent for these primitives,
+ the same as \p primitives unless fl_x11_batching() is on
+ \param[out] frame_primitives, frame_requests same values for the last frame only
+ \note All values are zero when FLTK draws with Cairo.
+ */
+void fl_x11_batch_statistics(unsigned long *frames, unsigned long *primitives, unsigned long *requests,
+                             unsigned long *frame_primitives, unsigned long *frame_requests)
+{
+  unsigned long f = 0, p = 0, r = 0, fp = 0, fr = 0;
+#if !FLTK_USE_CAIRO
+  Fl_Xlib_Graphics_Driver::batch_statistics(f, p, r, fp, fr);
+#endif
+  if (frames) *frames = f;
+  if (primitives) *primitives = p;
+  if (requests) *requests = r;
+  if (frame_primitives) *frame_primitives = fp;
+  if (frame_requests) *frame_requests = fr;
+}
+
+
 extern void fl_fix_focus(); // in Fl.cxx
 
 
@@ -474,6 +539,10 @@ void Fl_X11_Screen_Driver::grab(Fl_Window* win)
 // Wrapper around XParseColor...
 int Fl_X11_Screen_Driver::parse_color(const char* p, uchar& r, uchar& g, uchar& b)
 {
+  // "#rrggbb" and its 12 and 16 bit forms give the same values as XParseColor()
+  // without a display, e.g. for the pixmaps of widgets created before show()
+  size_t n = (p[0] == '#') ? strlen(p + 1) : 0;
+  if (n == 6 || n == 9 || n == 12) return Fl_Screen_Driver::parse_color(p, r, g, b);
   XColor x;
   if (!fl_display) open_display();
   if (XParseColor(fl_display, fl_colormap, p, &x)) {
@@ -632,6 +701,9 @@ Fl_RGB_Image *Fl_X11_Screen_Driver::read_win_rectangle(int X, int Y, int w, int
   if (w < 0) w = - w;
 
   Window xid = (win && !allow_outside ? fl_xid(win) : fl_window);
+#if !FLTK_USE_CAIRO
+  Fl_Xlib_Graphics_Driver::flush_batch(); // read what has been drawn so far
+#endif
 
   float s = allow_outside ? Fl::screen_driver()->scale(win->screen_num()) : Fl_Surface_Device::surface()->driver()->scale();
   int Xs = Fl_Scalable_Graphics_Driver::floor(X, s);
@@ -438,6 +438,9 @@ void Fl_X11_Window_Driver::hide() {
   Fl_X* ip = Fl_X::i(pWindow);
   if (hide_common()) return;
   if (ip->region) Fl_Graphics_Driver::default_driver().XDestroyRegion(ip->region);
+# if !FLTK_USE_CAIRO
+  Fl_Xlib_Graphics_Driver::flush_batch(); // before the window disappears
+# endif
 # if USE_XFT && ! FLTK_USE_CAIRO
   Fl_Xlib_Graphics_Driver::destroy_xft_draw(ip->xid);
   screen_num_ = -1;
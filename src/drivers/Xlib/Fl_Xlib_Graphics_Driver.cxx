@@ -38,7 +38,10 @@ int Fl_Xlib_Graphics_Driver::fl_overlay = 0;
  */
 GC fl_gc = 0;
 
-GC fl_x11_gc() { return fl_gc; }
+GC fl_x11_gc() {
+  Fl_Xlib_Graphics_Driver::expose_gc();
+  return fl_gc;
+}
 
 Fl_Xlib_Graphics_Driver::Fl_Xlib_Graphics_Driver(void) {
   mask_bitmap_ = NULL;
@@ -57,6 +60,7 @@ Fl_Xlib_Graphics_Driver::~Fl_Xlib_Graphics_Driver() {
 
 
 void Fl_Xlib_Graphics_Driver::gc(void *value) {
+  expose_gc();
   gc_ = (GC)value;
   fl_gc = gc_;
 }
@@ -73,6 +77,7 @@ void Fl_Xlib_Graphics_Driver::scale(float f) {
 }
 
 void Fl_Xlib_Graphics_Driver::copy_offscreen(int x, int y, int w, int h, Fl_Offscreen pixmap, int srcx, int srcy) {
+  flush_batch();
   XCopyArea(fl_display, (Pixmap)pixmap, fl_window, gc_, srcx*scale(), srcy*scale(), w*scale(), h*scale(), (x+offset_x_)*scale(), (y+offset_y_)*scale());
 
 }
@@ -0,0 +1,200 @@
+//
+// Request batching for the Xlib graphics driver for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+/**
+  \file Fl_Xlib_Graphics_Driver_batch.cxx
+  \brief Collects rectangles, line segments and points drawn with the same GC
+  and sends them as a few XFillRectangles(), XDrawSegments() and XDrawPoints()
+  requests.
+*/
+
+#include <config.h>
+#include "Fl_Xlib_Graphics_Driver.H"
+#include <FL/platform.H>
+
+// Box types, frames and most widgets are drawn as many small rectangles and
+// horizontal or vertical lines, each of which used to be a separate X request.
+// We queue them as long as the drawable and the GC state (foreground, clip
+// region, line attributes) stay the same. Since all queued primitives use the
+// same GC their relative order does not matter, so the three kinds can be
+// queued in parallel and sent as one request of each kind.
+//
+// The queue is flushed before any GC change, before any other drawing
+// operation, when the drawable changes, when the GC is handed out with gc(),
+// and at the end of each Fl::flush().
+//
+// Batching is off unless the program turns it on with fl_x11_batching(1),
+// because code that draws with the fl_gc global directly would draw before
+// the queued primitives and could change the GC behind our back.
+
+static XRectangle batch_rects[FL_XLIB_BATCH_SIZE];
+static XSegment batch_segments[FL_XLIB_BATCH_SIZE];
+static XPoint batch_points[FL_XLIB_BATCH_SIZE];
+static int n_rects = 0, n_segments = 0, n_points = 0;
+static Drawable batch_drawable = 0;
+static GC batch_gc = 0;
+
+// statistics
+static unsigned long stat_frames = 0;
+static unsigned long stat_primitives = 0, stat_requests = 0;
+static unsigned long frame_primitives = 0, frame_requests = 0;
+static unsigned long last_frame_primitives = 0, last_frame_requests = 0;
+
+int Fl_Xlib_Graphics_Driver::batch_count_ = 0;
+bool Fl_Xlib_Graphics_Driver::batching_ = false;
+unsigned long Fl_Xlib_Graphics_Driver::fg_pixel_ = 0;
+bool Fl_Xlib_Graphics_Driver::fg_known_ = false;
+
+void Fl_Xlib_Graphics_Driver::flush_batch_() {
+  if (n_rects) {
+    XFillRectangles(fl_display, batch_drawable, batch_gc, batch_rects, n_rects);
+    frame_requests++;
+  }
+  if (n_segments) {
+    XDrawSegments(fl_display, batch_drawable, batch_gc, batch_segments, n_segments);
+    frame_requests++;
+  }
+  if (n_points) {
+    XDrawPoints(fl_display, batch_drawable, batch_gc, batch_points, n_points, CoordModeOrigin);
+    frame_requests++;
+  }
+  frame_primitives += batch_count_;
+  n_rects = n_segments = n_points = batch_count_ = 0;
+}
+
+// Makes sure queued primitives go to the current drawable with the current GC.
+static inline void check_target(GC gc) {
+  if (batch_drawable != fl_window || batch_gc != gc) {
+    Fl_Xlib_Graphics_Driver::flush_batch();
+    batch_drawable = fl_window;
+    batch_gc = gc;
+  }
+}
+
+// Queues a filled rectangle in X coordinates (already clipped to 16 bits).
+void Fl_Xlib_Graphics_Driver::batch_rectangle(int x, int y, int w, int h) {
+  if (!batching_) {
+    XFillRectangle(fl_display, fl_window, gc_, x, y, w, h);
+    frame_primitives++;
+    frame_requests++;
+    return;
+  }
+  check_target(gc_);
+  if (n_rects >= FL_XLIB_BATCH_SIZE) flush_batch_();
+  XRectangle *r = batch_rects + n_rects++;
+  r->x = short(x); r->y = short(y);
+  r->width = (unsigned short)w; r->height = (unsigned short)h;
+  batch_count_++;
+}
+
+// Queues a line segment in X coordinates (already clipped to 16 bits).
+void Fl_Xlib_Graphics_Driver::batch_segment(int x1, int y1, int x2, int y2) {
+  if (!batching_) {
+    XDrawLine(fl_display, fl_window, gc_, x1, y1, x2, y2);
+    frame_primitives++;
+    frame_requests++;
+    return;
+  }
+  check_target(gc_);
+  if (n_segments >= FL_XLIB_BATCH_SIZE) flush_batch_();
+  XSegment *s = batch_segments + n_segments++;
+  s->x1 = short(x1); s->y1 = short(y1);
+  s->x2 = short(x2); s->y2 = short(y2);
+  batch_count_++;
+}
+
+// Queues a single pixel in X coordinates.
+void Fl_Xlib_Graphics_Driver::batch_point(int x, int y) {
+  if (!batching_) {
+    XDrawPoint(fl_display, fl_window, gc_, x, y);
+    frame_primitives++;
+    frame_requests++;
+    return;
+  }
+  check_target(gc_);
+  if (n_points >= FL_XLIB_BATCH_SIZE) flush_batch_();
+  XPoint *p = batch_points + n_points++;
+  p->x = short(x); p->y = short(y);
+  batch_count_++;
+}
+
+// Changes the foreground of the GC. Queued primitives must keep the color
+// they were drawn with, so the queue is flushed if the pixel value changes.
+void Fl_Xlib_Graphics_Driver::set_foreground(unsigned long pixel) {
+  if (batch_count_ && !(fg_known_ && pixel == fg_pixel_)) flush_batch_();
+  XSetForeground(fl_display, gc_, pixel);
+  fg_pixel_ = pixel;
+  fg_known_ = true;
+}
+
+/** Sends all queued primitives before the GC is handed out.
+ The caller may draw with the GC or change it directly, hence the foreground
+ pixel can no longer be trusted.
+ */
+void Fl_Xlib_Graphics_Driver::expose_gc() {
+  flush_batch();
+  fg_known_ = false;
+}
+
+void *Fl_Xlib_Graphics_Driver::gc() {
+  expose_gc();
+  return gc_;
+}
+
+/** Turns batching on or off. Turning it off sends all queued primitives. */
+void Fl_Xlib_Graphics_Driver::batching(bool on) {
+  if (!on) flush_batch();
+  batching_ = on;
+}
+
+/** Flushes the queue and accounts for the end of a frame.
+ Called by the X11 screen driver at the end of each Fl::flush().
+ */
+void Fl_Xlib_Graphics_Driver::end_batch_frame() {
+  flush_batch();
+  if (!frame_primitives) return;
+  stat_frames++;
+  stat_primitives += frame_primitives;
+  stat_requests += frame_requests;
+  last_frame_primitives = frame_primitives;
+  last_frame_requests = frame_requests;
+  frame_primitives = frame_requests = 0;
+}
+
+/** Reports how well rectangles, segments and points were batched.
+ \param[out] frames number of frames that drew batched primitives
+ \param[out] primitives number of primitives queued, i.e. the number of X
+ requests that would have been sent without batching
+ \param[out] requests number of X requests actually sent for them
+ \param[out] frame_prims same as \p primitives for the last frame
+ \param[out] frame_reqs same as \p requests for the last frame
+ */
+void Fl_Xlib_Graphics_Driver::batch_statistics(unsigned long &frames, unsigned long &primitives,
+                                               unsigned long &requests, unsigned long &frame_prims,
+                                               unsigned long &frame_reqs) {
+  frames = stat_frames;
+  primitives = stat_primitives;
+  requests = stat_requests;
+  frame_prims = last_frame_primitives;
+  frame_reqs = last_frame_requests;
+}
+
+/** Clears all counters reported by batch_statistics(). */
+void Fl_Xlib_Graphics_Driver::reset_batch_statistics() {
+  stat_frames = stat_primitives = stat_requests = 0;
+  frame_primitives = frame_requests = 0;
+  last_frame_primitives = last_frame_requests = 0;
+}
@@ -102,14 +102,14 @@ void Fl_Xlib_Graphics_Driver::color(Fl_Color i) {
   } else {
     Fl_Graphics_Driver::color(i);
     if(!gc_) return; // don't get a default gc if current window is not yet created/valid
-    XSetForeground(fl_display, gc_, fl_xpixel(i));
+    set_foreground(fl_xpixel(i));
   }
 }
 
 void Fl_Xlib_Graphics_Driver::color(uchar r,uchar g,uchar b) {
   Fl_Graphics_Driver::color( fl_rgb_color(r, g, b) );
   if(!gc_) return; // don't get a default gc if current window is not yet created/valid
-  XSetForeground(fl_display, gc_, fl_xpixel(r,g,b));
+  set_foreground(fl_xpixel(r,g,b));
 }
 
 /** \addtogroup  fl_attributes
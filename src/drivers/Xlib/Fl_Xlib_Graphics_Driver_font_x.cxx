@@ -544,9 +544,9 @@ static Fl_Font_Descriptor* find(int fnum, int size) {
   char *name;
   Fl_Xlib_Fontdesc* s = ((Fl_Xlib_Fontdesc*)fl_fonts)+fnum;
   if (!s->name) s = (Fl_Xlib_Fontdesc*)fl_fonts; // use font 0 if still undefined
-  Fl_Font_Descriptor* f;
-  for (f = s->first; f; f = f->next)
-    if (f->size == size) return f;
+  Fl_Font num = Fl_Font(s - (Fl_Xlib_Fontdesc*)fl_fonts);
+  Fl_Font_Descriptor* f = Fl_Font_Descriptor::find(num, size);
+  if (f) return f;
   fl_open_display();
 
   name = put_font_size(s->name, size);
@@ -554,6 +554,7 @@ static Fl_Font_Descriptor* find(int fnum, int size) {
   f->size = size;
   f->next = s->first;
   s->first = f;
+  f->cache(num);
   free(name);
   return f;
 }
@@ -637,6 +638,7 @@ void Fl_Xlib_Graphics_Driver::draw_unscaled(const char* c, int n, int x, int y)
     font_gc = gc_;
     XSetFont(fl_display, gc_, ((Fl_Xlib_Font_Descriptor*)font_descriptor())->font->fid);
   }
+  flush_batch();
   if (gc_) XUtf8DrawString(fl_display, fl_window, ((Fl_Xlib_Font_Descriptor*)font_descriptor())->font, gc_, x1, y1, c, n);
 }
 
@@ -671,6 +673,7 @@ void Fl_Xlib_Graphics_Driver::rtl_draw_unscaled(const char* c, int n, int x, int
     if (!font_descriptor()) this->font(FL_HELVETICA, FL_NORMAL_SIZE);
     font_gc = gc_;
   }
+  flush_batch();
   if (gc_) XUtf8DrawRtlString(fl_display, fl_window, ((Fl_Xlib_Font_Descriptor*)font_descriptor())->font, gc_, x1, y1, c, n);
 }
 
@@ -23,6 +23,7 @@
 #include <FL/fl_string_functions.h>  // fl_strdup()
 #include <FL/platform.H>
 #include "Fl_Font.H"
+#include "../Unix/Fl_Unix_System_Driver.H"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -266,6 +267,13 @@ Fl_Font Fl_Xlib_Graphics_Driver::set_fonts(const char* pattern_name)
 
   fl_open_display(); // Just in case...
 
+  // the names found by a previous run, if the installed fonts didn't change
+  int cached = Fl_Unix_System_Driver::load_font_cache("xft");
+  if (cached >= 0) {
+    fl_free_font += cached;
+    return (Fl_Font)fl_free_font;
+  }
+
   // Make sure fontconfig is ready... is this necessary? The docs say it is
   // safe to call it multiple times, so just go for it anyway!
   if (!FcInit())
@@ -380,6 +388,7 @@ Fl_Font Fl_Xlib_Graphics_Driver::set_fonts(const char* pattern_name)
     }
     // Now we are done with the list, release it fully
     free(full_list);
+    Fl_Unix_System_Driver::save_font_cache("xft", fl_free_font - FL_FREE_FONT);
   }
   return (Fl_Font)fl_free_font;
 } // ::set_fonts
@@ -714,6 +723,7 @@ void Fl_Xlib_Graphics_Driver::draw_unscaled(const char *str, int n, int x, int y
   int y1 = y + floor(offset_y_) ;
   if (y1 < clip_min() || y1 > clip_max()) return;
 
+  flush_batch();
   if (!draw_)
     draw_ = XftDrawCreate(fl_display, draw_window = fl_window,
                          fl_visual->visual, fl_colormap);
@@ -750,6 +760,7 @@ void Fl_Xlib_Graphics_Driver::draw_unscaled(int angle, const char *str, int n, i
 }
 
 void Fl_Xlib_Graphics_Driver::drawUCS4(const void *str, int n, int x, int y) {
+  flush_batch();
   if (!draw_)
     draw_ = XftDrawCreate(fl_display, draw_window = fl_window,
                          fl_visual->visual, fl_colormap);
@@ -907,7 +918,9 @@ const char* Fl_Xlib_Graphics_Driver::get_font_name(Fl_Font fnum, int* ap) {
 
 Fl_Xlib_Font_Descriptor::~Fl_Xlib_Font_Descriptor() {
   if (this == fl_graphics_driver->font_descriptor()) fl_graphics_driver->font_descriptor(NULL);
-  //  XftFontClose(fl_display, font);
+#if !USE_PANGO
+  if (font) XftFontClose(fl_display, font); // Fl_Graphics_Driver::font_cache_limit() closes fonts
+#endif
 #if USE_PANGO
   if (width) for (int i = 0; i < 64; i++) delete[] width[i];
   delete[] width;
@@ -932,14 +945,12 @@ static void fl_xft_font(Fl_Xlib_Graphics_Driver *driver, Fl_Font fnum, Fl_Fontsi
   driver->Fl_Graphics_Driver::font(fnum, size);
   Fl_Fontdesc *font = fl_fonts + fnum;
   // search the fontsizes we have generated already
-  for (f = (Fl_Xlib_Font_Descriptor*)font->first; f; f = (Fl_Xlib_Font_Descriptor*)f->next) {
-    if (f->size == size && f->angle == angle)// && !strcasecmp(f->encoding, fl_encoding_))
-      break;
-  }
+  f = (Fl_Xlib_Font_Descriptor*)Fl_Font_Descriptor::find(fnum, size, angle);
   if (!f) {
     f = new Fl_Xlib_Font_Descriptor(font->name, size, angle);
     f->next = font->first;
     font->first = f;
+    f->cache(fnum);
   }
   driver->font_descriptor(f);
 #if XFT_MAJOR < 2 && ! USE_PANGO
@@ -1228,6 +1239,7 @@ void Fl_Xlib_Graphics_Driver::do_draw(int from_right, const char *str, int n, in
   color.color.green = ((int)g)*0x101;
   color.color.blue  = ((int)b)*0x101;
   color.color.alpha = 0xffff;
+  flush_batch();
   if (!draw_)
     draw_ = XftDrawCreate(fl_display, draw_window = fl_window, fl_visual->visual, fl_colormap);
   else
@@ -1335,11 +1347,16 @@ static int font_sort(Fl_Fontdesc *fa, Fl_Fontdesc *fb) {
 
 Fl_Font Fl_Xlib_Graphics_Driver::set_fonts(const char* pattern_name)
 {
+  static int found = -1; // number of fonts found by a previous call
+  if (found >= 0) return FL_FREE_FONT + found;
   fl_open_display();
   int n_families, count = 0;
   PangoFontFamily **families;
   Fl_Xlib_Graphics_Driver::context();
   Fl_Xlib_Graphics_Driver::init_built_in_fonts();
+  // the names found by a previous run, if the installed fonts didn't change
+  found = Fl_Unix_System_Driver::load_font_cache("pango");
+  if (found >= 0) return FL_FREE_FONT + found;
   pango_font_map_list_families(Fl_Xlib_Graphics_Driver::pfmap_, &families, &n_families);
   for (int fam = 0; fam < n_families; fam++) {
     PangoFontFace **faces;
@@ -1360,6 +1377,8 @@ Fl_Font Fl_Xlib_Graphics_Driver::set_fonts(const char* pattern_name)
   /*g_*/free(families);
   // Sort the list into alphabetic order
   qsort(fl_fonts + FL_FREE_FONT, count, sizeof(Fl_Fontdesc), (sort_f_type)font_sort);
+  Fl_Unix_System_Driver::save_font_cache("pango", count);
+  found = count;
   return FL_FREE_FONT + count;
 }
 
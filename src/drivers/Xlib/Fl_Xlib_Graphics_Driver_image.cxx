@@ -476,6 +476,7 @@ static void innards(const uchar *buf, int X, int Y, int W, int H,
   int dx = 0, dy = 0, w = 0, h = 0;
   fl_clip_box(X, Y, W, H, dx, dy, w, h);
   if (w<=0 || h<=0) return;
+  Fl_Xlib_Graphics_Driver::flush_batch();
   dx -= X;
   dy -= Y;
   if (!bytes_per_pixel) figure_out_visual();
@@ -624,6 +625,7 @@ void Fl_Xlib_Graphics_Driver::delete_bitmask(fl_uintptr_t bm) {
 }
 
 void Fl_Xlib_Graphics_Driver::draw_fixed(Fl_Bitmap *bm, int X, int Y, int W, int H, int cx, int cy) {
+  flush_batch();
   X = floor(X)+floor(offset_x_);
   Y = floor(Y)+floor(offset_y_);
   cache_size(bm, W, H);
@@ -738,6 +740,7 @@ void Fl_Xlib_Graphics_Driver::cache(Fl_RGB_Image *img) {
 
 
 void Fl_Xlib_Graphics_Driver::draw_fixed(Fl_RGB_Image *img, int X, int Y, int W, int H, int cx, int cy) {
+  flush_batch();
   X = floor(X)+floor(offset_x_);
   Y = floor(Y)+floor(offset_y_);
   cache_size(img, W, H);
@@ -793,6 +796,7 @@ void Fl_Xlib_Graphics_Driver::draw_rgb(Fl_RGB_Image *rgb, int XP, int YP, int WP
  */
 int Fl_Xlib_Graphics_Driver::scale_and_render_pixmap(Fl_Offscreen pixmap, int depth, double scale_x, double scale_y, int XP, int YP, int WP, int HP) {
   bool has_alpha = (depth == 2 || depth == 4);
+  flush_batch();
   if (!has_alpha && scale_x == 1 && scale_y == 1) {
     // Fix for a problem visible under XQuartz with test/device and Fl_Image_Surface:
     // the drawn image is fully black. The problem does not occur under linux.
@@ -863,6 +867,7 @@ void Fl_Xlib_Graphics_Driver::cache(Fl_Bitmap *bm) {
 }
 
 void Fl_Xlib_Graphics_Driver::draw_fixed(Fl_Pixmap *pxm, int X, int Y, int W, int H, int cx, int cy) {
+  flush_batch();
   X = floor(X)+floor(offset_x_);
   Y = floor(Y)+floor(offset_y_);
   cache_size(pxm, W, H);
@@ -911,8 +916,8 @@ void Fl_Xlib_Graphics_Driver::cache(Fl_Pixmap *pxm) {
   Fl_Image_Surface *surf = new Fl_Image_Surface(pxm->data_w(), pxm->data_h());
   Fl_Surface_Device::push_current(surf);
   uchar **pbitmap = surf->driver()->mask_bitmap();
-  *pbitmap = (uchar*)1;// will instruct fl_draw_pixmap() to compute the image's mask
-  fl_draw_pixmap(pxm->data(), 0, 0, FL_BLACK);
+  *pbitmap = (uchar*)1;// will instruct draw_pixmap_data() to compute the image's mask
+  draw_pixmap_data(pxm, 0, 0, FL_BLACK);
   uchar *bitmap = *pbitmap;
   if (bitmap) {
     *Fl_Graphics_Driver::mask(pxm) = (fl_uintptr_t)create_bitmask(pxm->data_w(), pxm->data_h(), bitmap);
@@ -55,6 +55,7 @@ void Fl_Xlib_Graphics_Driver::line_style_unscaled(int style, int width, char* da
   }
   static int Cap[4] = {CapButt, CapButt, CapRound, CapProjecting};
   static int Join[4] = {JoinMiter, JoinMiter, JoinRound, JoinBevel};
+  flush_batch();
   XSetLineAttributes(fl_display, gc_,
                      line_width_,
                      ndashes ? LineOnOffDash : LineSolid,
@@ -63,6 +64,7 @@ void Fl_Xlib_Graphics_Driver::line_style_unscaled(int style, int width, char* da
 }
 
 void *Fl_Xlib_Graphics_Driver::change_pen_width(int lwidth) {
+  flush_batch();
   XGCValues *gc_values = (XGCValues*)malloc(sizeof(XGCValues));
   gc_values->line_width = lwidth;
   XChangeGC(fl_display, gc_, GCLineWidth, gc_values);
@@ -72,6 +74,7 @@ void *Fl_Xlib_Graphics_Driver::change_pen_width(int lwidth) {
 }
 
 void Fl_Xlib_Graphics_Driver::reset_pen_width(void *data) {
+  flush_batch();
   XGCValues *gc_values = (XGCValues*)data;
   line_width_ = gc_values->line_width;
   XChangeGC(fl_display, gc_, GCLineWidth, gc_values);
@@ -230,8 +230,9 @@ void Fl_Xlib_Graphics_Driver::focus_rect(int x, int y, int w, int h) {
 void Fl_Xlib_Graphics_Driver::rectf_unscaled(int x, int y, int w, int h) {
   x += floor(offset_x_);
   y += floor(offset_y_);
-  if (!clip_rect(x, y, w, h))
-    XFillRectangle(fl_display, fl_window, gc_, x, y, w, h);
+  if (clip_rect(x, y, w, h)) return;
+  if (w == 1 && h == 1) batch_point(x, y);
+  else batch_rectangle(x, y, w, h);
 }
 
 void Fl_Xlib_Graphics_Driver::line_unscaled(int x, int y, int x1, int y1) {
@@ -262,6 +263,7 @@ void Fl_Xlib_Graphics_Driver::loop_unscaled(int x, int y, int x1, int y1, int x2
   p[2].x = x2 + floor(offset_x_) ; p[2].y = y2 + floor(offset_y_) ;
   p[3].x = p[0].x;  p[3].y = p[0].y;
   // *FIXME* This needs X coordinate clipping!
+  flush_batch();
   XDrawLines(fl_display, fl_window, gc_, p, 4, 0);
 }
 
@@ -273,6 +275,7 @@ void Fl_Xlib_Graphics_Driver::loop_unscaled(int x, int y, int x1, int y1, int x2
   p[3].x = x3 + floor(offset_x_) ; p[3].y = y3 + floor(offset_y_) ;
   p[4].x = p[0].x;  p[4].y = p[0].y;
   // *FIXME* This needs X coordinate clipping!
+  flush_batch();
   XDrawLines(fl_display, fl_window, gc_, p, 5, 0);
 }
 
@@ -283,6 +286,7 @@ void Fl_Xlib_Graphics_Driver::polygon_unscaled(int x, int y, int x1, int y1, int
   p[2].x = x2 + floor(offset_x_) ; p[2].y = y2 + floor(offset_y_) ;
   p[3].x = p[0].x;  p[3].y = p[0].y;
   // *FIXME* This needs X coordinate clipping!
+  flush_batch();
   XFillPolygon(fl_display, fl_window, gc_, p, 3, Convex, 0);
   XDrawLines(fl_display, fl_window, gc_, p, 4, 0);
 }
@@ -295,6 +299,7 @@ void Fl_Xlib_Graphics_Driver::polygon_unscaled(int x, int y, int x1, int y1, int
   p[3].x = x3 + floor(offset_x_) ; p[3].y = y3 + floor(offset_y_) ;
   p[4].x = p[0].x;  p[4].y = p[0].y;
   // *FIXME* This needs X coordinate clipping!
+  flush_batch();
   XFillPolygon(fl_display, fl_window, gc_, p, 4, Convex, 0);
   XDrawLines(fl_display, fl_window, gc_, p, 5, 0);
 }
@@ -306,7 +311,7 @@ void Fl_Xlib_Graphics_Driver::polygon_unscaled(int x, int y, int x1, int y1, int
 
 void Fl_Xlib_Graphics_Driver::draw_clipped_line(int x1, int y1, int x2, int y2) {
   if (!clip_line(x1, y1, x2, y2))
-    XDrawLine(fl_display, fl_window, gc_, x1, y1, x2, y2);
+    batch_segment(x1, y1, x2, y2);
 }
 
 // --- clipping
@@ -374,6 +379,7 @@ int Fl_Xlib_Graphics_Driver::not_clipped(int x, int y, int w, int h) {
 
 void Fl_Xlib_Graphics_Driver::restore_clip() {
   fl_clip_state_number++;
+  flush_batch();
   if (gc_) {
     Region r = (Region)rstack[rstackptr];
     if (r) {
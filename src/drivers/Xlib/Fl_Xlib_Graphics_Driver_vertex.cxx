@@ -29,6 +29,7 @@
 
 
 void Fl_Xlib_Graphics_Driver::end_points() {
+  flush_batch();
   if (n>1) XDrawPoints(fl_display, fl_window, gc_, short_point, n, 0);
 }
 
@@ -37,6 +38,7 @@ void Fl_Xlib_Graphics_Driver::end_line() {
     end_points();
     return;
   }
+  flush_batch();
   if (n>1) XDrawLines(fl_display, fl_window, gc_, short_point, n, 0);
 }
 
@@ -54,6 +56,7 @@ void Fl_Xlib_Graphics_Driver::end_polygon() {
     end_line();
     return;
   }
+  flush_batch();
   if (n>2) XFillPolygon(fl_display, fl_window, gc_, short_point, n, Convex, 0);
 }
 
@@ -73,6 +76,7 @@ void Fl_Xlib_Graphics_Driver::end_complex_polygon() {
     end_line();
     return;
   }
+  flush_batch();
   if (n>2) XFillPolygon(fl_display, fl_window, gc_, short_point, n, 0, 0);
 }
 
@@ -88,6 +92,7 @@ void Fl_Xlib_Graphics_Driver::ellipse_unscaled(double xt, double yt, double rx,
   int w = (int)rint(xt+rx)-llx;
   int lly = (int)rint(yt-ry);
   int h = (int)rint(yt+ry)-lly;
+  flush_batch();
 
   (what == POLYGON ? XFillArc : XDrawArc)
     (fl_display, fl_window, gc_, llx, lly, w, h, 0, 360*64);
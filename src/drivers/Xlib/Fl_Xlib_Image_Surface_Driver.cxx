@@ -53,6 +53,8 @@ Fl_Xlib_Image_Surface_Driver::Fl_Xlib_Image_Surface_Driver(int w, int h, int hig
 Fl_Xlib_Image_Surface_Driver::~Fl_Xlib_Image_Surface_Driver() {
 #if FLTK_USE_CAIRO
   cairo_destroy(cairo_);
+#else
+  Fl_Xlib_Graphics_Driver::flush_batch(); // may still target the offscreen
 #endif
   if (offscreen && !external_offscreen) XFreePixmap(fl_display, (Pixmap)offscreen);
   delete driver();
@@ -86,6 +88,9 @@ void Fl_Xlib_Image_Surface_Driver::untranslate() {
 
 Fl_RGB_Image* Fl_Xlib_Image_Surface_Driver::image()
 {
+#if !FLTK_USE_CAIRO
+  Fl_Xlib_Graphics_Driver::flush_batch();
+#endif
   Fl_RGB_Image *image = Fl::screen_driver()->read_win_rectangle(0, 0, width, height, 0);
   return image;
 }
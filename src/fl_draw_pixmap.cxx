@@ -34,15 +34,61 @@
 #include "Fl_System_Driver.H"
 #include <FL/platform.H>
 #include <FL/fl_draw.H>
+#include <FL/Fl_Pixmap.H>
 #include <stdio.h>
 #include "flstring.h"
 
 
-static int ncolors, chars_per_pixel;
-
 typedef struct { uchar r; uchar g; uchar b; } UsedColor;
-static UsedColor *used_colors;
-static int color_count;             // # of non-transparent colors used in pixmap
+
+// The colormap of an XPM image, compiled once per conversion so that the
+// pixels can be looked up quickly. All the state of a conversion lives
+// here, which makes the conversion reentrant.
+//
+// Colors are kept as the 4 bytes r,g,b,a written to the output. One
+// character keys index a table. Two character keys index a table per
+// first character, allocated only for the first characters the colormap
+// uses, instead of a table for all 65536 keys.
+struct Fl_XPM_Palette {
+  int w, h, cpp;
+  const uchar *const *rows;     // the first row of pixels
+  U32 colors[256];              // colors of one character keys
+  U32 *tables[256];             // colors of two character keys
+  unsigned *transparent;        // keys of the transparent colors
+  int transparent_count;        // # of transparent colors
+  UsedColor *used_colors;       // the colors, if collected
+  int color_count;              // # of non-transparent colors used in pixmap
+
+  Fl_XPM_Palette() : transparent(0), transparent_count(0), used_colors(0), color_count(0) {
+    memset(colors, 0, sizeof(colors));
+    memset(tables, 0, sizeof(tables));
+  }
+  ~Fl_XPM_Palette() {
+    if (used_colors) free(used_colors);
+    if (transparent) free(transparent);
+    for (int i = 0; i < 256; i++) delete[] tables[i];
+  }
+  U32 *slot(unsigned key) {
+    if (cpp < 2) return colors + (key & 255);
+    U32 *&t = tables[(key >> 8) & 255];
+    if (!t) {
+      t = new U32[256];
+      memset(t, 0, 256 * sizeof(U32));
+    }
+    return t + (key & 255);
+  }
+  void set_transparent(unsigned key, uchar r, uchar g, uchar b);
+  int compile(const char *const *cdata, Fl_Color bg, int collect);
+  void transparent_color(uchar r, uchar g, uchar b);
+  void convert(uchar *out) const;
+};
+
+static U32 make_color(uchar r, uchar g, uchar b, uchar a) {
+  uchar c[4] = {r, g, b, a};
+  U32 v;
+  memcpy(&v, c, 4);
+  return v;
+}
 
 /**
   Get the dimensions of a pixmap.
@@ -62,30 +108,35 @@ int fl_measure_pixmap(/*const*/ char* const* data, int &w, int &h) {
   \see fl_measure_pixmap(char* const* data, int &w, int &h)
   */
 int fl_measure_pixmap(const char * const *cdata, int &w, int &h) {
+  int ncolors, chars_per_pixel;
   int i = sscanf(cdata[0],"%d%d%d%d",&w,&h,&ncolors,&chars_per_pixel);
   if (i<4 || w<=0 || h<=0 ||
       (chars_per_pixel!=1 && chars_per_pixel!=2) ) return w=0;
   return 1;
 }
 
-int fl_convert_pixmap(const char*const* cdata, uchar* out, Fl_Color bg) {
-  int w, h;
-  const uchar*const* data = (const uchar*const*)(cdata+1);
-  uchar *transparent_c = (uchar *)0; // such that transparent_c[0,1,2] are the RGB of the transparent color
-
-  if (!fl_measure_pixmap(cdata, w, h))
-    return 0;
+// Makes key a transparent color and records it.
+void Fl_XPM_Palette::set_transparent(unsigned key, uchar r, uchar g, uchar b) {
+  *slot(key) = make_color(r, g, b, 0);
+  if ((transparent_count & 7) == 0)
+    transparent = (unsigned*)realloc(transparent, (transparent_count + 8) * sizeof(unsigned));
+  transparent[transparent_count++] = key;
+}
 
-  if ((chars_per_pixel < 1) || (chars_per_pixel > 2))
+// Reads the header and the colormap of the XPM data. Returns 0 if the
+// data can't be converted.
+// If collect is non-zero, the colors are also collected in used_colors.
+int Fl_XPM_Palette::compile(const char *const *cdata, Fl_Color bg, int collect) {
+  int ncolors;
+  if (sscanf(cdata[0], "%d%d%d%d", &w, &h, &ncolors, &cpp) < 4 ||
+      w <= 0 || h <= 0 || (cpp != 1 && cpp != 2))
     return 0;
+  const uchar *const *data = (const uchar *const *)(cdata + 1);
+  uchar bg_r, bg_g, bg_b;
+  Fl::get_color(bg, bg_r, bg_g, bg_b);
 
-  typedef uchar uchar4[4];
-  uchar4 *colors = new uchar4[ int(1<<(chars_per_pixel*8)) ];
-
-  if (Fl_Graphics_Driver::need_pixmap_bg_color) {
-    color_count = 0;
-    used_colors = (UsedColor*)malloc(abs(ncolors) * sizeof(UsedColor));
-  }
+  if (collect)
+    used_colors = (UsedColor*)malloc((abs(ncolors) + 1) * sizeof(UsedColor));
 
   if (ncolors < 0) {    // FLTK (non standard) compressed colormap
     ncolors = -ncolors;
@@ -93,35 +144,27 @@ int fl_convert_pixmap(const char*const* cdata, uchar* out, Fl_Color bg) {
     // if first color is ' ' it is transparent (put it later to make
     // it not be transparent):
     if (*p == ' ') {
-      uchar* c = colors[(int)' '];
-      Fl::get_color(bg, c[0], c[1], c[2]); c[3] = 0;
-      if (Fl_Graphics_Driver::need_pixmap_bg_color) transparent_c = c;
+      set_transparent(' ', bg_r, bg_g, bg_b);
       p += 4;
       ncolors--;
     }
     // read all the rest of the colors:
-    for (int i=0; i < ncolors; i++) {
-      uchar* c = colors[*p++];
-      if (Fl_Graphics_Driver::need_pixmap_bg_color) {
-        used_colors[color_count].r = *(p+0);
-        used_colors[color_count].g = *(p+1);
-        used_colors[color_count].b = *(p+2);
+    for (int i=0; i < ncolors; i++, p += 4) {
+      if (used_colors) {
+        used_colors[color_count].r = p[1];
+        used_colors[color_count].g = p[2];
+        used_colors[color_count].b = p[3];
         color_count++;
       }
-      *c++ = *p++;
-      *c++ = *p++;
-      *c++ = *p++;
-      *c = 255;
+      *slot(p[0]) = make_color(p[1], p[2], p[3], 255);
     }
   } else {      // normal XPM colormap with names
     for (int i=0; i<ncolors; i++) {
       const uchar *p = *data++;
       // the first 1 or 2 characters are the color index:
-      int ind = *p++;
-      uchar* c;
-      if (chars_per_pixel>1)
+      unsigned ind = *p++;
+      if (cpp>1)
         ind = (ind<<8)|*p++;
-      c = colors[ind];
       // look for "c word", or last word if none:
       const uchar *previous_word = p;
       for (;;) {
@@ -134,66 +177,70 @@ int fl_convert_pixmap(const char*const* cdata, uchar* out, Fl_Color bg) {
         previous_word = p;
         while (*p && !isspace(*p)) p++;
       }
-      int parse = fl_parse_color((const char*)p, c[0], c[1], c[2]);
-      c[3] = 255;
-      if (parse) {
-        if (Fl_Graphics_Driver::need_pixmap_bg_color) {
-          used_colors[color_count].r = c[0];
-          used_colors[color_count].g = c[1];
-          used_colors[color_count].b = c[2];
+      uchar r, g, b;
+      if (fl_parse_color((const char*)p, r, g, b)) {
+        *slot(ind) = make_color(r, g, b, 255);
+        if (used_colors) {
+          used_colors[color_count].r = r;
+          used_colors[color_count].g = g;
+          used_colors[color_count].b = b;
           color_count++;
         }
       } else {
         // assume "None" or "#transparent" for any errors
         // "bg" should be transparent...
-        Fl::get_color(bg, c[0], c[1], c[2]);
-        //uchar **m = fl_graphics_driver->mask_bitmap();
-        c[3] = /*(m && !*m) ? 255 :*/ 0;
-        if (Fl_Graphics_Driver::need_pixmap_bg_color) transparent_c = c;
+        set_transparent(ind, bg_r, bg_g, bg_b);
       } // if parse
     } // for ncolors
   } // if ncolors
-  if (Fl_Graphics_Driver::need_pixmap_bg_color) {
-    if (transparent_c) {
-      fl_graphics_driver->make_unused_color_(transparent_c[0], transparent_c[1], transparent_c[2], color_count, (void**)&used_colors);
-    } else {
-      uchar r, g, b;
-      fl_graphics_driver->make_unused_color_(r, g, b, color_count, (void**)&used_colors);
-    }
+  rows = data;
+  return 1;
+}
+
+// Gives all transparent colors the color r,g,b.
+void Fl_XPM_Palette::transparent_color(uchar r, uchar g, uchar b) {
+  U32 t = make_color(r, g, b, 0);
+  for (int i = 0; i < transparent_count; i++) {
+    U32 *v = slot(transparent[i]);
+    if (((uchar*)v)[3] == 0) *v = t; // unless the key was redefined later
   }
+}
 
+// Writes the pixels as 4 bytes r,g,b,a to out.
+void Fl_XPM_Palette::convert(uchar *out) const {
   U32 *q = (U32*)out;
   for (int Y = 0; Y < h; Y++) {
-    const uchar* p = data[Y];
-    if (chars_per_pixel <= 1) {
+    const uchar* p = rows[Y];
+    if (cpp <= 1) {
       for (int X = 0; X < w; X++)
-        memcpy(q++, colors[*p++], 4);
+        *q++ = colors[*p++];
     } else {
-      for (int X = 0; X < w; X++) {
-        int ind = (*p++)<<8;
-        ind |= *p++;
-        memcpy(q++, colors[ind], 4);
+      for (int X = 0; X < w; X++, p += 2) {
+        const U32 *t = tables[p[0]];
+        *q++ = t ? t[p[1]] : 0; // unknown keys are transparent black
       }
     }
   }
-  delete[] colors;
-  return 1;
 }
 
-int fl_draw_pixmap(const char*const* cdata, int x, int y, Fl_Color bg) {
-  int w, h;
-
-  if (!fl_measure_pixmap(cdata, w, h))
-    return 0;
-
-  uchar *buffer = new uchar[w*h*4];
-
-  if (!fl_convert_pixmap(cdata, buffer, bg)) {
-    delete[] buffer;
+int fl_convert_pixmap(const char*const* cdata, uchar* out, Fl_Color bg) {
+  Fl_XPM_Palette palette;
+  if (!palette.compile(cdata, bg, Fl_Graphics_Driver::need_pixmap_bg_color != 0))
     return 0;
+  if (Fl_Graphics_Driver::need_pixmap_bg_color) {
+    // give the transparent pixels a color that no other pixel uses
+    uchar r, g, b;
+    Fl::get_color(bg, r, g, b);
+    fl_graphics_driver->make_unused_color_(r, g, b, palette.color_count, (void**)&palette.used_colors);
+    if (palette.transparent_count) palette.transparent_color(r, g, b);
   }
+  palette.convert(out);
+  return 1;
+}
 
-  // build the mask bitmap used by Fl_Pixmap:
+// Draws the r,g,b,a pixels in buffer and builds the mask bitmap used by
+// Fl_Pixmap if the graphics driver asks for it.
+static void draw_rgba(const uchar *buffer, int x, int y, int w, int h) {
   uchar **p = fl_graphics_driver->mask_bitmap();
   if (p && *p) {
     int W = (w+7)/8;
@@ -217,7 +264,69 @@ int fl_draw_pixmap(const char*const* cdata, int x, int y, Fl_Color bg) {
   }
 
   fl_draw_image(buffer, x, y, w, h, 4);
+}
+
+int fl_draw_pixmap(const char*const* cdata, int x, int y, Fl_Color bg) {
+  int w, h;
+
+  if (!fl_measure_pixmap(cdata, w, h))
+    return 0;
+
+  uchar *buffer = new uchar[w*h*4];
+
+  if (!fl_convert_pixmap(cdata, buffer, bg)) {
+    delete[] buffer;
+    return 0;
+  }
+
+  draw_rgba(buffer, x, y, w, h);
 
   delete[] buffer;
   return 1;
 }
+
+// Returns the pixels of the pixmap decoded as 4 bytes r,g,b,a, with black
+// transparent pixels. The pixels are decoded once and kept until the
+// pixmap is uncached.
+const uchar *Fl_Pixmap::rgba_data_() {
+  if (!rgba_ && data() && data_w() > 0 && data_h() > 0) {
+    rgba_ = new uchar[data_w() * data_h() * 4];
+    if (!fl_convert_pixmap(data(), rgba_, FL_BLACK)) {
+      delete[] rgba_;
+      rgba_ = 0;
+    }
+  }
+  return rgba_;
+}
+
+// Writes the pixels of the pixmap to out like fl_convert_pixmap(), but
+// from the decoded pixels of the pixmap if there are any. If keep is
+// non-zero the pixels are decoded and kept for later conversions.
+int Fl_Pixmap::convert_(uchar *out, Fl_Color bg, int keep) const {
+  if (Fl_Graphics_Driver::need_pixmap_bg_color || (!rgba_ && !keep))
+    return data() ? fl_convert_pixmap(data(), out, bg) : 0;
+  const uchar *p = ((Fl_Pixmap*)this)->rgba_data_();
+  if (!p) return 0;
+  uchar r, g, b;
+  Fl::get_color(bg, r, g, b);
+  for (int n = data_w() * data_h(); n > 0; n--, p += 4, out += 4) {
+    if (p[3]) {
+      memcpy(out, p, 4);
+    } else {
+      out[0] = r; out[1] = g; out[2] = b; out[3] = 0;
+    }
+  }
+  return 1;
+}
+
+// Draws the pixmap like fl_draw_pixmap() draws its data. The graphics
+// drivers keep the result, so the pixels are not decoded for later.
+int Fl_Pixmap::draw_data_(int x, int y, Fl_Color bg) {
+  int w = data_w(), h = data_h();
+  if (w <= 0 || h <= 0) return 0;
+  uchar *buffer = new uchar[w*h*4];
+  int ret = convert_(buffer, bg, 0);
+  if (ret) draw_rgba(buffer, x, y, w, h);
+  delete[] buffer;
+  return ret;
+}
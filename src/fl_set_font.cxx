@@ -28,6 +28,12 @@ struct Fl_Fontdesc;
 extern FL_EXPORT Fl_Fontdesc *fl_fonts; // the table
 
 static int table_size;
+
+// Returns the number of faces the font table has room for
+int fl_font_table_size() {
+  return table_size ? table_size : FL_FREE_FONT;
+}
+
 /**
   Changes a face.
  \param fnum The font number to be assigned a new face
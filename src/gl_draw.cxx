@@ -97,6 +97,11 @@ void  gl_font(int fontid, int size) {
   fl_font(fontid, size);
   Fl_Font_Descriptor *fl_fontsize = fl_graphics_driver->font_descriptor();
   if (!has_texture_rectangle) Fl_Gl_Window_Driver::global()->gl_bitmap_font(fl_fontsize);
+  static int held = 0;
+  if (!held) { // the font cache must not delete the descriptor gl_fontsize refers to
+    Fl_Font_Descriptor::hold(&gl_fontsize);
+    held = 1;
+  }
   gl_fontsize = fl_fontsize;
 }
 
@@ -137,7 +142,10 @@ void gl_remove_displaylist_fonts()
   */
 void gl_draw(const char* str, int n) {
   if (n > 0) {
-    if (has_texture_rectangle)  Fl_Gl_Window_Driver::draw_string_with_texture(str, n);
+    if (has_texture_rectangle) {
+      if (!gl_glyph_atlas_pages() || !Fl_Gl_Window_Driver::draw_string_with_atlas(str, n))
+        Fl_Gl_Window_Driver::draw_string_with_texture(str, n);
+    }
     else Fl_Gl_Window_Driver::global()->draw_string_legacy(str, n);
   }
 }
@@ -277,7 +285,7 @@ private:
   typedef struct { // information for a pre-computed texture
     GLuint texName; // its name
     char *utf8; //its text
-    Fl_Font_Descriptor *fdesc; // its font
+    unsigned long font; // serial number of its font descriptor
     float scale; // scaling factor of the GUI
     int str_len; // the length of the utf8 text
   } data;
@@ -318,7 +326,7 @@ int gl_texture_fifo::already_known(const char *str, int n)
   int rank;
   for ( rank = 0; rank <= last; rank++) {
     if ((fifo[rank].str_len == n) &&
-        (fifo[rank].fdesc == gl_fontsize) &&
+        (fifo[rank].font == gl_fontsize->serial) &&
         (fifo[rank].scale == Fl_Gl_Window_Driver::gl_scale) &&
         (memcmp(str, fifo[rank].utf8, n) == 0)) {
       return rank;
@@ -333,11 +341,12 @@ static gl_texture_fifo *gl_fifo = NULL; // points to the texture pile class inst
 // Cross-platform implementation of the texture mechanism for text rendering
 // using textures with the alpha channel only.
 
-// displays a pre-computed texture on the GL scene
-void gl_texture_fifo::display_texture(int rank)
+// Prepares the GL scene for drawing text with textures: the matrices are set so
+// that units are pixels of the GL window, and blending of alpha textures is on.
+// Returns in pos the current raster position in these units.
+static void begin_text_scene(GLint &matrixMode, GLfloat pos[4])
 {
   //setup matrices
-  GLint matrixMode;
   glGetIntegerv (GL_MATRIX_MODE, &matrixMode);
   glMatrixMode (GL_PROJECTION);
   glPushMatrix();
@@ -353,7 +362,6 @@ void gl_texture_fifo::display_texture(int rank)
   glEnable (GL_BLEND); // for text fading
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   glDisable(GL_LIGHTING);
-  GLfloat pos[4];
   glGetFloatv(GL_CURRENT_RASTER_POSITION, pos);
   if (gl_start_scale != 1) { // using gl_start() / gl_finish()
     pos[0] /= gl_start_scale;
@@ -364,23 +372,11 @@ void gl_texture_fifo::display_texture(int rank)
   glScalef (R/winw, R/winh, 1.0f);
   glTranslatef (-winw/R, -winh/R, 0.0f);
   glEnable (GL_TEXTURE_RECTANGLE_ARB);
-  glBindTexture (GL_TEXTURE_RECTANGLE_ARB, fifo[rank].texName);
-  GLint width, height;
-  glGetTexLevelParameteriv(GL_TEXTURE_RECTANGLE_ARB, 0, GL_TEXTURE_WIDTH, &width);
-  glGetTexLevelParameteriv(GL_TEXTURE_RECTANGLE_ARB, 0, GL_TEXTURE_HEIGHT, &height);
-  //write the texture on screen
-  glBegin (GL_QUADS);
-  float ox = pos[0];
-  float oy = pos[1] + height - Fl_Gl_Window_Driver::gl_scale * fl_descent();
-  glTexCoord2f (0.0f, 0.0f); // draw lower left in world coordinates
-  glVertex2f (ox, oy);
-  glTexCoord2f (0.0f, (GLfloat)height); // draw upper left in world coordinates
-  glVertex2f (ox, oy - height);
-  glTexCoord2f ((GLfloat)width, (GLfloat)height); // draw upper right in world coordinates
-  glVertex2f (ox + width, oy - height);
-  glTexCoord2f ((GLfloat)width, 0.0f); // draw lower right in world coordinates
-  glVertex2f (ox + width, oy);
-  glEnd ();
+}
+
+// Undoes begin_text_scene() and moves the raster position by width pixels.
+static void end_text_scene(GLint matrixMode, GLfloat pos[4], float width)
+{
   glPopAttrib();
 
   // reset original matrices
@@ -406,6 +402,32 @@ void gl_texture_fifo::display_texture(int rank)
   }
   glRasterPos2d(objX, objY);
 #endif // HAVE_GL_GLU_H
+}
+
+// displays a pre-computed texture on the GL scene
+void gl_texture_fifo::display_texture(int rank)
+{
+  GLint matrixMode;
+  GLfloat pos[4];
+  begin_text_scene(matrixMode, pos);
+  glBindTexture (GL_TEXTURE_RECTANGLE_ARB, fifo[rank].texName);
+  GLint width, height;
+  glGetTexLevelParameteriv(GL_TEXTURE_RECTANGLE_ARB, 0, GL_TEXTURE_WIDTH, &width);
+  glGetTexLevelParameteriv(GL_TEXTURE_RECTANGLE_ARB, 0, GL_TEXTURE_HEIGHT, &height);
+  //write the texture on screen
+  glBegin (GL_QUADS);
+  float ox = pos[0];
+  float oy = pos[1] + height - Fl_Gl_Window_Driver::gl_scale * fl_descent();
+  glTexCoord2f (0.0f, 0.0f); // draw lower left in world coordinates
+  glVertex2f (ox, oy);
+  glTexCoord2f (0.0f, (GLfloat)height); // draw upper left in world coordinates
+  glVertex2f (ox, oy - height);
+  glTexCoord2f ((GLfloat)width, (GLfloat)height); // draw upper right in world coordinates
+  glVertex2f (ox + width, oy - height);
+  glTexCoord2f ((GLfloat)width, 0.0f); // draw lower right in world coordinates
+  glVertex2f (ox + width, oy);
+  glEnd ();
+  end_text_scene(matrixMode, pos, (float)width);
 } // display_texture
 
 
@@ -430,7 +452,7 @@ int gl_texture_fifo::compute_texture(const char* str, int n)
   fl_font(fl_font(), fs);
   fs = int(fs * Fl_Gl_Window_Driver::gl_scale);
   fifo[current].scale = Fl_Gl_Window_Driver::gl_scale;
-  fifo[current].fdesc = gl_fontsize;
+  fifo[current].font = gl_fontsize->serial;
   char *alpha_buf = Fl_Gl_Window_Driver::global()->alpha_mask_for_string(str, n, w, h, fs);
 
   // save GL parameters GL_UNPACK_ROW_LENGTH and GL_UNPACK_ALIGNMENT
@@ -458,6 +480,237 @@ int gl_texture_fifo::compute_texture(const char* str, int n)
   return current;
 }
 
+
+/* Implement the glyph atlas mechanism, used when gl_glyph_atlas_pages() is not 0:
+ Each glyph is rendered once for a given font, size and GUI scale into one of
+ a few large alpha-only textures, the atlas pages, where glyphs are packed in
+ rows ("shelves"). A string is drawn as one textured quad per glyph, with one
+ glBegin()/glEnd() pair per atlas page it uses. When all pages are full,
+ the least recently used page is emptied and reused.
+*/
+
+class gl_glyph_atlas {
+  friend class Fl_Gl_Window_Driver;
+private:
+  enum { PAGE_SIZE = 512 };
+  typedef struct { // a glyph stored in a page
+    unsigned long font; // serial number of its font descriptor
+    float scale; // scaling factor of the GUI
+    unsigned ucs; // its Unicode code point
+    short x, y, w, h; // its position and size in the page
+    float advance; // horizontal advance in pixels
+  } glyph;
+  typedef struct { // an atlas page
+    GLuint texName;
+    glyph *glyphs;
+    int count, alloc; // used and allocated elements of glyphs
+    int shelf_x, shelf_y, shelf_h; // free position in the current shelf, and its height
+    unsigned long last_use; // value of use_count when a glyph of this page was last drawn
+  } page;
+  typedef struct { // a hash table entry: location of a glyph
+    int page, slot; // page is -1 for a free entry
+  } entry;
+  page *pages;
+  int npages, max_pages;
+  entry *table;
+  int table_size; // a power of 2
+  int nglyphs;
+  unsigned long use_count; // incremented for each string drawn
+  static unsigned hash(unsigned long font, float scale, unsigned ucs);
+  void insert(int p, int slot);
+  void rehash(int size);
+  int find(unsigned ucs, int &p);
+  static int fit(page &pg, int w, int h, int &x, int &y);
+  int place(int w, int h, int &p, int &x, int &y);
+  int add(unsigned ucs, int &p);
+public:
+  gl_glyph_atlas(int max);
+  ~gl_glyph_atlas();
+};
+
+gl_glyph_atlas::gl_glyph_atlas(int max)
+{
+  max_pages = max;
+  pages = (page*)calloc(max_pages, sizeof(page));
+  npages = 0;
+  table = NULL;
+  table_size = 0;
+  nglyphs = 0;
+  use_count = 0;
+  rehash(256);
+}
+
+gl_glyph_atlas::~gl_glyph_atlas()
+{
+  for (int i = 0; i < npages; i++) {
+    glDeleteTextures(1, &pages[i].texName);
+    free(pages[i].glyphs);
+  }
+  free(pages);
+  free(table);
+}
+
+unsigned gl_glyph_atlas::hash(unsigned long font, float scale, unsigned ucs)
+{
+  unsigned h = (unsigned)font;
+  h = h * 31 + (unsigned)(scale * 64);
+  h = h * 31 + ucs;
+  return h ^ (h >> 15);
+}
+
+void gl_glyph_atlas::insert(int p, int slot)
+{
+  const glyph &g = pages[p].glyphs[slot];
+  unsigned i = hash(g.font, g.scale, g.ucs) & (table_size - 1);
+  while (table[i].page >= 0) i = (i + 1) & (table_size - 1);
+  table[i].page = p;
+  table[i].slot = slot;
+}
+
+// rebuilds the hash table with size entries from the glyphs of all pages
+void gl_glyph_atlas::rehash(int size)
+{
+  free(table);
+  table_size = size;
+  table = (entry*)malloc(table_size * sizeof(entry));
+  for (int i = 0; i < table_size; i++) table[i].page = -1;
+  nglyphs = 0;
+  for (int p = 0; p < npages; p++) {
+    for (int slot = 0; slot < pages[p].count; slot++) {
+      insert(p, slot);
+      nglyphs++;
+    }
+  }
+}
+
+// returns the slot of a glyph of the current font and sets p to its page, or returns -1
+int gl_glyph_atlas::find(unsigned ucs, int &p)
+{
+  float scale = Fl_Gl_Window_Driver::gl_scale;
+  unsigned i = hash(gl_fontsize->serial, scale, ucs) & (table_size - 1);
+  while (table[i].page >= 0) {
+    const glyph &g = pages[table[i].page].glyphs[table[i].slot];
+    if (g.ucs == ucs && g.font == gl_fontsize->serial && g.scale == scale) {
+      p = table[i].page;
+      return table[i].slot;
+    }
+    i = (i + 1) & (table_size - 1);
+  }
+  return -1;
+}
+
+// finds room for a w x h glyph in page pg: returns 0 if there's none,
+// otherwise reserves the room and sets x,y to its position
+int gl_glyph_atlas::fit(page &pg, int w, int h, int &x, int &y)
+{
+  if (pg.shelf_x + w + 1 > PAGE_SIZE) { // start a new shelf below the current one
+    if (pg.shelf_y + pg.shelf_h + 1 + h + 1 > PAGE_SIZE) return 0;
+    pg.shelf_y += pg.shelf_h + 1;
+    pg.shelf_x = 0;
+    pg.shelf_h = 0;
+  }
+  if (pg.shelf_y + h + 1 > PAGE_SIZE) return 0;
+  if (h > pg.shelf_h) pg.shelf_h = h; // the current shelf is the last one, it can grow
+  x = pg.shelf_x;
+  y = pg.shelf_y;
+  pg.shelf_x += w + 1;
+  return 1;
+}
+
+// finds room for a w x h glyph: returns 0 if there's none,
+// otherwise sets page p and position x,y of the glyph in that page
+int gl_glyph_atlas::place(int w, int h, int &p, int &x, int &y)
+{
+  if (w + 1 > PAGE_SIZE || h + 1 > PAGE_SIZE) return 0;
+  for (p = 0; p < npages; p++) {
+    if (fit(pages[p], w, h, x, y)) return 1;
+  }
+  if (npages < max_pages) { // create a new page
+    p = npages++;
+    page &pg = pages[p];
+    memset(&pg, 0, sizeof(page));
+    glGenTextures(1, &pg.texName);
+    glPushAttrib(GL_TEXTURE_BIT);
+    glBindTexture(GL_TEXTURE_RECTANGLE_ARB, pg.texName);
+    glTexParameteri(GL_TEXTURE_RECTANGLE_ARB, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_RECTANGLE_ARB, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_RECTANGLE_ARB, 0, GL_ALPHA8, PAGE_SIZE, PAGE_SIZE, 0, GL_ALPHA, GL_UNSIGNED_BYTE, NULL);
+    glPopAttrib();
+  } else { // empty the least recently used page not used by the string being drawn
+    p = -1;
+    for (int i = 0; i < npages; i++) {
+      if (pages[i].last_use == use_count) continue;
+      if (p < 0 || pages[i].last_use < pages[p].last_use) p = i;
+    }
+    if (p < 0) return 0;
+    page &pg = pages[p];
+    pg.count = 0;
+    pg.shelf_x = pg.shelf_y = pg.shelf_h = 0;
+    rehash(table_size);
+  }
+  return fit(pages[p], w, h, x, y);
+}
+
+// renders a glyph of the current font into the atlas: returns its slot and sets its page p,
+// or returns -1 if the glyph can't be stored
+int gl_glyph_atlas::add(unsigned ucs, int &p)
+{
+  char utf8[4];
+  int l = fl_utf8encode(ucs, utf8);
+  // measure the glyph at the font size to use in the GL scene
+  Fl_Fontsize fs = fl_size();
+  float s = fl_graphics_driver->scale();
+  fl_graphics_driver->Fl_Graphics_Driver::scale(1); // temporarily remove scaling factor
+  fl_font(fl_font(), int(fs * Fl_Gl_Window_Driver::gl_scale));
+  double advance = fl_width(utf8, l);
+  int h = fl_height();
+  fl_graphics_driver->Fl_Graphics_Driver::scale(s); // re-install scaling factor
+  fl_font(fl_font(), fs);
+  fs = int(fs * Fl_Gl_Window_Driver::gl_scale);
+  int w = (int)ceil(advance) + fs / 4 + 1; // leave room for italic overhang
+  int x, y;
+  if (!place(w, h, p, x, y)) return -1;
+  char *alpha_buf = Fl_Gl_Window_Driver::global()->alpha_mask_for_string(utf8, l, w, h, fs);
+
+  // save GL parameters GL_UNPACK_ROW_LENGTH and GL_UNPACK_ALIGNMENT
+  GLint row_length, alignment;
+  glGetIntegerv(GL_UNPACK_ROW_LENGTH, &row_length);
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  glPushAttrib(GL_TEXTURE_BIT);
+  glBindTexture(GL_TEXTURE_RECTANGLE_ARB, pages[p].texName);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, w);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexSubImage2D(GL_TEXTURE_RECTANGLE_ARB, 0, x, y, w, h, GL_ALPHA, GL_UNSIGNED_BYTE, alpha_buf);
+  delete[] alpha_buf;
+  glPopAttrib();
+  // restore saved GL parameters
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, row_length);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+  page &pg = pages[p];
+  if (pg.count >= pg.alloc) {
+    pg.alloc = pg.alloc ? 2 * pg.alloc : 64;
+    pg.glyphs = (glyph*)realloc(pg.glyphs, pg.alloc * sizeof(glyph));
+  }
+  int slot = pg.count++;
+  glyph &g = pg.glyphs[slot];
+  g.font = gl_fontsize->serial;
+  g.scale = Fl_Gl_Window_Driver::gl_scale;
+  g.ucs = ucs;
+  g.x = (short)x; g.y = (short)y; g.w = (short)w; g.h = (short)h;
+  g.advance = (float)advance;
+  if (2 * (nglyphs + 1) > table_size) {
+    rehash(2 * table_size); // this inserts the new glyph too
+  } else {
+    insert(p, slot);
+    nglyphs++;
+  }
+  return slot;
+}
+
+static gl_glyph_atlas *gl_atlas = NULL; // the glyph atlas, created when first used
+static int gl_atlas_pages = 0; // max number of atlas pages, 0 when not using the atlas
+
 #endif  // ! defined(FL_DOXYGEN)
 
 /**
@@ -477,6 +730,7 @@ int gl_texture_pile_height(void)
 void gl_texture_reset()
 {
   if (gl_fifo) gl_texture_pile_height(gl_texture_pile_height());
+  if (gl_atlas) gl_glyph_atlas_pages(gl_glyph_atlas_pages());
 }
 
 
@@ -494,6 +748,42 @@ void gl_texture_pile_height(int max)
   gl_fifo = new gl_texture_fifo(max);
 }
 
+/**
+ Returns the maximum number of glyph atlas pages, 0 if the glyph atlas is not used.
+ \see gl_glyph_atlas_pages(int)
+ */
+int gl_glyph_atlas_pages()
+{
+  return gl_atlas_pages;
+}
+
+/**
+ Makes gl_draw() draw text from a glyph atlas.
+
+ By default, gl_draw() renders each distinct string into its own texture
+ kept in the pile of pre-computed string textures (see gl_texture_pile_height(int)).
+ When many different strings are drawn, e.g. numbers that change at each frame,
+ the pile is constantly renewed. With a glyph atlas, each character is
+ rendered only once for a given font, size and GUI scale, into one of up to
+ \p max textures of 512x512 pixels, and strings are drawn from these.
+ When all textures are full, the least recently used one is emptied.
+
+ Strings are drawn character by character, without kerning between characters,
+ which suits labels and numbers best. The glyph atlas is used only when
+ GL text is drawn with textures (see Fl::draw_GL_text_with_textures(int)).
+ Strings that can't be drawn from the atlas, e.g. because a character is
+ larger than an atlas texture, are drawn as without the atlas.
+ \param max maximum number of atlas textures, or 0 to stop using the glyph atlas,
+   which is the default
+ \version 1.4.0
+ */
+void gl_glyph_atlas_pages(int max)
+{
+  if (gl_atlas) delete gl_atlas;
+  gl_atlas = NULL;
+  gl_atlas_pages = (max > 0 ? max : 0);
+}
+
 
 /**
  \cond DriverDev
@@ -525,6 +815,71 @@ void Fl_Gl_Window_Driver::draw_string_with_texture(const char* str, int n)
 }
 
 
+/** draws a utf8 string using the glyph atlas, returns 0 if that's not possible */
+int Fl_Gl_Window_Driver::draw_string_with_atlas(const char* str, int n)
+{
+  Fl_Gl_Window *gwin = Fl_Window::current()->as_gl_window();
+  gl_scale = (gwin ? gwin->pixels_per_unit() : 1);
+  if (!gl_atlas) gl_atlas = new gl_glyph_atlas(gl_atlas_pages);
+  gl_atlas->use_count++;
+  // find or render all glyphs of the string before drawing,
+  // the pages they are in can't be emptied while the string is processed
+  static int *refs = NULL; // page and slot of each glyph of the string
+  static int refs_size = 0;
+  if (2 * n > refs_size) {
+    refs_size = 2 * n;
+    refs = (int*)realloc(refs, refs_size * sizeof(int));
+  }
+  int count = 0;
+  const char *p = str, *end = str + n;
+  while (p < end) {
+    int l;
+    unsigned ucs = fl_utf8decode(p, end, &l);
+    p += l;
+    int page, slot = gl_atlas->find(ucs, page);
+    if (slot < 0) slot = gl_atlas->add(ucs, page);
+    if (slot < 0) return 0;
+    gl_atlas->pages[page].last_use = gl_atlas->use_count;
+    refs[2 * count] = page;
+    refs[2 * count + 1] = slot;
+    count++;
+  }
+
+  GLint matrixMode;
+  GLfloat pos[4];
+  begin_text_scene(matrixMode, pos);
+  float descent = gl_scale * fl_descent();
+  float width = 0;
+  // one batch of quads per atlas page used by the string
+  for (int pg = 0; pg < gl_atlas->npages; pg++) {
+    if (gl_atlas->pages[pg].last_use != gl_atlas->use_count) continue;
+    glBindTexture(GL_TEXTURE_RECTANGLE_ARB, gl_atlas->pages[pg].texName);
+    glBegin(GL_QUADS);
+    float pen = 0;
+    for (int i = 0; i < count; i++) {
+      const gl_glyph_atlas::glyph &g = gl_atlas->pages[refs[2 * i]].glyphs[refs[2 * i + 1]];
+      if (refs[2 * i] == pg) {
+        float ox = floorf(pos[0] + pen + 0.5f);
+        float oy = pos[1] + g.h - descent;
+        glTexCoord2f(g.x, g.y); // upper left
+        glVertex2f(ox, oy);
+        glTexCoord2f(g.x, g.y + g.h); // lower left
+        glVertex2f(ox, oy - g.h);
+        glTexCoord2f(g.x + g.w, g.y + g.h); // lower right
+        glVertex2f(ox + g.w, oy - g.h);
+        glTexCoord2f(g.x + g.w, g.y); // upper right
+        glVertex2f(ox + g.w, oy);
+      }
+      pen += g.advance;
+    }
+    glEnd();
+    width = pen;
+  }
+  end_text_scene(matrixMode, pos, width);
+  return 1;
+}
+
+
 char *Fl_Gl_Window_Driver::alpha_mask_for_string(const char *str, int n, int w, int h, Fl_Fontsize fs)
 {
   // write str to a bitmap that is just big enough
@@ -0,0 +1,358 @@
+//
+// Widget drawing benchmark for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+//
+// Times draw(), handle() and resize() of stock widgets holding 1,000 to
+// 1,000,000 items. All widgets are drawn on an Fl_Recording_Surface, so no
+// display connection is needed and the results do not depend on the
+// graphics system. The results are written to stdout as comma separated
+// values, one line per widget, number of items and operation:
+//
+//   widget,items,operation,calls,seconds_per_call,drawing_ops_per_call
+//
+// Usage: draw_benchmark [max_items]
+//
+
+#include <FL/Fl.H>
+#include <FL/Fl_Recording_Surface.H>
+#include <FL/Fl_Group.H>
+#include <FL/Fl_Browser.H>
+#include <FL/Fl_Check_Browser.H>
+#include <FL/Fl_Tree.H>
+#include <FL/Fl_Table_Row.H>
+#include <FL/Fl_Text_Display.H>
+#include <FL/Fl_Scroll.H>
+#include <FL/Fl_Choice.H>
+#include <FL/Fl_Box.H>
+#include <FL/Fl_Button.H>
+#include <FL/Fl_Check_Button.H>
+#include <FL/Fl_Input.H>
+#include <FL/Fl_Value_Slider.H>
+#include <FL/Fl_Dial.H>
+#include <FL/Fl_Progress.H>
+#include <FL/Fl_Counter.H>
+#include <FL/fl_draw.H>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <sys/time.h> // gettimeofday()
+#endif // _WIN32
+
+#define BENCH_W         400
+#define BENCH_H         300
+#define BENCH_TIME      0.2     // seconds to spend on one operation
+#define BENCH_CALLS     1000    // maximum number of calls of one operation
+
+static Fl_Recording_Surface *surface = 0;
+
+// returns the time in seconds since some point in the past
+static double now() {
+#ifdef _WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+  struct timeval t;
+  gettimeofday(&t, NULL);
+  return t.tv_sec + 0.000001 * t.tv_usec;
+#endif // _WIN32
+}
+
+static void report(const char *widget, int items, const char *op,
+                   int calls, double seconds, unsigned long ops) {
+  printf("%s,%d,%s,%d,%.9f,%lu\n", widget, items, op, calls,
+         seconds / calls, ops / calls);
+  fflush(stdout);
+}
+
+// The operations that are timed. 'step' counts the calls, so that each
+// call can do something different, e.g. scroll further down.
+typedef void (*Bench_Op)(Fl_Widget *w, int step);
+
+// draws the widget clipped to the surface, as a window clips to its size
+static void draw_op(Fl_Widget *w, int) {
+  w->damage(FL_DAMAGE_ALL);
+  fl_push_clip(0, 0, BENCH_W, BENCH_H);
+  surface->draw(w);
+  fl_pop_clip();
+}
+
+static void resize_op(Fl_Widget *w, int step) {
+  int d = (step & 1) ? 50 : 0;
+  w->resize(0, 0, BENCH_W - d, BENCH_H - d);
+}
+
+// scrolls down by one notch of the mouse wheel
+static void wheel_op(Fl_Widget *w, int step) {
+  Fl::e_x = w->x() + w->w() / 2;
+  Fl::e_y = w->y() + w->h() / 2;
+  Fl::e_dx = 0;
+  Fl::e_dy = (step % 100 < 50) ? 1 : -1;
+  w->handle(FL_MOUSEWHEEL);
+}
+
+// moves the selection down with the Down arrow key
+static void down_op(Fl_Widget *w, int) {
+  Fl::e_keysym = FL_Down;
+  Fl::e_state = 0;
+  Fl::e_text = (char *)"";
+  Fl::e_length = 0;
+  w->handle(FL_KEYBOARD);
+}
+
+// tries a shortcut that none of the items has
+static void shortcut_op(Fl_Widget *w, int) {
+  Fl::e_keysym = FL_F + 12;
+  Fl::e_state = FL_ALT;
+  Fl::e_text = (char *)"";
+  Fl::e_length = 0;
+  w->handle(FL_SHORTCUT);
+}
+
+// calls op until BENCH_TIME seconds or BENCH_CALLS calls have passed
+static void bench(const char *widget, int items, const char *name,
+                  Fl_Widget *w, Bench_Op op) {
+  surface->reset();
+  double start = now(), t = 0;
+  int calls = 0;
+  while (calls < BENCH_CALLS && t < BENCH_TIME) {
+    op(w, calls++);
+    t = now() - start;
+  }
+  report(widget, items, name, calls, t, surface->total());
+}
+
+//
+// Builders of the widgets, each one fills a widget with n items
+//
+
+static Fl_Widget *make_browser(int n) {
+  Fl_Browser *o = new Fl_Browser(0, 0, BENCH_W, BENCH_H);
+  static const int widths[] = { 100, 100, 0 };
+  o->type(FL_HOLD_BROWSER);
+  o->column_widths(widths);
+  char s[60];
+  for (int i = 0; i < n; i++) {
+    snprintf(s, sizeof(s), "Line %d\t@bColumn 2\t@iColumn 3", i);
+    o->add(s);
+  }
+  o->value(1);
+  return o;
+}
+
+static Fl_Widget *make_check_browser(int n) {
+  Fl_Check_Browser *o = new Fl_Check_Browser(0, 0, BENCH_W, BENCH_H);
+  char s[30];
+  for (int i = 0; i < n; i++) {
+    snprintf(s, sizeof(s), "Item %d", i);
+    o->add(s, i & 1);
+  }
+  return o;
+}
+
+static Fl_Widget *make_tree(int n) {
+  Fl_Tree *o = new Fl_Tree(0, 0, BENCH_W, BENCH_H);
+  o->showroot(0);
+  Fl_Tree_Item *folder = 0;
+  char s[30];
+  for (int i = 0; i < n; i++) {
+    if (i % 100 == 0) {
+      snprintf(s, sizeof(s), "Folder %d", i / 100);
+      folder = o->add(o->root(), s);
+    }
+    snprintf(s, sizeof(s), "Item %d", i);
+    o->add(folder, s);
+  }
+  return o;
+}
+
+class Bench_Table : public Fl_Table_Row {
+protected:
+  void draw_cell(TableContext context, int R, int C, int X, int Y, int W, int H) {
+    char s[30];
+    switch (context) {
+      case CONTEXT_COL_HEADER:
+      case CONTEXT_ROW_HEADER:
+        snprintf(s, sizeof(s), "%d", context == CONTEXT_COL_HEADER ? C : R);
+        fl_draw_box(FL_THIN_UP_BOX, X, Y, W, H, row_header_color());
+        fl_color(FL_BLACK);
+        fl_draw(s, X, Y, W, H, FL_ALIGN_CENTER);
+        break;
+      case CONTEXT_CELL:
+        snprintf(s, sizeof(s), "%d/%d", R, C);
+        fl_color(row_selected(R) ? selection_color() : FL_WHITE);
+        fl_rectf(X, Y, W, H);
+        fl_color(FL_BLACK);
+        fl_draw(s, X, Y, W, H, FL_ALIGN_LEFT);
+        break;
+      default:
+        break;
+    }
+  }
+public:
+  Bench_Table(int X, int Y, int W, int H) : Fl_Table_Row(X, Y, W, H) { end(); }
+};
+
+static Fl_Widget *make_table(int n) {
+  Bench_Table *o = new Bench_Table(0, 0, BENCH_W, BENCH_H);
+  o->rows(n);
+  o->cols(5);
+  o->row_header(1);
+  o->col_header(1);
+  return o;
+}
+
+static Fl_Widget *make_text_display(int n) {
+  Fl_Text_Buffer *buf = new Fl_Text_Buffer();
+  char *text = new char[n * 40 + 1], *p = text;
+  for (int i = 0; i < n; i++)
+    p += snprintf(p, 40, "This is line %d of the text\n", i);
+  buf->text(text);
+  delete[] text;
+  Fl_Text_Display *o = new Fl_Text_Display(0, 0, BENCH_W, BENCH_H);
+  o->buffer(buf);
+  return o;
+}
+
+static Fl_Widget *make_scroll_row(Fl_Scroll *, int row, Fl_Widget *reuse, void *) {
+  Fl_Box *o = reuse ? (Fl_Box *)reuse : new Fl_Box(0, 0, 10, 10);
+  o->box(FL_BORDER_BOX);
+  o->copy_label("row");
+  o->argument(row);
+  return o;
+}
+
+static Fl_Widget *make_scroll(int n) {
+  Fl_Scroll *o = new Fl_Scroll(0, 0, BENCH_W, BENCH_H);
+  o->end();
+  o->rows(n, 25, make_scroll_row);
+  return o;
+}
+
+static char *choice_labels = 0;
+#define CHOICE_LABEL_SIZE 24    // fits "Choice %d" for any int
+
+static Fl_Widget *make_choice(int n) {
+  Fl_Menu_Item *items = new Fl_Menu_Item[n + 1];
+  memset(items, 0, (n + 1) * sizeof(Fl_Menu_Item));
+  choice_labels = new char[n * CHOICE_LABEL_SIZE];
+  for (int i = 0; i < n; i++) {
+    char *label = choice_labels + i * CHOICE_LABEL_SIZE;
+    snprintf(label, CHOICE_LABEL_SIZE, "Choice %d", i);
+    items[i].label(label);
+  }
+  Fl_Choice *o = new Fl_Choice(100, 0, BENCH_W - 100, 25, "Choice:");
+  o->menu(items);
+  o->value(n / 2);
+  return o;
+}
+
+// a group of n stock widgets of all kinds, laid out in rows
+static Fl_Widget *make_group(int n) {
+  Fl_Group *o = new Fl_Group(0, 0, BENCH_W, BENCH_H);
+  for (int i = 0; i < n; i++) {
+    int X = (i % 8) * 50, Y = (i / 8) * 25;
+    switch (i % 8) {
+      case 0: new Fl_Box(FL_UP_BOX, X, Y, 50, 25, "Box"); break;
+      case 1: new Fl_Button(X, Y, 50, 25, "Button"); break;
+      case 2: new Fl_Check_Button(X, Y, 50, 25, "Check"); break;
+      case 3: new Fl_Input(X, Y, 50, 25); break;
+      case 4: {
+        Fl_Value_Slider *s = new Fl_Value_Slider(X, Y, 50, 25);
+        s->type(FL_HOR_SLIDER);
+        s->value(0.5);
+        break;
+      }
+      case 5: new Fl_Dial(X, Y, 50, 25); break;
+      case 6: new Fl_Progress(X, Y, 50, 25, "50%"); break;
+      default: new Fl_Counter(X, Y, 50, 25); break;
+    }
+  }
+  o->end();
+  return o;
+}
+
+//
+// The benchmarks: widget name, builder, and the operations of handle()
+//
+
+struct Benchmark {
+  const char *name;
+  Fl_Widget *(*make)(int n);
+  const char *handle_name;
+  Bench_Op handle_op;
+};
+
+static const Benchmark benchmarks[] = {
+  { "Fl_Browser",         make_browser,       "handle_down",     down_op },
+  { "Fl_Browser",         make_browser,       "handle_wheel",    wheel_op },
+  { "Fl_Check_Browser",   make_check_browser, "handle_wheel",    wheel_op },
+  { "Fl_Tree",            make_tree,          "handle_wheel",    wheel_op },
+  { "Fl_Table_Row",       make_table,         "handle_wheel",    wheel_op },
+  { "Fl_Text_Display",    make_text_display,  "handle_wheel",    wheel_op },
+  { "Fl_Scroll",          make_scroll,        "handle_wheel",    wheel_op },
+  { "Fl_Choice",          make_choice,        "handle_shortcut", shortcut_op },
+  { "Fl_Group",           make_group,         "handle_shortcut", shortcut_op }
+};
+
+int main(int argc, char **argv) {
+  int max_items = 1000000;
+  if (argc > 1) max_items = atoi(argv[1]);
+  if (argc > 2 || max_items < 1) {
+    fprintf(stderr, "Usage: %s [max_items]\n", argv[0]);
+    return 1;
+  }
+
+  surface = new Fl_Recording_Surface(BENCH_W, BENCH_H);
+  Fl_Surface_Device::push_current(surface); // text is measured by the surface
+  Fl_Group::current(0);                     // widgets have no window
+
+  printf("widget,items,operation,calls,seconds_per_call,drawing_ops_per_call\n");
+  int count = sizeof(benchmarks) / sizeof(benchmarks[0]);
+  for (int i = 0; i < count; i++) {
+    const Benchmark &b = benchmarks[i];
+    for (int n = 1000; n <= max_items; n *= 10) {
+      double start = now();
+      Fl_Widget *w = b.make(n);
+      report(b.name, n, "create", 1, now() - start, 0);
+      bench(b.name, n, "draw", w, draw_op);
+      bench(b.name, n, b.handle_name, w, b.handle_op);
+      bench(b.name, n, "resize", w, resize_op);
+      if (b.make == make_text_display) {
+        Fl_Text_Buffer *buf = ((Fl_Text_Display *)w)->buffer();
+        delete w;
+        delete buf;
+      } else if (b.make == make_choice) {
+        const Fl_Menu_Item *items = ((Fl_Choice *)w)->menu();
+        delete w;
+        delete[] items;
+        delete[] choice_labels;
+      } else {
+        delete w;
+      }
+      Fl::do_widget_deletion();
+    }
+  }
+
+  Fl_Surface_Device::pop_current();
+  delete surface;
+  return 0;
+}
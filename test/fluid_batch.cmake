@@ -0,0 +1,130 @@
+#
+# Test of the batch mode of fluid for the Fast Light Tool Kit (FLTK).
+#
+# Copyright 2026 by Bill Spitzak and others.
+#
+# This library is free software. Distribution and use rights are outlined in
+# the file "COPYING" which should have been included with this file.  If this
+# file is missing or damaged, see the license at:
+#
+#     https://www.fltk.org/COPYING.php
+#
+# Please see the following page on how to report bugs and issues:
+#
+#     https://www.fltk.org/bugs.php
+#
+
+# Usage: cmake -D FLUID=<fluid executable> -D WORK_DIR=<empty dir> -P fluid_batch.cmake
+#
+# Compiles a few small .fl files with 'fluid -c' and checks response files,
+# the handling of unreadable files, and the -stamp option.
+
+if (NOT FLUID OR NOT WORK_DIR)
+  message (FATAL_ERROR "Usage: cmake -D FLUID=<fluid> -D WORK_DIR=<dir> -P fluid_batch.cmake")
+endif ()
+
+file (REMOVE_RECURSE "${WORK_DIR}")
+file (MAKE_DIRECTORY "${WORK_DIR}")
+
+# writes a design with a single button labeled 'label' to 'name'.fl
+function (write_design name label)
+  file (WRITE "${WORK_DIR}/${name}.fl"
+"# data file for the Fltk User Interface Designer (fluid)
+version 1.0400
+header_name {.h}
+code_name {.cxx}
+Function {make_${name}()} {open
+} {
+  Fl_Window {} {open
+    xywh {100 100 200 100} type Double visible
+  } {
+    Fl_Button {} {
+      label {${label}}
+      xywh {10 10 80 25}
+    }
+  }
+}
+")
+endfunction ()
+
+# runs fluid with the given arguments, sets 'result' in the caller's scope
+function (run_fluid)
+  execute_process (COMMAND "${FLUID}" ${ARGN}
+    WORKING_DIRECTORY "${WORK_DIR}"
+    RESULT_VARIABLE res
+    OUTPUT_QUIET ERROR_QUIET)
+  set (result ${res} PARENT_SCOPE)
+endfunction ()
+
+function (remove_output)
+  file (GLOB files "${WORK_DIR}/*.cxx" "${WORK_DIR}/*.h")
+  if (files)
+    file (REMOVE ${files})
+  endif ()
+endfunction ()
+
+function (expect_files)
+  foreach (f ${ARGN})
+    if (NOT EXISTS "${WORK_DIR}/${f}")
+      message (FATAL_ERROR "${CHECK}: ${f} was not written")
+    endif ()
+  endforeach ()
+endfunction ()
+
+function (expect_result expected)
+  if (expected EQUAL 0 AND NOT result EQUAL 0)
+    message (FATAL_ERROR "${CHECK}: fluid failed with ${result}")
+  elseif (NOT expected EQUAL 0 AND result EQUAL 0)
+    message (FATAL_ERROR "${CHECK}: fluid did not report an error")
+  endif ()
+endfunction ()
+
+write_design (a "Button A")
+write_design (b "Button B")
+write_design (c "Button C")
+file (WRITE "${WORK_DIR}/list.txt" "# files of the test\n\n  a.fl  \nb.fl\n")
+
+set (CHECK "response file")
+run_fluid (-c @list.txt c.fl)
+expect_result (0)
+expect_files (a.cxx a.h b.cxx b.h c.cxx c.h)
+
+foreach (jobs 1 2)
+  set (CHECK "unreadable file with -j ${jobs}")
+  remove_output ()
+  run_fluid (-c -j ${jobs} a.fl missing.fl b.fl c.fl)
+  expect_result (1)
+  expect_files (a.cxx b.cxx c.cxx)
+endforeach ()
+
+set (CHECK "unreadable response file")
+remove_output ()
+run_fluid (-c @missing.txt a.fl)
+expect_result (1)
+expect_files (a.cxx a.h)
+
+set (CHECK "-stamp")
+remove_output ()
+run_fluid (-c -stamp a.fl b.fl)
+expect_result (0)
+expect_files (a.cxx b.cxx)
+file (APPEND "${WORK_DIR}/a.cxx" "// not written again\n")
+file (APPEND "${WORK_DIR}/b.cxx" "// not written again\n")
+write_design (b "Changed B")
+run_fluid (-c -stamp a.fl b.fl)
+expect_result (0)
+file (READ "${WORK_DIR}/a.cxx" a_code)
+file (READ "${WORK_DIR}/b.cxx" b_code)
+if (NOT a_code MATCHES "not written again")
+  message (FATAL_ERROR "${CHECK}: unchanged a.fl was compiled again")
+endif ()
+if (b_code MATCHES "not written again" OR NOT b_code MATCHES "Changed B")
+  message (FATAL_ERROR "${CHECK}: changed b.fl was not compiled again")
+endif ()
+run_fluid (-cs -stamp a.fl)
+expect_result (0)
+expect_files (a.txt)
+file (READ "${WORK_DIR}/a.cxx" a_code)
+if (a_code MATCHES "not written again")
+  message (FATAL_ERROR "${CHECK}: a.fl was not compiled again with other options")
+endif ()
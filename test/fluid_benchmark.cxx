@@ -0,0 +1,153 @@
+//
+// FLUID code generation benchmark for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+//
+// Times 'fluid -c' on synthetic .fl files with up to 20,000 widgets and
+// menu items. Most widgets share their labels and have callbacks, so FLUID
+// must generate many unique callback names from the same base name. The
+// results are written to stdout as comma separated values:
+//
+//   widgets,seconds,code_bytes
+//
+// The .fl file and the generated code are written to the current directory
+// as fluid_benchmark.fl, .cxx and .h, and removed at the end.
+//
+// Usage: fluid_benchmark <path to fluid> [max_widgets]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <sys/time.h> // gettimeofday()
+#endif // _WIN32
+
+#define BENCH_NAME      "fluid_benchmark"
+
+// returns the time in seconds since some point in the past
+static double now() {
+#ifdef _WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+  struct timeval t;
+  gettimeofday(&t, NULL);
+  return t.tv_sec + 0.000001 * t.tv_usec;
+#endif // _WIN32
+}
+
+// Writes a design with n widgets and menu items. Every group holds 50
+// buttons and inputs and a menu bar with 50 items, all with callbacks.
+static int write_design(const char *name, int n) {
+  FILE *f = fopen(name, "w");
+  if (!f) return 0;
+  fprintf(f, "# data file for the Fltk User Interface Designer (fluid)\n"
+             "version 1.0400\n"
+             "header_name {.h}\n"
+             "code_name {.cxx}\n"
+             "Function {make_window()} {open\n"
+             "} {\n"
+             "  Fl_Window {} {open\n"
+             "    xywh {100 100 800 600} type Double visible\n"
+             "  } {\n");
+  int i = 0;
+  while (i < n) {
+    fprintf(f, "    Fl_Group {} {open\n"
+               "      xywh {0 0 800 600}\n"
+               "    } {\n");
+    int k;
+    for (k = 0; k < 50 && i < n; k++, i++) {
+      if (k & 1)
+        fprintf(f, "      Fl_Button {} {\n"
+                   "        label OK\n"
+                   "        callback {puts(\"OK\");}\n"
+                   "        xywh {%d %d 80 25}\n"
+                   "      }\n", (k % 10) * 80, (k / 10) * 25);
+      else
+        fprintf(f, "      Fl_Input {} {\n"
+                   "        label {Name:}\n"
+                   "        callback {puts(o->value());}\n"
+                   "        xywh {%d %d 80 25}\n"
+                   "      }\n", (k % 10) * 80, (k / 10) * 25);
+    }
+    if (i < n) {
+      fprintf(f, "      Fl_Menu_Bar {} {open\n"
+                 "        xywh {0 500 800 25}\n"
+                 "      } {\n");
+      for (k = 0; k < 50 && i < n; k++, i++)
+        fprintf(f, "        MenuItem {} {\n"
+                   "          label Open\n"
+                   "          callback {puts(\"Open\");}\n"
+                   "          xywh {0 0 100 20}\n"
+                   "        }\n");
+      fprintf(f, "      }\n");
+    }
+    fprintf(f, "    }\n");
+  }
+  fprintf(f, "  }\n}\n");
+  return fclose(f) == 0;
+}
+
+static long file_size(const char *name) {
+  FILE *f = fopen(name, "rb");
+  if (!f) return -1;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fclose(f);
+  return size;
+}
+
+int main(int argc, char **argv) {
+  int max_widgets = 20000;
+  if (argc > 2) max_widgets = atoi(argv[2]);
+  if (argc < 2 || argc > 3 || max_widgets < 1) {
+    fprintf(stderr, "Usage: %s <path to fluid> [max_widgets]\n", argv[0]);
+    return 1;
+  }
+  char command[2048];
+  snprintf(command, sizeof(command), "\"%s\" -c " BENCH_NAME ".fl", argv[1]);
+
+  printf("widgets,seconds,code_bytes\n");
+  int ret = 0;
+  for (int n = max_widgets % 1250 ? max_widgets : 1250; n <= max_widgets; n *= 2) {
+    if (!write_design(BENCH_NAME ".fl", n)) {
+      perror(BENCH_NAME ".fl");
+      ret = 1;
+      break;
+    }
+    remove(BENCH_NAME ".cxx");
+    double start = now();
+    int status = system(command);
+    double t = now() - start;
+    long size = file_size(BENCH_NAME ".cxx");
+    if (status != 0 || size < 0) {
+      fprintf(stderr, "%s failed\n", command);
+      ret = 1;
+      break;
+    }
+    printf("%d,%.3f,%ld\n", n, t, size);
+    fflush(stdout);
+  }
+
+  remove(BENCH_NAME ".fl");
+  remove(BENCH_NAME ".cxx");
+  remove(BENCH_NAME ".h");
+  return ret;
+}
@@ -0,0 +1,130 @@
+//
+// OpenGL widget drawing benchmark for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+//
+// Redraws an Fl_Gl_Window holding 100 to 1,600 stock widgets and counts the
+// OpenGL draw calls that the FLTK drawing functions make for them. The
+// rectangles, lines and points of the widgets are collected and drawn with
+// a few glDrawArrays() calls, so draw_calls_per_frame should be much lower
+// than primitives_per_frame, which is the number of OpenGL calls needed
+// without batching. The results are written to stdout as comma separated
+// values, one line per number of widgets:
+//
+//   widgets,frames,seconds_per_frame,draw_calls_per_frame,primitives_per_frame
+//
+// Usage: gl_draw_benchmark [frames]
+//
+
+#include <FL/Fl.H>
+#include <FL/Fl_Gl_Window.H>
+#include <FL/Fl_Button.H>
+#include <FL/Fl_Check_Button.H>
+#include <FL/Fl_Slider.H>
+#include <FL/Fl_Input.H>
+#include <FL/gl.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <sys/time.h> // gettimeofday()
+#endif // _WIN32
+
+#define BENCH_W         800
+#define BENCH_H         600
+
+// returns the time in seconds since some point in the past
+static double now() {
+#ifdef _WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+  struct timeval t;
+  gettimeofday(&t, NULL);
+  return t.tv_sec + 0.000001 * t.tv_usec;
+#endif // _WIN32
+}
+
+// Draws the widgets and waits until OpenGL has finished drawing them
+class BenchWindow : public Fl_Gl_Window {
+protected:
+  void draw() {
+    Fl_Gl_Window::draw();
+    glFinish();
+  }
+public:
+  BenchWindow(int w, int h, const char *l) : Fl_Gl_Window(w, h, l) {}
+};
+
+// Fills the window with a grid of n widgets of 4 kinds
+static void add_widgets(Fl_Gl_Window *win, int n) {
+  int cols = 1;
+  while (cols * cols < n) cols++;
+  int rows = (n + cols - 1) / cols;
+  int cw = BENCH_W / cols, ch = BENCH_H / rows;
+  win->begin();
+  for (int i = 0; i < n; i++) {
+    int x = (i % cols) * cw, y = (i / cols) * ch;
+    switch (i % 4) {
+      case 0: new Fl_Button(x + 1, y + 1, cw - 2, ch - 2, "OK"); break;
+      case 1: new Fl_Check_Button(x + 1, y + 1, cw - 2, ch - 2, "On"); break;
+      case 2: {
+        Fl_Slider *s = new Fl_Slider(x + 1, y + 1, cw - 2, ch - 2);
+        s->type(FL_HOR_NICE_SLIDER);
+        s->value(0.5);
+        break;
+      }
+      default: new Fl_Input(x + 1, y + 1, cw - 2, ch - 2); break;
+    }
+  }
+  win->end();
+}
+
+int main(int argc, char **argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 100;
+  if (argc > 2 || frames < 1) {
+    fprintf(stderr, "Usage: %s [frames]\n", argv[0]);
+    return 1;
+  }
+  printf("widgets,frames,seconds_per_frame,draw_calls_per_frame,primitives_per_frame\n");
+  for (int n = 100; n <= 1600; n *= 4) {
+    BenchWindow *win = new BenchWindow(BENCH_W, BENCH_H, "gl_draw_benchmark");
+    win->mode(FL_RGB | FL_DOUBLE);
+    add_widgets(win, n);
+    win->show();
+    win->wait_for_expose();
+    Fl::flush();
+
+    unsigned long calls0, prims0, calls, prims;
+    Fl_Gl_Window::batch_statistics(&calls0, &prims0);
+    double start = now();
+    for (int i = 0; i < frames; i++) {
+      win->redraw();
+      Fl::flush();
+    }
+    double t = now() - start;
+    Fl_Gl_Window::batch_statistics(&calls, &prims);
+    printf("%d,%d,%.6f,%.1f,%.1f\n", n, frames, t / frames,
+           double(calls - calls0) / frames, double(prims - prims0) / frames);
+    fflush(stdout);
+    delete win;
+    Fl::check();
+  }
+  return 0;
+}
@@ -0,0 +1,122 @@
+//
+// OpenGL text drawing benchmark for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+//
+// Draws 100 to 1,600 labels with gl_draw() in an Fl_Gl_Window. The labels
+// change in every frame, like the values of a live dashboard, so the pile
+// of string textures seldom holds them. Each number of labels is drawn with
+// the glyph atlas off and with gl_glyph_atlas_pages(4), which renders each
+// glyph once and draws all strings from the atlas pages. The results are
+// written to stdout as comma separated values, one line per number of
+// labels and number of atlas pages:
+//
+//   labels,atlas_pages,frames,seconds_per_frame
+//
+// Usage: gl_text_benchmark [frames]
+//
+
+#include <FL/Fl.H>
+#include <FL/Fl_Gl_Window.H>
+#include <FL/gl.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <sys/time.h> // gettimeofday()
+#endif // _WIN32
+
+#define BENCH_W         800
+#define BENCH_H         600
+
+// returns the time in seconds since some point in the past
+static double now() {
+#ifdef _WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+  struct timeval t;
+  gettimeofday(&t, NULL);
+  return t.tv_sec + 0.000001 * t.tv_usec;
+#endif // _WIN32
+}
+
+// Draws a grid of labels whose values change in every frame
+class TextWindow : public Fl_Gl_Window {
+  int labels, frame;
+protected:
+  void draw() {
+    if (!valid()) {
+      glLoadIdentity();
+      glViewport(0, 0, pixel_w(), pixel_h());
+      glOrtho(0, w(), 0, h(), -1, 1);
+    }
+    glClearColor(0, 0, 0, 1);
+    glClear(GL_COLOR_BUFFER_BIT);
+    int cols = 1;
+    while (cols * cols < labels) cols++;
+    int cw = w() / cols, ch = h() / cols;
+    gl_font(FL_HELVETICA, ch > 16 ? 12 : ch * 3 / 4);
+    char s[40];
+    for (int i = 0; i < labels; i++) {
+      snprintf(s, sizeof(s), "%c%d.%02d", 'A' + i % 26, (i * 37 + frame) % 1000, frame % 100);
+      gl_color(i % 3 ? FL_WHITE : FL_YELLOW);
+      gl_draw(s, float((i % cols) * cw + 2), float(h() - (i / cols + 1) * ch + 2));
+    }
+    glFinish();
+  }
+public:
+  TextWindow(int w, int h, const char *l) : Fl_Gl_Window(w, h, l), labels(0), frame(0) {}
+  void set_labels(int n) { labels = n; }
+  void next_frame() { frame++; }
+};
+
+int main(int argc, char **argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 100;
+  if (argc > 2 || frames < 1) {
+    fprintf(stderr, "Usage: %s [frames]\n", argv[0]);
+    return 1;
+  }
+  TextWindow *win = new TextWindow(BENCH_W, BENCH_H, "gl_text_benchmark");
+  win->mode(FL_RGB | FL_DOUBLE);
+  win->end();
+  win->show();
+  win->wait_for_expose();
+  printf("labels,atlas_pages,frames,seconds_per_frame\n");
+  for (int n = 100; n <= 1600; n *= 4) {
+    for (int pages = 0; pages <= 4; pages += 4) {
+      win->make_current(); // the textures of the old atlas are deleted
+      gl_glyph_atlas_pages(pages);
+      win->set_labels(n);
+      win->redraw();
+      Fl::flush(); // renders the glyphs into the atlas, if any
+      double start = now();
+      for (int i = 0; i < frames; i++) {
+        win->next_frame();
+        win->redraw();
+        Fl::flush();
+      }
+      double t = now() - start;
+      printf("%d,%d,%d,%.6f\n", n, pages, frames, t / frames);
+      fflush(stdout);
+    }
+  }
+  delete win;
+  return 0;
+}
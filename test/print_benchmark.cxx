@@ -0,0 +1,196 @@
+//
+// PostScript printing benchmark for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+//
+// Prints a report of 10 to 1,000 pages with Fl_PostScript_File_Device. Each
+// page shows the same screenshot, a chart that differs on every page, and
+// the next rows of an Fl_Table. The screenshot should be written once and
+// shared by all pages, so bytes_per_page should not grow with the number of
+// pages. The results are written to stdout as comma separated values, one
+// line per number of pages:
+//
+//   pages,seconds,seconds_per_page,bytes,bytes_per_page
+//
+// The PostScript file is written to the current directory as
+// print_benchmark.ps, and removed at the end unless -k is given.
+//
+// Usage: print_benchmark [-k] [max_pages]
+//
+
+#include <FL/Fl.H>
+#include <FL/platform.H>
+#include <FL/Fl_PostScript.H>
+#include <FL/Fl_Table.H>
+#include <FL/Fl_RGB_Image.H>
+#include <FL/fl_draw.H>
+#include <FL/fl_utf8.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <sys/time.h> // gettimeofday()
+#endif // _WIN32
+
+#define BENCH_FILE      "print_benchmark.ps"
+#define SHOT_W          320     // size of the screenshot
+#define SHOT_H          200
+#define CHART_W         160     // size of the chart of each page
+#define CHART_H         100
+#define ROW_H           16      // height of the rows of the table
+
+// returns the time in seconds since some point in the past
+static double now() {
+#ifdef _WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+  struct timeval t;
+  gettimeofday(&t, NULL);
+  return t.tv_sec + 0.000001 * t.tv_usec;
+#endif // _WIN32
+}
+
+// A table of invoice lines
+class Report_Table : public Fl_Table {
+protected:
+  void draw_cell(TableContext context, int R, int C, int X, int Y, int W, int H) {
+    static const char *titles[] = { "Item", "Article", "Quantity", "Price", "Total" };
+    char s[40];
+    switch (context) {
+      case CONTEXT_COL_HEADER:
+        fl_draw_box(FL_THIN_UP_BOX, X, Y, W, H, FL_LIGHT2);
+        fl_color(FL_BLACK);
+        fl_draw(titles[C], X, Y, W, H, FL_ALIGN_CENTER);
+        break;
+      case CONTEXT_CELL:
+        switch (C) {
+          case 0: snprintf(s, sizeof(s), "%d", R + 1); break;
+          case 1: snprintf(s, sizeof(s), "Article %d", R * 7919 % 1000); break;
+          case 2: snprintf(s, sizeof(s), "%d", R % 17 + 1); break;
+          case 3: snprintf(s, sizeof(s), "%d.%02d", R % 89 + 1, R % 100); break;
+          default: snprintf(s, sizeof(s), "%d.%02d", (R % 17 + 1) * (R % 89 + 1), R % 100); break;
+        }
+        fl_color(R & 1 ? FL_WHITE : FL_LIGHT3);
+        fl_rectf(X, Y, W, H);
+        fl_color(FL_BLACK);
+        fl_draw(s, X + 2, Y, W - 4, H, C < 2 ? FL_ALIGN_LEFT : FL_ALIGN_RIGHT);
+        fl_color(FL_GRAY);
+        fl_rect(X, Y, W, H);
+        break;
+      default:
+        break;
+    }
+  }
+public:
+  Report_Table(int X, int Y, int W, int H) : Fl_Table(X, Y, W, H) {
+    box(FL_NO_BOX);
+    cols(5);
+    col_header(1);
+    col_header_height(ROW_H);
+    row_height_all(ROW_H);
+    col_width_all(W / 5);
+    end();
+  }
+};
+
+// Prints a report of the given number of pages to f
+static void print_report(FILE *f, int pages, Fl_RGB_Image *shot, uchar *chart) {
+  Fl_PostScript_File_Device ps;
+  if (ps.begin_job(f, pages)) {
+    fprintf(stderr, "Cannot start the print job\n");
+    exit(1);
+  }
+  int pw, ph;
+  ps.printable_rect(&pw, &ph);
+  int table_y = SHOT_H + 10;
+  int rows_per_page = (ph - table_y) / ROW_H - 2;
+  Report_Table *table = new Report_Table(0, table_y, pw, ph - table_y);
+  table->rows(pages * rows_per_page);
+  for (int page = 0; page < pages; page++) {
+    ps.begin_page();
+    shot->draw(0, 0);
+    // the chart is different on every page
+    for (int i = 0; i < CHART_W * CHART_H; i++)
+      chart[i] = uchar((i % CHART_W) * 255 / CHART_W + page * 37);
+    fl_draw_image_mono(chart, SHOT_W + 10, 0, CHART_W, CHART_H);
+    table->row_position(page * rows_per_page);
+    table->damage(FL_DAMAGE_ALL);
+    ps.draw(table, 0, table_y);
+    ps.end_page();
+  }
+  ps.end_job();
+  delete table;
+}
+
+int main(int argc, char **argv) {
+  int keep = 0;
+  if (argc > 1 && !strcmp(argv[1], "-k")) {
+    keep = 1;
+    argc--;
+    argv++;
+  }
+  int max_pages = argc > 1 ? atoi(argv[1]) : 1000;
+  if (argc > 2 || max_pages < 10) {
+    fprintf(stderr, "Usage: print_benchmark [-k] [max_pages]\n");
+    return 1;
+  }
+  fl_open_display(); // the fonts of the display are used to measure text
+
+  // a screenshot with areas of flat color, some gradients and text-like noise
+  uchar *shot_data = new uchar[SHOT_W * SHOT_H * 3];
+  srand(1);
+  for (int y = 0; y < SHOT_H; y++) {
+    for (int x = 0; x < SHOT_W; x++) {
+      uchar *p = shot_data + (y * SHOT_W + x) * 3;
+      if (y < 20) {
+        p[0] = uchar(40 + x * 100 / SHOT_W); p[1] = 80; p[2] = 160;
+      } else if (y % 20 > 6 && y % 20 < 14 && x % 80 < 60) {
+        p[0] = p[1] = p[2] = uchar(rand() % 2 ? 0 : 240);
+      } else {
+        p[0] = p[1] = p[2] = 230;
+      }
+    }
+  }
+  Fl_RGB_Image *shot = new Fl_RGB_Image(shot_data, SHOT_W, SHOT_H, 3);
+  uchar *chart = new uchar[CHART_W * CHART_H];
+
+  printf("pages,seconds,seconds_per_page,bytes,bytes_per_page\n");
+  for (int pages = 10; pages <= max_pages; pages *= 10) {
+    FILE *f = fl_fopen(BENCH_FILE, "wb");
+    if (!f) {
+      fprintf(stderr, "Cannot write %s\n", BENCH_FILE);
+      return 1;
+    }
+    double start = now();
+    print_report(f, pages, shot, chart);
+    double t = now() - start;
+    long bytes = ftell(f);
+    fclose(f);
+    printf("%d,%.3f,%.6f,%ld,%ld\n", pages, t, t / pages, bytes, bytes / pages);
+    fflush(stdout);
+  }
+  if (!keep) fl_unlink(BENCH_FILE);
+
+  delete shot;
+  delete[] shot_data;
+  delete[] chart;
+  return 0;
+}
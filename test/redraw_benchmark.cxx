@@ -0,0 +1,238 @@
+//
+// Redraw scheduling benchmark for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+//
+// Measures and checks two ways to redraw less:
+//
+// - Frame pacing: a timer updates a progress bar every millisecond, with
+//   and without Fl::max_fps() and Fl_Window::max_fps(). The results are
+//   written to stdout as comma separated values:
+//
+//     max_fps,window_max_fps,seconds,updates,draws,flushed,coalesced
+//
+// - Layer caching: a panel of 100 decorated boxes is redrawn with its
+//   window 200 times, with and without Fl_Group::cache_layer(). The
+//   results are written as:
+//
+//     cache_layer,redraws,child_draws,seconds,layer_bytes
+//
+// The results are also checked, e.g. that no more frames are drawn than
+// the frame rate allows, and that the boxes of a cached panel are drawn
+// only once. Failed checks are written to stderr, and the exit code is 1.
+//
+// Usage: redraw_benchmark
+//
+
+#include <FL/Fl.H>
+#include <FL/Fl_Double_Window.H>
+#include <FL/Fl_Group.H>
+#include <FL/Fl_Box.H>
+#include <FL/Fl_Progress.H>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <sys/time.h> // gettimeofday()
+#endif // _WIN32
+
+#define BENCH_TIME      1.0     // seconds to run the progress bar timer
+#define BENCH_REDRAWS   200     // window redraws with and without a layer
+#define PANEL_BOXES     100
+
+static int failures = 0;
+
+// returns the time in seconds since some point in the past
+static double now() {
+#ifdef _WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+  struct timeval t;
+  gettimeofday(&t, NULL);
+  return t.tv_sec + 0.000001 * t.tv_usec;
+#endif // _WIN32
+}
+
+static void expect(int ok, const char *what) {
+  if (ok) return;
+  fprintf(stderr, "FAILED: %s\n", what);
+  failures++;
+}
+
+// A progress bar that counts how often it is drawn
+class Counting_Progress : public Fl_Progress {
+public:
+  static unsigned long draws;
+  Counting_Progress(int X, int Y, int W, int H) : Fl_Progress(X, Y, W, H) {}
+  void draw() {
+    draws++;
+    Fl_Progress::draw();
+  }
+};
+unsigned long Counting_Progress::draws = 0;
+
+// A box that counts how often it is drawn
+class Counting_Box : public Fl_Box {
+public:
+  static unsigned long draws;
+  Counting_Box(int X, int Y, int W, int H, const char *L) : Fl_Box(X, Y, W, H, L) {}
+  void draw() {
+    draws++;
+    Fl_Box::draw();
+  }
+};
+unsigned long Counting_Box::draws = 0;
+
+static Fl_Double_Window *win;
+static Counting_Progress *progress;
+static Fl_Group *panel;
+static unsigned long updates;
+
+// updates the progress bar much more often than it can be shown
+static void update_cb(void *) {
+  updates++;
+  progress->value(float(updates % 1000) / 10);
+  Fl::repeat_timeout(0.001, update_cb);
+}
+
+// Runs the progress bar timer for BENCH_TIME seconds with the given frame
+// rate limits, a window limit below 0 uses the application-wide limit
+static void bench_pacing(double max_fps, double window_max_fps) {
+  Fl::max_fps(max_fps);
+  win->max_fps(window_max_fps);
+  Fl::flush_now();
+  Counting_Progress::draws = 0;
+  updates = 0;
+  Fl::reset_frame_statistics();
+  Fl::add_timeout(0.001, update_cb);
+  double start = now(), t;
+  while ((t = now() - start) < BENCH_TIME) Fl::wait(BENCH_TIME - t);
+  Fl::remove_timeout(update_cb);
+  unsigned long flushed, coalesced;
+  Fl::frame_statistics(flushed, coalesced);
+  printf("%g,%g,%.3f,%lu,%lu,%lu,%lu\n", max_fps, window_max_fps, t, updates,
+         Counting_Progress::draws, flushed, coalesced);
+  fflush(stdout);
+
+  double fps = window_max_fps < 0 ? max_fps : window_max_fps;
+  if (fps > 0) {
+    expect(Counting_Progress::draws <= t * fps * 1.1 + 2, "no more frames than max_fps allows");
+    expect(coalesced > 0, "frames are coalesced with max_fps");
+  } else {
+    expect(coalesced == 0, "no frames are coalesced without max_fps");
+  }
+}
+
+// Fl::flush_now() draws a frame that Fl::flush() postpones
+static void check_flush_now() {
+  Fl::max_fps(1);
+  win->max_fps(-1);
+  progress->redraw();
+  Fl::flush(); // draws the frame, or postpones it after a recent frame
+  unsigned long draws = Counting_Progress::draws;
+  progress->redraw();
+  Fl::flush(); // a frame was drawn less than one second ago
+  expect(Counting_Progress::draws == draws, "Fl::flush() postpones a frame with max_fps");
+  Fl::flush_now();
+  expect(Counting_Progress::draws == draws + 1, "Fl::flush_now() draws the frame immediately");
+  Fl::max_fps(0);
+}
+
+// Redraws the window BENCH_REDRAWS times with or without the layer of the panel
+static void bench_layer(int cache) {
+  panel->cache_layer(cache);
+  Counting_Box::draws = 0;
+  double start = now();
+  for (int i = 0; i < BENCH_REDRAWS; i++) {
+    win->redraw();
+    Fl::flush_now();
+  }
+  double t = now() - start;
+  int count;
+  size_t bytes = Fl_Group::layer_memory(&count);
+  printf("%d,%d,%lu,%.6f,%lu\n", cache, BENCH_REDRAWS, Counting_Box::draws, t,
+         (unsigned long)bytes);
+  fflush(stdout);
+
+  if (!cache) {
+    expect(Counting_Box::draws == (unsigned long)PANEL_BOXES * BENCH_REDRAWS,
+           "the boxes of a panel without a layer are drawn with every redraw");
+    expect(count == 0 && bytes == 0, "no layer memory is used without a layer");
+    return;
+  }
+  expect(Counting_Box::draws == PANEL_BOXES, "the boxes of a cached panel are drawn once");
+  expect(count == 1 && bytes >= size_t(panel->w()) * panel->h() * 4,
+         "layer_memory() counts the layer of the panel");
+
+  // a damaged box is drawn again into the layer, alone
+  Counting_Box::draws = 0;
+  panel->child(0)->redraw();
+  Fl::flush_now();
+  expect(Counting_Box::draws == 1, "only the damaged box of a cached panel is drawn");
+
+  // a resized panel is drawn again completely
+  Counting_Box::draws = 0;
+  panel->size(panel->w() - 10, panel->h());
+  win->redraw();
+  Fl::flush_now();
+  expect(Counting_Box::draws == PANEL_BOXES, "a resized cached panel is drawn again");
+  panel->size(panel->w() + 10, panel->h());
+
+  panel->cache_layer(0);
+  expect(Fl_Group::layer_memory(&count) == 0 && count == 0,
+         "cache_layer(0) releases the layer memory");
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1) {
+    fprintf(stderr, "Usage: %s\n", argv[0]);
+    return 1;
+  }
+  win = new Fl_Double_Window(640, 480, "redraw_benchmark");
+  progress = new Counting_Progress(20, 20, 600, 30);
+  panel = new Fl_Group(20, 70, 600, 390);
+  panel->box(FL_PLASTIC_DOWN_BOX);
+  for (int i = 0; i < PANEL_BOXES; i++) {
+    Counting_Box *b = new Counting_Box(25 + (i % 10) * 59, 75 + (i / 10) * 38, 55, 34,
+                                       "Static\nlabel");
+    b->box(i & 1 ? FL_PLASTIC_UP_BOX : FL_GTK_UP_BOX);
+    b->labelsize(10);
+  }
+  panel->end();
+  win->end();
+  win->show();
+  win->wait_for_expose();
+  Fl::flush();
+
+  printf("max_fps,window_max_fps,seconds,updates,draws,flushed,coalesced\n");
+  bench_pacing(0, -1);
+  bench_pacing(60, -1);
+  bench_pacing(30, -1);
+  bench_pacing(60, 0);  // the window is not paced
+  bench_pacing(0, 20);  // only the window is paced
+  check_flush_now();
+
+  printf("cache_layer,redraws,child_draws,seconds,layer_bytes\n");
+  bench_layer(0);
+  bench_layer(1);
+
+  delete win;
+  return failures ? 1 : 0;
+}
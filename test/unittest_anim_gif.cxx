@@ -0,0 +1,178 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_Anim_GIF_Image.H>
+#include <FL/Fl_GIF_Image.H>
+#include <FL/Fl_Device.H>
+#include <FL/Fl_Graphics_Driver.H>
+#include <FL/Fl_Box.H>
+#include <string.h>     // memcmp()
+
+//
+//------- test the frames of Fl_Anim_GIF_Image ----------
+//
+
+// A 16x16 GIF with 4 frames, looped 3 times:
+//  0: the whole image, color (x ^ y) & 3, delay 0.1 s, not disposed
+//  1: 4x4 pixels at 2,2 of color 2, delay 0.2 s, restored to background
+//  2: 4x4 pixels at 8,8 of color 3 with a transparent corner at 11,11,
+//     delay 0.3 s, restored to previous
+//  3: 1 pixel at 0,15 of color 1, no delay (0.1 s)
+static const unsigned char anim_gif_data[] = {
+  0x47, 0x49, 0x46, 0x38, 0x39, 0x61, 0x10, 0x00, 0x10, 0x00, 0x81, 0x00, 0x00, 0x0a, 0x14, 0x1e,
+  0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff, 0x21, 0xff, 0x0b, 0x4e, 0x45, 0x54, 0x53,
+  0x43, 0x41, 0x50, 0x45, 0x32, 0x2e, 0x30, 0x03, 0x01, 0x02, 0x00, 0x00, 0x21, 0xf9, 0x04, 0x04,
+  0x0a, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x10, 0x00, 0x00, 0x02, 0x2f,
+  0x44, 0x34, 0x86, 0x9a, 0x37, 0x01, 0x86, 0x80, 0x92, 0xce, 0x28, 0x96, 0x63, 0x3c, 0x54, 0x6c,
+  0x85, 0x40, 0xa7, 0x95, 0x0f, 0x88, 0x7e, 0x92, 0x49, 0x36, 0xea, 0xf5, 0x42, 0x6d, 0x2b, 0xc6,
+  0x18, 0xbb, 0xe5, 0xb6, 0x3d, 0xe7, 0x48, 0x0d, 0x0b, 0xe2, 0x70, 0xbb, 0x20, 0xa4, 0x00, 0x00,
+  0x21, 0xf9, 0x04, 0x08, 0x14, 0x00, 0x00, 0x00, 0x2c, 0x02, 0x00, 0x02, 0x00, 0x04, 0x00, 0x04,
+  0x00, 0x00, 0x02, 0x04, 0x94, 0x8f, 0x29, 0x05, 0x00, 0x21, 0xf9, 0x04, 0x0d, 0x1e, 0x00, 0x00,
+  0x00, 0x2c, 0x08, 0x00, 0x08, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00, 0x02, 0x04, 0x9c, 0x8f, 0x09,
+  0x05, 0x00, 0x21, 0xf9, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x0f, 0x00, 0x01,
+  0x00, 0x01, 0x00, 0x00, 0x02, 0x02, 0x4c, 0x01, 0x00, 0x3b
+};
+
+static const uchar anim_colors[4][3] = {
+  { 10, 20, 30 }, { 255, 0, 0 }, { 0, 255, 0 }, { 0, 0, 255 }
+};
+
+// A graphics driver that keeps the last RGB image drawn with it
+class FrameGrabber : public Fl_Graphics_Driver {
+public:
+  Fl_RGB_Image *image;
+  FrameGrabber() : image(0) { }
+protected:
+  void draw_rgb(Fl_RGB_Image *rgb, int, int, int, int, int, int) { image = rgb; }
+};
+
+class FrameGrabSurface : public Fl_Surface_Device {
+public:
+  FrameGrabSurface() : Fl_Surface_Device(new FrameGrabber) { }
+  ~FrameGrabSurface() { delete driver(); }
+  Fl_RGB_Image *image() { return ((FrameGrabber *)driver())->image; }
+};
+
+class AnimGIFTest : public UnitCheck {
+  uchar expected[4][16][16][4];
+
+  static void set(uchar *p, int color) {
+    p[0] = anim_colors[color][0];
+    p[1] = anim_colors[color][1];
+    p[2] = anim_colors[color][2];
+    p[3] = 255;
+  }
+
+  // composites the frames of anim_gif_data like a web browser
+  void composite() {
+    int x, y;
+    for (y = 0; y < 16; y++)
+      for (x = 0; x < 16; x++)
+        set(expected[0][y][x], (x ^ y) & 3);
+    memcpy(expected[1], expected[0], sizeof(expected[0]));
+    for (y = 2; y < 6; y++)
+      for (x = 2; x < 6; x++)
+        set(expected[1][y][x], 2);
+    memcpy(expected[2], expected[1], sizeof(expected[0]));
+    for (y = 2; y < 6; y++)
+      for (x = 2; x < 6; x++)
+        memset(expected[2][y][x], 0, 4);
+    for (y = 8; y < 12; y++)
+      for (x = 8; x < 12; x++)
+        if (x != 11 || y != 11) set(expected[2][y][x], 3);
+    memcpy(expected[3], expected[2], sizeof(expected[0]));
+    for (y = 8; y < 12; y++)
+      for (x = 8; x < 12; x++)
+        memcpy(expected[3][y][x], expected[1][y][x], 4);
+    set(expected[3][15][0], 1);
+  }
+
+  // draws the current frame and compares it with frame n
+  int shows(Fl_Anim_GIF_Image *img, int n) {
+    FrameGrabSurface grab;
+    Fl_Surface_Device::push_current(&grab);
+    img->draw(0, 0);
+    Fl_Surface_Device::pop_current();
+    Fl_RGB_Image *rgb = grab.image();
+    return rgb && rgb->data_w() == 16 && rgb->data_h() == 16 && rgb->d() == 4 &&
+           !rgb->ld() && !memcmp(rgb->array, expected[n], sizeof(expected[n]));
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new AnimGIFTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  AnimGIFTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    composite();
+    int i, ok;
+
+    Fl_GIF_Image *gif = new Fl_GIF_Image("anim", anim_gif_data, sizeof(anim_gif_data));
+    Fl_RGB_Image *rgb = gif->fail() ? 0 : new Fl_RGB_Image(gif, FL_BLACK);
+    ok = rgb && rgb->w() == 16 && rgb->h() == 16;
+    for (i = 0; ok && i < 16 * 16; i++)
+      ok = !memcmp(rgb->array + i * rgb->d(), expected[0][i / 16][i % 16], 3);
+    check(ok, "Fl_GIF_Image decodes the first frame");
+    delete rgb;
+    delete gif;
+
+    Fl_Anim_GIF_Image *img = new Fl_Anim_GIF_Image("anim", anim_gif_data, sizeof(anim_gif_data));
+    check(!img->fail() && img->w() == 16 && img->h() == 16 && img->frames() == 4,
+          "the animation has 4 frames of 16x16 pixels");
+    check(img->loop_count() == 3, "loop_count() of the NETSCAPE extension: %d",
+          img->loop_count());
+    check(img->delay(0) == 0.1 && img->delay(1) == 0.2 && img->delay(2) == 0.3 &&
+          img->delay(3) == 0.1, "delay() of all frames, 0.1 s for a missing delay");
+
+    for (i = 0, ok = 1; i < 4; i++) {
+      img->frame(i);
+      if (!shows(img, i)) ok = 0;
+    }
+    check(ok, "frames are composited with their disposal methods");
+
+    img->frame_cache(1);
+    img->frame(3);
+    ok = shows(img, 3);
+    img->frame(1);
+    ok = ok && shows(img, 1);
+    img->frame(2);
+    ok = ok && shows(img, 2);
+    check(ok, "frames are decoded again when they are not cached");
+
+    Fl_Anim_GIF_Image *copy = (Fl_Anim_GIF_Image *)img->copy(32, 32);
+    check(copy->frame() == 2 && copy->w() == 32 && copy->data_w() == 16 && shows(copy, 2),
+          "copy() shows the same frame");
+    delete copy;
+
+    Fl_Group *save = Fl_Group::current();
+    Fl_Group::current(0);
+    Fl_Box *box = new Fl_Box(0, 0, 16, 16);
+    Fl_Group::current(save);
+    img->canvas(box);
+    img->start();
+    check(img->playing(), "start() plays the animation");
+    img->stop();
+    check(!img->playing() && img->frame() == 2, "stop() keeps the current frame");
+    img->start();
+    delete box;
+    check(img->canvas() == 0, "deleting the canvas widget clears canvas()");
+    delete img;
+    summary();
+  }
+};
+
+UnitTest anim_gif(kTestAnimGIF, "Animated GIF", AnimGIFTest::create);
@@ -0,0 +1,155 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include "../fluid/undo_store.h"
+#include <stdio.h>      // snprintf()
+#include <stdlib.h>     // rand(), srand(), malloc(), free()
+#include <string.h>     // memcmp(), memcpy(), strlen()
+
+//
+//------- test the storage of the undo levels of FLUID ----------
+//
+
+class FluidUndoTest : public UnitCheck {
+  enum { LINES = 200, LEVELS = 300 };
+  Fd_Undo_Store store;
+  char *texts[LEVELS];          // the expected text of every level
+  int sizes[LEVELS];
+  char lines[LINES][40];
+  int nlines;
+
+  // Changes, inserts, or deletes a random line of the design
+  void edit() {
+    int i = rand() % nlines, what = rand() % 4;
+    if (what == 0 && nlines < LINES) {
+      memmove(lines[i + 1], lines[i], (nlines - i) * sizeof(lines[0]));
+      nlines++;
+    } else if (what == 1 && nlines > 1) {
+      memmove(lines[i], lines[i + 1], (nlines - i - 1) * sizeof(lines[0]));
+      nlines--;
+      return;
+    }
+    snprintf(lines[i], sizeof(lines[i]), "Fl_Button b%d {label {Item %d}}\n",
+             rand() % 10000, rand());
+  }
+
+  // Returns the design as a text allocated with malloc()
+  char *design(int &size) {
+    size = 0;
+    int i;
+    for (i = 0; i < nlines; i++) size += (int)strlen(lines[i]);
+    char *text = (char *)malloc(size + 1), *p = text;
+    for (i = 0; i < nlines; i++) {
+      int n = (int)strlen(lines[i]);
+      memcpy(p, lines[i], n);
+      p += n;
+    }
+    *p = 0;
+    return text;
+  }
+
+  // Stores the design as the given level
+  void store_level(int level) {
+    char *text = design(sizes[level]);
+    free(texts[level]);
+    texts[level] = (char *)malloc(sizes[level] + 1);
+    memcpy(texts[level], text, sizes[level] + 1);
+    store.store(level, text, sizes[level]);
+  }
+
+  // Checks that the levels first..last of the store are levels
+  // offset+first..offset+last of the expected texts, in random order
+  int texts_ok(int first, int last, int offset) {
+    for (int k = 0; k < 3 * (last - first + 1); k++) {
+      int level = first + rand() % (last - first + 1), size = -1;
+      const char *text = store.text(level, size);
+      int i = level + offset;
+      if (!text || size != sizes[i] || memcmp(text, texts[i], size + 1)) return 0;
+    }
+    return 1;
+  }
+
+  int max_chain() {
+    int n = 0;
+    for (int i = 0; i < store.count(); i++)
+      if (store.chain_length(i) > n) n = store.chain_length(i);
+    return n;
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new FluidUndoTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  FluidUndoTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    int i, total = 0, size;
+    memset(texts, 0, sizeof(texts));
+    srand(26);
+    for (nlines = 0; nlines < LINES / 2; nlines++)
+      snprintf(lines[nlines], sizeof(lines[nlines]), "Fl_Box box%d {label {Box %d}}\n",
+               nlines, nlines);
+
+    for (i = 0; i < 100; i++) {
+      store_level(i);
+      total += sizes[i];
+      edit();
+    }
+    check(store.count() == 100 && texts_ok(0, 99, 0),
+          "100 levels are restored in random order");
+    check(store.chain_length(15) == 15 && store.chain_length(16) == 0 && max_chain() < 16,
+          "a full copy follows at most %d deltas", UNDO_KEYFRAME_INTERVAL - 1);
+    check(store.memory_used() < total / 4, "deltas use %ld of %d bytes",
+          store.memory_used(), total);
+
+    // drop the oldest levels while editing, like undo_store() does
+    int dropped = 0;
+    for (i = 100; i < LEVELS; i++) {
+      store_level(i);
+      edit();
+      if (i % 3 == 0) {
+        store.drop_oldest();
+        dropped++;
+      }
+    }
+    check(store.count() == LEVELS - dropped && texts_ok(0, store.count() - 1, dropped),
+          "levels are restored after dropping the %d oldest levels", dropped);
+    check(max_chain() < 16, "a full copy follows at most %d deltas after dropping levels: %d",
+          UNDO_KEYFRAME_INTERVAL - 1, max_chain());
+
+    store.truncate(50);
+    const char *text = store.text(50, size);
+    check(store.count() == 50 && text == 0 && texts_ok(0, 49, dropped),
+          "truncate() removes the later levels");
+
+    // store an edit as level 50 again, like undo_checkpoint() after undo
+    store_level(50 + dropped);
+    check(store.count() == 51 && texts_ok(0, 50, dropped), "a new level replaces the redo levels");
+
+    while (store.count() > 1) store.drop_oldest();
+    text = store.text(0, size);
+    check(text && size == sizes[50 + dropped] && !memcmp(text, texts[50 + dropped], size) &&
+          store.memory_used() == size, "the last level is kept as a full copy");
+
+    store.truncate(0);
+    check(store.count() == 0 && store.memory_used() == 0, "truncate(0) releases all levels");
+
+    for (i = 0; i < LEVELS; i++) free(texts[i]);
+    summary();
+  }
+};
+
+UnitTest fluid_undo(kTestFluidUndo, "FLUID Undo", FluidUndoTest::create);
@@ -0,0 +1,170 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_Graphics_Driver.H>
+
+//
+//------- test the hash table of font descriptors ----------
+//
+
+class FontCacheTest : public UnitCheck {
+  enum { FACES = 10, SIZES = 60, ANGLES = 3, N = FACES * SIZES * ANGLES, FACE0 = 1000 };
+  Fl_Font_Descriptor *desc[N];
+
+  static Fl_Font face(int i) { return FACE0 + i / (SIZES * ANGLES); }
+  static Fl_Fontsize size(int i) { return 1 + (i / ANGLES) % SIZES; }
+  static int angle(int i) { return 90 * (i % ANGLES); }
+
+  // returns non-zero if exactly the descriptors that are not NULL are found
+  int all_found() {
+    for (int i = 0; i < N; i++) {
+      Fl_Font_Descriptor *f = Fl_Font_Descriptor::find(face(i), size(i), angle(i));
+      if (f != desc[i]) return 0;
+    }
+    return 1;
+  }
+
+  // Limits the cache and checks that it deletes the least recently used
+  // descriptors that nobody holds
+  void test_limit() {
+    enum { M = 100 };
+    Fl_Font_Descriptor *d[M + 1];
+    unsigned long lookups, probes;
+    int fonts, fonts0, i;
+    Fl_Graphics_Driver::font_cache_purge(); // leaves the fonts of the drivers
+    Fl_Graphics_Driver::font_cache_stats(lookups, probes, fonts0);
+    for (i = 0; i < M; i++) {
+      d[i] = new Fl_Font_Descriptor("test", size(i));
+      d[i]->cache(FACE0 + i);
+    }
+    for (i = 0; i < M / 2; i++) Fl_Font_Descriptor::find(FACE0 + i, size(i));
+    // use order from the least recent: d[50..99], d[0..49], then d[100]
+    Fl_Font_Descriptor *held = d[60];
+    Fl_Font_Descriptor::hold(&held);
+    Fl_Graphics_Driver &driver = Fl_Graphics_Driver::default_driver();
+    Fl_Font_Descriptor *selected = driver.font_descriptor();
+    driver.font_descriptor(d[61]);
+
+    int limit = fonts0 + M;
+    Fl_Graphics_Driver::font_cache_limit(limit);
+    Fl_Graphics_Driver::font_cache_stats(lookups, probes, fonts);
+    int ok = fonts == fonts0 + M && Fl_Graphics_Driver::font_cache_limit() == limit;
+    d[M] = new Fl_Font_Descriptor("test", size(M));
+    d[M]->cache(FACE0 + M);
+    Fl_Graphics_Driver::font_cache_stats(lookups, probes, fonts);
+    int evicted = 0, kept = 1, order = 1;
+    for (i = 0; i <= M; i++) {
+      int rank = i < M / 2 ? i + M / 2 : (i < M ? i - M / 2 : M);
+      if (!Fl_Font_Descriptor::find(FACE0 + i, size(i))) {
+        evicted++;
+        if (i == 60 || i == 61 || i == M) kept = 0;
+        // all descriptors used before this one that nobody holds are evicted, too
+        for (int k = 0; k < M; k++) {
+          int rank_k = k < M / 2 ? k + M / 2 : k - M / 2;
+          if (rank_k < rank && k != 60 && k != 61 &&
+              Fl_Font_Descriptor::find(FACE0 + k, size(k))) order = 0;
+        }
+        d[i] = 0;
+      }
+    }
+    check(ok && fonts == limit * 3 / 4 && evicted == fonts0 + M + 1 - fonts,
+          "exceeding the limit of %d fonts deletes %d of them", limit, evicted);
+    check(kept && order, "the least recently used fonts are deleted, held ones are kept");
+
+    Fl_Graphics_Driver::font_cache_limit(0);
+    int purged = Fl_Graphics_Driver::font_cache_purge();
+    Fl_Graphics_Driver::font_cache_stats(lookups, probes, fonts);
+    check(purged == fonts0 + M + 1 - evicted - 2 && fonts == fonts0 + 2 &&
+          Fl_Font_Descriptor::find(FACE0 + 60, size(60)) == held &&
+          Fl_Font_Descriptor::find(FACE0 + 61, size(61)) == d[61],
+          "font_cache_purge() deletes the %d fonts that nobody holds", purged);
+
+    Fl_Graphics_Driver::font_cache_limit(1);
+    Fl_Font_Descriptor *added = new Fl_Font_Descriptor("test", 1);
+    added->cache(FACE0 - 1);
+    check(Fl_Font_Descriptor::find(FACE0 - 1, 1) == added,
+          "a font added above the limit is kept until it was selected");
+    Fl_Graphics_Driver::font_cache_limit(0);
+    delete added;
+
+    Fl_Font_Descriptor::release(&held);
+    driver.font_descriptor(selected);
+    i = Fl_Graphics_Driver::font_cache_purge();
+    Fl_Graphics_Driver::font_cache_stats(lookups, probes, fonts);
+    check(i == 2 && fonts == fonts0, "released fonts are purged");
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new FontCacheTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  FontCacheTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    unsigned long lookups, probes, lookups0, probes0;
+    int fonts, fonts0, i;
+    Fl_Graphics_Driver::font_cache_stats(lookups0, probes0, fonts0);
+
+    for (i = 0; i < N; i++) {
+      desc[i] = new Fl_Font_Descriptor("test", size(i));
+      desc[i]->angle = angle(i);
+      desc[i]->cache(face(i));
+    }
+    Fl_Graphics_Driver::font_cache_stats(lookups, probes, fonts);
+    check(fonts == fonts0 + N, "font_cache_stats() counts %d cached descriptors", fonts - fonts0);
+
+    Fl_Graphics_Driver::font_cache_stats(lookups0, probes0, fonts0);
+    int ok = all_found();
+    Fl_Graphics_Driver::font_cache_stats(lookups, probes, fonts);
+    check(ok, "find() returns the descriptor of each face, size and angle");
+    check(lookups - lookups0 == N && probes - probes0 < 2 * N,
+          "%lu lookups compare %lu descriptors", lookups - lookups0, probes - probes0);
+    check(!Fl_Font_Descriptor::find(FACE0, SIZES + 1) &&
+          !Fl_Font_Descriptor::find(FACE0, 1, 45) &&
+          !Fl_Font_Descriptor::find(FACE0 + FACES, 1),
+          "find() returns NULL for fonts that are not cached");
+
+    Fl_Font_Descriptor *f = desc[0];
+    f->cache(FACE0 - 1);
+    ok = Fl_Font_Descriptor::find(FACE0 - 1, size(0), angle(0)) == f;
+    desc[0] = 0;
+    ok = ok && all_found();
+    Fl_Graphics_Driver::font_cache_stats(lookups, probes, fonts);
+    check(ok && fonts == fonts0, "cache() moves a descriptor to another face");
+    delete f;
+
+    for (i = 1; i < N; i += 2) {
+      delete desc[i];
+      desc[i] = 0;
+    }
+    Fl_Graphics_Driver::font_cache_stats(lookups, probes, fonts);
+    check(all_found() && fonts == fonts0 - 1 - N / 2,
+          "deleted descriptors are removed from the cache");
+
+    for (i = 2; i < N; i += 2) {
+      desc[i]->uncache();
+      delete desc[i];
+    }
+    Fl_Graphics_Driver::font_cache_stats(lookups, probes, fonts);
+    check(fonts == fonts0 - N && !Fl_Font_Descriptor::find(face(2), size(2), angle(2)),
+          "uncache() removes a descriptor once");
+
+    test_limit();
+    summary();
+  }
+};
+
+UnitTest font_cache(kTestFontCache, "Font Cache", FontCacheTest::create);
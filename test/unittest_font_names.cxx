@@ -0,0 +1,177 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <FL/fl_config.h>
+
+#if defined(FLTK_USE_X11) || defined(FLTK_USE_WAYLAND)
+
+#include "unittests.h"
+
+#include "../src/drivers/Unix/Fl_Unix_System_Driver.H"
+#include <FL/Fl.H>
+#include <stdio.h>      // snprintf(), fopen()
+#include <stdlib.h>     // getenv(), setenv(), unsetenv(), free()
+#include <string.h>     // strcmp(), strdup()
+#include <unistd.h>     // getpid(), unlink(), rmdir()
+#include <sys/stat.h>   // mkdir()
+
+//
+//------- test the cache of the font names found by Fl::set_fonts() ----------
+//
+
+class FontNamesTest : public UnitCheck {
+  enum { N = 3 };
+  char dir[100], file[200], fonts[200], newfonts[200];
+
+  // sets environment variable name to value, or removes it if value is NULL
+  static void env(const char *name, const char *value) {
+    if (value) setenv(name, value, 1);
+    else unsetenv(name);
+  }
+
+  // returns non-zero if the fonts from FL_FREE_FONT on have the test names
+  static int names_ok() {
+    static const char *names[N] = { "Test Sans", "Test Serif", "Test Mono" };
+    for (int i = 0; i < N; i++) {
+      const char *name = Fl::get_font((Fl_Font)(FL_FREE_FONT + i));
+      if (!name || strcmp(name, names[i])) return 0;
+    }
+    return 1;
+  }
+
+  static void set_names(const char *a, const char *b, const char *c) {
+    Fl::set_font((Fl_Font)(FL_FREE_FONT + 0), a);
+    Fl::set_font((Fl_Font)(FL_FREE_FONT + 1), b);
+    Fl::set_font((Fl_Font)(FL_FREE_FONT + 2), c);
+  }
+
+  // Removes the last line of the cache file. Returns 0 on failure.
+  int truncate_file() {
+    char buf[1000];
+    FILE *f = fopen(file, "r");
+    if (!f) return 0;
+    int n = (int)fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    if (n < 2) return 0;
+    n--;                                  // the last newline
+    while (n > 0 && buf[n - 1] != '\n') n--;
+    f = fopen(file, "w");
+    if (!f) return 0;
+    fwrite(buf, 1, n, f);
+    fclose(f);
+    return 1;
+  }
+
+  void test(const char *no_cache) {
+    int n;
+    set_names("Test Sans", "Test Serif", "Test Mono");
+    Fl_Unix_System_Driver::save_font_cache("unittest", N);
+    char tmp[220];
+    snprintf(tmp, sizeof(tmp), "%s.%ld", file, (long)getpid());
+    struct stat st;
+    check(stat(file, &st) == 0 && stat(tmp, &st) != 0,
+          "save_font_cache() writes the cache file and removes the temporary file");
+
+    set_names("Other", "Other", "Other");
+    n = Fl_Unix_System_Driver::load_font_cache("unittest");
+    check(n == N && names_ok(), "load_font_cache() sets the saved names: %d", n);
+
+    set_names("Other", "Other", "Other");
+    n = Fl_Unix_System_Driver::load_font_cache("none");
+    check(n == -1 && !names_ok(), "a missing cache file is not loaded: %d", n);
+
+    char *fc_path = getenv("FONTCONFIG_PATH");
+    if (fc_path) fc_path = strdup(fc_path);
+    env("FONTCONFIG_PATH", "/nonexistent/fontconfig");
+    n = Fl_Unix_System_Driver::load_font_cache("unittest");
+    env("FONTCONFIG_PATH", fc_path);
+    free(fc_path);
+    check(n == -1, "the cache is not used with another fontconfig configuration: %d", n);
+
+    mkdir(newfonts, 0700);
+    n = Fl_Unix_System_Driver::load_font_cache("unittest");
+    check(n == -1, "the cache is not used after a font directory was added: %d", n);
+    Fl_Unix_System_Driver::save_font_cache("unittest", N);
+    n = Fl_Unix_System_Driver::load_font_cache("unittest");
+    check(n == N, "the cache saved again is used: %d", n);
+
+    set_names("Other", "Other", "Other");
+    int ok = truncate_file();
+    n = Fl_Unix_System_Driver::load_font_cache("unittest");
+    check(ok && n == -1 && !names_ok(), "a truncated cache file is not loaded: %d", n);
+
+    set_names("Test Sans", "", "Test Mono");
+    Fl_Unix_System_Driver::save_font_cache("unittest", N);
+    set_names("Other", "Other", "Other");
+    n = Fl_Unix_System_Driver::load_font_cache("unittest");
+    const char *name = Fl::get_font((Fl_Font)(FL_FREE_FONT + 1));
+    check(n == N && name && !*name, "empty names are saved and loaded: %d", n);
+
+    set_names("Test Sans", "Test Serif", "Test Mono");
+    env("FLTK_NO_FONT_CACHE", "1");
+    unlink(file);
+    Fl_Unix_System_Driver::save_font_cache("unittest", N);
+    ok = stat(file, &st) != 0;
+    env("FLTK_NO_FONT_CACHE", NULL);
+    Fl_Unix_System_Driver::save_font_cache("unittest", N);
+    env("FLTK_NO_FONT_CACHE", "1");
+    n = Fl_Unix_System_Driver::load_font_cache("unittest");
+    env("FLTK_NO_FONT_CACHE", no_cache);
+    check(ok && n == -1, "FLTK_NO_FONT_CACHE turns the cache off: %d", n);
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new FontNamesTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  FontNamesTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    // use a cache and font directory of our own; the fonts from
+    // FL_FREE_FONT on are not used by the other tests
+    char *cache_home = getenv("XDG_CACHE_HOME");
+    char *data_home = getenv("XDG_DATA_HOME");
+    char *no_cache = getenv("FLTK_NO_FONT_CACHE");
+    if (cache_home) cache_home = strdup(cache_home);
+    if (data_home) data_home = strdup(data_home);
+    if (no_cache) no_cache = strdup(no_cache);
+    snprintf(dir, sizeof(dir), "/tmp/fltk-unittest-%ld", (long)getpid());
+    snprintf(file, sizeof(file), "%s/fltk/fonts-unittest.cache", dir);
+    snprintf(fonts, sizeof(fonts), "%s/fonts", dir);
+    snprintf(newfonts, sizeof(newfonts), "%s/fonts/new", dir);
+    mkdir(dir, 0700);
+    mkdir(fonts, 0700);
+    env("XDG_CACHE_HOME", dir);
+    env("XDG_DATA_HOME", dir);
+    env("FLTK_NO_FONT_CACHE", NULL);
+    test(no_cache);
+
+    env("XDG_CACHE_HOME", cache_home);
+    env("XDG_DATA_HOME", data_home);
+    free(cache_home);
+    free(data_home);
+    free(no_cache);
+    unlink(file);
+    snprintf(file, sizeof(file), "%s/fltk", dir);
+    rmdir(file);
+    rmdir(newfonts);
+    rmdir(fonts);
+    rmdir(dir);
+    summary();
+  }
+};
+
+UnitTest font_names(kTestFontNames, "Font Names Cache", FontNamesTest::create);
+
+#endif // FLTK_USE_X11 || FLTK_USE_WAYLAND
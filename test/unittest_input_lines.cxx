@@ -0,0 +1,119 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_Multiline_Input.H>
+#include <FL/fl_utf8.h>     // fl_utf8len1()
+#include <stdio.h>      // snprintf()
+#include <stdlib.h>     // rand(), srand()
+
+//
+//------- test the line layout of Fl_Input_ ----------
+//
+
+// Gives access to the line layout of the input
+class InputLinesInput : public Fl_Multiline_Input {
+public:
+  InputLinesInput() : Fl_Multiline_Input(0, 0, 300, 200) { }
+  int start(int i) const { return line_start(i); }
+  int end(int i) const { return line_end(i); }
+};
+
+class InputLinesTest : public UnitCheck {
+  InputLinesInput *in, *ref;
+
+  static const char *random_text() {
+    static const char *words[] = {
+      "a ", "mew ", "word ", "tenacious ", "\n", "\n\n", "lorem ipsum ", "\xc3\xa4\xc3\xb6\xc3\xbc ",
+      "wwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwww"
+    };
+    return words[rand() % 9];
+  }
+
+  // Compares the lines of 'in' with a fresh layout of the same text.
+  // Returns 0 and describes the first difference in 'msg'.
+  int same(char *msg, int size) {
+    ref->value(in->value(), in->size());
+    for (int i = 0; i <= in->size(); i = in->index(i) ? i + fl_utf8len1(in->index(i)) : i + 1) {
+      if (in->start(i) != ref->start(i) || in->end(i) != ref->end(i)) {
+        snprintf(msg, size, ": index %d is in line %d..%d instead of %d..%d", i,
+                 in->start(i), in->end(i), ref->start(i), ref->end(i));
+        return 0;
+      }
+    }
+    msg[0] = 0;
+    return 1;
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new InputLinesTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  InputLinesTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    Fl_Group *save = Fl_Group::current();
+    Fl_Group::current(0);
+    in = new InputLinesInput;
+    ref = new InputLinesInput;
+    Fl_Group::current(save);
+    char msg[200];
+    int i, ok;
+
+    srand(3);
+    for (i = 0; i < 300; i++) in->insert(random_text());
+    check(in->start(0) == 0 && in->end(in->size()) == in->size(),
+          "lines without wrapping start and end at newlines");
+
+    in->wrap(1);
+    ref->wrap(1);
+    ok = same(msg, sizeof(msg));
+    check(ok, "wrapped lines of %d bytes of text%s", in->size(), msg);
+
+    for (i = 0, ok = 1; i < 300 && ok; i++) {
+      int b = rand() % (in->size() + 1), e = b + rand() % 20;
+      while (b > 0 && (in->index(b) & 0xc0) == 0x80) b--;
+      if (e > in->size()) e = in->size();
+      while (e < in->size() && (in->index(e) & 0xc0) == 0x80) e++;
+      switch (rand() % 4) {
+        case 0: in->replace(b, b, random_text()); break;
+        case 1: in->replace(b, e, 0); break;
+        case 2: in->replace(b, e, "\n"); break;
+        case 3: in->undo(); break;
+      }
+      ok = same(msg, sizeof(msg));
+    }
+    check(ok, "wrapped lines after %d random edits and undos%s", i, msg);
+
+    in->textsize(in->textsize() + 6);
+    ref->textsize(in->textsize());
+    ok = same(msg, sizeof(msg));
+    check(ok, "wrapped lines after textsize()%s", msg);
+
+    in->resize(0, 0, 150, 200);
+    ref->resize(0, 0, 150, 200);
+    ok = same(msg, sizeof(msg));
+    check(ok, "wrapped lines after resize()%s", msg);
+
+    in->value("one\ntwo");
+    check(in->start(5) == 4 && in->end(0) == 3, "lines after value()");
+
+    delete in;
+    delete ref;
+    summary();
+  }
+};
+
+UnitTest input_lines(kTestInputLines, "Input Lines", InputLinesTest::create);
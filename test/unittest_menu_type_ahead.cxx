@@ -0,0 +1,196 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_Menu_Item.H>
+#include <FL/Fl_Recording_Surface.H>
+#include <FL/fl_draw.H>
+#include <stdio.h>      // snprintf(), sscanf()
+#include <string.h>     // memset(), strstr()
+
+//
+//------- test the type-ahead filter and drawing of large popup menus ----------
+//
+
+class MenuTypeAheadTest : public UnitCheck {
+  enum { N = 2000 };
+  Fl_Menu_Item items[N + 1];
+  char labels[N][12];
+  const char *typing;   // keys still to be typed into the open menu
+  char text[2];
+  int menu_w, menu_h;   // size of the menu window before the last key
+  char drawn[N];        // items drawn by draw_menu() ...
+  int label_y[N];       // ... and the positions of their labels
+  int full_count;       // items drawn by a full redraw of the menu window
+  int full_ok, rows_ok; // results of check_drawing()
+
+  // Draws the menu window clipped to the rows from y to y + h into a
+  // recording surface and marks the items whose labels were drawn
+  void draw_menu(Fl_Window *win, int y, int h) {
+    memset(drawn, 0, sizeof(drawn));
+    Fl_Recording_Surface *rec = new Fl_Recording_Surface(win->w(), win->h(), 1);
+    Fl_Surface_Device::push_current(rec);
+    fl_push_clip(0, y, win->w(), h);
+    rec->draw(win);
+    fl_pop_clip();
+    Fl_Surface_Device::pop_current();
+    for (const char *p = rec->commands(); (p = strstr(p, "\ntext ")) != 0; p++) {
+      int x, ly, i;
+      if (sscanf(p, "\ntext %d %d Item %d", &x, &ly, &i) == 3 && i >= 0 && i < N) {
+        drawn[i] = 1;
+        label_y[i] = ly;
+      }
+    }
+    delete rec;
+  }
+
+  // Checks that a full redraw of the open menu window draws the items on
+  // the screen, and that a redraw of rows 10 to 30 draws only these
+  void check_drawing(Fl_Window *win) {
+    int i, first = -1, last = -1;
+    draw_menu(win, 0, win->h());
+    full_count = full_ok = rows_ok = 0;
+    for (i = 0; i < N; i++) {
+      if (!drawn[i]) continue;
+      if (first < 0) first = i;
+      last = i;
+      full_count++;
+    }
+    if (full_count < 2 || last - first + 1 != full_count) return;
+    int ih = (label_y[last] - label_y[first]) / (last - first);
+    int y0 = label_y[first] - first * ih; // label position of the first item
+    int sx, sy, sw, sh;
+    Fl::screen_work_area(sx, sy, sw, sh, win->x(), win->y());
+    int top = (sy - win->y() - y0) / ih + 1;
+    int bottom = (sy + sh - win->y() - y0) / ih - 1;
+    if (top < 0) top = 0;
+    if (bottom > N - 1) bottom = N - 1;
+    full_ok = first <= top && last >= bottom;
+
+    draw_menu(win, y0 + 10 * ih, 20 * ih);
+    rows_ok = 1;
+    for (i = 0; i < N; i++) {
+      if (i > 10 && i < 29 && !drawn[i]) rows_ok = 0;
+      if ((i < 10 - 3 || i > 30 + 3) && drawn[i]) rows_ok = 0;
+    }
+  }
+
+  // Types the next key of 'typing' into the menu, the menu window has
+  // the grab while it is open. '\b' is BackSpace, '\r' is Enter, '\033'
+  // is Escape, and '>' is the Down arrow. '#' calls check_drawing().
+  static void type_cb(void *data) {
+    MenuTypeAheadTest *t = (MenuTypeAheadTest *)data;
+    if (!*t->typing || !Fl::grab()) return;
+    t->menu_w = Fl::grab()->w();
+    t->menu_h = Fl::grab()->h();
+    char c = *t->typing++;
+    if (c == '#') {
+      t->check_drawing(Fl::grab());
+      Fl::add_timeout(0.01, type_cb, data);
+      return;
+    }
+    int key = c == '\b' ? FL_BackSpace : c == '\r' ? FL_Enter :
+              c == '\033' ? FL_Escape : c == '>' ? FL_Down : (c | 0x20);
+    t->text[0] = (c == '>') ? 0 : c;
+    t->text[1] = 0;
+    Fl::e_keysym = key;
+    Fl::e_state = (c >= 'A' && c <= 'Z') ? FL_SHIFT : 0;
+    Fl::e_text = t->text;
+    Fl::e_length = t->text[0] ? 1 : 0;
+    Fl::handle(FL_KEYBOARD, Fl::grab());
+    if (*t->typing) Fl::add_timeout(0.01, type_cb, data);
+  }
+
+  // pops up the menu and types 'keys', returns the item picked
+  const Fl_Menu_Item *pick(const char *keys) {
+    typing = keys;
+    menu_w = menu_h = 0;
+    Fl::add_timeout(0.01, type_cb, this);
+    const Fl_Menu_Item *m = items->popup(0, 0);
+    Fl::remove_timeout(type_cb, this);
+    return m;
+  }
+
+  // returns the index of the item picked with 'keys', or -1
+  int picked(const char *keys) {
+    const Fl_Menu_Item *m = pick(keys);
+    return m ? (int)(m - items) : -1;
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new MenuTypeAheadTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  MenuTypeAheadTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    int keysym = Fl::e_keysym, state = Fl::e_state, length = Fl::e_length;
+    char *etext = Fl::e_text;
+    int lazy = Fl::menu_lazy_items();
+    memset(items, 0, sizeof(items));
+    for (int i = 0; i < N; i++) {
+      snprintf(labels[i], sizeof(labels[i]), "Item %04d", i);
+      items[i].label(labels[i]);
+    }
+    items[500].shortcut('q');
+    items[N - 1].label("Item 1999 is the last item and has a long label");
+    Fl::menu_lazy_items(500);
+    int n, wide, high;
+
+    picked("\033");
+    wide = menu_w;
+    high = menu_h;
+    picked("123\033");
+    check(menu_h > 0 && menu_h < high / 100,
+          "the menu shrinks to the 12 items that match: %d of %d pixels", menu_h, high);
+
+    n = picked("1234\r");
+    check(n == 1234, "typing \"1234\" picks the only matching item: %d", n);
+    n = picked("12\b34\r");
+    check(n == 134, "BackSpace removes the last typed character: %d", n);
+    n = picked("ITEM 19>\r");
+    check(n == 1901, "the filter ignores case and Down moves in the matching items: %d", n);
+    n = picked("xyz\r");
+    check(n == -1, "nothing is picked if no item matches: %d", n);
+    n = picked("1\033");
+    check(n == -1, "Escape closes the filtered menu: %d", n);
+    n = picked("q");
+    check(n == 500, "shortcuts of the items take precedence: %d", n);
+    picked("#\033");
+    check(full_ok && full_count < N / 2,
+          "a full redraw draws the %d items near the screen", full_count);
+    check(rows_ok, "a redraw of a few rows draws only the items in these rows");
+
+    Fl::menu_lazy_items(N);
+    picked("\033");
+    check(wide < menu_w, "labels below the screen are not measured: %d < %d pixels", wide, menu_w);
+    n = picked("1234\r");
+    check(n == -1, "menus with at most menu_lazy_items() items are not filtered: %d", n);
+    Fl::menu_lazy_items(0);
+    n = picked("1234\r");
+    check(n == -1, "menu_lazy_items(0) turns the filter off: %d", n);
+    picked("#\033");
+    check(full_count == N, "a full redraw of other menus draws all %d items", full_count);
+
+    Fl::menu_lazy_items(lazy);
+    Fl::e_keysym = keysym;
+    Fl::e_state = state;
+    Fl::e_text = etext;
+    Fl::e_length = length;
+    summary();
+  }
+};
+
+UnitTest menu_type_ahead(kTestMenuTypeAhead, "Menu Type-Ahead", MenuTypeAheadTest::create);
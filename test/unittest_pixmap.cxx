@@ -0,0 +1,303 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_Pixmap.H>
+#include <FL/Fl_RGB_Image.H>
+#include <FL/platform.H>   // fl_parse_color()
+#include <ctype.h>      // isspace()
+#include <stdio.h>      // sscanf(), snprintf()
+#include <string.h>     // memcmp(), memset(), strlen()
+
+#include "../fluid/pixmaps/flAdjuster.xpm"
+#include "../fluid/pixmaps/flBox.xpm"
+#include "../fluid/pixmaps/flBrowser.xpm"
+#include "../fluid/pixmaps/flButton.xpm"
+#include "../fluid/pixmaps/flCheckBrowser.xpm"
+#include "../fluid/pixmaps/flCheckButton.xpm"
+#include "../fluid/pixmaps/flCheckMenuitem.xpm"
+#include "../fluid/pixmaps/flChoice.xpm"
+#include "../fluid/pixmaps/flClass.xpm"
+#include "../fluid/pixmaps/flClock.xpm"
+#include "../fluid/pixmaps/flCode.xpm"
+#include "../fluid/pixmaps/flCodeBlock.xpm"
+#include "../fluid/pixmaps/flComment.xpm"
+#include "../fluid/pixmaps/flCounter.xpm"
+#include "../fluid/pixmaps/flData.xpm"
+#include "../fluid/pixmaps/flDeclaration.xpm"
+#include "../fluid/pixmaps/flDeclarationBlock.xpm"
+#include "../fluid/pixmaps/flDial.xpm"
+#include "../fluid/pixmaps/flFileBrowser.xpm"
+#include "../fluid/pixmaps/flFileInput.xpm"
+#include "../fluid/pixmaps/flFlex.xpm"
+#include "../fluid/pixmaps/flFunction.xpm"
+#include "../fluid/pixmaps/flGroup.xpm"
+#include "../fluid/pixmaps/flHelp.xpm"
+#include "../fluid/pixmaps/flInput.xpm"
+#include "../fluid/pixmaps/flInputChoice.xpm"
+#include "../fluid/pixmaps/flLightButton.xpm"
+#include "../fluid/pixmaps/flMenuButton.xpm"
+#include "../fluid/pixmaps/flMenubar.xpm"
+#include "../fluid/pixmaps/flMenuitem.xpm"
+#include "../fluid/pixmaps/flOutput.xpm"
+#include "../fluid/pixmaps/flPack.xpm"
+#include "../fluid/pixmaps/flProgress.xpm"
+#include "../fluid/pixmaps/flRadioMenuitem.xpm"
+#include "../fluid/pixmaps/flRepeatButton.xpm"
+#include "../fluid/pixmaps/flReturnButton.xpm"
+#include "../fluid/pixmaps/flRoller.xpm"
+#include "../fluid/pixmaps/flRoundButton.xpm"
+#include "../fluid/pixmaps/flScroll.xpm"
+#include "../fluid/pixmaps/flScrollBar.xpm"
+#include "../fluid/pixmaps/flSimpleTerminal.xpm"
+#include "../fluid/pixmaps/flSlider.xpm"
+#include "../fluid/pixmaps/flSpinner.xpm"
+#include "../fluid/pixmaps/flSubmenu.xpm"
+#include "../fluid/pixmaps/flTable.xpm"
+#include "../fluid/pixmaps/flTabs.xpm"
+#include "../fluid/pixmaps/flTextDisplay.xpm"
+#include "../fluid/pixmaps/flTextEdit.xpm"
+#include "../fluid/pixmaps/flTile.xpm"
+#include "../fluid/pixmaps/flTree.xpm"
+#include "../fluid/pixmaps/flValueInput.xpm"
+#include "../fluid/pixmaps/flValueOutput.xpm"
+#include "../fluid/pixmaps/flValueSlider.xpm"
+#include "../fluid/pixmaps/flWidgetClass.xpm"
+#include "../fluid/pixmaps/flWindow.xpm"
+#include "../fluid/pixmaps/flWizard.xpm"
+#include "../fluid/pixmaps/invisible.xpm"
+#include "../fluid/pixmaps/lock.xpm"
+#include "../fluid/pixmaps/protected.xpm"
+#include "pixmaps/blast.xpm"
+#include "pixmaps/blue.xpm"
+#include "pixmaps/blue_bomb.xpm"
+#include "pixmaps/cyan.xpm"
+#include "pixmaps/cyan_bomb.xpm"
+#include "pixmaps/gray.xpm"
+#include "pixmaps/gray_bomb.xpm"
+#include "pixmaps/green.xpm"
+#include "pixmaps/green_bomb.xpm"
+#include "pixmaps/magenta.xpm"
+#include "pixmaps/magenta_bomb.xpm"
+#include "pixmaps/porsche.xpm"
+#include "pixmaps/porsche1.xpm"
+#include "pixmaps/red.xpm"
+#include "pixmaps/red_bomb.xpm"
+#include "pixmaps/tile.xpm"
+#include "pixmaps/yellow.xpm"
+#include "pixmaps/yellow_bomb.xpm"
+
+//
+//------- test the conversion of XPM pixmaps to RGBA pixels ----------
+//
+
+// the pixmaps of FLUID and of the test programs
+static const char *const *stock_xpms[] = {
+  flAdjuster_xpm, flBox_xpm, flBrowser_xpm, flButton_xpm, flCheckBrowser_xpm,
+  flCheckButton_xpm, flCheckMenuitem_xpm, flChoice_xpm, flClass_xpm, flClock_xpm,
+  flCode_xpm, flCodeBlock_xpm, flComment_xpm, flCounter_xpm, flData_xpm,
+  flDeclaration_xpm, flDeclarationBlock_xpm, flDial_xpm, flFileBrowser_xpm,
+  flFileInput_xpm, flFlex_xpm, flFunction_xpm, flGroup_xpm, flHelp_xpm, flInput_xpm,
+  flInputChoice_xpm, flLightButton_xpm, flMenuButton_xpm, flMenubar_xpm,
+  flMenuitem_xpm, flOutput_xpm, flPack_xpm, flProgress_xpm, flRadioMenuitem_xpm,
+  flRepeatButton_xpm, flReturnButton_xpm, flRoller_xpm, flRoundButton_xpm,
+  flScroll_xpm, flScrollBar_xpm, flSimpleTerminal_xpm, flSlider_xpm, flSpinner_xpm,
+  flSubmenu_xpm, flTable_xpm, flTabs_xpm, flTextDisplay_xpm, flTextEdit_xpm,
+  flTile_xpm, flTree_xpm, flValueInput_xpm, flValueOutput_xpm, flValueSlider_xpm,
+  flWidgetClass_xpm, flWindow_xpm, flWizard_xpm, invisible_xpm, lock_xpm,
+  protected_xpm, blast_xpm, blue_xpm, blue_bomb_xpm, cyan_xpm, cyan_bomb_xpm, gray_xpm,
+  gray_bomb_xpm, green_xpm, green_bomb_xpm, magenta_xpm, magenta_bomb_xpm, porsche_xpm,
+  porsche, red_xpm, red_bomb_xpm, tile_xpm, yellow_xpm, yellow_bomb_xpm
+};
+
+// Two character keys, keys that share the first character and are
+// transparent or opaque, keys that are redefined, and black, which is
+// also the color of the transparent pixels with bg = FL_BLACK
+static const char *const keys2_xpm[] = {
+  "6 3 7 2",
+  "   c None",
+  ".. c #000000",
+  ". \tc None",
+  " .\tc #FF0000",
+  ".x c None",
+  "x. s foo c #00FF00",
+  ".x c blue",
+  "  ..  . . .x",
+  "x..x ...    ",
+  "x.  . .. . ."
+};
+
+// The FLTK compressed colormap of 1 character keys followed by the bytes
+// r, g, b. A first key ' ' is transparent.
+static const char *const compressed_xpm[] = {
+  "4 2 -3 1",
+  " \x01\x02\x03" "r\xff\x00\x00" "k\x00\x00\x00",
+  " rk ",
+  "kr  "
+};
+
+class PixmapTest : public UnitCheck {
+  enum { BUFFER_SIZE = 64 * 1024, NBGS = 4 };
+  static const Fl_Color bgs[NBGS];
+  uchar expected[BUFFER_SIZE];
+  char *rows[1024];     // the data of the pixmap with two character keys
+  int nrows;
+
+  // The converter of FLTK 1.4.0, without the colors for the GDI printer.
+  // Keys that are not in the colormap are transparent black.
+  static int reference_convert(const char *const *cdata, uchar *out, Fl_Color bg) {
+    int w, h, ncolors, chars_per_pixel;
+    if (sscanf(cdata[0], "%d%d%d%d", &w, &h, &ncolors, &chars_per_pixel) < 4 ||
+        w <= 0 || h <= 0 || (chars_per_pixel != 1 && chars_per_pixel != 2))
+      return 0;
+    const uchar *const *data = (const uchar *const *)(cdata + 1);
+    typedef uchar uchar4[4];
+    uchar4 *colors = new uchar4[1 << (chars_per_pixel * 8)];
+    memset(colors, 0, (1 << (chars_per_pixel * 8)) * sizeof(uchar4));
+    if (ncolors < 0) {
+      ncolors = -ncolors;
+      const uchar *p = *data++;
+      if (*p == ' ') {
+        uchar *c = colors[(int)' '];
+        Fl::get_color(bg, c[0], c[1], c[2]); c[3] = 0;
+        p += 4;
+        ncolors--;
+      }
+      for (int i = 0; i < ncolors; i++) {
+        uchar *c = colors[*p++];
+        *c++ = *p++;
+        *c++ = *p++;
+        *c++ = *p++;
+        *c = 255;
+      }
+    } else {
+      for (int i = 0; i < ncolors; i++) {
+        const uchar *p = *data++;
+        int ind = *p++;
+        if (chars_per_pixel > 1)
+          ind = (ind << 8) | *p++;
+        uchar *c = colors[ind];
+        const uchar *previous_word = p;
+        for (;;) {
+          while (*p && isspace(*p)) p++;
+          uchar what = *p++;
+          while (*p && !isspace(*p)) p++;
+          while (*p && isspace(*p)) p++;
+          if (!*p) { p = previous_word; break; }
+          if (what == 'c') break;
+          previous_word = p;
+          while (*p && !isspace(*p)) p++;
+        }
+        c[3] = 255;
+        if (!fl_parse_color((const char *)p, c[0], c[1], c[2])) {
+          Fl::get_color(bg, c[0], c[1], c[2]);
+          c[3] = 0;
+        }
+      }
+    }
+    for (int Y = 0; Y < h; Y++) {
+      const uchar *p = data[Y];
+      for (int X = 0; X < w; X++, out += 4) {
+        int ind = *p++;
+        if (chars_per_pixel > 1) ind = (ind << 8) | *p++;
+        memcpy(out, colors[ind], 4);
+      }
+    }
+    delete[] colors;
+    return 1;
+  }
+
+  // Returns non-zero if Fl_RGB_Image converts xpm like the reference with
+  // all backgrounds. The first conversion decodes the pixmap with a black
+  // background, the next ones fill in the background of its decoded pixels.
+  int same_conversion(const char *const *xpm) {
+    int w, h;
+    if (!fl_measure_pixmap(xpm, w, h) || w * h * 4 > BUFFER_SIZE) return 0;
+    Fl_Pixmap pixmap(xpm);
+    int ok = 1;
+    for (int pass = 0; pass < 2 && ok; pass++) {
+      for (int k = 0; k < NBGS && ok; k++) {
+        Fl_RGB_Image rgb(&pixmap, bgs[k]);
+        ok = rgb.d() == 4 && reference_convert(xpm, expected, bgs[k]) &&
+             !memcmp(rgb.array, expected, w * h * 4);
+      }
+      pixmap.uncache(); // frees the decoded pixels
+    }
+    return ok;
+  }
+
+  // Makes a copy of the 1 character XPM with two character keys, where the
+  // first character of each key is 'a' or 'b'
+  const char *const *two_char_keys(const char *const *xpm) {
+    free_rows();
+    int w, h, ncolors, cpp;
+    sscanf(xpm[0], "%d%d%d%d", &w, &h, &ncolors, &cpp);
+    char *s = new char[40];
+    snprintf(s, 40, "%d %d %d 2", w, h, ncolors);
+    rows[nrows++] = s;
+    for (int i = 1; i <= ncolors + h && nrows < 1024; i++) {
+      const char *p = xpm[i];
+      int n = i <= ncolors ? 1 : w; // the number of keys in the line
+      s = new char[strlen(p) + n + 1];
+      char *q = s;
+      for (int k = 0; k < n; k++) {
+        *q++ = char('a' + (p[k] & 1));
+        *q++ = p[k];
+      }
+      strcpy(q, p + n);
+      rows[nrows++] = s;
+    }
+    return rows;
+  }
+
+  void free_rows() {
+    for (int i = 0; i < nrows; i++) delete[] rows[i];
+    nrows = 0;
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new PixmapTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  PixmapTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    const int nxpms = sizeof(stock_xpms) / sizeof(stock_xpms[0]);
+    int i, ok;
+    nrows = 0;
+
+    for (i = 0, ok = 1; i < nxpms && ok; i++) ok = same_conversion(stock_xpms[i]);
+    check(ok, "%d pixmaps of FLUID and of the tests with one character keys", nxpms);
+
+    for (i = 0, ok = 1; i < nxpms && ok; i++) ok = same_conversion(two_char_keys(stock_xpms[i]));
+    check(ok, "the same pixmaps with two character keys");
+    free_rows();
+
+    check(same_conversion(keys2_xpm),
+          "transparent, black and redefined keys that share their first character");
+    Fl_Pixmap pixmap(keys2_xpm);
+    Fl_RGB_Image rgb(&pixmap, FL_BLACK);
+    const uchar *p = rgb.array;
+    check(p[0] == 0 && p[3] == 0 && p[4] == 0 && p[7] == 255,
+          "with bg = FL_BLACK, transparent pixels and black pixels differ in alpha");
+
+    check(same_conversion(compressed_xpm), "the FLTK compressed colormap");
+    summary();
+  }
+};
+
+const Fl_Color PixmapTest::bgs[NBGS] = { FL_BLACK, FL_GRAY, FL_WHITE, 0x01020300 };
+
+UnitTest pixmap(kTestPixmap, "Pixmap Conversion", PixmapTest::create);
@@ -0,0 +1,292 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_PostScript.H>
+#include <FL/Fl_RGB_Image.H>
+#include <FL/fl_draw.H>
+#include <stdio.h>      // tmpfile(), fread(), snprintf()
+#include <stdlib.h>     // rand(), srand(), malloc(), realloc(), free()
+#include <string.h>     // strstr(), strncmp(), strlen(), memcmp()
+
+//
+//------- test the compressed and shared images of the PostScript output ----------
+//
+
+// A growing array of bytes
+class Bytes {
+public:
+  uchar *data;
+  int size, alloc;
+  Bytes() : data(0), size(0), alloc(0) {}
+  ~Bytes() { free(data); }
+  void add(uchar c) {
+    if (size >= alloc) {
+      alloc = alloc ? 2 * alloc : 4096;
+      data = (uchar *)realloc(data, alloc);
+    }
+    data[size++] = c;
+  }
+  void clear() { size = 0; }
+};
+
+class PostScriptTest : public UnitCheck {
+  enum { W1 = 61, H1 = 37, W2 = 320, H2 = 240, W3 = 50, H3 = 30 };
+  char *text;   // the PostScript output
+  int largest;  // the size of the largest string of the last resource_image()
+
+  // Decodes ASCII85 data up to and including the "~>" end mark.
+  // Returns the end of the data, or NULL if the data is not valid.
+  static const char *decode85(const char *p, Bytes &out) {
+    unsigned val = 0;
+    int n = 0;
+    for (;; p++) {
+      char c = *p;
+      if (c == ' ' || c == '\n' || c == '\r' || c == '\t') continue;
+      if (c == '~') break;
+      if (c == 'z' && n == 0) {
+        for (int i = 0; i < 4; i++) out.add(0);
+        continue;
+      }
+      if (c < '!' || c > 'u') return 0;
+      val = val * 85 + (c - '!');
+      if (++n == 5) {
+        for (int i = 3; i >= 0; i--) out.add(uchar(val >> (8 * i)));
+        val = 0;
+        n = 0;
+      }
+    }
+    if (p[1] != '>' || n == 1) return 0;
+    if (n) { // a final partial group of n characters holds n - 1 bytes
+      for (int i = n; i < 5; i++) val = val * 85 + 84;
+      for (int i = 3; i > 4 - n; i--) out.add(uchar(val >> (8 * i)));
+    }
+    return p + 2;
+  }
+
+  // Decodes LZW data like the LZWDecode filter with EarlyChange 1.
+  // Returns 0 if the data is not valid.
+  static int decode_lzw(const Bytes &in, Bytes &out) {
+    static short prefix[4096];
+    static uchar suffix[4096], stack[4096];
+    int nbits = 9, next = 258, prev = -1, bitpos = 0;
+    for (;;) {
+      if (bitpos + nbits > in.size * 8) return 0; // no end of data code
+      int code = 0;
+      for (int i = 0; i < nbits; i++, bitpos++)
+        code = (code << 1) | ((in.data[bitpos / 8] >> (7 - bitpos % 8)) & 1);
+      if (code == 256) {
+        nbits = 9;
+        next = 258;
+        prev = -1;
+        continue;
+      }
+      if (code == 257) return 1;
+      if (prev < 0) {
+        if (code > 255) return 0;
+        out.add(uchar(code));
+        prev = code;
+        continue;
+      }
+      if (code > next || next >= 4096) return 0;
+      int c = (code == next ? prev : code), n = 0;
+      while (c > 255) {
+        stack[n++] = suffix[c];
+        c = prefix[c];
+      }
+      uchar first = uchar(c);
+      out.add(first);
+      while (n) out.add(stack[--n]);
+      if (code == next) out.add(first);
+      prefix[next] = short(prev);
+      suffix[next] = first;
+      next++;
+      if (next + 1 >= (1 << nbits) && nbits < 12) nbits++;
+      prev = code;
+    }
+  }
+
+  // Decodes the data that follows the n-th drawing command cmd that is
+  // followed by data, and returns 0 if there is no such data
+  int inline_image(const char *cmd, int n, Bytes &out) {
+    out.clear();
+    int len = (int)strlen(cmd);
+    for (const char *p = text; (p = strstr(p, cmd)) != 0; ) {
+      p += len;
+      if (!strncmp(p, "restore", 7)) continue; // the data is in a resource
+      if (n-- > 0) continue;
+      Bytes lzw;
+      return decode85(p, lzw) && decode_lzw(lzw, out);
+    }
+    return 0;
+  }
+
+  // Decodes the data of the part-th part of image resource id
+  int resource_image(int id, int part, Bytes &out) {
+    out.clear();
+    largest = 0;
+    char name[40];
+    snprintf(name, sizeof(name), "FLI /I%d [\n", id);
+    const char *p = strstr(text, name);
+    if (!p) return 0;
+    p += strlen(name);
+    for (; part > 0; part--) {
+      p = strstr(p, "]\n");
+      if (!p) return 0;
+      p += 2;
+    }
+    if (*p++ != '[') return 0;
+    // the LZW data is split into strings
+    Bytes lzw;
+    while (*p == '<' && p[1] == '~') {
+      int size = lzw.size;
+      p = decode85(p + 2, lzw);
+      if (!p) return 0;
+      if (lzw.size - size > largest) largest = lzw.size - size;
+      if (*p == '\n') p++;
+    }
+    return *p == ']' && decode_lzw(lzw, out);
+  }
+
+  // Counts the occurrences of s in the output
+  int count(const char *s) {
+    int n = 0;
+    for (const char *p = text; (p = strstr(p, s)) != 0; p += strlen(s)) n++;
+    return n;
+  }
+
+  static int same(const Bytes &b, const uchar *data, int size) {
+    return b.size == size && !memcmp(b.data, data, size);
+  }
+
+  // Opens a PostScript file of 2 pages, returns 0 on errors
+  static Fl_PostScript_File_Device *begin_job(FILE *f) {
+    Fl_PostScript_File_Device *ps = new Fl_PostScript_File_Device;
+    if (f && ps->begin_job(f, 2) == 0) return ps;
+    delete ps;
+    return 0;
+  }
+
+  // Ends the job and sets text to the contents of f
+  void end_job(Fl_PostScript_File_Device *ps, FILE *f) {
+    ps->end_job();
+    delete ps;
+    long size = ftell(f);
+    text = new char[size + 1];
+    rewind(f);
+    size = (long)fread(text, 1, size, f);
+    text[size] = 0;
+    fclose(f);
+  }
+
+  // Prints a gray image of 1 row of n bytes
+  int print_gray(const uchar *data, int n) {
+    FILE *f = tmpfile();
+    Fl_PostScript_File_Device *ps = begin_job(f);
+    if (!ps) {
+      if (f) fclose(f);
+      return 0;
+    }
+    ps->begin_page();
+    fl_draw_image_mono(data, 10, 10, n, 1);
+    ps->end_page();
+    end_job(ps, f);
+    return 1;
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new PostScriptTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  PostScriptTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    int i, ok;
+    // a gradient with noise, a large image of random bytes, which fill the
+    // LZW table many times, and a gray image
+    uchar *data1 = new uchar[W1 * H1 * 3];
+    uchar *data2 = new uchar[W2 * H2 * 3];
+    uchar *data3 = new uchar[W3 * H3];
+    srand(49);
+    for (i = 0; i < W1 * H1 * 3; i++) data1[i] = uchar((i / 3) % W1 * 4 + rand() % 4);
+    for (i = 0; i < W2 * H2 * 3; i++) data2[i] = uchar(rand());
+    for (i = 0; i < W3 * H3; i++) data3[i] = uchar(i % W3 < W3 / 2 ? 0 : i);
+    Fl_RGB_Image *img1 = new Fl_RGB_Image(data1, W1, H1, 3);
+    Fl_RGB_Image *img2 = new Fl_RGB_Image(data2, W2, H2, 3);
+
+    // draw each image twice on the first page and once on the second
+    FILE *f = tmpfile();
+    Fl_PostScript_File_Device *ps = begin_job(f);
+    text = 0;
+    if (ps) {
+      for (int page = 0; page < 2; page++) {
+        ps->begin_page();
+        for (i = 0; i < 2 - page; i++) {
+          img1->draw(10, 10 + 100 * i);
+          img2->draw(100, 10 + 100 * i);
+          fl_draw_image_mono(data3, 10, 300 + 100 * i, W3, H3);
+        }
+        ps->end_page();
+      }
+      end_job(ps, f);
+    } else if (f) {
+      fclose(f);
+    }
+
+    if (!text) {
+      check(0, "the PostScript output could not be written");
+    } else if (!strstr(text, "/IR {")) {
+      check(1, "the output is made by cairo, which compresses images itself");
+    } else {
+      Bytes out;
+      int ok1 = inline_image("CII\n", 0, out) && same(out, data1, W1 * H1 * 3);
+      int n1 = out.size;
+      check(ok1, "the data of a %dx%d color image decodes to the image: %d bytes", W1, H1, n1);
+      int ok2 = inline_image("CII\n", 1, out) && same(out, data2, W2 * H2 * 3);
+      check(ok2, "the data of a %dx%d random image decodes to the image: %d bytes", W2, H2, out.size);
+      check(inline_image("GII\n", 0, out) && same(out, data3, W3 * H3),
+            "the data of a %dx%d gray image decodes to the image", W3, H3);
+      check(!inline_image("CII\n", 2, out) && !inline_image("GII\n", 1, out),
+            "the data of each image follows its first drawing only");
+
+      ok1 = resource_image(1, 0, out) && same(out, data1, W1 * H1 * 3);
+      ok2 = resource_image(2, 0, out) && same(out, data2, W2 * H2 * 3);
+      int largest2 = largest;
+      int ok3 = resource_image(3, 0, out) && same(out, data3, W3 * H3);
+      check(ok1 && ok2 && ok3, "the image resources decode to the images");
+      check(count("FLI /I2 [\n") == 1 && count("/IDQ FLI /I2 get store") == 2 &&
+            largest2 == 32768, "later drawings read the resource, split in strings of %d bytes",
+            largest2);
+
+      // the LZW codes grow from 9 to 10 bits after 254 codes, the last code
+      // must have the width that the decoder expects near this limit
+      for (i = 240, ok = 1; i <= 280 && ok; i++) {
+        delete[] text;
+        text = 0;
+        ok = print_gray(data2, i) && inline_image("GII\n", 0, out) && same(out, data2, i);
+      }
+      check(ok, "gray images of 240 to 280 random bytes decode to the image");
+    }
+    delete[] text;
+    delete img1;
+    delete img2;
+    delete[] data1;
+    delete[] data2;
+    delete[] data3;
+    summary();
+  }
+};
+
+UnitTest postscript(kTestPostScript, "PostScript Images", PostScriptTest::create);
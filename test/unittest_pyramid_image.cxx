@@ -0,0 +1,158 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_Pyramid_Image.H>
+#include <FL/Fl_Recording_Surface.H>
+#include <FL/fl_draw.H>
+#include <stdio.h>      // sscanf()
+#include <string.h>     // strncmp(), strchr()
+
+//
+//------- test the tile requests of Fl_Pyramid_Image ----------
+//
+
+class PyramidImageTest : public UnitCheck {
+  enum { W = 1000, H = 700, T = 64 };
+
+  // counts the tiles requested from the provider, by level
+  int requests[8], failTile;
+
+  static int provider(void *data, int level, int col, int row,
+                      uchar *buf, int w, int h, int ld) {
+    PyramidImageTest *t = (PyramidImageTest *)data;
+    if (level < 8) t->requests[level]++;
+    if (t->failTile && level == 0 && col == 0 && row == 0) {
+      t->failTile--;
+      return 1;
+    }
+    for (int y = 0; y < h; y++)
+      memset(buf + y * ld, (col + row) & 1 ? 255 : 0, w * 3);
+    return 0;
+  }
+
+  void reset() { memset(requests, 0, sizeof(requests)); }
+  int total() const {
+    int n = 0;
+    for (int i = 0; i < 8; i++) n += requests[i];
+    return n;
+  }
+
+  // Checks that the images drawn on the surface cover the rectangle
+  // 0,0,w,h exactly, without gaps or overlaps.
+  int covers(Fl_Recording_Surface *s, int w, int h) {
+    int r[400][4], n = 0;
+    long area = 0;
+    for (const char *p = s->commands(); p && *p && n < 400; p = strchr(p, '\n') + 1) {
+      if (!strncmp(p, "rgb_image ", 10) &&
+          sscanf(p + 10, "%d %d %d %d", &r[n][0], &r[n][1], &r[n][2], &r[n][3]) == 4) {
+        if (r[n][0] < 0 || r[n][1] < 0 || r[n][0] + r[n][2] > w || r[n][1] + r[n][3] > h)
+          return 0;
+        area += (long)r[n][2] * r[n][3];
+        n++;
+      }
+      if (!strchr(p, '\n')) break;
+    }
+    for (int i = 0; i < n; i++)
+      for (int j = i + 1; j < n; j++)
+        if (r[i][0] < r[j][0] + r[j][2] && r[j][0] < r[i][0] + r[i][2] &&
+            r[i][1] < r[j][1] + r[j][3] && r[j][1] < r[i][1] + r[i][3])
+          return 0;
+    return area == (long)w * h;
+  }
+
+  void draw(Fl_Recording_Surface *s, Fl_Pyramid_Image *img, int cw, int ch) {
+    s->reset();
+    Fl_Surface_Device::push_current(s);
+    fl_push_clip(0, 0, cw, ch);
+    img->draw(0, 0);
+    fl_pop_clip();
+    Fl_Surface_Device::pop_current();
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new PyramidImageTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  PyramidImageTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    Fl_Recording_Surface *s = new Fl_Recording_Surface(W, H, 1);
+    Fl_Pyramid_Image *img = new Fl_Pyramid_Image(W, H, 3, T, 1, provider, this);
+    failTile = 0;
+    reset();
+    check(img->levels() == 5, "levels() of a %dx%d image with %d pixel tiles: %d", W, H, T,
+          img->levels());
+
+    draw(s, img, 100, 100);
+    check(requests[0] == 4 && total() == 4 && s->count(Fl_Recording_Surface::IMAGE) == 4,
+          "drawing a 100x100 area requests 4 tiles");
+    reset();
+    draw(s, img, 100, 100);
+    check(total() == 0 && s->count(Fl_Recording_Surface::IMAGE) == 4,
+          "drawing it again requests no tiles");
+
+    reset();
+    draw(s, img, W, H);
+    check(requests[0] == 16 * 11 - 4 && covers(s, W, H),
+          "the tiles of level 0 cover the image");
+
+    img->scale(250, 175, 0, 1);
+    reset();
+    draw(s, img, W, H);
+    check(total() == 0 && s->count(Fl_Recording_Surface::IMAGE) == 12 && covers(s, 250, 175),
+          "drawing at 1/4 size computes the 12 tiles of level 2");
+
+    Fl_Pyramid_Image *img3 = new Fl_Pyramid_Image(W, H, 3, T, 3, provider, this);
+    img3->scale(250, 175, 0, 1);
+    reset();
+    draw(s, img3, W, H);
+    check(requests[2] == 12 && total() == 12 && covers(s, 250, 175),
+          "drawing at 1/4 size requests the 12 provided tiles of level 2");
+    img3->scale(125, 88, 0, 1);
+    reset();
+    draw(s, img3, W, H);
+    check(requests[2] == 0 && total() == 0 && covers(s, 125, 88),
+          "level 3 is computed from the cached tiles of level 2");
+    delete img3;
+
+    img->clear_cache();
+    check(img->cached_tiles() == 0 && img->cache_used() == 0, "clear_cache() removes all tiles");
+    img->scale(W, H, 0, 1);
+    img->cache_limit(6 * T * T * 3);
+    int ok = 1;
+    for (int i = 0; i < 10; i++) {
+      draw(s, img, 100 + 64 * i, 100);
+      if (img->cache_used() > img->cache_limit() && img->cached_tiles() > 2 * (i + 2)) ok = 0;
+    }
+    check(ok && img->cached_tiles() == 2 * 11, "cache_limit() keeps only the tiles drawn last");
+
+    img->clear_cache();
+    failTile = 1;
+    reset();
+    draw(s, img, 100, 100);
+    int drawn = (int)s->count(Fl_Recording_Surface::IMAGE);
+    reset();
+    draw(s, img, 100, 100);
+    check(drawn == 3 && requests[0] == 1 && s->count(Fl_Recording_Surface::IMAGE) == 4,
+          "a tile that is not available is requested again");
+
+    delete img;
+    delete s;
+    summary();
+  }
+};
+
+UnitTest pyramid_image(kTestPyramidImage, "Pyramid Image", PyramidImageTest::create);
@@ -0,0 +1,181 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_Range_Set.H>
+#include <FL/Fl_Table_Row.H>
+#include <stdlib.h>     // rand(), srand()
+#include <string.h>     // memset()
+
+//
+//------- test Fl_Range_Set and the Fl_Table_Row selection ----------
+//
+
+// A table that records the ranges reported by selection_changed()
+class RangeSetTable : public Fl_Table_Row {
+protected:
+  void draw_cell(TableContext, int, int, int, int, int, int) { }
+  void selection_changed(int first, int last) {
+    nChanged++;
+    changedFirst = first;
+    changedLast = last;
+  }
+public:
+  int nChanged, changedFirst, changedLast;
+  RangeSetTable() : Fl_Table_Row(0, 0, 200, 200),
+    nChanged(0), changedFirst(-1), changedLast(-1) {
+    end();
+  }
+  void reset() { nChanged = 0; changedFirst = changedLast = -1; }
+};
+
+class RangeSetTest : public UnitCheck {
+  enum { N = 200 };
+
+  // Compares the set with a plain array of flags for the integers 0..N-1.
+  // Integers from N on must not be in the set.
+  int same(const Fl_Range_Set &s, const char *flags) {
+    int i;
+    for (i = 0; i < N; i++) {
+      if ((s.contains(i) != 0) != (flags[i] != 0)) return 0;
+      int ns = i; while (ns < N && !flags[ns]) ns++;
+      if (ns == N) ns = -1;
+      if (s.next_set(i) != ns) return 0;
+      int nu = i; while (nu < N && flags[nu]) nu++;
+      if (s.next_unset(i) != nu) return 0;
+    }
+    return !s.contains(N + 1000);
+  }
+
+  void testRangeSet() {
+    Fl_Range_Set s;
+    char flags[N];
+    int i, k;
+    check(s.empty() && !s.contains(0) && s.next_set(0) == -1 && s.next_unset(0) == 0,
+          "new Fl_Range_Set is empty");
+    check(s.set(10, 19, 1) == 1 && s.set(12, 15, 1) == 0,
+          "set() returns 1 only if the set changed");
+    check(s.set(15, 15, 0) == 1 && !s.contains(15) && s.contains(14) && s.contains(16),
+          "removing one integer splits a range");
+    check(s.next_set(0) == 10 && s.next_unset(10) == 15 && s.next_set(15) == 16 &&
+          s.next_unset(16) == 20, "next_set() and next_unset() step over the ranges");
+    check(s.set(15, 15, 1) == 1 && s.next_unset(10) == 20,
+          "adding the gap back merges the ranges");
+    check(s.set(20, 29, 1) == 1 && s.next_unset(10) == 30,
+          "adjacent ranges are merged");
+    check(s.set(-5, 2, 1) == 1 && s.contains(0) && !s.contains(3),
+          "negative integers are ignored");
+    s.invert();
+    check(!s.contains(10) && s.contains(3) && s.contains(1000000) && s.next_set(10) == 30,
+          "invert() replaces the set by its complement");
+    check(s.set(100, 0x7fffffff, 0) == 1 && s.next_unset(30) == 100 && !s.contains(1000000),
+          "set(limit, INT_MAX, 0) limits an inverted set");
+    s.clear();
+    check(s.empty() && s.next_set(0) == -1, "clear() empties the set");
+
+    // random operations, compared with an array of flags
+    srand(42);
+    memset(flags, 0, sizeof(flags));
+    int ok = 1, ops = 0;
+    for (k = 0; k < 2000 && ok; k++, ops++) {
+      int a = rand() % N, b = a + rand() % 20;
+      if (b >= N) b = N - 1;
+      int r = rand() % 20;
+      if (r == 0) {
+        s.invert();
+        s.set(N, 0x7fffffff, 0);
+        for (i = 0; i < N; i++) flags[i] = !flags[i];
+      } else if (r == 1) {
+        s.clear();
+        memset(flags, 0, sizeof(flags));
+      } else {
+        int flag = rand() % 3, changed = 0;
+        for (i = a; i <= b; i++) {
+          char f = (flag == 2) ? !flags[i] : (char)flag;
+          if (f != flags[i]) changed = 1;
+          flags[i] = f;
+        }
+        int ret = s.set(a, b, flag);
+        if (flag != 2 && ret != changed) ok = 0;
+      }
+      if (!same(s, flags)) ok = 0;
+    }
+    check(ok, "%d random set(), invert() and clear() calls match a flag array", ops);
+  }
+
+  void testTableRow() {
+    Fl_Group *save = Fl_Group::current();
+    Fl_Group::current(0);
+    RangeSetTable *t = new RangeSetTable;
+    Fl_Group::current(save);
+    t->rows(1000);
+    t->cols(1);
+
+    check(t->select_rows(10, 19, 1) == 1 && t->nChanged == 1 &&
+          t->changedFirst == 10 && t->changedLast == 19,
+          "select_rows() reports the range once");
+    t->reset();
+    check(t->select_rows(12, 15, 1) == 0 && t->nChanged == 0,
+          "select_rows() of selected rows changes nothing");
+    check(t->select_row(5, 1) == 1 && t->row_selected(5) == 1 && t->row_selected(6) == 0,
+          "select_row() selects one row");
+    check(t->select_rows(990, 2000, 1) == 1 && t->changedLast == 999 &&
+          t->row_selected(999) == 1 && t->row_selected(1000) == -1,
+          "select_rows() is clipped to the rows of the table");
+    const Fl_Range_Set &sel = t->selection();
+    check(sel.next_set(0) == 5 && sel.next_unset(5) == 6 && sel.next_set(6) == 10 &&
+          sel.next_unset(10) == 20 && sel.next_set(20) == 990,
+          "selection() returns the selected ranges");
+
+    t->reset();
+    t->select_all_rows(2);
+    check(t->nChanged == 1 && t->changedFirst == 0 && t->changedLast == 999 &&
+          t->row_selected(0) == 1 && t->row_selected(5) == 0 && t->row_selected(989) == 1 &&
+          t->row_selected(990) == 0, "select_all_rows(2) toggles all rows");
+    check(sel.next_set(990) == -1, "select_all_rows(2) leaves rows past the end deselected");
+    t->select_all_rows(1);
+    check(sel.next_unset(0) == 1000, "select_all_rows(1) selects all rows");
+    t->rows(500);
+    check(t->row_selected(499) == 1 && sel.next_set(500) == -1,
+          "rows() deselects removed rows");
+    t->reset();
+    t->select_all_rows(0);
+    check(t->nChanged == 1 && sel.next_set(0) == -1, "select_all_rows(0) clears the selection");
+
+    t->type(Fl_Table_Row::SELECT_SINGLE);
+    t->select_row(3, 1);
+    t->select_rows(7, 9, 1);
+    check(t->row_selected(3) == 0 && t->row_selected(7) == 0 && t->row_selected(9) == 1,
+          "SELECT_SINGLE keeps only the last row of a range");
+    t->type(Fl_Table_Row::SELECT_NONE);
+    check(t->select_row(3, 1) == -1 && sel.next_set(0) == -1,
+          "SELECT_NONE clears and rejects the selection");
+    delete t;
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new RangeSetTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  RangeSetTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    testRangeSet();
+    testTableRow();
+    summary();
+  }
+};
+
+UnitTest range_set(kTestRangeSet, "Range Set", RangeSetTest::create);
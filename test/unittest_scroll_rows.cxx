@@ -0,0 +1,162 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_Scroll.H>
+#include <FL/Fl_Box.H>
+#include <stdio.h>      // snprintf()
+#include <stdlib.h>     // rand(), srand()
+
+//
+//------- test the row mode of Fl_Scroll ----------
+//
+
+// A row widget that counts how many of its kind exist
+class ScrollRowsBox : public Fl_Box {
+public:
+  static int alive;
+  ScrollRowsBox() : Fl_Box(0, 0, 10, 10) { alive++; }
+  ~ScrollRowsBox() { alive--; }
+};
+
+int ScrollRowsBox::alive = 0;
+
+class ScrollRowsTest : public UnitCheck {
+  enum { RH = 25 };
+  Fl_Scroll *scroll;
+  int calls, created;
+
+  // the recycler, stores the row in the argument of the widget
+  static Fl_Widget *recycler(Fl_Scroll *, int row, Fl_Widget *reuse, void *data) {
+    ScrollRowsTest *t = (ScrollRowsTest *)data;
+    t->calls++;
+    Fl_Widget *o = reuse;
+    if (!o) {
+      o = new ScrollRowsBox;
+      t->created++;
+    }
+    o->argument(row);
+    return o;
+  }
+
+  // Checks that the children are the visible rows, in order, and placed
+  // where they belong. Returns 0 and describes the first error in 'msg'.
+  int rows_ok(char *msg, int size) {
+    int X = scroll->x() + Fl::box_dx(scroll->box());
+    int Y = scroll->y() + Fl::box_dy(scroll->box());
+    int H = scroll->h() - Fl::box_dh(scroll->box());
+    int W = scroll->w() - Fl::box_dw(scroll->box());
+    if (scroll->rows() * RH > H) W -= Fl::scrollbar_size();
+    int first = scroll->yposition() / RH;
+    int last = (scroll->yposition() + H - 1) / RH;
+    if (last >= scroll->rows()) last = scroll->rows() - 1;
+    int n = last - first + 1;
+    if (scroll->children() - 2 != n) {
+      snprintf(msg, size, ": %d row widgets instead of %d", scroll->children() - 2, n);
+      return 0;
+    }
+    for (int k = 0; k < n; k++) {
+      Fl_Widget *o = scroll->child(k);
+      int row = first + k;
+      if (o->argument() != row || scroll->row_widget(row) != o) {
+        snprintf(msg, size, ": child %d shows row %ld instead of %d", k, o->argument(), row);
+        return 0;
+      }
+      if (o->x() != X || o->y() != Y + row * RH - scroll->yposition() ||
+          o->w() != W || o->h() != RH) {
+        snprintf(msg, size, ": row %d is at %d,%d,%d,%d", row, o->x(), o->y(), o->w(), o->h());
+        return 0;
+      }
+    }
+    msg[0] = 0;
+    return 1;
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new ScrollRowsTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  ScrollRowsTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    Fl_Group *save = Fl_Group::current();
+    Fl_Group::current(0);
+    scroll = new Fl_Scroll(10, 20, 200, 100);
+    scroll->end();
+    Fl_Group::current(save);
+    char msg[200];
+    int i, ok;
+
+    calls = created = 0;
+    scroll->rows(20000, RH, recycler, this);
+    ok = rows_ok(msg, sizeof(msg));
+    check(ok && created == 4, "rows() creates widgets for the 4 visible rows only%s", msg);
+
+    calls = 0;
+    scroll->scroll_to(0, 1000000);
+    ok = rows_ok(msg, sizeof(msg));
+    check(ok && scroll->yposition() == 20000 * RH - 100,
+          "scroll_to() stops at the last row: %d%s", scroll->yposition(), msg);
+    check(created == 4 && calls == 4, "the widgets are reused for other rows");
+
+    srand(9);
+    for (i = 0, ok = 1; i < 1000 && ok; i++) {
+      calls = 0;
+      scroll->scroll_to(0, rand() % (20000 * RH));
+      ok = rows_ok(msg, sizeof(msg)) && calls <= 5;
+    }
+    Fl::do_widget_deletion();
+    check(ok && created == 5 && ScrollRowsBox::alive <= scroll->children(),
+          "1000 random scrolls reuse a few widgets for the visible rows%s", msg);
+
+    scroll->scroll_to(0, 250 * RH + 7);
+    calls = 0;
+    i = created;
+    scroll->update_rows();
+    ok = rows_ok(msg, sizeof(msg));
+    check(ok && calls == 5 && created == i, "update_rows() reuses the widgets of all rows%s", msg);
+
+    scroll->rows(10, RH, recycler, this);
+    ok = rows_ok(msg, sizeof(msg));
+    check(ok && scroll->yposition() == 10 * RH - 100,
+          "fewer rows move the scroll position back: %d%s", scroll->yposition(), msg);
+
+    scroll->resize(10, 20, 300, 300);
+    Fl::do_widget_deletion();
+    ok = rows_ok(msg, sizeof(msg));
+    check(ok && scroll->yposition() == 0 && scroll->children() == 12,
+          "all rows fit after resize()%s", msg);
+
+    scroll->resize(40, 50, 150, 60);
+    ok = rows_ok(msg, sizeof(msg));
+    check(ok, "rows after moving and shrinking the scroll%s", msg);
+
+    scroll->rows(0, 0, 0);
+    Fl::do_widget_deletion();
+    check(scroll->children() == 2 && scroll->rows() == 0 && ScrollRowsBox::alive == 0,
+          "rows() without a recycler deletes the row widgets");
+
+    Fl_Box *box = new Fl_Box(40, 50, 400, 400);
+    scroll->add(box);
+    scroll->scroll_to(30, 40);
+    check(box->x() == 10 && box->y() == 10 && scroll->xposition() == 30,
+          "children are moved when not in row mode");
+
+    delete scroll;
+    summary();
+  }
+};
+
+UnitTest scroll_rows(kTestScrollRows, "Scroll Rows", ScrollRowsTest::create);
@@ -0,0 +1,165 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_Menu_Bar.H>
+#include <stdio.h>      // snprintf()
+#include <stdlib.h>     // rand(), srand()
+#include <string.h>     // memset()
+
+//
+//------- test the shortcut matching of Fl_Menu_ ----------
+//
+
+class ShortcutTest : public UnitCheck {
+  enum { NKEYS = 12, NMODS = 4 };
+  Fl_Menu_Bar *mb;
+  char text[2];
+
+  static int key(int i) { return i < 8 ? 'a' + i : FL_F + i - 7; }
+  static int mod(int i) {
+    static const int mods[NMODS] = { 0, FL_CTRL, FL_ALT, FL_CTRL | FL_SHIFT };
+    return mods[i];
+  }
+
+  // sets the event that Fl::test_shortcut() compares with
+  void event(int k, int state) {
+    Fl::e_keysym = k;
+    Fl::e_state = state;
+    text[0] = (k < 128) ? (char)k : 0;
+    text[1] = 0;
+    Fl::e_text = text;
+    Fl::e_length = text[0] ? 1 : 0;
+  }
+
+  static const char *name(const Fl_Menu_Item *m) {
+    return m ? (m->label() ? m->label() : "(no label)") : "(none)";
+  }
+
+  // Compares Fl_Menu_::test_shortcut() with a walk of all items for all
+  // keys. Returns 0 and describes the first difference in 'msg'.
+  int same(char *msg, int size) {
+    for (int k = 0; k < NKEYS; k++) {
+      for (int m = 0; m < NMODS; m++) {
+        event(key(k), mod(m));
+        const Fl_Menu_Item *walk = mb->menu()->test_shortcut();
+        const Fl_Menu_Item *found = mb->test_shortcut();
+        if (walk != found) {
+          snprintf(msg, size, ": key 0x%x state 0x%x finds %s instead of %s",
+                   key(k), mod(m), name(found), name(walk));
+          return 0;
+        }
+      }
+    }
+    msg[0] = 0;
+    return 1;
+  }
+
+  int random_shortcut() {
+    return (rand() % 4 == 0) ? 0 : key(rand() % NKEYS) + mod(rand() % NMODS);
+  }
+
+  void testMenu() {
+    char msg[200], path[40];
+    int i, ok;
+    srand(7);
+    for (i = 0; i < 60; i++) {
+      snprintf(path, sizeof(path), "Menu %d/%sItem %d", i % 4,
+               (i % 3 == 0) ? "Sub/" : "", i);
+      int flags = 0;
+      if (rand() % 8 == 0) flags = FL_MENU_INACTIVE;
+      else if (rand() % 8 == 0) flags = FL_MENU_INVISIBLE;
+      mb->add(path, random_shortcut(), 0, 0, flags);
+    }
+    ok = same(msg, sizeof(msg));
+    check(ok, "test_shortcut() finds the same items as a walk of the menu%s", msg);
+
+    for (i = 0, ok = 1; i < 20 && ok; i++) {
+      int n = rand() % mb->size();
+      if (mb->menu()[n].label() && !mb->menu()[n].submenu())
+        mb->shortcut(n, random_shortcut());
+      ok = same(msg, sizeof(msg));
+    }
+    check(ok, "shortcuts changed with shortcut(i, s)%s", msg);
+
+    for (i = 0, ok = 1; i < 20 && ok; i++) {
+      int n = rand() % mb->size();
+      Fl_Menu_Item *item = (Fl_Menu_Item *)mb->menu() + n;
+      if (item->label() && !item->submenu()) item->shortcut(random_shortcut());
+      ok = same(msg, sizeof(msg));
+    }
+    check(ok, "shortcuts changed without shortcuts_changed()%s", msg);
+
+    for (i = 0, ok = 1; i < 10 && ok; i++) {
+      int n = rand() % mb->size();
+      Fl_Menu_Item *item = (Fl_Menu_Item *)mb->menu() + n;
+      if (!item->label() || item->submenu()) continue;
+      if (i % 2) mb->remove(n);
+      else mb->mode(n, item->flags ^ FL_MENU_INACTIVE);
+      ok = same(msg, sizeof(msg));
+    }
+    check(ok, "items removed and deactivated%s", msg);
+  }
+
+  void testSubmenuPointer() {
+    static Fl_Menu_Item sub1[] = {
+      { "Alpha", FL_ALT + 'a', 0, 0, 0, 0, 0, 0, 0 },
+      { 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+    };
+    static Fl_Menu_Item sub2[] = {
+      { "Beta", FL_ALT + 'b', 0, 0, 0, 0, 0, 0, 0 },
+      { 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+    };
+    mb->clear();
+    mb->add("Edit/Copy", FL_CTRL + 'c', 0);
+    mb->add("Pointer", 0, 0, (void *)sub1, FL_SUBMENU_POINTER);
+    event('a', FL_ALT);
+    check(mb->test_shortcut() == sub1, "finds items of FL_SUBMENU_POINTER submenus");
+    ((Fl_Menu_Item *)mb->find_item("Pointer"))->user_data(sub2);
+    event('a', FL_ALT);
+    const Fl_Menu_Item *a = mb->test_shortcut();
+    event('b', FL_ALT);
+    const Fl_Menu_Item *b = mb->test_shortcut();
+    check(a == 0 && b == sub2, "follows a replaced FL_SUBMENU_POINTER array");
+    event('c', FL_CTRL);
+    check(mb->test_shortcut() && !strcmp(mb->test_shortcut()->label(), "Copy"),
+          "finds items next to FL_SUBMENU_POINTER submenus");
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new ShortcutTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  ShortcutTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    int keysym = Fl::e_keysym, state = Fl::e_state, length = Fl::e_length;
+    char *etext = Fl::e_text;
+    Fl_Group *save = Fl_Group::current();
+    Fl_Group::current(0);
+    mb = new Fl_Menu_Bar(0, 0, 100, 20);
+    Fl_Group::current(save);
+    testMenu();
+    testSubmenuPointer();
+    delete mb;
+    Fl::e_keysym = keysym;
+    Fl::e_state = state;
+    Fl::e_text = etext;
+    Fl::e_length = length;
+    summary();
+  }
+};
+
+UnitTest shortcuts(kTestShortcuts, "Menu Shortcuts", ShortcutTest::create);
@@ -0,0 +1,137 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_SVG_File_Surface.H>
+#include <FL/Fl_PNG_Image.H>
+#include <FL/Fl_Bitmap.H>
+#include <FL/fl_draw.H>
+#include <stdio.h>      // tmpfile(), fread()
+#include <stdlib.h>     // rand(), srand()
+#include <string.h>     // strstr(), strchr(), memcmp()
+
+//
+//------- test the images in the output of Fl_SVG_File_Surface ----------
+//
+
+class SVGImagesTest : public UnitCheck {
+  enum { W = 100, H = 70 };
+
+  static int keep_open(FILE *) { return 0; }
+
+  // counts the occurrences of s in text
+  static int count(const char *text, const char *s) {
+    int n = 0;
+    for (const char *p = strstr(text, s); p; p = strstr(p + 1, s)) n++;
+    return n;
+  }
+
+  // Decodes the base64 data that starts at p and ends at a double quote.
+  // Returns the number of bytes decoded to out, or -1 on errors.
+  static int from_base64(const char *p, uchar *out, int size) {
+    static const char table[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    int n = 0, bits = 0, value = 0;
+    for (; *p && *p != '"'; p++) {
+      if (*p == '\n' || *p == '=') continue;
+      const char *c = strchr(table, *p);
+      if (!c) return -1;
+      value = (value << 6) | int(c - table);
+      bits += 6;
+      if (bits >= 8) {
+        bits -= 8;
+        if (n >= size) return -1;
+        out[n++] = uchar(value >> bits);
+      }
+    }
+    return *p == '"' ? n : -1;
+  }
+
+  // returns the SVG output of the drawings, to be deleted with delete[]
+  static char *draw(uchar *noise, uchar *other) {
+    static const uchar bits[] = { 0x81, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, 0x81 };
+    FILE *f = tmpfile();
+    if (!f) return 0;
+    Fl_SVG_File_Surface *svg = new Fl_SVG_File_Surface(300, 300, f, keep_open);
+    Fl_Surface_Device::push_current(svg);
+    Fl_RGB_Image a(noise, W, H, 4), b(noise, W, H, 4), c(other, 8, 8, 4);
+    Fl_RGB_Image scaled(noise, W, H, 4);
+    scaled.scale(W / 2, H / 2, 0, 1);
+    Fl_Bitmap bm(bits, 8, 8);
+    int i;
+    for (i = 0; i < 10; i++) a.draw(i * 10, 0);
+    for (i = 0; i < 5; i++) b.draw(i * 10, 100);
+    fl_draw_image(noise, 0, 200, W, H, 4);
+    for (i = 0; i < 2; i++) scaled.draw(i * 10, 200);
+    for (i = 0; i < 3; i++) c.draw(i * 10, 250);
+    fl_color(FL_RED);
+    for (i = 0; i < 2; i++) bm.draw(i * 10, 280);
+    fl_color(FL_BLUE);
+    bm.draw(50, 280);
+    Fl_Surface_Device::pop_current();
+    delete svg;
+
+    long size = ftell(f);
+    char *text = new char[size + 1];
+    rewind(f);
+    size = (long)fread(text, 1, size, f);
+    text[size] = 0;
+    fclose(f);
+    return text;
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new SVGImagesTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  SVGImagesTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    uchar *noise = new uchar[W * H * 4], other[8 * 8 * 4];
+    int i;
+    srand(11);
+    for (i = 0; i < W * H * 4; i++) noise[i] = uchar(rand());
+    for (i = 0; i < 8 * 8 * 4; i++) other[i] = uchar(i);
+    char *text = draw(noise, other);
+    check(text != 0, "Fl_SVG_File_Surface writes to a temporary file");
+    if (!text) {
+      delete[] noise;
+      summary();
+      return;
+    }
+
+    int defs = count(text, "<defs><image "), uses = count(text, "<use href=\"#FLimg");
+    check(defs == 5, "5 different images are defined once: %d definitions", defs);
+    check(uses == 24, "all 24 drawings refer to a definition: %d", uses);
+    check(count(text, "<use href=\"#FLimg0\"") == 16,
+          "the same data drawn from other images and fl_draw_image() share a definition");
+
+    const char *p = strstr(text, "data:image/png;base64,\n");
+    int size = W * H * 8;
+    uchar *png = new uchar[size];
+    int n = p ? from_base64(p + 23, png, size) : -1;
+    Fl_PNG_Image *img = n > 0 ? new Fl_PNG_Image(0, png, n) : 0;
+    int ok = img && !img->fail() && img->data_w() == W && img->data_h() == H &&
+             img->d() == 4 && !memcmp(img->array, noise, W * H * 4);
+    check(ok, "the base64 PNG data of %d bytes decodes to the image", n);
+    delete img;
+    delete[] png;
+    delete[] text;
+    delete[] noise;
+    summary();
+  }
+};
+
+UnitTest svg_images(kTestSVGImages, "SVG Images", SVGImagesTest::create);
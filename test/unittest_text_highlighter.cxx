@@ -0,0 +1,199 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_Text_Display.H>
+#include <FL/Fl_Text_Buffer.H>
+#include <FL/Fl_Text_Highlighter.H>
+#include <stdlib.h>     // rand(), srand(), calloc(), free()
+#include <string.h>     // memchr(), strlen()
+
+//
+//------- test the incremental styling of Fl_Text_Highlighter ----------
+//
+
+// Styles C block comments as 'B' and digits as 'C'. The newline at the end
+// of a line is not styled, so it takes the style of the byte before it.
+class CommentHighlighter : public Fl_Text_Highlighter {
+protected:
+  int style_line(const char *text, int length, char *style, int state) {
+    for (int i = 0; i < length; i++) {
+      if (text[i] == '\n' && i > 0) break;
+      if (state) {
+        style[i] = 'B';
+        if (text[i] == '*' && i + 1 < length && text[i + 1] == '/') {
+          style[++i] = 'B';
+          state = 0;
+        }
+      } else if (text[i] == '/' && i + 1 < length && text[i + 1] == '*') {
+        style[i] = style[i + 1] = 'B';
+        i++;
+        state = 1;
+      } else {
+        style[i] = (text[i] >= '0' && text[i] <= '9') ? 'C' : 'A';
+      }
+    }
+    return state;
+  }
+public:
+  // Styles the whole text in one pass, for comparison
+  char *full_style(const char *text) {
+    int n = (int)strlen(text), state = 0;
+    char *style = (char *)calloc(n + 1, 1);
+    for (int p = 0; p < n; ) {
+      const char *nl = (const char *)memchr(text + p, '\n', n - p);
+      int l = nl ? int(nl - (text + p)) + 1 : n - p;
+      state = style_line(text + p, l, style + p, state);
+      for (int i = p + 1; i < p + l; i++) if (!style[i]) style[i] = style[i - 1];
+      p += l;
+    }
+    return style;
+  }
+};
+
+class TextHighlighterTest : public UnitCheck {
+  Fl_Text_Buffer *buf;
+  CommentHighlighter *hl;
+  long restyled;                // bytes written to the style buffer
+
+  static void style_modified_cb(int, int nInserted, int, int, const char *, void *cbArg) {
+    ((TextHighlighterTest *)cbArg)->restyled += nInserted;
+  }
+
+  // Inserts a random snippet or deletes a few bytes at a random position
+  void edit() {
+    static const char *snippets[] = {
+      "/*", "*/", "x", "42", "\n", "abc\n", "/* note */\n", "*", "/", "\n\n"
+    };
+    int length = buf->length();
+    int pos = length ? rand() % (length + 1) : 0;
+    if (rand() % 3 == 0 && pos < length) {
+      int end = pos + 1 + rand() % 20;
+      buf->remove(pos, end < length ? end : length);
+    } else {
+      buf->insert(pos, snippets[rand() % 10]);
+    }
+  }
+
+  // Returns non-zero if the style buffer matches a full restyle
+  int converged() {
+    char *text = buf->text();
+    char *expected = hl->full_style(text);
+    char *style = hl->style_buffer()->text();
+    int ok = !strcmp(style, expected);
+    free(style);
+    free(expected);
+    free(text);
+    return ok;
+  }
+
+  // Sets lines of text with a comment of 4 lines every n lines
+  void set_text(int lines, int n) {
+    char *text = (char *)malloc(lines * 24 + 1), *p = text;
+    for (int i = 0; i < lines; i++) {
+      if (i % n == 0) p += snprintf(p, 24, "/* comment %d\n", i);
+      else if (i % n == 3) p += snprintf(p, 24, "end */ code %d\n", i);
+      else p += snprintf(p, 24, "line %d abc\n", i);
+    }
+    buf->text(text);
+    free(text);
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new TextHighlighterTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  TextHighlighterTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    Fl_Group *save = Fl_Group::current();
+    Fl_Group::current(0);
+    Fl_Text_Display *d = new Fl_Text_Display(0, 0, 500, 400);
+    Fl_Group::current(save);
+    static const Fl_Text_Display::Style_Table_Entry styles[] = {
+      { FL_BLACK,     FL_COURIER, 14, 0, 0 },
+      { FL_DARK_GREEN, FL_COURIER, 14, 0, 0 },
+      { FL_BLUE,      FL_COURIER, 14, 0, 0 }
+    };
+    buf = new Fl_Text_Buffer;
+    d->buffer(buf);
+    srand(35);
+    set_text(5000, 50);
+    hl = new CommentHighlighter;
+    hl->attach(d, styles, 3);
+    hl->finish();
+    check(!hl->pending() && converged(), "finish() styles %d bytes like a full restyle",
+          buf->length());
+
+    restyled = 0;
+    hl->style_buffer()->add_modify_callback(style_modified_cb, this);
+    buf->insert(buf->line_start(buf->length() / 2), "x\n");
+    hl->finish();
+    check(converged() && restyled < 1000,
+          "an edit outside of comments restyles %ld bytes", restyled);
+    // line 50 opens a comment, so the state of line 51 does not change
+    restyled = 0;
+    int start = buf->skip_lines(0, 10), end = buf->skip_lines(0, 51);
+    buf->insert(start, "/*");
+    hl->finish();
+    check(converged() && restyled >= end - start && restyled < end - start + 100,
+          "opening a comment restyles %ld bytes up to the next comment", restyled);
+    hl->style_buffer()->remove_modify_callback(style_modified_cb, this);
+
+    // random edits, styled in the smallest possible slices, which leaves
+    // work pending while the next edit arrives if the text is restyled up to
+    // a comment that is far away
+    int i, ok = 1, pending = 0, edits = 20000;
+    hl->time_slice(0);
+    for (i = 0; i < edits && ok; i++) {
+      if (i % 500 == 0) {
+        set_text(5000, 2000);
+        hl->finish();
+      }
+      edit();
+      if (hl->pending()) pending++;
+      if (i % 97 == 0) {
+        hl->finish();
+        ok = converged();
+      }
+    }
+    hl->finish();
+    check(ok && converged() && pending > edits / 10,
+          "%d random edits, %d with pending work, give the same styles as a full restyle",
+          i, pending);
+
+    // the same with the default time slice
+    hl->time_slice(0.005);
+    for (i = 0, ok = 1; i < 2000 && ok; i++) {
+      edit();
+      if (i % 13 == 0) {
+        hl->finish();
+        ok = converged();
+      }
+    }
+    check(ok, "random edits with the default time slice");
+
+    set_text(2000, 50);
+    hl->finish();
+    check(converged(), "replacing all text restyles it");
+
+    delete hl;
+    delete d;
+    delete buf;
+    summary();
+  }
+};
+
+UnitTest text_highlighter(kTestTextHighlighter, "Text Highlighter", TextHighlighterTest::create);
@@ -0,0 +1,252 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_Trace.H>
+#include <FL/fl_utf8.h>
+#include <stdio.h>      // tmpfile(), fread(), snprintf()
+#include <stdlib.h>     // strtol()
+#include <string.h>     // strcmp(), strncmp(), strstr(), strlen(), strcat()
+
+//
+//------- test the statistics and the trace files of Fl_Trace ----------
+//
+
+class TraceTest : public UnitCheck {
+  enum { VALUES = 1000, MAX_EVENTS = 64 };
+  char *names[MAX_EVENTS];      // the names of the events of the trace file
+  int nnames;
+
+  // Returns the output of write_chrome_trace(), to be deleted with delete[]
+  static char *trace_file() {
+    FILE *f = tmpfile();
+    if (!f) return 0;
+    if (Fl_Trace::write_chrome_trace(f)) {
+      fclose(f);
+      return 0;
+    }
+    long size = ftell(f);
+    char *text = new char[size + 1];
+    rewind(f);
+    size = (long)fread(text, 1, size, f);
+    text[size] = 0;
+    fclose(f);
+    return text;
+  }
+
+  // Decodes the JSON string at p into out, returns the end of the string
+  // or NULL if it is not valid JSON
+  static const char *json_string(const char *p, char *out, int size) {
+    if (*p++ != '"') return 0;
+    int n = 0;
+    for (; *p != '"'; p++) {
+      unsigned char c = (unsigned char)*p;
+      if (c < 0x20) return 0; // control characters must be escaped
+      if (c == '\\') {
+        p++;
+        if (*p == 'u') {
+          char hex[5] = { 0 };
+          strncpy(hex, p + 1, 4);
+          c = (unsigned char)strtol(hex, 0, 16);
+          p += 4;
+        } else if (*p == '"' || *p == '\\') {
+          c = *p;
+        } else {
+          return 0;
+        }
+      }
+      if (n < size - 1) out[n++] = c;
+    }
+    out[n] = 0;
+    return p + 1;
+  }
+
+  // Reads the names of all events of the trace file, returns 0 on errors
+  int read_names() {
+    for (int i = 0; i < nnames; i++) delete[] names[i];
+    nnames = 0;
+    char *text = trace_file();
+    if (!text) return 0;
+    const char *p = text;
+    int ok = !strncmp(p, "{\"displayTimeUnit\"", 18);
+    while (ok && (p = strstr(p, "{\"name\":")) != 0 && nnames < MAX_EVENTS) {
+      char *name = new char[100];
+      p = json_string(p + 8, name, 100);
+      names[nnames++] = name;
+      ok = p && !strncmp(p, ",\"cat\":", 7);
+    }
+    delete[] text;
+    return ok;
+  }
+
+  // Returns non-zero if s holds complete UTF-8 sequences only
+  static int valid_utf8(const char *s) {
+    while (*s) {
+      int n = fl_utf8len(*s);
+      if (n < 1) return 0;
+      for (int i = 1; i < n; i++)
+        if ((s[i] & 0xC0) != 0x80) return 0;
+      s += n;
+    }
+    return 1;
+  }
+
+  void test_statistics() {
+    int i, ok;
+    Fl_Trace::reset();
+    Fl_Trace::enable();
+    // 0.5, 1.5, ... 999.5 microseconds
+    double total = 0;
+    for (i = 0; i < VALUES; i++) {
+      Fl_Trace::value(Fl_Trace::FLUSH, (i + 0.5) * 1e-6);
+      total += (i + 0.5) * 1e-6;
+    }
+    Fl_Trace::value(Fl_Trace::AWAKE_QUEUE, 1);
+    Fl_Trace::value(Fl_Trace::AWAKE_QUEUE, 4);
+    Fl_Trace::value(Fl_Trace::AWAKE_QUEUE, 7);
+    Fl_Trace::enable(0);
+    Fl_Trace::value(Fl_Trace::FLUSH, 1.0); // ignored
+
+    check(Fl_Trace::count(Fl_Trace::FLUSH) == VALUES &&
+          Fl_Trace::total(Fl_Trace::FLUSH) > total - 1e-9 &&
+          Fl_Trace::total(Fl_Trace::FLUSH) < total + 1e-9 &&
+          Fl_Trace::maximum(Fl_Trace::FLUSH) == (VALUES - 0.5) * 1e-6,
+          "count, total, and maximum of %d values", VALUES);
+    check(Fl_Trace::mean(Fl_Trace::FLUSH) > 499.99e-6 &&
+          Fl_Trace::mean(Fl_Trace::FLUSH) < 500.01e-6 &&
+          Fl_Trace::mean(Fl_Trace::IDLE) == 0, "mean of the values: %g",
+          Fl_Trace::mean(Fl_Trace::FLUSH));
+
+    // bucket 0 holds 0.5, bucket b the values from 2^(b-1) to 2^b
+    unsigned long expected[Fl_Trace::BUCKETS] = { 0 };
+    for (i = 0; i < VALUES; i++) {
+      int b = 0;
+      while (b < Fl_Trace::BUCKETS - 1 && (1 << b) <= i) b++;
+      expected[i ? b : 0]++;
+    }
+    for (i = 0, ok = 1; i < Fl_Trace::BUCKETS; i++)
+      if (Fl_Trace::histogram(Fl_Trace::FLUSH, i) != expected[i]) ok = 0;
+    double limit = Fl_Trace::bucket_limit(Fl_Trace::FLUSH, 10);
+    check(ok && Fl_Trace::histogram(Fl_Trace::FLUSH, 10) == 488 &&
+          limit > 1023.99e-6 && limit < 1024.01e-6,
+          "histogram buckets of durations");
+    // the lower limit of a bucket belongs to the bucket
+    check(Fl_Trace::histogram(Fl_Trace::AWAKE_QUEUE, 1) == 1 &&
+          Fl_Trace::histogram(Fl_Trace::AWAKE_QUEUE, 3) == 2 &&
+          Fl_Trace::bucket_limit(Fl_Trace::AWAKE_QUEUE, 3) == 8,
+          "histogram buckets of the awake queue length");
+
+    // the percentile is the limit of its bucket, at most twice the exact value
+    for (i = 1, ok = 1; i <= 100 && ok; i++) {
+      double exact = (VALUES * i / 100 - 0.5) * 1e-6;
+      double p = Fl_Trace::percentile(Fl_Trace::FLUSH, i);
+      if (p < exact || p > 2 * exact + 1e-6) ok = 0;
+    }
+    check(ok && Fl_Trace::percentile(Fl_Trace::FLUSH, 50) ==
+          Fl_Trace::bucket_limit(Fl_Trace::FLUSH, 9) &&
+          Fl_Trace::percentile(Fl_Trace::FLUSH, 100) == (VALUES - 0.5) * 1e-6,
+          "percentiles are exact within a factor of two");
+
+    Fl_Trace::enable();
+    Fl_Trace::value(Fl_Trace::TIMEOUT, 1e6);
+    Fl_Trace::enable(0);
+    check(Fl_Trace::histogram(Fl_Trace::TIMEOUT, Fl_Trace::BUCKETS - 1) == 1 &&
+          Fl_Trace::percentile(Fl_Trace::TIMEOUT, 50) == 1e6 &&
+          Fl_Trace::bucket_limit(Fl_Trace::TIMEOUT, Fl_Trace::BUCKETS - 1) ==
+          Fl_Trace::bucket_limit(Fl_Trace::TIMEOUT, Fl_Trace::BUCKETS - 2),
+          "the last bucket holds all large values");
+
+    Fl_Trace::reset();
+    check(Fl_Trace::count(Fl_Trace::FLUSH) == 0 && Fl_Trace::maximum(Fl_Trace::FLUSH) == 0 &&
+          Fl_Trace::histogram(Fl_Trace::FLUSH, 10) == 0 &&
+          Fl_Trace::percentile(Fl_Trace::FLUSH, 50) == 0, "reset() clears the statistics");
+  }
+
+  void test_events() {
+    int i, ok;
+    char name[64];
+    Fl_Trace::reset();
+    Fl_Trace::record_events(10);
+    Fl_Trace::enable();
+    for (i = 0; i < 25; i++) {
+      snprintf(name, sizeof(name), "event %d", i);
+      Fl_Trace::value(Fl_Trace::FLUSH, 1e-3, name);
+    }
+    Fl_Trace::enable(0);
+    ok = read_names() && nnames == 10 && Fl_Trace::recorded_events() == 10;
+    for (i = 0; i < 10 && ok; i++) {
+      snprintf(name, sizeof(name), "event %d", i + 15);
+      ok = !strcmp(names[i], name);
+    }
+    check(ok, "the ring buffer keeps the last 10 of 25 events in order");
+
+    // names are cut to 27 bytes, but not within an UTF-8 sequence
+    static const char *utf8[] = { "\xc3\xa4", "\xe2\x82\xac", "\xf0\x9f\x98\x80" };
+    char long_names[12][64];
+    Fl_Trace::record_events(MAX_EVENTS);
+    Fl_Trace::enable();
+    for (i = 0; i < 12; i++) {
+      int n = 20 + i % 4;
+      memset(long_names[i], 'a', n);
+      long_names[i][n] = 0;
+      for (int k = 0; k < 4; k++) strcat(long_names[i], utf8[i / 4]);
+      Fl_Trace::value(Fl_Trace::FLUSH, 1e-3, long_names[i]);
+    }
+    Fl_Trace::enable(0);
+    ok = read_names() && nnames == 12;
+    for (i = 0; i < nnames && ok; i++) {
+      int n = 27;
+      while ((long_names[i][n] & 0xC0) == 0x80) n--;
+      ok = (int)strlen(names[i]) == n && !strncmp(names[i], long_names[i], n) &&
+           valid_utf8(names[i]);
+    }
+    check(ok, "long names are cut between UTF-8 sequences");
+
+    static const char *special[] = {
+      "quote \" and backslash \\", "new\nline and\ttab", "\x01\x1f control", "\xc3\xa4\\\""
+    };
+    Fl_Trace::record_events(MAX_EVENTS);
+    Fl_Trace::enable();
+    for (i = 0; i < 4; i++) Fl_Trace::value(Fl_Trace::FLUSH, 1e-3, special[i]);
+    Fl_Trace::enable(0);
+    ok = read_names() && nnames == 4;
+    for (i = 0; i < nnames && ok; i++) ok = !strcmp(names[i], special[i]);
+    check(ok, "names are escaped in the JSON trace file");
+
+    Fl_Trace::record_events(0);
+    Fl_Trace::reset();
+    check(Fl_Trace::recorded_events() == 0 && read_names() && nnames == 0,
+          "record_events(0) stops recording");
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new TraceTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  TraceTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    nnames = 0;
+    int was_enabled = Fl_Trace::enabled();
+    Fl_Trace::enable(0);
+    test_statistics();
+    test_events();
+    for (int i = 0; i < nnames; i++) delete[] names[i];
+    Fl_Trace::enable(was_enabled);
+    summary();
+  }
+};
+
+UnitTest trace(kTestTrace, "Trace", TraceTest::create);
@@ -0,0 +1,146 @@
+//
+// Unit tests for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "unittests.h"
+
+#include <FL/Fl_Text_Display.H>
+#include <FL/Fl_Text_Buffer.H>
+#include <stdlib.h>     // rand(), srand()
+#include <string.h>     // strlen()
+
+//
+//------- test the wrapped line counts of Fl_Text_Display ----------
+//
+
+// Gives access to the line counts of the display
+class WrapCacheDisplay : public Fl_Text_Display {
+public:
+  WrapCacheDisplay(int w, int h) : Fl_Text_Display(0, 0, w, h) { }
+  // measures all rows that are still estimated
+  void finish() {
+    while (refine_wrap_cache(1e300)) { }
+    Fl::remove_idle(wrap_cache_idle_cb, this);
+  }
+  // returns non-zero if rows are left to be measured
+  int estimated() { return refine_wrap_cache(0); }
+  int rows() const { return mNBufferLines; }
+  int top() const { return mTopLineNum; }
+  int exact_rows() const { return count_lines(0, buffer()->length(), true); }
+  int exact_top() const { return count_lines(0, mFirstChar, true) + 1; }
+};
+
+class WrapCacheTest : public UnitCheck {
+  // Appends about n bytes of words, long words, tabs and empty lines
+  static void add_text(Fl_Text_Buffer *buf, int pos, int n) {
+    static const char *words[] = {
+      "a", "mew", "word", "tenacious", "x\ty", "lorem", "ipsum", "\xc3\xa4\xc3\xb6\xc3\xbc",
+      "wwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwww"
+    };
+    char *text = new char[n + 100];
+    int len = 0;
+    while (len < n) {
+      int r = rand() % 100;
+      const char *w = (r < 12) ? "\n" : (r < 14) ? "\n\n" : words[rand() % 9];
+      strcpy(text + len, w);
+      len += (int)strlen(w);
+      if (r >= 14) text[len++] = ' ';
+    }
+    text[len] = 0;
+    buf->insert(pos, text);
+    delete[] text;
+  }
+
+  int same(WrapCacheDisplay *d) {
+    return d->rows() == d->exact_rows() && d->top() == d->exact_top();
+  }
+
+public:
+  static Fl_Widget *create() {
+    return new WrapCacheTest(TESTAREA_X, TESTAREA_Y, TESTAREA_W, TESTAREA_H);
+  }
+  WrapCacheTest(int x, int y, int w, int h) : UnitCheck(x, y, w, h) {
+    Fl_Group *save = Fl_Group::current();
+    Fl_Group::current(0);
+    WrapCacheDisplay *d = new WrapCacheDisplay(500, 400);
+    Fl_Group::current(save);
+    Fl_Text_Buffer *buf = new Fl_Text_Buffer;
+    srand(5);
+    add_text(buf, 0, 100000);
+    d->wrap_mode(Fl_Text_Display::WRAP_AT_BOUNDS, 0);
+    d->buffer(buf);
+    d->finish();
+    check(same(d), "rows of a new buffer: %d", d->rows());
+
+    d->scroll(d->rows() / 2, 0);
+    check(same(d), "top line after scrolling: %d", d->top());
+
+    int i, lazy = 1, ok = 1;
+    for (i = 0; i < 10; i++) {
+      d->resize(0, 0, 200 + rand() % 600, 400);
+      if (!d->estimated()) lazy = 0;
+      d->finish();
+      if (!same(d)) ok = 0;
+    }
+    check(lazy, "resize() leaves the rows to be measured in the background");
+    check(ok, "rows and top line after 10 resizes");
+
+    ok = 1;
+    for (i = 0; i < 200; i++) {
+      int len = buf->length();
+      int pos = buf->utf8_align(rand() % (len + 1));
+      int end = buf->utf8_align(pos + rand() % 2000 < len ? pos + rand() % 2000 : len);
+      switch (rand() % 4) {
+        case 0: add_text(buf, pos, rand() % 300); break;
+        case 1: buf->remove(pos, end); break;
+        case 2: buf->replace(pos, end, "\n"); break;
+        case 3: if (rand() % 10 == 0) add_text(buf, pos, 20000); break;
+      }
+      if (i % 20 == 0) d->resize(0, 0, 200 + rand() % 600, 400);
+      d->finish();
+      if (!same(d)) ok = 0;
+    }
+    check(ok, "rows and top line after 200 edits");
+
+    d->textsize(d->textsize() + 4);
+    d->resize(0, 0, 400, 400);
+    d->finish();
+    check(same(d), "rows after textsize() and resize()");
+    d->wrap_mode(Fl_Text_Display::WRAP_AT_COLUMN, 40);
+    d->finish();
+    check(same(d), "rows after wrap_mode(WRAP_AT_COLUMN, 40)");
+    d->wrap_mode(Fl_Text_Display::WRAP_NONE, 0);
+    check(d->rows() == buf->count_lines(0, buf->length()), "rows after WRAP_NONE");
+    d->wrap_mode(Fl_Text_Display::WRAP_AT_PIXEL, 300);
+    d->finish();
+    check(same(d), "rows after wrap_mode(WRAP_AT_PIXEL, 300)");
+
+    Fl_Text_Buffer *buf2 = new Fl_Text_Buffer;
+    buf2->text("short\ntext");
+    d->buffer(buf2);
+    d->finish();
+    check(same(d), "rows of a short buffer");
+    buf2->text("");
+    d->finish();
+    check(same(d) && d->rows() == 0, "rows of an empty buffer");
+
+    delete d;
+    delete buf;
+    delete buf2;
+    summary();
+  }
+};
+
+UnitTest wrap_cache(kTestWrapCache, "Wrapped Lines", WrapCacheTest::create);
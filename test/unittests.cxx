@@ -32,6 +32,8 @@
 #include <FL/fl_draw.H>     // fl_text_extents()
 #include <FL/fl_string_functions.h>   // fl_strdup()
 #include <stdlib.h>         // malloc, free
+#include <stdio.h>          // vsnprintf, fprintf
+#include <stdarg.h>
 
 class MainWindow *mainwin = 0;
 class Fl_Hold_Browser *browser = 0;
@@ -75,6 +77,41 @@ void UnitTest::add(int index, UnitTest *t) {
 int UnitTest::nTest = 0;
 UnitTest *UnitTest::fTest[200] = { 0 };
 
+UnitCheck::UnitCheck(int x, int y, int w, int h, const char *l) :
+  Fl_Simple_Terminal(x, y, w, h, l),
+  fChecks(0),
+  fFailed(0)
+{
+  ansi(true);
+  stay_at_bottom(false);
+  history_lines(-1);
+}
+
+// Prints the result of a check and returns \p ok.
+int UnitCheck::check(int ok, const char *fmt, ...) {
+  char msg[256];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(msg, sizeof(msg), fmt, ap);
+  va_end(ap);
+  fChecks++;
+  if (ok) {
+    printf("\033[32m ok \033[0m %s\n", msg);
+  } else {
+    fFailed++;
+    printf("\033[31mFAIL %s\033[0m\n", msg);
+    fprintf(stderr, "%s: FAIL %s\n", label() ? label() : "unittests", msg);
+  }
+  return ok;
+}
+
+void UnitCheck::summary() {
+  if (fFailed)
+    printf("\n\033[31m%d of %d checks failed\033[0m\n", fFailed, fChecks);
+  else
+    printf("\n%d checks passed\n", fChecks);
+}
+
 MainWindow::MainWindow(int w, int h, const char *l) :
 Fl_Double_Window(w, h, l),
 fTestAlignment(0)
@@ -19,6 +19,7 @@
 
 #include <FL/Fl.H>
 #include <FL/Fl_Double_Window.H>
+#include <FL/Fl_Simple_Terminal.H>
 
 // WINDOW/WIDGET SIZES
 #define MAINWIN_W       700                             // main window w()
@@ -49,7 +50,23 @@ enum {
   kTestViewport,
   kTestScrollbarsize,
   kTestSchemes,
-  kTestSimpleTerminal
+  kTestSimpleTerminal,
+  kTestRangeSet,
+  kTestWrapCache,
+  kTestShortcuts,
+  kTestInputLines,
+  kTestPyramidImage,
+  kTestAnimGIF,
+  kTestScrollRows,
+  kTestMenuTypeAhead,
+  kTestFontCache,
+  kTestFontNames,
+  kTestSVGImages,
+  kTestFluidUndo,
+  kTestTextHighlighter,
+  kTestTrace,
+  kTestPostScript,
+  kTestPixmap
 };
 
 // This class helps to automatically register a new test with the unittest app.
@@ -73,6 +90,21 @@ private:
   static UnitTest *fTest[];
 };
 
+// Tests that compare results instead of showing a drawing derive from this
+// class. They run their checks in the constructor and call summary() at the
+// end. Each check prints one line, failures in red; failures are also
+// printed to stderr.
+class UnitCheck : public Fl_Simple_Terminal {
+public:
+  UnitCheck(int x, int y, int w, int h, const char *l=0L);
+  int check(int ok, const char *fmt, ...);
+  void summary();
+  int failed() const { return fFailed; }
+private:
+  int fChecks;
+  int fFailed;
+};
+
 // The main window needs an additional drawing feature in order to support
 // the viewport alignment test.
 class MainWindow : public Fl_Double_Window {